@@ -25,6 +25,7 @@ struct SystemConfig {
     uint_fast32_t port = MDBServer::Protocol::DEFAULT_PORT;
     uint_fast32_t browser_port = MDBServer::Protocol::DEFAULT_BROWSER_PORT;
     uint_fast32_t workers = std::thread::hardware_concurrency();
+    uint_fast32_t parallelism = 1; // max threads used by a single query
 
     uint64_t limit = 0; // 0 means no limit
     uint64_t strings_static_buffer = StringManager::DEFAULT_STATIC_BUFFER;
@@ -53,6 +54,7 @@ struct SystemOptions {
     std::optional<uint_fast32_t> port;
     std::optional<uint_fast32_t> browser_port;
     std::optional<uint_fast32_t> workers;
+    std::optional<uint_fast32_t> parallelism;
     std::optional<uint64_t> limit;
     std::optional<uint64_t> strings_static_buffer;
     std::optional<uint64_t> strings_dynamic_buffer;
@@ -93,6 +95,7 @@ inline int mdb_server(const SystemConfig& conf)
             model_destroyer = QuadModel::init();
 
             quad_model.path_mode = conf.path_mode;
+            quad_model.MAX_PARALLELISM = conf.parallelism;
             if (conf.limit != 0) {
                 quad_model.MAX_LIMIT = conf.limit;
             }
@@ -106,6 +109,7 @@ inline int mdb_server(const SystemConfig& conf)
             model_destroyer = RdfModel::init();
 
             rdf_model.path_mode = conf.path_mode;
+            rdf_model.MAX_PARALLELISM = conf.parallelism;
             if (conf.limit != 0) {
                 rdf_model.MAX_LIMIT = conf.limit;
             }
@@ -278,6 +282,18 @@ inline std::map<std::string, std::function<std::string(SystemOptions&, const std
                     return "";
                 } });
 
+    opt.insert({ "parallelism", [](SystemOptions& config, const std::string& value) {
+                    try {
+                        auto threads = std::stoi(value);
+                        if (threads > 0) {
+                            config.parallelism = threads;
+                            return "";
+                        }
+                    } catch (...) {
+                    }
+                    return "invalid parallelism, expected to be a positive integer";
+                } });
+
     return opt;
 }
 
@@ -358,6 +374,7 @@ inline SystemConfig get_system_config(const std::string& db_directory, const Sys
     try_replace(res.port, args.port, db_config.port);
     try_replace(res.browser_port, args.browser_port, db_config.browser_port);
     try_replace(res.workers, args.browser_port, db_config.workers);
+    try_replace(res.parallelism, args.parallelism, db_config.parallelism);
     try_replace(res.limit, args.limit, db_config.limit);
     try_replace(res.strings_static_buffer, args.strings_static_buffer, db_config.strings_static_buffer);
     try_replace(res.strings_dynamic_buffer, args.strings_dynamic_buffer, db_config.strings_dynamic_buffer);
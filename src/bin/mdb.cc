@@ -21,6 +21,7 @@ void print_server_help()
             "\n    -j,--threads,--workers <N>         number of worker threads"
             "\n    -p,--port <port>                   server port (default: 1234)"
             "\n    -t,--timeout <seconds>             set query timeout (default: 60)"
+            "\n    --parallelism <N>                  max threads used by a single query (default: 1)"
             "\n    --browser <true|false>             enable or disable web browser"
             "\n    --browser-port <port>              browser port (default: 4321)"
             "\n    --admin-user <username>            admin username"
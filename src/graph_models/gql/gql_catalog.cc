@@ -8,7 +8,8 @@ GQLCatalog::GQLCatalog(const std::string& filename) :
     if (!is_empty()) {
         auto diff_minor_version = check_version("GQL", MODEL_ID, MAJOR_VERSION, MINOR_VERSION);
 
-        if (diff_minor_version != 0) {
+        // catalogs of version 2.0 are read without sketches
+        if (diff_minor_version != 0 && diff_minor_version != 1) {
             throw LogicException("Undefined catalog recovery");
         }
 
@@ -38,6 +39,11 @@ GQLCatalog::GQLCatalog(const std::string& filename) :
 
         node_keys2id = convert_strvec_to_map(node_keys_str);
         edge_keys2id = convert_strvec_to_map(edge_keys_str);
+
+        if (diff_minor_version == 0) {
+            node_key2distinct_values = read_sketch_map();
+            edge_key2distinct_values = read_sketch_map();
+        }
     } else {
         has_changes = true;
     }
@@ -94,4 +100,7 @@ void GQLCatalog::save()
 
     write_strvec(node_keys_str);
     write_strvec(edge_keys_str);
+
+    write_sketch_map(node_key2distinct_values);
+    write_sketch_map(edge_key2distinct_values);
 }
@@ -8,8 +8,8 @@
 class GQLCatalog : public Catalog {
 public:
     static constexpr uint8_t MODEL_ID = 2;
-    static constexpr uint8_t MAJOR_VERSION = 1;
-    static constexpr uint8_t MINOR_VERSION = 0;
+    static constexpr uint8_t MAJOR_VERSION = 2;
+    static constexpr uint8_t MINOR_VERSION = 1;
 
     GQLCatalog(const std::string& filename);
 
@@ -47,6 +47,10 @@ public:
 
     boost::unordered_flat_map<uint64_t, uint64_t> edge_key2total_count;
 
+    boost::unordered_flat_map<uint64_t, HyperLogLog> node_key2distinct_values;
+
+    boost::unordered_flat_map<uint64_t, HyperLogLog> edge_key2distinct_values;
+
     std::vector<std::string> node_labels_str;
     boost::unordered_flat_map<std::string, uint64_t> node_labels2id;
 
@@ -24,7 +24,8 @@ QuadCatalog::QuadCatalog(const std::string& filename) :
     } else {
         auto diff_minor_version = check_version("Quad", MODEL_ID, MAJOR_VERSION, MINOR_VERSION);
 
-        if (diff_minor_version != 0) {
+        // catalogs of version 3.0 are read without sketches
+        if (diff_minor_version != 0 && diff_minor_version != 1) {
             throw LogicException("Undefined catalog recovery");
         }
 
@@ -117,6 +118,12 @@ QuadCatalog::QuadCatalog(const std::string& filename) :
             metadata.predicate = read_string();
             hnsw_index_manager.load_hnsw_index(name, metadata);
         }
+
+        if (diff_minor_version == 0) {
+            key2distinct_values = read_sketch_map();
+            type2distinct_from = read_sketch_map();
+            type2distinct_to = read_sketch_map();
+        }
     }
 }
 
@@ -202,6 +209,10 @@ void QuadCatalog::save()
         write_uint8(static_cast<uint8_t>(metadata.metric_type));
         write_string(metadata.predicate);
     }
+
+    write_sketch_map(key2distinct_values);
+    write_sketch_map(type2distinct_from);
+    write_sketch_map(type2distinct_to);
 }
 
 void QuadCatalog::print(std::ostream& os)
@@ -292,11 +303,43 @@ uint64_t QuadCatalog::equal_to_type_with_type(uint64_t type_id) const
     }
 }
 
+double QuadCatalog::distinct_values_with_key(uint64_t key_id) const
+{
+    auto search = key2distinct_values.find(key_id);
+    if (search == key2distinct_values.end()) {
+        return 0;
+    } else {
+        return search->second.estimate();
+    }
+}
+
+double QuadCatalog::distinct_from_with_type(uint64_t type_id) const
+{
+    auto search = type2distinct_from.find(type_id);
+    if (search == type2distinct_from.end()) {
+        return 0;
+    } else {
+        return search->second.estimate();
+    }
+}
+
+double QuadCatalog::distinct_to_with_type(uint64_t type_id) const
+{
+    auto search = type2distinct_to.find(type_id);
+    if (search == type2distinct_to.end()) {
+        return 0;
+    } else {
+        return search->second.estimate();
+    }
+}
+
 uint64_t QuadCatalog::insert_new_edge(uint64_t from, uint64_t to, uint64_t type)
 {
     auto new_edge_id = ++edge_count;
 
     type2total_count[type]++;
+    type2distinct_from[type].add(from);
+    type2distinct_to[type].add(to);
     if (from == to) {
         type2equal_from_to_count[type]++;
         equal_from_to_count++;
@@ -318,11 +361,18 @@ uint64_t QuadCatalog::insert_new_edge(uint64_t from, uint64_t to, uint64_t type)
     return new_edge_id;
 }
 
-void QuadCatalog::insert_property(uint64_t key)
+void QuadCatalog::insert_property(uint64_t key, uint64_t value)
 {
     has_changes = true;
     properties_count++;
     key2total_count[key]++;
+    key2distinct_values[key].add(value);
+}
+
+void QuadCatalog::overwrite_property(uint64_t key, uint64_t value)
+{
+    has_changes = true;
+    key2distinct_values[key].add(value);
 }
 
 void QuadCatalog::insert_label(uint64_t label)
@@ -10,8 +10,8 @@
 class QuadCatalog : public Catalog {
 public:
     static constexpr uint8_t MODEL_ID = 0;
-    static constexpr uint8_t MAJOR_VERSION = 2;
-    static constexpr uint8_t MINOR_VERSION = 0;
+    static constexpr uint8_t MAJOR_VERSION = 3;
+    static constexpr uint8_t MINOR_VERSION = 1;
 
     QuadCatalog(const std::string& filename);
 
@@ -26,8 +26,16 @@ public:
     uint64_t equal_from_type_with_type(uint64_t type_id) const;
     uint64_t equal_to_type_with_type(uint64_t type_id) const;
 
+    // estimated number of distinct values of the key, 0 if unknown
+    double distinct_values_with_key(uint64_t key_id) const;
+
+    // estimated number of distinct from (to) nodes of the edges with the type, 0 if unknown
+    double distinct_from_with_type(uint64_t type_id) const;
+    double distinct_to_with_type(uint64_t type_id) const;
+
     uint64_t insert_new_edge(uint64_t from, uint64_t to, uint64_t type);
-    void insert_property(uint64_t key);
+    void insert_property(uint64_t key, uint64_t value);
+    void overwrite_property(uint64_t key, uint64_t value);
     void insert_label(uint64_t label);
 
     uint64_t nodes_count;
@@ -50,6 +58,10 @@ public:
     boost::unordered_flat_map<uint64_t, uint64_t> type2equal_from_type_count;
     boost::unordered_flat_map<uint64_t, uint64_t> type2equal_to_type_count;
 
+    boost::unordered_flat_map<uint64_t, HyperLogLog> key2distinct_values;
+    boost::unordered_flat_map<uint64_t, HyperLogLog> type2distinct_from;
+    boost::unordered_flat_map<uint64_t, HyperLogLog> type2distinct_to;
+
     TextSearch::TextIndexManager text_index_manager;
     HNSW::HNSWIndexManager hnsw_index_manager;
 };
@@ -40,6 +40,9 @@ public:
 
     uint64_t MAX_LIMIT = UINT64_MAX;
 
+    // maximum number of threads used to evaluate a single query
+    uint_fast32_t MAX_PARALLELISM = 1;
+
     // Path mode to use
     PathSearchMode path_mode = PathSearchMode::BFS;
 
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Subjects that have exactly the same set of predicates, as defined in
+// "Characteristic Sets: Accurate Cardinality Estimation for RDF Queries
+// with Multiple Joins" (Neumann & Moerkotte, 2011)
+struct CharacteristicSet {
+    // sorted predicate ids
+    std::vector<uint64_t> predicates;
+
+    // triples of the subjects with each predicate, in the order of predicates
+    std::vector<uint64_t> counts;
+
+    // number of subjects with this set of predicates
+    uint64_t subjects;
+};
@@ -7,6 +7,7 @@
 #include "graph_models/rdf_model/conversions.h"
 #include "graph_models/rdf_model/rdf_model.h"
 #include "query/query_context.h"
+#include "storage/tuple_collection/sort_key.h"
 #include "system/string_manager.h"
 
 using namespace SPARQL;
@@ -212,6 +213,82 @@ int64_t Comparisons::_compare(ObjectId lhs_oid, ObjectId rhs_oid, bool* error) {
     }
 }
 
+// The key starts with the generic type, as compare. The rest of the key is:
+// - IRI: the first bytes of the IRI.
+// - STRING: the generic sub type, the language or datatype and the first bytes
+//   of the string.
+// - NUMERIC: the value converted to double, which keeps the order of the
+//   conversions used by compare. It is exact for floats, doubles and integers
+//   that can be converted to double without rounding.
+// - BOOL and the types compared by value: the value.
+// - DATE and TENSOR: nothing, they are always compared with compare.
+bool Comparisons::normalize(ObjectId oid, unsigned char* key) {
+    auto gen_t = RDF_OID::get_generic_type(oid);
+    key[0] = static_cast<unsigned char>(gen_t);
+
+    switch (gen_t) {
+    case RDF_OID::GenericType::IRI: {
+        auto buffer = get_query_ctx().get_buffer1();
+        auto size = Conversions::print_iri(oid, buffer);
+        return SortKey::write_prefix(buffer, size, key + 1, SortKey::COMPARED_BYTES - 1);
+    }
+    case RDF_OID::GenericType::STRING: {
+        auto sub_t = RDF_OID::get_generic_sub_type(oid);
+        key[1] = static_cast<unsigned char>(sub_t);
+
+        auto buffer = get_query_ctx().get_buffer1();
+        size_t size;
+        uint64_t tag = 0;
+        switch (sub_t) {
+        case RDF_OID::GenericSubType::STRING_SIMPLE:
+        case RDF_OID::GenericSubType::STRING_XSD:
+            size = Conversions::print_string(oid, buffer);
+            break;
+        case RDF_OID::GenericSubType::STRING_LANG:
+            tag = (oid.id & ObjectId::MASK_LITERAL_TAG) >> 44;
+            size = Conversions::print_string_lang(oid, buffer);
+            break;
+        case RDF_OID::GenericSubType::STRING_DATATYPE:
+            tag = (oid.id & ObjectId::MASK_LITERAL_TAG) >> 44;
+            size = Conversions::print_string_datatype(oid, buffer);
+            break;
+        default:
+            throw LogicException("unexpected RDF_OID::GenericSubType at SPARQL::Comparisons::normalize");
+        }
+        key[2] = tag >> 8;
+        key[3] = tag & 0xFF;
+        return SortKey::write_prefix(buffer, size, key + 4, SortKey::COMPARED_BYTES - 4);
+    }
+    case RDF_OID::GenericType::NUMERIC: {
+        auto value = Conversions::to_double(oid);
+        SortKey::write_uint64(SortKey::double_bits(value), key + 1);
+
+        switch (oid.get_sub_type()) {
+        case ObjectId::MASK_INT: {
+            auto i = Conversions::unpack_int(oid);
+            return i >= -(1LL << 53) && i <= (1LL << 53);
+        }
+        case ObjectId::MASK_FLOAT:
+        case ObjectId::MASK_DOUBLE:
+            return !std::isnan(value);
+        default:
+            return false;
+        }
+    }
+    case RDF_OID::GenericType::BOOL: {
+        key[1] = oid.id & 1;
+        return true;
+    }
+    case RDF_OID::GenericType::DATE:
+    case RDF_OID::GenericType::TENSOR: {
+        return false;
+    }
+    default: {
+        SortKey::write_uint64(oid.id & ObjectId::VALUE_MASK, key + 1);
+        return true;
+    }
+    }
+}
 
 template int64_t Comparisons::_compare<Comparisons::Mode::Normal>(ObjectId lhs_oid, ObjectId rhs_oid, bool* error);
 template int64_t Comparisons::_compare<Comparisons::Mode::Strict>(ObjectId lhs_oid, ObjectId rhs_oid, bool* error);
@@ -15,6 +15,9 @@ public:
         return _compare<Mode::Strict>(lhs, rhs, error);
     }
 
+    // SortKey::Normalizer for compare
+    static bool normalize(ObjectId oid, unsigned char* key);
+
 private:
     enum class Mode { Normal, Strict };
 
@@ -1,5 +1,6 @@
 #include "rdf_catalog.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "query/exceptions.h"
@@ -15,7 +16,10 @@ RdfCatalog::RdfCatalog(const std::string& filename) :
 
     auto diff_minor_version = check_version("RDF", MODEL_ID, MAJOR_VERSION, MINOR_VERSION);
 
-    if (diff_minor_version != 0) {
+    // catalogs of version 2.0 are read without characteristic sets, catalogs
+    // of versions 2.0 and 2.1 without predicate sketches, and catalogs of
+    // versions 2.0 to 2.2 without predicate histograms
+    if (diff_minor_version < 0 || diff_minor_version > 3) {
         throw LogicException("Undefined catalog recovery");
     }
 
@@ -60,6 +64,32 @@ RdfCatalog::RdfCatalog(const std::string& filename) :
         metadata.predicate = read_string();
         hnsw_index_manager.load_hnsw_index(name, metadata);
     }
+
+    if (diff_minor_version <= 2) {
+        const auto characteristic_sets_size = read_uint64();
+        for (uint_fast32_t i = 0; i < characteristic_sets_size; ++i) {
+            CharacteristicSet characteristic_set;
+            characteristic_set.subjects = read_uint64();
+            const auto predicates_size = read_uint64();
+            for (uint_fast32_t j = 0; j < predicates_size; ++j) {
+                characteristic_set.predicates.push_back(read_uint64());
+                characteristic_set.counts.push_back(read_uint64());
+            }
+            characteristic_sets.push_back(std::move(characteristic_set));
+            index_characteristic_set(characteristic_sets.size() - 1);
+        }
+    }
+
+    if (diff_minor_version <= 1) {
+        predicate2distinct_subjects = read_sketch_map();
+        predicate2distinct_objects = read_sketch_map();
+    }
+
+    if (diff_minor_version == 0) {
+        for (auto& histograms : predicate2histograms) {
+            histograms = read_histogram_map();
+        }
+    }
 }
 
 // Constructor for new empty catalog
@@ -122,6 +152,31 @@ void RdfCatalog::save()
         write_uint8(static_cast<uint8_t>(metadata.metric_type));
         write_string(metadata.predicate);
     }
+
+    const auto non_empty_sets = std::count_if(
+        characteristic_sets.begin(),
+        characteristic_sets.end(),
+        [](const CharacteristicSet& characteristic_set) { return characteristic_set.subjects > 0; }
+    );
+    write_uint64(non_empty_sets);
+    for (const auto& characteristic_set : characteristic_sets) {
+        if (characteristic_set.subjects == 0) {
+            continue;
+        }
+        write_uint64(characteristic_set.subjects);
+        write_uint64(characteristic_set.predicates.size());
+        for (size_t i = 0; i < characteristic_set.predicates.size(); ++i) {
+            write_uint64(characteristic_set.predicates[i]);
+            write_uint64(characteristic_set.counts[i]);
+        }
+    }
+
+    write_sketch_map(predicate2distinct_subjects);
+    write_sketch_map(predicate2distinct_objects);
+
+    for (auto& histograms : predicate2histograms) {
+        write_histogram_map(histograms);
+    }
 }
 
 void RdfCatalog::print(std::ostream& os)
@@ -130,6 +185,7 @@ void RdfCatalog::print(std::ostream& os)
     os << "Catalog:\n";
     os << "  triples:                " << triples_count << "\n";
     os << "  distinct predicates:    " << predicate2total_count.size() << "\n";
+    os << "  characteristic sets:    " << characteristic_sets.size() << "\n";
 
     os << "  blank nodes count:      " << blank_node_count << "\n";
 
@@ -190,6 +246,8 @@ void RdfCatalog::insert_triple(uint64_t s, uint64_t p, uint64_t o)
     }
 
     predicate2total_count[p]++;
+    predicate2distinct_subjects[p].add(s);
+    predicate2distinct_objects[p].add(o);
     has_changes = true;
 }
 
@@ -221,3 +279,111 @@ void RdfCatalog::delete_triple(uint64_t s, uint64_t p, uint64_t o)
     }
     has_changes = true;
 }
+
+void RdfCatalog::index_characteristic_set(uint64_t position)
+{
+    const auto& characteristic_set = characteristic_sets[position];
+    predicates2characteristic_set.insert({ characteristic_set.predicates, position });
+    for (auto predicate : characteristic_set.predicates) {
+        predicate2characteristic_sets[predicate].push_back(position);
+    }
+}
+
+void RdfCatalog::set_characteristic_sets(std::vector<CharacteristicSet>&& sets)
+{
+    characteristic_sets = std::move(sets);
+    predicates2characteristic_set.clear();
+    predicate2characteristic_sets.clear();
+    for (uint64_t i = 0; i < characteristic_sets.size(); i++) {
+        index_characteristic_set(i);
+    }
+    has_changes = true;
+}
+
+void RdfCatalog::update_characteristic_set(
+    const std::vector<std::pair<uint64_t, uint64_t>>& old_predicates,
+    const std::vector<std::pair<uint64_t, uint64_t>>& new_predicates
+)
+{
+    std::vector<uint64_t> predicates;
+
+    if (!old_predicates.empty()) {
+        for (auto&& [predicate, count] : old_predicates) {
+            predicates.push_back(predicate);
+        }
+        auto it = predicates2characteristic_set.find(predicates);
+        if (it != predicates2characteristic_set.end()) {
+            auto& characteristic_set = characteristic_sets[it->second];
+            characteristic_set.subjects--;
+            for (size_t i = 0; i < old_predicates.size(); i++) {
+                characteristic_set.counts[i] -= std::min(characteristic_set.counts[i], old_predicates[i].second);
+            }
+        }
+    }
+
+    if (!new_predicates.empty()) {
+        predicates.clear();
+        for (auto&& [predicate, count] : new_predicates) {
+            predicates.push_back(predicate);
+        }
+        auto it = predicates2characteristic_set.find(predicates);
+        if (it != predicates2characteristic_set.end()) {
+            auto& characteristic_set = characteristic_sets[it->second];
+            characteristic_set.subjects++;
+            for (size_t i = 0; i < new_predicates.size(); i++) {
+                characteristic_set.counts[i] += new_predicates[i].second;
+            }
+        } else if (characteristic_sets.size() < MAX_CHARACTERISTIC_SETS) {
+            CharacteristicSet characteristic_set;
+            characteristic_set.predicates = std::move(predicates);
+            for (auto&& [predicate, count] : new_predicates) {
+                characteristic_set.counts.push_back(count);
+            }
+            characteristic_set.subjects = 1;
+            characteristic_sets.push_back(std::move(characteristic_set));
+            index_characteristic_set(characteristic_sets.size() - 1);
+        }
+    }
+    has_changes = true;
+}
+
+double RdfCatalog::estimate_star(const std::vector<uint64_t>& predicates) const
+{
+    if (predicates.empty()) {
+        return 0;
+    }
+
+    // only the sets of the less common predicate are visited
+    const std::vector<uint64_t>* candidates = nullptr;
+    for (auto predicate : predicates) {
+        auto it = predicate2characteristic_sets.find(predicate);
+        if (it == predicate2characteristic_sets.end()) {
+            return 0;
+        }
+        if (candidates == nullptr || it->second.size() < candidates->size()) {
+            candidates = &it->second;
+        }
+    }
+
+    // each subject of a set has in average counts[i] / subjects triples with
+    // the predicate i, the star returns their product for each subject
+    double res = 0;
+    for (auto position : *candidates) {
+        const auto& characteristic_set = characteristic_sets[position];
+        if (characteristic_set.subjects == 0) {
+            continue;
+        }
+        const auto& set_predicates = characteristic_set.predicates;
+        if (!std::includes(set_predicates.begin(), set_predicates.end(), predicates.begin(), predicates.end())) {
+            continue;
+        }
+        const double subjects = characteristic_set.subjects;
+        double set_results = subjects;
+        for (auto predicate : predicates) {
+            auto i = std::lower_bound(set_predicates.begin(), set_predicates.end(), predicate) - set_predicates.begin();
+            set_results *= characteristic_set.counts[i] / subjects;
+        }
+        res += set_results;
+    }
+    return res;
+}
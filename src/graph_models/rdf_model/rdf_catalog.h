@@ -1,9 +1,13 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <ostream>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "graph_models/rdf_model/characteristic_set.h"
 #include "graph_models/rdf_model/iri_prefixes.h"
 #include "storage/catalog/catalog.h"
 #include "storage/index/hnsw/hnsw_index_manager.h"
@@ -13,13 +17,17 @@ class RdfCatalog : public Catalog {
 public:
     static constexpr uint8_t MODEL_ID = 1;
 
-    static constexpr uint8_t MAJOR_VERSION = 1;
-    static constexpr uint8_t MINOR_VERSION = 0;
+    static constexpr uint8_t MAJOR_VERSION = 2;
+    static constexpr uint8_t MINOR_VERSION = 3;
 
     // The database can handle more than MAX_LANG_AND_DTT languages and datatypes,
     // but the catalog can save up to this this many
     static constexpr uint64_t MAX_LANG_AND_DTT = 4095;
 
+    // Only the characteristic sets with more subjects are kept, subjects
+    // with other sets of predicates are not considered in the estimations
+    static constexpr uint64_t MAX_CHARACTERISTIC_SETS = 10'000;
+
     // Constructor for existing catalog
     RdfCatalog(const std::string& filename);
 
@@ -57,6 +65,11 @@ public:
         equal_po_count = count;
     }
 
+    inline void set_permutations(uint64_t new_permutations) {
+        permutations = new_permutations;
+        has_changes = true;
+    }
+
     inline void set_blank_node_count(uint64_t count) {
         blank_node_count = count;
     }
@@ -65,6 +78,43 @@ public:
         predicate2total_count = std::move(predicate_stats);
     }
 
+    void set_predicate_sketches(
+        boost::unordered_flat_map<uint64_t, HyperLogLog>&& subject_sketches,
+        boost::unordered_flat_map<uint64_t, HyperLogLog>&& object_sketches
+    ) {
+        predicate2distinct_subjects = std::move(subject_sketches);
+        predicate2distinct_objects = std::move(object_sketches);
+    }
+
+    // estimated number of distinct subjects of the triples with the predicate
+    double get_distinct_subjects(uint64_t predicate_id) const {
+        auto it = predicate2distinct_subjects.find(predicate_id);
+        return it != predicate2distinct_subjects.end() ? it->second.estimate() : 0;
+    }
+
+    // estimated number of distinct objects of the triples with the predicate
+    double get_distinct_objects(uint64_t predicate_id) const {
+        auto it = predicate2distinct_objects.find(predicate_id);
+        return it != predicate2distinct_objects.end() ? it->second.estimate() : 0;
+    }
+
+    // histograms[kind] has the histogram of the objects of each predicate with
+    // values of that kind (see ValueHistogram::Kind)
+    void set_predicate_histograms(
+        std::array<boost::unordered_flat_map<uint64_t, ValueHistogram>, ValueHistogram::KINDS>&& histograms
+    ) {
+        predicate2histograms = std::move(histograms);
+    }
+
+    // histogram of the objects of the predicate with values of the kind, nullptr if
+    // the predicate had no such objects. The histograms are built by the import and
+    // are not changed by updates
+    const ValueHistogram* get_predicate_histogram(uint64_t predicate_id, ValueHistogram::Kind kind) const {
+        const auto& histograms = predicate2histograms[static_cast<size_t>(kind)];
+        auto it = histograms.find(predicate_id);
+        return it != histograms.end() ? &it->second : nullptr;
+    }
+
     uint64_t get_predicate_count(uint64_t predicate_id) const {
         auto it = predicate2total_count.find(predicate_id);
         if (it != predicate2total_count.end()) {
@@ -74,6 +124,20 @@ public:
         }
     }
 
+    void set_characteristic_sets(std::vector<CharacteristicSet>&& sets);
+
+    // Moves a subject from the characteristic set of `old_predicates` to the one of
+    // `new_predicates`, both are sorted lists of (predicate, triples of the subject
+    // with the predicate). An empty list means the subject had or has no triples.
+    void update_characteristic_set(
+        const std::vector<std::pair<uint64_t, uint64_t>>& old_predicates,
+        const std::vector<std::pair<uint64_t, uint64_t>>& new_predicates
+    );
+
+    // Estimates the results of a star join of the triples of a subject with each
+    // one of `predicates` (sorted and without duplicates)
+    double estimate_star(const std::vector<uint64_t>& predicates) const;
+
     uint64_t get_new_blank_node() {
         return blank_node_count++;
     }
@@ -107,4 +171,20 @@ private:
     uint64_t equal_po_count;
 
     boost::unordered_flat_map<uint64_t, uint64_t> predicate2total_count;
+
+    boost::unordered_flat_map<uint64_t, HyperLogLog> predicate2distinct_subjects;
+    boost::unordered_flat_map<uint64_t, HyperLogLog> predicate2distinct_objects;
+
+    std::array<boost::unordered_flat_map<uint64_t, ValueHistogram>, ValueHistogram::KINDS> predicate2histograms;
+
+    // sets without subjects are kept until the catalog is saved
+    std::vector<CharacteristicSet> characteristic_sets;
+
+    // position of each set in characteristic_sets
+    boost::unordered_flat_map<std::vector<uint64_t>, uint64_t> predicates2characteristic_set;
+
+    // positions of the sets with each predicate
+    boost::unordered_flat_map<uint64_t, std::vector<uint64_t>> predicate2characteristic_sets;
+
+    void index_characteristic_set(uint64_t position);
 };
@@ -1,9 +1,15 @@
 #include "rdf_model.h"
 
+#include <cmath>
+#include <cstdio>
 #include <type_traits>
 
 #include "graph_models/rdf_model/conversions.h"
+#include "import/disk_vector.h"
+#include "macros/aligned_alloc.h"
+#include "query/query_context.h"
 #include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/file_manager.h"
 
 using namespace std;
 
@@ -19,7 +25,8 @@ std::unique_ptr<ModelDestroyer> RdfModel::init()
 }
 
 RdfModel::RdfModel() :
-    catalog("catalog.dat")
+    catalog("catalog.dat"),
+    cardinality_feedback("cardinality_feedback.dat")
 {
     QueryContext::_debug_print = SPARQL::Conversions::debug_print;
 
@@ -28,12 +35,12 @@ RdfModel::RdfModel() :
     osp = make_unique<BPlusTree<3>>("osp");
 
     if (catalog.permutations >= 4) {
-        pso = make_unique<BPlusTree<3>>("pso");
+        pso.publish(make_unique<BPlusTree<3>>("pso"), 0);
     }
 
     if (catalog.permutations == 6) {
-        sop = make_unique<BPlusTree<3>>("sop");
-        ops = make_unique<BPlusTree<3>>("ops");
+        sop.publish(make_unique<BPlusTree<3>>("sop"), 0);
+        ops.publish(make_unique<BPlusTree<3>>("ops"), 0);
     }
 
     equal_spo = make_unique<BPlusTree<1>>("equal_spo");
@@ -45,3 +52,147 @@ RdfModel::RdfModel() :
     equal_so_inverted = make_unique<BPlusTree<2>>("equal_so_inverted");
     equal_po_inverted = make_unique<BPlusTree<2>>("equal_po_inverted");
 }
+
+BPlusTree<3>* RdfModel::OptionalPermutation::get() const
+{
+    if (get_query_ctx().result_version < version.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return bpt.get();
+}
+
+void RdfModel::OptionalPermutation::publish(std::unique_ptr<BPlusTree<3>> new_bpt, uint64_t new_version)
+{
+    bpt = std::move(new_bpt);
+    version.store(new_version, std::memory_order_release);
+}
+
+std::vector<std::string> RdfModel::create_permutation(const std::string& permutation)
+{
+    constexpr uint64_t COL_SUBJ = 0, COL_PRED = 1, COL_OBJ = 2;
+
+    struct PermutationToBuild {
+        std::string name;
+        std::array<uint64_t, 3> columns;
+        OptionalPermutation& permutation;
+    };
+    std::vector<PermutationToBuild> to_build;
+
+    // updates are executed one at a time, so only this thread modifies the permutations
+    uint64_t new_permutations = permutation == "pso" ? 4 : 6;
+    if (pso.bpt == nullptr) {
+        to_build.push_back({ "pso", { COL_PRED, COL_SUBJ, COL_OBJ }, pso });
+    }
+    if (new_permutations == 6 && sop.bpt == nullptr) {
+        to_build.push_back({ "sop", { COL_SUBJ, COL_OBJ, COL_PRED }, sop });
+    }
+    if (new_permutations == 6 && ops.bpt == nullptr) {
+        to_build.push_back({ "ops", { COL_OBJ, COL_PRED, COL_SUBJ }, ops });
+    }
+
+    std::vector<std::string> created;
+    if (to_build.empty()) {
+        return created;
+    }
+
+    // frees the sort buffer and removes the temporary file, and also the
+    // files of the B+trees if the build does not finish
+    struct BuildCleanup {
+        // the temporary file first
+        std::vector<std::string> files;
+        char* buffer = nullptr;
+        bool finished = false;
+
+        ~BuildCleanup()
+        {
+            if (buffer != nullptr) {
+                MDB_ALIGNED_FREE(buffer);
+            }
+            const auto files_to_remove = finished ? 1 : files.size();
+            for (size_t i = 0; i < files_to_remove; i++) {
+                std::remove(files[i].c_str());
+            }
+        }
+    } cleanup;
+
+    const auto tmp_file = file_manager.get_file_path("tmp_permutation_triples");
+    cleanup.files.push_back(tmp_file);
+    for (auto& permutation_to_build : to_build) {
+        cleanup.files.push_back(file_manager.get_file_path(permutation_to_build.name) + ".dir");
+        cleanup.files.push_back(file_manager.get_file_path(permutation_to_build.name) + ".leaf");
+        cleanup.files.push_back(file_manager.get_file_path(permutation_to_build.name) + ".bloom");
+    }
+
+    // copy spo into a DiskVector, the records are already in (subject, predicate, object) order
+    Import::DiskVector<3> triples(tmp_file);
+    bool interruption_requested = false;
+    try {
+        auto it = spo->get_range(&interruption_requested, { 0, 0, 0 }, { UINT64_MAX, UINT64_MAX, UINT64_MAX });
+        for (auto record = it.next(); record != nullptr; record = it.next()) {
+            triples.push_back({ (*record)[0], (*record)[1], (*record)[2] });
+        }
+        triples.finish_appends();
+    } catch (...) {
+        triples.skip_indexing();
+        throw;
+    }
+
+    // DiskVector sorts with a single merge, so the buffer must hold a block of each run
+    constexpr uint64_t block_size = VPage::SIZE * 3 * sizeof(uint64_t);
+    const uint64_t file_size = triples.get_total_tuples() * 3 * sizeof(uint64_t);
+    uint64_t buffer_size = 2 * static_cast<uint64_t>(std::sqrt(static_cast<double>(file_size) * block_size))
+                         + 2 * block_size;
+    buffer_size = std::max(buffer_size, PERMUTATION_BUILD_BUFFER_SIZE);
+    buffer_size = ((buffer_size + block_size - 1) / block_size) * block_size;
+
+    cleanup.buffer = reinterpret_cast<char*>(MDB_ALIGNED_ALLOC(buffer_size));
+    if (cleanup.buffer == nullptr) {
+        triples.skip_indexing();
+        throw std::runtime_error("Could not allocate the buffer to build the permutation");
+    }
+    triples.start_indexing(cleanup.buffer, buffer_size, { COL_SUBJ, COL_PRED, COL_OBJ });
+
+    for (auto& permutation_to_build : to_build) {
+        Import::NoStat<3> no_stat;
+        auto columns = permutation_to_build.columns;
+        triples.create_bpt(
+            file_manager.get_file_path(permutation_to_build.name),
+            std::move(columns),
+            no_stat
+        );
+    }
+    triples.finish_indexing();
+
+    std::vector<std::unique_ptr<BPlusTree<3>>> new_bpts;
+    for (auto& permutation_to_build : to_build) {
+        new_bpts.push_back(make_unique<BPlusTree<3>>(permutation_to_build.name));
+    }
+    cleanup.finished = true;
+
+    // the B+trees are published after every file is written, queries that
+    // started before this update keep using the permutations they had
+    const auto version = get_query_ctx().result_version;
+    for (size_t i = 0; i < to_build.size(); i++) {
+        to_build[i].permutation.publish(std::move(new_bpts[i]), version);
+        created.push_back(to_build[i].name);
+    }
+    // the catalog is only read when the database is loaded and saved
+    catalog.set_permutations(new_permutations);
+    return created;
+}
+
+BPlusTreeCompaction RdfModel::compact_permutation(const std::string& permutation)
+{
+    BPlusTree<3>* bpt = nullptr;
+    if      (permutation == "spo") bpt = spo.get();
+    else if (permutation == "pos") bpt = pos.get();
+    else if (permutation == "osp") bpt = osp.get();
+    else if (permutation == "pso") bpt = pso.get();
+    else if (permutation == "sop") bpt = sop.get();
+    else if (permutation == "ops") bpt = ops.get();
+
+    if (bpt == nullptr) {
+        throw std::runtime_error("Permutation \"" + permutation + "\" does not exist");
+    }
+    return bpt->compact(get_query_ctx().get_buffer1(), QueryContext::buffer_size);
+}
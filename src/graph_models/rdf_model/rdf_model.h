@@ -1,14 +1,19 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include "graph_models/model_destroyer.h"
 #include "graph_models/rdf_model/rdf_catalog.h"
+#include "query/cardinality_feedback.h"
 #include "query/parser/grammar/sparql/mdb_extensions.h"
 #include "query/parser/op/sparql/op.h"
 #include "query/parser/paths/regular_path_expr.h"
 
 template <std::size_t N> class BPlusTree;
+struct BPlusTreeCompaction;
 
 class SparqlElement;
 
@@ -17,10 +22,6 @@ public:
     std::unique_ptr<BPlusTree<3>> spo; // (subject,    predicate, object)
     std::unique_ptr<BPlusTree<3>> pos; // (predicate, object,     subject)
     std::unique_ptr<BPlusTree<3>> osp; // (object,    subject,    predicate)
-    std::unique_ptr<BPlusTree<3>> pso; // (predicate, subject,    object)
-
-    std::unique_ptr<BPlusTree<3>> sop;
-    std::unique_ptr<BPlusTree<3>> ops;
 
     // Special cases
     std::unique_ptr<BPlusTree<1>> equal_spo; // (subject=predicate=object)
@@ -34,8 +35,17 @@ public:
 
     RdfCatalog catalog;
 
+    // rows observed when executing triple patterns, used by the optimizer
+    CardinalityFeedback cardinality_feedback;
+
     uint64_t MAX_LIMIT = SPARQL::Op::DEFAULT_LIMIT;
 
+    // maximum number of threads used to evaluate a single query
+    uint_fast32_t MAX_PARALLELISM = 1;
+
+    // minimum size of the sort buffer used by create_permutation
+    static constexpr uint64_t PERMUTATION_BUILD_BUFFER_SIZE = 1024ULL * 1024 * 256; // 256 MB
+
     // Path mode to use
     PathSearchMode path_mode = PathSearchMode::BFS;
 
@@ -88,10 +98,48 @@ public:
         "https://www.",
     };
 
+    // Optional permutations, nullptr if they don't exist or if they were
+    // created by an update that finished after the current query started
+    BPlusTree<3>* get_pso() const { return pso.get(); } // (predicate, subject,   object)
+    BPlusTree<3>* get_sop() const { return sop.get(); } // (subject,   object,    predicate)
+    BPlusTree<3>* get_ops() const { return ops.get(); } // (object,    predicate, subject)
+
     // necessary to be called before first usage
     static std::unique_ptr<ModelDestroyer> init();
 
+    // Builds the missing B+trees needed to have `permutation` (pso, sop or ops),
+    // reading the triples from spo and using the import bulk builder, and registers
+    // them in the catalog. Must be called by an update, the B+trees are published
+    // with its version: the update and the queries that start after it can use them.
+    // As the catalog only knows 3, 4 or 6 permutations, building sop or ops also
+    // builds pso if it is missing. Returns the names of the permutations created.
+    std::vector<std::string> create_permutation(const std::string& permutation);
+
+    // Compacts the B+tree of an existing triple permutation (see BPlusTree::compact).
+    // Throws if the permutation does not exist.
+    BPlusTreeCompaction compact_permutation(const std::string& permutation);
+
 private:
+    // A permutation that may be created by an update while other queries are
+    // running. The files of a new B+tree are written outside the buffer manager,
+    // so queries with a version older than the one that created it must not
+    // read it. `version` is stored after `bpt` is set, queries load it first.
+    struct OptionalPermutation {
+        std::unique_ptr<BPlusTree<3>> bpt;
+
+        // version of the update that created the B+tree, UINT64_MAX if it doesn't exist
+        std::atomic<uint64_t> version { UINT64_MAX };
+
+        // the B+tree if the current query can use it
+        BPlusTree<3>* get() const;
+
+        void publish(std::unique_ptr<BPlusTree<3>> new_bpt, uint64_t new_version);
+    };
+
+    OptionalPermutation pso;
+    OptionalPermutation sop;
+    OptionalPermutation ops;
+
     RdfModel();
 };
 
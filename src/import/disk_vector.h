@@ -143,9 +143,11 @@ private:
     void merge_sort(const std::string& base_name, StatsProcessor<N>& stat_processor) {
         BPTLeafWriter<N> leaf_writer(base_name + ".leaf");
         BPTDirWriter<N> dir_writer(base_name + ".dir");
+        BPTBloomWriter<N> bloom_writer(base_name + ".bloom");
 
         if (total_tuples == 0) {
             leaf_writer.make_empty();
+            bloom_writer.add_leaf(nullptr, 0);
             return;
         }
 
@@ -201,6 +203,8 @@ private:
                                               tuples_written,
                                               bitset,
                                               ++leaf_current_block);
+                    dir_writer.add_leaf(tuples_written);
+                    bloom_writer.add_leaf(ptr, tuples_written);
                 } else {
                     // last leaf
                     tuples_written = leaf_tuples;
@@ -208,6 +212,8 @@ private:
                                               tuples_written,
                                               bitset,
                                               0);
+                    dir_writer.add_leaf(tuples_written);
+                    bloom_writer.add_leaf(ptr, tuples_written);
                 }
 
 
@@ -350,6 +356,8 @@ private:
                                           output_block_curr - 1,
                                           bitset,
                                           next_bpt_block);
+                dir_writer.add_leaf(output_block_curr - 1);
+                bloom_writer.add_leaf(output_block, output_block_curr - 1);
 
 
                 output_block[0] = last_seen_record;
@@ -396,6 +404,8 @@ private:
             }
             write_to_buffer(output_block, bitset, output_block_curr);
             leaf_writer.process_block(compression_buffer, output_block_curr, bitset, 0);
+            dir_writer.add_leaf(output_block_curr);
+            bloom_writer.add_leaf(output_block, output_block_curr);
         }
 
         // delete aux arrays
@@ -552,6 +562,19 @@ private:
                     (*key_ptr)[2] = aux;
                 }
             }
+            else if (new_permutation[0] == current_permutation[0]
+                  && new_permutation[1] == current_permutation[2]
+                  && new_permutation[2] == current_permutation[1])
+            {
+                for (auto key_ptr = reinterpret_cast<std::array<uint64_t, N>*>(buffer);
+                     key_ptr < end_ptr;
+                     ++key_ptr)
+                {
+                    auto aux      = (*key_ptr)[1];
+                    (*key_ptr)[1] = (*key_ptr)[2];
+                    (*key_ptr)[2] = aux;
+                }
+            }
             else {
                 throw std::invalid_argument("Unsupported permutation");
             }
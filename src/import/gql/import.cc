@@ -1125,7 +1125,10 @@ void OnDiskImport::start_import(MDBIstream& in)
         NoStat<3> no_stat;
         PropStat prop_stat;
 
-        node_properties.create_bpt(db_folder + "/node_key_value", { COL_NODE, COL_KEY, COL_VAL }, no_stat);
+        // distinct values of each key
+        KeySketchStat<3> sketch_stat(COL_KEY, { COL_VAL });
+        node_properties.create_bpt(db_folder + "/node_key_value", { COL_NODE, COL_KEY, COL_VAL }, sketch_stat);
+        catalog.node_key2distinct_values = std::move(sketch_stat.sketches[0]);
         node_properties.create_bpt(db_folder + "/key_value_node", { COL_KEY, COL_VAL, COL_NODE }, prop_stat);
 
         catalog.node_properties_count = prop_stat.all;
@@ -1140,7 +1143,10 @@ void OnDiskImport::start_import(MDBIstream& in)
         NoStat<3> no_stat;
         PropStat prop_stat;
 
-        edge_properties.create_bpt(db_folder + "/edge_key_value", { COL_EDGE, COL_KEY, COL_VAL }, no_stat);
+        // distinct values of each key
+        KeySketchStat<3> sketch_stat(COL_KEY, { COL_VAL });
+        edge_properties.create_bpt(db_folder + "/edge_key_value", { COL_EDGE, COL_KEY, COL_VAL }, sketch_stat);
+        catalog.edge_key2distinct_values = std::move(sketch_stat.sketches[0]);
         edge_properties.create_bpt(db_folder + "/key_value_edge", { COL_KEY, COL_VAL, COL_EDGE }, prop_stat);
 
         catalog.edge_properties_count = prop_stat.all;
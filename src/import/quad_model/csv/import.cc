@@ -264,7 +264,10 @@ void OnDiskImport::start_import(
         NoStat<3> no_stat;
         PropStat prop_stat;
 
-        properties.create_bpt(db_folder + "/object_key_value", { C_OBJ, C_KEY, C_VALUE }, no_stat);
+        // distinct values of each key
+        KeySketchStat<3> sketch_stat(C_KEY, { C_VALUE });
+        properties.create_bpt(db_folder + "/object_key_value", { C_OBJ, C_KEY, C_VALUE }, sketch_stat);
+        catalog.key2distinct_values = std::move(sketch_stat.sketches[0]);
 
         properties.create_bpt(db_folder + "/key_value_object", { C_KEY, C_VALUE, C_OBJ }, prop_stat);
         catalog.properties_count = prop_stat.all;
@@ -282,7 +285,11 @@ void OnDiskImport::start_import(
 
         edges.create_bpt(db_folder + "/from_to_type_edge", { C_FROM, C_TO, C_TYPE, C_EDGE }, all_stat);
 
-        edges.create_bpt(db_folder + "/to_type_from_edge", { C_TO, C_TYPE, C_FROM, C_EDGE }, no_stat);
+        // distinct from and to of each type, the tuples are in to_type_from_edge order
+        KeySketchStat<4> sketch_stat(1, { 2, 0 });
+        edges.create_bpt(db_folder + "/to_type_from_edge", { C_TO, C_TYPE, C_FROM, C_EDGE }, sketch_stat);
+        catalog.type2distinct_from = std::move(sketch_stat.sketches[0]);
+        catalog.type2distinct_to = std::move(sketch_stat.sketches[1]);
 
         edges.create_bpt(db_folder + "/type_from_to_edge", { C_TYPE, C_FROM, C_TO, C_EDGE }, dict_count_stat);
 
@@ -424,17 +424,24 @@ exit_while:
     { // B+tree creation for triple
         size_t COL_SUBJ = 0, COL_PRED = 1, COL_OBJ = 2;
 
-        PredicateStat pred_stat;
+        PredicateHistogramStat pred_stat;
+        CharacteristicSetStat characteristic_set_stat;
         NoStat<3> no_stat;
 
-        triples.create_bpt(db_folder + "/spo", { COL_SUBJ, COL_PRED, COL_OBJ }, no_stat);
+        triples.create_bpt(db_folder + "/spo", { COL_SUBJ, COL_PRED, COL_OBJ }, characteristic_set_stat);
+        characteristic_set_stat.end(RdfCatalog::MAX_CHARACTERISTIC_SETS);
+        catalog.set_characteristic_sets(std::move(characteristic_set_stat.characteristic_sets));
 
         triples.create_bpt(db_folder + "/pos", { COL_PRED, COL_OBJ, COL_SUBJ }, pred_stat);
         pred_stat.end();
         catalog.set_triples_count(pred_stat.all_count);
         catalog.set_predicate_stats(std::move(pred_stat.map_predicate_count));
+        catalog.set_predicate_histograms(std::move(pred_stat.histograms));
 
-        triples.create_bpt(db_folder + "/osp", { COL_OBJ, COL_SUBJ, COL_PRED }, no_stat);
+        // distinct subjects and objects of each predicate
+        KeySketchStat<3> sketch_stat(2, { 1, 0 });
+        triples.create_bpt(db_folder + "/osp", { COL_OBJ, COL_SUBJ, COL_PRED }, sketch_stat);
+        catalog.set_predicate_sketches(std::move(sketch_stat.sketches[0]), std::move(sketch_stat.sketches[1]));
 
         if (index_permutations >= 4) {
             triples.create_bpt(db_folder + "/pso", { COL_PRED, COL_SUBJ, COL_OBJ }, no_stat);
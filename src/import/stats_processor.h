@@ -1,11 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstdlib>
+#include <random>
+#include <vector>
 
 #include <boost/unordered/unordered_flat_map.hpp>
 
+#include "graph_models/rdf_model/characteristic_set.h"
+#include "storage/catalog/hyper_log_log.h"
+#include "storage/catalog/value_histogram.h"
+
 namespace Import {
 template<size_t N>
 class StatsProcessor {
@@ -81,6 +88,42 @@ public:
     }
 };
 
+template<size_t N>
+class KeySketchStat : public StatsProcessor<N> {
+    // sketches the distinct values of each one of `value_columns` for each value
+    // of `key_column`, faster if the tuples are grouped by key_column
+public:
+    std::vector<boost::unordered_flat_map<uint64_t, HyperLogLog>> sketches;
+
+    KeySketchStat(size_t key_column, std::vector<size_t>&& value_columns) :
+        sketches      (value_columns.size()),
+        key_column    (key_column),
+        value_columns (std::move(value_columns)),
+        current       (this->value_columns.size(), nullptr) { }
+
+    void process_tuple(const std::array<uint64_t, N>& tuple) override
+    {
+        if (tuple[key_column] != current_key || current[0] == nullptr) {
+            current_key = tuple[key_column];
+            for (size_t i = 0; i < sketches.size(); i++) {
+                current[i] = &sketches[i][current_key];
+            }
+        }
+        for (size_t i = 0; i < sketches.size(); i++) {
+            current[i]->add(tuple[value_columns[i]]);
+        }
+    }
+
+private:
+    size_t key_column;
+    std::vector<size_t> value_columns;
+
+    uint64_t current_key = 0;
+
+    // sketches of current_key, valid until a new key is inserted
+    std::vector<HyperLogLog*> current;
+};
+
 class PropStat : public StatsProcessor<3> {
 public:
     uint64_t all = 0;
@@ -187,4 +230,132 @@ public:
     }
 };
 
+class PredicateHistogramStat : public PredicateStat {
+    // also builds the histograms of the inlined numeric and datetime objects of
+    // each predicate, assuming POS order. The histograms are built from a uniform
+    // sample of up to SAMPLE_SIZE values of each predicate
+public:
+    static constexpr size_t SAMPLE_SIZE = 16 * 1024;
+
+    std::array<boost::unordered_flat_map<uint64_t, ValueHistogram>, ValueHistogram::KINDS> histograms;
+
+    void process_tuple(const std::array<uint64_t, 3>& tuple) override
+    {
+        if (tuple[0] != current_predicate) {
+            save_histograms();
+        }
+        PredicateStat::process_tuple(tuple);
+
+        ValueHistogram::Kind kind;
+        double value;
+        if (!ValueHistogram::get_value(ObjectId(tuple[1]), &kind, &value)) {
+            return;
+        }
+        // reservoir sampling
+        auto& sample = samples[static_cast<size_t>(kind)];
+        sample.values_seen++;
+        if (sample.values.size() < SAMPLE_SIZE) {
+            sample.values.push_back(value);
+        } else {
+            auto position = random_generator() % sample.values_seen;
+            if (position < SAMPLE_SIZE) {
+                sample.values[position] = value;
+            }
+        }
+    }
+
+    void end()
+    {
+        save_histograms();
+        PredicateStat::end();
+    }
+
+private:
+    struct Sample {
+        std::vector<double> values;
+        uint64_t values_seen = 0;
+    };
+
+    // samples of the values of current_predicate of each kind
+    std::array<Sample, ValueHistogram::KINDS> samples;
+
+    // fixed seed, so the same data gives the same histograms
+    std::mt19937_64 random_generator { 0 };
+
+    void save_histograms()
+    {
+        for (size_t kind = 0; kind < ValueHistogram::KINDS; kind++) {
+            auto& sample = samples[kind];
+            if (sample.values_seen == 0) {
+                continue;
+            }
+            std::sort(sample.values.begin(), sample.values.end());
+            histograms[kind].insert({ current_predicate, ValueHistogram(sample.values, sample.values_seen) });
+            sample.values.clear();
+            sample.values_seen = 0;
+        }
+    }
+};
+
+class CharacteristicSetStat : public StatsProcessor<3> {
+    // groups the subjects by their set of predicates, assuming SPO order
+public:
+    std::vector<CharacteristicSet> characteristic_sets;
+
+    void process_tuple(const std::array<uint64_t, 3>& tuple) override
+    {
+        if (tuple[0] != current_subject || current_predicates.empty()) {
+            save_subject();
+            current_subject = tuple[0];
+        }
+        if (current_predicates.empty() || current_predicates.back() != tuple[1]) {
+            current_predicates.push_back(tuple[1]);
+            current_counts.push_back(1);
+        } else {
+            ++current_counts.back();
+        }
+    }
+
+    // keeps only the `max_sets` sets with more subjects
+    void end(size_t max_sets)
+    {
+        save_subject();
+        if (characteristic_sets.size() > max_sets) {
+            std::nth_element(
+                characteristic_sets.begin(),
+                characteristic_sets.begin() + max_sets,
+                characteristic_sets.end(),
+                [](const CharacteristicSet& a, const CharacteristicSet& b) { return a.subjects > b.subjects; }
+            );
+            characteristic_sets.resize(max_sets);
+        }
+    }
+
+private:
+    uint64_t current_subject = 0;
+    std::vector<uint64_t> current_predicates;
+    std::vector<uint64_t> current_counts;
+
+    boost::unordered_flat_map<std::vector<uint64_t>, size_t> predicates2index;
+
+    void save_subject()
+    {
+        if (current_predicates.empty()) {
+            return;
+        }
+        auto inserted = predicates2index.insert({ current_predicates, characteristic_sets.size() });
+        if (inserted.second) {
+            characteristic_sets.push_back({ current_predicates, current_counts, 1 });
+        } else {
+            auto& characteristic_set = characteristic_sets[inserted.first->second];
+            for (size_t i = 0; i < current_counts.size(); i++) {
+                characteristic_set.counts[i] += current_counts[i];
+            }
+            ++characteristic_set.subjects;
+        }
+        current_predicates.clear();
+        current_counts.clear();
+    }
+};
+
 } // namespace Import
@@ -0,0 +1,11 @@
+#pragma once
+#ifdef _MSC_VER
+    #include <xmmintrin.h>
+#endif
+
+// hint to load the cache line of ptr for a read
+#ifdef _MSC_VER
+    #define MDB_PREFETCH(ptr) _mm_prefetch(reinterpret_cast<const char*>(ptr), _MM_HINT_T0)
+#else
+    #define MDB_PREFETCH(ptr) __builtin_prefetch((ptr), 0, 3)
+#endif
@@ -0,0 +1,138 @@
+#include "cardinality_feedback.h"
+
+#include <fstream>
+#include <stdexcept>
+
+#include "misc/logger.h"
+#include "system/file_manager.h"
+
+CardinalityFeedback::CardinalityFeedback(const std::string& filename) :
+    file_path (file_manager.get_file_path(filename))
+{
+    // the observations are only a hint for the optimizer, a file that can't
+    // be read is discarded
+    try {
+        load();
+    } catch (const std::exception& e) {
+        logger(Category::Error) << "Failed to load cardinality feedback: " << e.what();
+        entries.clear();
+        signature2entry.clear();
+    }
+}
+
+CardinalityFeedback::~CardinalityFeedback()
+{
+    if (!has_changes) {
+        return;
+    }
+    try {
+        save();
+    } catch (const std::exception& e) {
+        logger(Category::Error) << "Failed to save cardinality feedback: " << e.what();
+    }
+}
+
+void CardinalityFeedback::record(const Signature& signature, double estimated_rows, double actual_rows)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    has_changes = true;
+
+    auto it = signature2entry.find(signature);
+    if (it != signature2entry.end()) {
+        auto& entry = *it->second;
+        entry.estimated_rows = estimated_rows;
+        entry.actual_rows += NEW_OBSERVATION_WEIGHT * (actual_rows - entry.actual_rows);
+        entry.observations++;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+
+    entries.push_front(Entry { signature, estimated_rows, actual_rows, 1 });
+    signature2entry.insert({ signature, entries.begin() });
+
+    if (entries.size() > MAX_ENTRIES) {
+        signature2entry.erase(entries.back().signature);
+        entries.pop_back();
+    }
+}
+
+std::optional<double> CardinalityFeedback::get_actual_rows(const Signature& signature) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = signature2entry.find(signature);
+    if (it == signature2entry.end()) {
+        return std::nullopt;
+    }
+    return it->second->actual_rows;
+}
+
+/*
+File layout:
+- 8 bytes: number of entries
+- for each entry, from the least recently observed:
+    - 8 bytes: size of the signature
+    - 8 bytes for each value of the signature
+    - 8 bytes: estimated rows (double)
+    - 8 bytes: actual rows (double)
+    - 8 bytes: observations
+*/
+void CardinalityFeedback::load()
+{
+    std::fstream ifs(file_path, std::ios::in | std::ios::binary);
+    if (!ifs.is_open()) {
+        return;
+    }
+
+    const auto read = [&ifs](void* dst, size_t size) {
+        ifs.read(reinterpret_cast<char*>(dst), size);
+        if (!ifs.good()) {
+            throw std::runtime_error("Could not read file");
+        }
+    };
+
+    uint64_t entries_size;
+    read(&entries_size, sizeof(entries_size));
+    for (uint64_t i = 0; i < entries_size && i < MAX_ENTRIES; i++) {
+        Entry entry;
+        uint64_t signature_size;
+        read(&signature_size, sizeof(signature_size));
+        if (signature_size > MAX_SIGNATURE_SIZE) {
+            throw std::runtime_error("Invalid signature size");
+        }
+        entry.signature.resize(signature_size);
+        read(entry.signature.data(), signature_size * sizeof(uint64_t));
+        read(&entry.estimated_rows, sizeof(entry.estimated_rows));
+        read(&entry.actual_rows, sizeof(entry.actual_rows));
+        read(&entry.observations, sizeof(entry.observations));
+
+        entries.push_front(std::move(entry));
+        signature2entry.insert({ entries.front().signature, entries.begin() });
+    }
+}
+
+void CardinalityFeedback::save()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::fstream ofs(file_path, std::ios::out | std::ios::trunc | std::ios::binary);
+
+    const auto write = [&ofs](const void* src, size_t size) {
+        ofs.write(reinterpret_cast<const char*>(src), size);
+        if (!ofs.good()) {
+            throw std::runtime_error("Could not write file");
+        }
+    };
+
+    const uint64_t entries_size = entries.size();
+    write(&entries_size, sizeof(entries_size));
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        const uint64_t signature_size = it->signature.size();
+        write(&signature_size, sizeof(signature_size));
+        write(it->signature.data(), signature_size * sizeof(uint64_t));
+        write(&it->estimated_rows, sizeof(it->estimated_rows));
+        write(&it->actual_rows, sizeof(it->actual_rows));
+        write(&it->observations, sizeof(it->observations));
+    }
+    has_changes = false;
+}
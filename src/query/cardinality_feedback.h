@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include "third_party/hashes/hash_function_wrapper.h"
+
+// Rows observed when executing plan fragments (e.g. a triple pattern with some
+// of its vars assigned), saved with the rows the optimizer estimated for them.
+// Fragments are identified by a signature that doesn't depend on the names of
+// the vars, so the same pattern in another query has the same signature. The
+// optimizers use the observed rows instead of their estimations, so queries
+// that are executed again converge to better plans.
+//
+// The store keeps the MAX_ENTRIES most recently observed fragments, and is
+// loaded from and saved to a file in the database folder.
+class CardinalityFeedback {
+public:
+    static constexpr uint64_t MAX_ENTRIES = 100'000;
+
+    // weight of a new observation in the average of the rows of a fragment,
+    // so the store follows the changes of the data
+    static constexpr double NEW_OBSERVATION_WEIGHT = 0.25;
+
+    static constexpr uint64_t MAX_SIGNATURE_SIZE = 64;
+
+    using Signature = std::vector<uint64_t>;
+
+    // A fragment of an executed plan, the executor calls record() after
+    // the fragment was evaluated
+    struct Fragment {
+        CardinalityFeedback* feedback;
+        Signature signature;
+        double estimated_rows;
+
+        // `executions` is the number of times the fragment was evaluated to the end
+        void record(uint64_t executions, uint64_t rows) const
+        {
+            if (executions > 0) {
+                feedback->record(signature, estimated_rows, static_cast<double>(rows) / executions);
+            }
+        }
+    };
+
+    // loads the file if it exists
+    CardinalityFeedback(const std::string& filename);
+
+    // saves the file if there are new observations
+    ~CardinalityFeedback();
+
+    // `estimated_rows` and `actual_rows` are for a single evaluation of the fragment
+    void record(const Signature& signature, double estimated_rows, double actual_rows);
+
+    // average rows of the executions of the fragment, nothing if it was not observed
+    std::optional<double> get_actual_rows(const Signature& signature) const;
+
+    void save();
+
+private:
+    struct Entry {
+        Signature signature;
+
+        // last estimation of the optimizer, without the feedback
+        double estimated_rows;
+
+        double actual_rows;
+
+        uint64_t observations;
+    };
+
+    struct SignatureHasher {
+        size_t operator()(const Signature& signature) const
+        {
+            return HashFunctionWrapper(signature.data(), signature.size() * sizeof(uint64_t));
+        }
+    };
+
+    std::string file_path;
+
+    mutable std::mutex mutex;
+
+    bool has_changes = false;
+
+    // the most recently observed entry is at the front
+    std::list<Entry> entries;
+
+    boost::unordered_flat_map<Signature, std::list<Entry>::iterator, SignatureHasher> signature2entry;
+
+    void load();
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "query/executor/binding.h"
+
+// Column-major buffer of results filled by BindingIter::next_batch.
+// column(var)[row] is the value of var in the row. Only the columns of the
+// variables assigned by the producer are written, the other variables keep
+// the value they have in the parent binding while the batch is consumed.
+// The valid rows are selection[0], ..., selection[selected - 1], so an
+// operator can discard rows (e.g. Filter) without moving the columns.
+class BindingBatch {
+public:
+    static constexpr uint_fast32_t DEFAULT_CAPACITY = 1024;
+
+    BindingBatch(std::size_t binding_size, uint_fast32_t capacity = DEFAULT_CAPACITY) :
+        binding_size (binding_size),
+        capacity     (capacity),
+        max_size     (capacity),
+        selection    (capacity),
+        is_assigned  (binding_size, false),
+        data         (binding_size * capacity) { }
+
+    const std::size_t binding_size;
+
+    const uint_fast32_t capacity;
+
+    // producers write at most max_size rows. A consumer that doesn't need
+    // a full batch (e.g. Slice with a small limit) can lower it
+    uint_fast32_t max_size;
+
+    // number of rows written in the columns
+    uint_fast32_t size = 0;
+
+    std::vector<uint_fast32_t> selection;
+
+    uint_fast32_t selected = 0;
+
+    inline void clear() noexcept {
+        size = 0;
+        selected = 0;
+    }
+
+    inline void select_all() noexcept {
+        for (uint_fast32_t i = 0; i < size; i++) {
+            selection[i] = i;
+        }
+        selected = size;
+    }
+
+    inline const ObjectId* column(VarId var) const noexcept {
+        return data.data() + var.id * capacity;
+    }
+
+    // returns the column of var to be written, marking var as assigned by the batch
+    inline ObjectId* write_column(VarId var) {
+        if (!is_assigned[var.id]) {
+            is_assigned[var.id] = true;
+            assigned_vars.push_back(var);
+        }
+        return data.data() + var.id * capacity;
+    }
+
+    inline const std::vector<VarId>& get_assigned_vars() const noexcept {
+        return assigned_vars;
+    }
+
+    // writes the assigned variables of the row into the binding
+    inline void load_row(uint_fast32_t row, Binding& binding) const noexcept {
+        for (auto var : assigned_vars) {
+            binding.add(var, data[var.id * capacity + row]);
+        }
+    }
+
+    // appends a row with all the variables of the binding, used by the row adapter
+    inline void push_row(const Binding& binding) {
+        if (assigned_vars.size() != binding_size) {
+            for (uint_fast32_t i = 0; i < binding_size; i++) {
+                write_column(VarId(i));
+            }
+        }
+        for (uint_fast32_t i = 0; i < binding_size; i++) {
+            data[i * capacity + size] = binding[VarId(i)];
+        }
+        size++;
+    }
+
+private:
+    std::vector<bool> is_assigned;
+
+    std::vector<VarId> assigned_vars;
+
+    std::vector<ObjectId> data;
+};
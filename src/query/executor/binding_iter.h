@@ -4,6 +4,8 @@
 
 #include "query/query_context.h" // IWYU pragma: export
 #include "query/executor/binding.h"
+#include "query/executor/binding_batch.h"
+#include "query/executor/runtime_filter.h"
 
 // Abstract class
 class BindingIter {
@@ -12,6 +14,18 @@ protected:
     virtual bool _next() = 0;
     virtual void _reset() = 0;
 
+    // Row adapter used by the iters without a native batch implementation:
+    // calls _next() until the batch is full, copying the whole parent binding
+    virtual uint_fast32_t _next_batch(BindingBatch& batch)
+    {
+        batch.clear();
+        while (batch.size < batch.max_size && _next()) {
+            batch.push_row(*row_adapter_binding);
+        }
+        batch.select_all();
+        return batch.size;
+    }
+
 public:
     uint64_t stat_begin = 0;
     uint64_t stat_next = 0;
@@ -27,6 +41,7 @@ public:
     inline void begin(Binding& parent_binding)
     {
         stat_begin++;
+        row_adapter_binding = &parent_binding;
         _begin(parent_binding);
     }
 
@@ -49,6 +64,20 @@ public:
         return result;
     }
 
+    // Writes the following results in the batch and returns the number of rows
+    // selected, 0 means there are no more results. A result only has the variables
+    // assigned by the batch, the rest are the ones in the parent_binding.
+    // The parent_binding may be modified. next() and next_batch() must not be
+    // mixed between a begin() or reset() and the end of the results.
+    inline uint_fast32_t next_batch(BindingBatch& batch)
+    {
+        stat_next++;
+
+        auto result = _next_batch(batch);
+        results += result;
+        return result;
+    }
+
     void print_generic_stats(std::ostream& os, int indent) const
     {
         os << std::string(indent, ' ') << "[begin: " << stat_begin << " next: " << stat_next
@@ -58,5 +87,18 @@ public:
     // Every var that the iter sets in the binding when next() returns true is set to null
     virtual void assign_nulls() = 0;
 
+    // Called by a join before begin() with a filter of the values of filter.var
+    // that can have a match. The iter may use it to skip results whose value
+    // of filter.var is rejected, the filter is updated by the join before each
+    // begin() or reset(). Returns true if the iter or one of its children uses it
+    virtual bool push_runtime_filter(const RuntimeFilter& /*filter*/)
+    {
+        return false;
+    }
+
     virtual void print(std::ostream& os, int indent, bool stats) const = 0;
+
+private:
+    // the binding received in begin(), needed by the row adapter
+    Binding* row_adapter_binding = nullptr;
 };
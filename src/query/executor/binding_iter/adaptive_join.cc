@@ -0,0 +1,205 @@
+#include "adaptive_join.h"
+
+#include <algorithm>
+
+AdaptiveJoin::AdaptiveJoin(
+    std::unique_ptr<BindingIter> lhs,
+    std::unique_ptr<BindingIter> rhs,
+    std::unique_ptr<BindingIter> scan_rhs,
+    std::vector<VarId>&&         join_vars,
+    std::vector<VarId>&&         rhs_only_vars,
+    double                       estimated_lhs_rows,
+    double                       estimated_scan_rows
+) :
+    lhs           (std::move(lhs)),
+    rhs           (std::move(rhs)),
+    scan_rhs      (std::move(scan_rhs)),
+    join_vars     (std::move(join_vars)),
+    rhs_only_vars (std::move(rhs_only_vars)),
+    switch_rows   (static_cast<uint64_t>(std::min(
+                       std::max({ static_cast<double>(MIN_SWITCH_ROWS),
+                                  estimated_lhs_rows * ESTIMATION_ERROR_FACTOR,
+                                  estimated_scan_rows / ROWS_PER_SEARCH }),
+                       static_cast<double>(UINT64_MAX / 2)))),
+    key_buf       (this->join_vars.size(), ObjectId::get_null()),
+    sorted_lhs    (*this->rhs) { }
+
+void AdaptiveJoin::_begin(Binding& _parent_binding)
+{
+    this->parent_binding = &_parent_binding;
+
+    lhs_rows = 0;
+    rhs_begun = false;
+    scan_rhs_begun = false;
+    hash_mode = false;
+    switch_failed = false;
+
+    lhs->begin(_parent_binding);
+    sorted_lhs.reset();
+    lhs_exhausted = !sorted_lhs.enabled() && !next_lhs();
+}
+
+void AdaptiveJoin::_reset()
+{
+    // the table depends on the input vars, so it is built again if needed
+    lhs_rows = 0;
+    hash_mode = false;
+    switch_failed = false;
+    clear_hash_table();
+
+    lhs->reset();
+    sorted_lhs.reset();
+    lhs_exhausted = !sorted_lhs.enabled() && !next_lhs();
+}
+
+bool AdaptiveJoin::next_lhs()
+{
+    if (!lhs->next()) {
+        return false;
+    }
+    start_row();
+    return true;
+}
+
+void AdaptiveJoin::start_row()
+{
+    lhs_rows++;
+    if (lhs_rows == switch_rows && !hash_mode && !switch_failed) {
+        try_switch();
+    }
+
+    if (hash_mode) {
+        for (size_t i = 0; i < join_vars.size(); i++) {
+            key_buf[i] = (*parent_binding)[join_vars[i]];
+        }
+        auto it = hash_table.find(key_buf);
+        current_row = it == hash_table.end() ? NO_ROW : it->second.first;
+    } else if (rhs_begun) {
+        rhs->reset();
+    } else {
+        rhs->begin(*parent_binding);
+        rhs_begun = true;
+    }
+}
+
+bool AdaptiveJoin::next_row_result()
+{
+    if (!hash_mode) {
+        return rhs->next();
+    }
+    if (current_row == NO_ROW) {
+        return false;
+    }
+    auto values = &build_values[current_row * rhs_only_vars.size()];
+    for (size_t i = 0; i < rhs_only_vars.size(); i++) {
+        parent_binding->add(rhs_only_vars[i], values[i]);
+    }
+    current_row = next_rows[current_row];
+    return true;
+}
+
+bool AdaptiveJoin::_next()
+{
+    if (sorted_lhs.enabled()) {
+        return sorted_lhs.next(
+            *lhs,
+            *parent_binding,
+            [this]() { start_row(); },
+            [this]() { return next_row_result(); }
+        );
+    }
+
+    if (lhs_exhausted) {
+        return false;
+    }
+    while (true) {
+        if (next_row_result()) {
+            return true;
+        }
+        if (!next_lhs()) {
+            lhs_exhausted = true;
+            return false;
+        }
+    }
+}
+
+void AdaptiveJoin::try_switch()
+{
+    // scan_rhs assigns the join vars, the values of the current lhs row
+    // are restored after the build
+    std::vector<ObjectId> lhs_values(join_vars.size());
+    for (size_t i = 0; i < join_vars.size(); i++) {
+        lhs_values[i] = (*parent_binding)[join_vars[i]];
+    }
+
+    clear_hash_table();
+    if (scan_rhs_begun) {
+        scan_rhs->reset();
+    } else {
+        scan_rhs->begin(*parent_binding);
+        scan_rhs_begun = true;
+    }
+
+    build_rows = 0;
+    while (scan_rhs->next()) {
+        if (build_rows == MAX_BUILD_ROWS) {
+            clear_hash_table();
+            switch_failed = true;
+            break;
+        }
+        for (size_t i = 0; i < join_vars.size(); i++) {
+            key_buf[i] = (*parent_binding)[join_vars[i]];
+        }
+        for (auto var : rhs_only_vars) {
+            build_values.push_back((*parent_binding)[var]);
+        }
+        // the row is appended to the list of its key
+        auto inserted = hash_table.insert({ key_buf, { build_rows, build_rows } });
+        if (!inserted.second) {
+            next_rows[inserted.first->second.second] = build_rows;
+            inserted.first->second.second = build_rows;
+        }
+        next_rows.push_back(NO_ROW);
+        build_rows++;
+    }
+
+    for (size_t i = 0; i < join_vars.size(); i++) {
+        parent_binding->add(join_vars[i], lhs_values[i]);
+    }
+    hash_mode = !switch_failed;
+}
+
+void AdaptiveJoin::clear_hash_table()
+{
+    hash_table.clear();
+    build_values.clear();
+    next_rows.clear();
+}
+
+void AdaptiveJoin::assign_nulls()
+{
+    lhs->assign_nulls();
+    rhs->assign_nulls();
+}
+
+void AdaptiveJoin::print(std::ostream& os, int indent, bool stats) const
+{
+    if (stats) {
+        print_generic_stats(os, indent);
+    }
+    os << std::string(indent, ' ') << "AdaptiveJoin(switch_rows: " << switch_rows;
+    if (stats) {
+        os << " lhs_rows: " << lhs_rows;
+        if (hash_mode) {
+            os << " switched to hash join, build_rows: " << build_rows;
+        } else if (switch_failed) {
+            os << " too many build rows, kept nested loop";
+        }
+    }
+    os << ")\n";
+    lhs->print(os, indent + 2, stats);
+    rhs->print(os, indent + 2, stats);
+    if (hash_mode) {
+        scan_rhs->print(os, indent + 2, stats);
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include "query/executor/binding_iter.h"
+#include "query/executor/binding_iter/sorted_probe_buffer.h"
+#include "third_party/hashes/hash_function_wrapper.h"
+
+// Join that starts as an IndexNestedLoopJoin and switches to a hash join if
+// lhs has many more rows than the optimizer estimated.
+//
+// `rhs` is evaluated for each row of lhs, using the variables of lhs as
+// input. `scan_rhs` is the same relation without those input variables.
+// When lhs reaches `switch_rows` rows, scan_rhs is read once into a hash
+// table by `join_vars` and the following rows of lhs are probed there instead
+// of searching the index. The rows already returned are kept, so the query
+// continues where it was. If scan_rhs has more than MAX_BUILD_ROWS rows the
+// table is discarded and the nested loop goes on.
+// As in IndexNestedLoopJoin, the rows of lhs are probed sorted by the input
+// vars of rhs and the results are returned in the order of lhs.
+class AdaptiveJoin : public BindingIter {
+public:
+    // lhs rows before switching, at least
+    static constexpr uint64_t MIN_SWITCH_ROWS = 10'000;
+
+    // lhs rows must exceed the estimation by this factor to switch
+    static constexpr double ESTIMATION_ERROR_FACTOR = 100;
+
+    // rows of scan_rhs whose scan costs about the same as an index search
+    static constexpr double ROWS_PER_SEARCH = 64;
+
+    static constexpr uint64_t MAX_BUILD_ROWS = 4 * 1024 * 1024;
+
+    AdaptiveJoin(
+        std::unique_ptr<BindingIter> lhs,
+        std::unique_ptr<BindingIter> rhs,
+        std::unique_ptr<BindingIter> scan_rhs,
+        std::vector<VarId>&&         join_vars,
+        std::vector<VarId>&&         rhs_only_vars,
+        double                       estimated_lhs_rows,
+        double                       estimated_scan_rows
+    );
+
+    void print(std::ostream& os, int indent, bool stats) const override;
+
+    void _begin(Binding& parent_binding) override;
+    bool _next() override;
+    void _reset() override;
+    void assign_nulls() override;
+
+    std::unique_ptr<BindingIter> lhs;
+    std::unique_ptr<BindingIter> rhs;
+    std::unique_ptr<BindingIter> scan_rhs;
+
+    // statistics
+    uint64_t lhs_rows = 0;
+    uint64_t build_rows = 0;
+
+private:
+    static constexpr uint64_t NO_ROW = UINT64_MAX;
+
+    struct KeyHasher {
+        size_t operator()(const std::vector<ObjectId>& key) const
+        {
+            return HashFunctionWrapper(key.data(), key.size() * sizeof(ObjectId));
+        }
+    };
+
+    const std::vector<VarId> join_vars;
+    const std::vector<VarId> rhs_only_vars;
+
+    // lhs rows that trigger the switch
+    const uint64_t switch_rows;
+
+    Binding* parent_binding;
+
+    bool rhs_begun;
+    bool scan_rhs_begun;
+    bool lhs_exhausted;
+
+    // true after the switch, rhs is no longer used
+    bool hash_mode;
+
+    // true if scan_rhs was too big
+    bool switch_failed;
+
+    // key -> (first row, last row), the values of rhs_only_vars of the row r
+    // are at r * rhs_only_vars.size() in build_values, the next row is
+    // next_rows[r]. The rows of a key are in the order of scan_rhs, that is
+    // the order rhs returns them
+    boost::unordered_flat_map<std::vector<ObjectId>, std::pair<uint64_t, uint64_t>, KeyHasher> hash_table;
+    std::vector<ObjectId> build_values;
+    std::vector<uint64_t> next_rows;
+
+    std::vector<ObjectId> key_buf;
+
+    SortedProbeBuffer sorted_lhs;
+
+    // row of the hash table to return next, in hash_mode
+    uint64_t current_row;
+
+    // moves lhs to its next row and prepares it with start_row(), when
+    // sorted_lhs is not enabled
+    bool next_lhs();
+
+    // prepares rhs or the hash table rows for the row of lhs in the binding
+    void start_row();
+
+    // writes the next result of the current row of lhs in the binding
+    bool next_row_result();
+
+    // reads scan_rhs into the hash table, sets hash_mode or switch_failed
+    void try_switch();
+
+    void clear_hash_table();
+};
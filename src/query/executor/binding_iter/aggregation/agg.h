@@ -44,6 +44,12 @@ public:
         return nullptr;
     }
 
+    // nullptr for COUNT(*)
+    const BindingExpr* get_expr() const
+    {
+        return expr.get();
+    }
+
 protected:
     Binding* binding;
     std::unique_ptr<BindingExpr> expr;
@@ -5,9 +5,11 @@ void Aggregation::_begin(Binding& _parent_binding) {
 
     group_vars_binding = Binding(parent_binding->size);
     child_binding = Binding(parent_binding->size);
+    child_batch = std::make_unique<BindingBatch>(parent_binding->size);
+    child_batch_pos = 0;
 
     child->begin(child_binding);
-    new_group = child->next();
+    new_group = next_child();
 
     for (auto&& [var_id, agg] : aggregations) {
         agg->set_binding(child_binding);
@@ -18,7 +20,9 @@ void Aggregation::_begin(Binding& _parent_binding) {
 
 void Aggregation::_reset() {
     child->reset();
-    new_group = child->next();
+    child_batch->clear();
+    child_batch_pos = 0;
+    new_group = next_child();
 
     for (auto&& [var_id, agg] : aggregations) {
         agg->begin();
@@ -51,7 +55,7 @@ bool Aggregation::_next() {
     }
 
     new_group = false;
-    while (child->next()) {
+    while (next_child()) {
         bool same_group = true;
         // check if group is changed
         for (auto& var_id : group_vars) {
@@ -79,6 +83,20 @@ bool Aggregation::_next() {
 }
 
 
+// Reads the next result of the child into child_binding.
+// The child is read with next_batch to avoid a virtual call chain per result
+bool Aggregation::next_child() {
+    if (child_batch_pos == child_batch->selected) {
+        if (child->next_batch(*child_batch) == 0) {
+            return false;
+        }
+        child_batch_pos = 0;
+    }
+    child_batch->load_row(child_batch->selection[child_batch_pos++], child_binding);
+    return true;
+}
+
+
 void Aggregation::assign_nulls() {
     for (auto&& [var_id, agg] : aggregations) {
         parent_binding->add(var_id, ObjectId::get_null());
@@ -32,6 +32,8 @@ public:
 
     void print(std::ostream& os, int indent, bool stats) const override;
 
+    bool next_child();
+
     std::unique_ptr<BindingIter> child;
 
     const std::map<VarId, std::unique_ptr<Agg>> aggregations;
@@ -43,6 +45,9 @@ public:
     Binding* parent_binding;
     Binding child_binding;
 
+    std::unique_ptr<BindingBatch> child_batch;
+    uint_fast32_t child_batch_pos = 0;
+
     bool new_group;
 
     uint32_t groups = 0;
@@ -27,6 +27,8 @@ void HybridAggregation::_begin(Binding& _parent_binding)
     parent_binding = &_parent_binding;
 
     child_binding = Binding(parent_binding->size);
+    child_batch = std::make_unique<BindingBatch>(parent_binding->size);
+    child_batch_pos = 0;
     ordered_group_binding = Binding(parent_binding->size);
 
     child->begin(child_binding);
@@ -52,6 +54,20 @@ void HybridAggregation::_reset()
     pending_ordered_group = ordered_group.next();
 }
 
+// Reads the next result of the child into child_binding.
+// The child is read with next_batch to avoid a virtual call chain per result
+bool HybridAggregation::next_child()
+{
+    if (child_batch_pos == child_batch->selected) {
+        if (child->next_batch(*child_batch) == 0) {
+            return false;
+        }
+        child_batch_pos = 0;
+    }
+    child_batch->load_row(child_batch->selection[child_batch_pos++], child_binding);
+    return true;
+}
+
 void HybridAggregation::prepare()
 {
     size_t data_size = 0;
@@ -64,7 +80,7 @@ void HybridAggregation::prepare()
     size_t max_buffer_groups = data_size == 0 ? UINT32_MAX : buffer_size / data_size;
     // size_t max_buffer_groups = 1;
 
-    while (child->next()) {
+    while (next_child()) {
         size_t i = 0;
         for (auto& var_id : group_vars) {
             key_buf[i] = child_binding[var_id];
@@ -99,7 +115,7 @@ void HybridAggregation::prepare()
     goto all_tuples_in_buffer;
 
 buffer_full:
-    while (child->next()) {
+    while (next_child()) {
         size_t i = 0;
         for (auto& var_id : group_vars) {
             key_buf[i] = child_binding[var_id];
@@ -54,6 +54,10 @@ private:
 
     Binding child_binding;
 
+    std::unique_ptr<BindingBatch> child_batch;
+
+    uint_fast32_t child_batch_pos = 0;
+
     Binding ordered_group_binding;
 
     boost::unordered_map<std::vector<ObjectId>, char*, OIDVectorHasher> groups;
@@ -67,6 +71,8 @@ private:
     // helper for begin/reset
     void prepare();
 
+    bool next_child();
+
     OrderedGroup ordered_group;
 
     bool pending_ordered_group;
@@ -0,0 +1,308 @@
+#include "parallel_aggregation.h"
+
+#include "query/executor/binding_iter/gather.h"
+
+template<std::size_t N>
+ParallelAggregation<N>::ParallelAggregation(
+    std::unique_ptr<HybridAggregation>                  fallback,
+    std::vector<std::unique_ptr<IndexScan<N>>>          scans,
+    std::vector<std::map<VarId, std::unique_ptr<UAgg>>> u_aggregations,
+    std::set<VarId>                                     group_vars
+) :
+    fallback   (std::move(fallback)),
+    workers    (scans.size()),
+    group_vars (std::move(group_vars))
+{
+    for (uint_fast32_t i = 0; i < workers.size(); i++) {
+        workers[i].scan = std::move(scans[i]);
+        workers[i].u_aggregations = std::move(u_aggregations[i]);
+        workers[i].partitions.resize(PARTITIONS);
+    }
+    data_size = 0;
+    for (auto&& [var, agg] : workers[0].u_aggregations) {
+        data_size += agg->get_offset();
+    }
+}
+
+template<std::size_t N>
+void ParallelAggregation<N>::_begin(Binding& _parent_binding)
+{
+    parent_binding = &_parent_binding;
+
+    used_fallback = !aggregate();
+    if (used_fallback) {
+        fallback->begin(*parent_binding);
+    }
+}
+
+template<std::size_t N>
+void ParallelAggregation<N>::_reset()
+{
+    // as HybridAggregation, the groups are returned again without reading the child
+    if (used_fallback) {
+        fallback->reset();
+    } else {
+        current_partition = 0;
+        iter = workers[0].partitions[0].begin();
+    }
+}
+
+template<std::size_t N>
+bool ParallelAggregation<N>::aggregate()
+{
+    for (auto& worker : workers) {
+        if (worker.binding == nullptr) {
+            worker.binding = std::make_unique<Binding>(parent_binding->size);
+            worker.batch = std::make_unique<BindingBatch>(parent_binding->size);
+            worker.key_buf.resize(group_vars.size());
+            for (auto&& [var, agg] : worker.u_aggregations) {
+                agg->set_binding(*worker.binding);
+            }
+        }
+        worker.binding->add_all(*parent_binding);
+
+        for (auto& groups : worker.partitions) {
+            groups.clear();
+        }
+        worker.groups = 0;
+        worker.state_blocks_used = 0;
+        worker.last_block_used = 0;
+    }
+
+    auto total = workers[0].scan->count_records(*parent_binding);
+    morsels = (total + Gather<N>::MORSEL_SIZE - 1) / Gather<N>::MORSEL_SIZE;
+    next_morsel = 0;
+    too_many_groups = false;
+
+    run_workers(&ParallelAggregation<N>::aggregate_morsels);
+    if (too_many_groups) {
+        return false;
+    }
+
+    next_partition = 0;
+    run_workers(&ParallelAggregation<N>::merge_partitions);
+
+    // We have aggregation without grouping and have never returned a binding.
+    // But for aggregation without grouping we have to return at least once.
+    // The empty key is in its partition, not necessarily the first one.
+    auto& result = workers[0];
+    if (group_vars.size() == 0) {
+        auto& groups = result.partitions[get_partition(result.key_buf)];
+        if (groups.empty()) {
+            auto data = new_state(result);
+            size_t offset = 0;
+            for (auto&& [var, agg] : result.u_aggregations) {
+                agg->begin(data + offset);
+                offset += agg->get_offset();
+            }
+            groups.insert({ result.key_buf, data });
+        }
+    }
+
+    current_partition = 0;
+    iter = result.partitions[0].begin();
+    return true;
+}
+
+template<std::size_t N>
+void ParallelAggregation<N>::run_workers(void (ParallelAggregation<N>::*task)(uint_fast32_t))
+{
+    threads.start(workers.size(), [this, task](uint_fast32_t i) { (this->*task)(i); });
+    threads.wait();
+}
+
+template<std::size_t N>
+char* ParallelAggregation<N>::new_state(Worker& worker)
+{
+    if (worker.state_blocks_used == 0 || worker.last_block_used + data_size > STATE_BLOCK_SIZE) {
+        if (worker.state_blocks_used == worker.state_blocks.size()) {
+            worker.state_blocks.push_back(std::make_unique<char[]>(STATE_BLOCK_SIZE));
+        }
+        worker.state_blocks_used++;
+        worker.last_block_used = 0;
+    }
+    auto res = worker.state_blocks[worker.state_blocks_used - 1].get() + worker.last_block_used;
+    worker.last_block_used += data_size;
+    return res;
+}
+
+template<std::size_t N>
+void ParallelAggregation<N>::aggregate_morsels(uint_fast32_t worker_index)
+{
+    auto& worker = workers[worker_index];
+    auto& scan = *worker.scan;
+    auto& binding = *worker.binding;
+    auto& batch = *worker.batch;
+    auto& key_buf = worker.key_buf;
+
+    // so print() shows the scan as it was built, even after an exception
+    struct ScanRestore {
+        IndexScan<N>& scan;
+        ~ScanRestore()
+        {
+            scan.offset = 0;
+            scan.limit = UINT64_MAX;
+        }
+    } scan_restore { scan };
+
+    bool begun = false;
+    while (!too_many_groups) {
+        auto morsel = next_morsel++;
+        if (morsel >= morsels) {
+            break;
+        }
+        scan.offset = morsel * Gather<N>::MORSEL_SIZE;
+        scan.limit = Gather<N>::MORSEL_SIZE;
+        if (begun) {
+            scan.reset();
+        } else {
+            scan.begin(binding);
+            begun = true;
+        }
+
+        while (!too_many_groups && scan.next_batch(batch) > 0) {
+            for (uint_fast32_t b = 0; b < batch.selected; b++) {
+                batch.load_row(batch.selection[b], binding);
+
+                size_t i = 0;
+                for (auto& var_id : group_vars) {
+                    key_buf[i] = binding[var_id];
+                    i++;
+                }
+
+                auto& groups = worker.partitions[get_partition(key_buf)];
+                auto it = groups.find(key_buf);
+                char* data;
+                if (it == groups.end()) {
+                    data = new_state(worker);
+                    groups.insert({ key_buf, data });
+                    worker.groups++;
+
+                    size_t offset = 0;
+                    for (auto&& [var, agg] : worker.u_aggregations) {
+                        agg->begin(data + offset);
+                        offset += agg->get_offset();
+                    }
+                } else {
+                    data = it->second;
+                }
+
+                size_t offset = 0;
+                for (auto&& [var, agg] : worker.u_aggregations) {
+                    agg->process(data + offset);
+                    offset += agg->get_offset();
+                }
+            }
+            if (worker.groups > MAX_GROUPS_PER_WORKER) {
+                too_many_groups = true;
+            }
+        }
+    }
+}
+
+template<std::size_t N>
+void ParallelAggregation<N>::merge_partitions(uint_fast32_t worker_index)
+{
+    auto& worker = workers[worker_index];
+    for (auto p = next_partition++; p < PARTITIONS; p = next_partition++) {
+        auto& result = workers[0].partitions[p];
+        for (uint_fast32_t w = 1; w < workers.size(); w++) {
+            for (auto&& [key, other_data] : workers[w].partitions[p]) {
+                auto inserted = result.insert({ key, other_data });
+                if (inserted.second) {
+                    // the state stays in the blocks of the worker w
+                    continue;
+                }
+                auto data = inserted.first->second;
+                size_t offset = 0;
+                for (auto&& [var, agg] : worker.u_aggregations) {
+                    agg->merge(data + offset, other_data + offset);
+                    offset += agg->get_offset();
+                }
+            }
+        }
+    }
+}
+
+template<std::size_t N>
+bool ParallelAggregation<N>::_next()
+{
+    if (used_fallback) {
+        return fallback->next();
+    }
+
+    auto& result = workers[0];
+    while (iter == result.partitions[current_partition].end()) {
+        current_partition++;
+        if (current_partition == PARTITIONS) {
+            // so next calls don't go out of range
+            current_partition--;
+            return false;
+        }
+        iter = result.partitions[current_partition].begin();
+    }
+
+    size_t offset = 0;
+    for (auto&& [var_id, agg] : result.u_aggregations) {
+        parent_binding->add(var_id, agg->get(iter->second + offset));
+        offset += agg->get_offset();
+    }
+    size_t i = 0;
+    for (auto& var_id : group_vars) {
+        parent_binding->add(var_id, iter->first[i]);
+        i++;
+    }
+    iter++;
+    return true;
+}
+
+template<std::size_t N>
+void ParallelAggregation<N>::assign_nulls()
+{
+    for (auto&& [var_id, agg] : workers[0].u_aggregations) {
+        parent_binding->add(var_id, ObjectId::get_null());
+    }
+    for (auto& var_id : group_vars) {
+        parent_binding->add(var_id, ObjectId::get_null());
+    }
+}
+
+template<std::size_t N>
+void ParallelAggregation<N>::print(std::ostream& os, int indent, bool stats) const
+{
+    if (stats) {
+        print_generic_stats(os, indent);
+    }
+    os << std::string(indent, ' ') << "ParallelAggregation(workers: " << workers.size();
+    if (stats) {
+        os << " morsels: " << morsels;
+        if (used_fallback) {
+            os << " too many groups, used fallback";
+        }
+    }
+
+    if (group_vars.size() > 0) {
+        os << " group vars:";
+        for (auto var : group_vars) {
+            os << " " << var;
+        }
+    }
+
+    if (workers[0].u_aggregations.size() > 0) {
+        os << " aggregations:";
+        for (auto& [var, agg] : workers[0].u_aggregations) {
+            os << " " << var << '=' << *agg;
+        }
+    }
+    os << ")\n";
+    if (used_fallback) {
+        fallback->print(os, indent + 2, stats);
+    } else {
+        workers[0].scan->print(os, indent + 2, stats);
+    }
+}
+
+template class ParallelAggregation<1>;
+template class ParallelAggregation<2>;
+template class ParallelAggregation<3>;
+template class ParallelAggregation<4>;
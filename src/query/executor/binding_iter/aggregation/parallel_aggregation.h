@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include "query/executor/binding_iter.h"
+#include "query/executor/binding_iter/aggregation/hybrid_aggregation.h"
+#include "query/executor/binding_iter/aggregation/unordered_agg.h"
+#include "query/executor/binding_iter/index_scan.h"
+#include "query/executor/helper_threads.h"
+
+// Aggregation of an IndexScan computed by several threads.
+// Each worker reads morsels of its own copy of the scan (see Gather) and keeps
+// thread-local partial aggregates of its groups, split in partitions by the
+// hash of the group. At the end the partitions are merged in parallel, the
+// partition i of every worker into the partition i of the first one, using
+// UAgg::merge.
+// The aggregates must only read variables, as the expressions are evaluated
+// by the workers, which are HelperThreads. If a worker gets more than MAX_GROUPS_PER_WORKER groups the
+// parallel aggregation is abandoned and the results come from `fallback`,
+// a HybridAggregation of the original scan that can spill to disk.
+template <std::size_t N>
+class ParallelAggregation : public BindingIter {
+public:
+    static constexpr uint64_t MAX_GROUPS_PER_WORKER = 1024 * 1024;
+
+    static constexpr uint_fast32_t PARTITION_BITS = 6;
+    static constexpr uint_fast32_t PARTITIONS = 1 << PARTITION_BITS;
+
+    // size of the blocks where the workers allocate the group states
+    static constexpr size_t STATE_BLOCK_SIZE = 64 * 1024;
+
+    // scans[i] and u_aggregations[i] are used by the worker i
+    ParallelAggregation(
+        std::unique_ptr<HybridAggregation>                  fallback,
+        std::vector<std::unique_ptr<IndexScan<N>>>          scans,
+        std::vector<std::map<VarId, std::unique_ptr<UAgg>>> u_aggregations,
+        std::set<VarId>                                     group_vars
+    );
+
+    void _begin(Binding& parent_binding) override;
+
+    void _reset() override;
+
+    bool _next() override;
+
+    void assign_nulls() override;
+
+    void print(std::ostream& os, int indent, bool stats) const override;
+
+    // statistics
+    uint64_t morsels = 0;
+    bool used_fallback = false;
+
+private:
+    using Groups = boost::unordered_flat_map<std::vector<ObjectId>, char*, HybridAggregation::OIDVectorHasher>;
+
+    struct Worker {
+        std::unique_ptr<IndexScan<N>> scan;
+        std::map<VarId, std::unique_ptr<UAgg>> u_aggregations;
+
+        std::unique_ptr<Binding> binding;
+        std::unique_ptr<BindingBatch> batch;
+
+        std::vector<Groups> partitions;
+        uint64_t groups;
+
+        std::vector<std::unique_ptr<char[]>> state_blocks;
+        size_t state_blocks_used;
+        size_t last_block_used;
+
+        std::vector<ObjectId> key_buf;
+    };
+
+    std::unique_ptr<HybridAggregation> fallback;
+
+    std::vector<Worker> workers;
+
+    // threads running the workers, created once
+    HelperThreads threads;
+
+    const std::set<VarId> group_vars;
+
+    // size of the state of a group
+    size_t data_size;
+
+    Binding* parent_binding;
+
+    std::atomic<uint64_t> next_morsel;
+    std::atomic<uint_fast32_t> next_partition;
+    std::atomic<bool> too_many_groups;
+
+    // current result when the fallback is not used
+    uint_fast32_t current_partition;
+    typename Groups::iterator iter;
+
+    // returns false if the fallback must be used
+    bool aggregate();
+
+    // runs (this->*task)(i) in the thread of each worker i and waits for all of them
+    void run_workers(void (ParallelAggregation<N>::*task)(uint_fast32_t));
+
+    void aggregate_morsels(uint_fast32_t worker_index);
+
+    void merge_partitions(uint_fast32_t worker_index);
+
+    char* new_state(Worker& worker);
+
+    static inline uint_fast32_t get_partition(const std::vector<ObjectId>& key)
+    {
+        return (HybridAggregation::OIDVectorHasher()(key) * 0x9E3779B97F4A7C15ULL) >> (64 - PARTITION_BITS);
+    }
+};
@@ -40,6 +40,13 @@ public:
         return Conversions::pack_int(data->count);
     }
 
+    void merge(void* vdata, void* vother) override
+    {
+        Data* data = reinterpret_cast<Data*>(vdata);
+        Data* other = reinterpret_cast<Data*>(vother);
+        data->count += other->count;
+    }
+
     std::ostream& print(std::ostream& os) const override
     {
         os << "COUNT(";
@@ -45,6 +45,20 @@ public:
         return data->max;
     }
 
+    void merge(void* vdata, void* vother) override
+    {
+        Data* data = reinterpret_cast<Data*>(vdata);
+        Data* other = reinterpret_cast<Data*>(vother);
+        if (data->max.is_null()) {
+            data->max = other->max;
+        } else if (other->max.is_valid()) {
+            auto cmp = SPARQL::Comparisons::compare(other->max, data->max);
+            if (cmp > 0) {
+                data->max = other->max;
+            }
+        }
+    }
+
     std::ostream& print(std::ostream& os) const override
     {
         os << "MAX(";
@@ -46,6 +46,20 @@ public:
         return data->min;
     }
 
+    void merge(void* vdata, void* vother) override
+    {
+        Data* data = reinterpret_cast<Data*>(vdata);
+        Data* other = reinterpret_cast<Data*>(vother);
+        if (data->min.is_null()) {
+            data->min = other->min;
+        } else if (other->min.is_valid()) {
+            auto cmp = SPARQL::Comparisons::compare(other->min, data->min);
+            if (cmp < 0) {
+                data->min = other->min;
+            }
+        }
+    }
+
     std::ostream& print(std::ostream& os) const override
     {
         os << "MIN(";
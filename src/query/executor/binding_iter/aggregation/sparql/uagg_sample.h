@@ -40,6 +40,15 @@ public:
         return data->sample;
     }
 
+    void merge(void* vdata, void* vother) override
+    {
+        Data* data = reinterpret_cast<Data*>(vdata);
+        Data* other = reinterpret_cast<Data*>(vother);
+        if (data->sample.is_null()) {
+            data->sample = other->sample;
+        }
+    }
+
     std::ostream& print(std::ostream& os) const override
     {
         os << "COUNT(";
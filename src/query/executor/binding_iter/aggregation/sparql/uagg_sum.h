@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "graph_models/rdf_model/conversions.h"
 #include "query/executor/binding_iter/aggregation/unordered_agg.h"
 #include "query/executor/binding_iter/binding_expr/binding_expr_printer.h"
@@ -104,6 +106,34 @@ public:
         }
     }
 
+    void merge(void* vdata, void* vother) override
+    {
+        Data* data = reinterpret_cast<Data*>(vdata);
+        Data* other = reinterpret_cast<Data*>(vother);
+
+        if (data->sum_type == Conversions::OpType::INVALID) {
+            return;
+        }
+        if (other->sum_type == Conversions::OpType::INVALID) {
+            data->sum_type = Conversions::OpType::INVALID;
+            return;
+        }
+
+        auto sum_type = std::max(data->sum_type, other->sum_type);
+        promote(*data, sum_type);
+        promote(*other, sum_type);
+
+        if (sum_type == Conversions::OpType::INTEGER) {
+            data->sum.sum_integer += other->sum.sum_integer;
+        } else if (sum_type == Conversions::OpType::DECIMAL) {
+            data->sum.sum_decimal = data->sum.sum_decimal + other->sum.sum_decimal;
+        } else if (sum_type == Conversions::OpType::FLOAT) {
+            data->sum.sum_float += other->sum.sum_float;
+        } else {
+            data->sum.sum_double += other->sum.sum_double;
+        }
+    }
+
     std::ostream& print(std::ostream& os) const override
     {
         os << "SUM(";
@@ -112,5 +142,32 @@ public:
         os << ")";
         return os;
     }
+
+private:
+    // converts the sum to sum_type, which can't be smaller than its current type
+    static void promote(Data& data, Conversions::OpType sum_type)
+    {
+        if (sum_type == data.sum_type) {
+            return;
+        }
+        if (sum_type == Conversions::OpType::DECIMAL) {
+            data.sum.sum_decimal = Decimal(data.sum.sum_integer);
+        } else if (sum_type == Conversions::OpType::FLOAT) {
+            if (data.sum_type == Conversions::OpType::INTEGER) {
+                data.sum.sum_float = data.sum.sum_integer;
+            } else {
+                data.sum.sum_float = data.sum.sum_decimal.to_float();
+            }
+        } else {
+            if (data.sum_type == Conversions::OpType::INTEGER) {
+                data.sum.sum_double = data.sum.sum_integer;
+            } else if (data.sum_type == Conversions::OpType::DECIMAL) {
+                data.sum.sum_double = data.sum.sum_decimal.to_double();
+            } else {
+                data.sum.sum_double = data.sum.sum_float;
+            }
+        }
+        data.sum_type = sum_type;
+    }
 };
 } // namespace SPARQL
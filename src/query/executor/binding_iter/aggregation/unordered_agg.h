@@ -28,6 +28,10 @@ public:
     // gets the final result of the aggregation
     virtual ObjectId get(void* state_data) = 0;
 
+    // adds to state_data the bindings processed in other_state_data, which
+    // may be modified. Used to combine partial aggregations of different threads
+    virtual void merge(void* state_data, void* other_state_data) = 0;
+
     virtual std::ostream& print(std::ostream& os) const = 0;
 
     friend std::ostream& operator<<(std::ostream& os, const UAgg& a)
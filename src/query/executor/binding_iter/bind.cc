@@ -22,6 +22,18 @@ bool Bind::_next()
     return false;
 }
 
+uint_fast32_t Bind::_next_batch(BindingBatch& batch)
+{
+    auto selected = child_iter->next_batch(batch);
+    auto column = batch.write_column(var);
+    for (uint_fast32_t i = 0; i < selected; i++) {
+        auto row = batch.selection[i];
+        batch.load_row(row, *parent_binding);
+        column[row] = expr->eval(*parent_binding);
+    }
+    return selected;
+}
+
 void Bind::assign_nulls()
 {
     parent_binding->add(var, ObjectId::get_null());
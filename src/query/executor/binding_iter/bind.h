@@ -19,6 +19,8 @@ public:
 
     bool _next() override;
 
+    uint_fast32_t _next_batch(BindingBatch& batch) override;
+
     void assign_nulls() override;
 
     void print(std::ostream& os, int indent, bool stats) const override;
@@ -1,5 +1,9 @@
 #include "distinct_hash.h"
 
+#include <algorithm>
+
+#include "third_party/hashes/hash_function_wrapper.h"
+
 using namespace std;
 
 void DistinctHash::_begin(Binding& parent_binding)
@@ -12,7 +16,11 @@ void DistinctHash::_begin(Binding& parent_binding)
 void DistinctHash::_reset()
 {
     child_iter->reset();
-    extendable_table.reset();
+    tuple_set.reset();
+    if (extendable_table != nullptr) {
+        extendable_table->reset();
+    }
+    spilled = false;
 }
 
 bool DistinctHash::_next()
@@ -36,15 +44,44 @@ void DistinctHash::assign_nulls()
 
 bool DistinctHash::current_tuple_distinct()
 {
-    bool is_new_tuple = !extendable_table.is_in_or_insert(current_tuple);
+    if (!spilled && tuple_set.full()) {
+        spill();
+    }
+
+    bool is_new_tuple;
+    if (spilled) {
+        is_new_tuple = !extendable_table->is_in_or_insert(current_tuple);
+    } else {
+        auto hash = HashFunctionWrapper(current_tuple.data(), current_tuple.size() * sizeof(ObjectId));
+        is_new_tuple = !tuple_set.is_in_or_insert(current_tuple.data(), hash);
+    }
     return is_new_tuple;
 }
 
+void DistinctHash::spill()
+{
+    if (extendable_table == nullptr) {
+        extendable_table = make_unique<DistinctBindingHash>(projected_vars.size());
+    }
+
+    std::vector<ObjectId> tuple(projected_vars.size());
+    tuple_set.for_each([&](const ObjectId* stored_tuple) {
+        std::copy(stored_tuple, stored_tuple + tuple.size(), tuple.begin());
+        extendable_table->is_in_or_insert(tuple);
+    });
+    tuple_set.reset();
+    spilled = true;
+}
+
 void DistinctHash::print(std::ostream& os, int indent, bool stats) const
 {
     if (stats) {
         print_generic_stats(os, indent);
     }
-    os << std::string(indent, ' ') << "DistinctHash()\n";
+    os << std::string(indent, ' ') << "DistinctHash(";
+    if (stats && spilled) {
+        os << "spilled";
+    }
+    os << ")\n";
     child_iter->print(os, indent + 2, stats);
 }
@@ -4,13 +4,20 @@
 
 #include "query/executor/binding_iter.h"
 #include "storage/index/hash/distinct_binding_hash/distinct_binding_hash.h"
+#include "storage/index/hash/distinct_binding_hash/distinct_tuple_set.h"
 
+// Removes duplicated tuples of the projected vars. The tuples seen are kept
+// in a DistinctTupleSet until it would need more than MAX_MEMORY bytes, then
+// they are moved to a DistinctBindingHash, that keeps them in temp files,
+// and it is used for the rest of the tuples.
 class DistinctHash : public BindingIter {
 public:
+    static constexpr size_t MAX_MEMORY = 1024 * 1024 * 64; // 64 MB
+
     DistinctHash(std::unique_ptr<BindingIter> child_iter, std::vector<VarId>&& _projected_vars) :
         child_iter(std::move(child_iter)),
         projected_vars(std::move(_projected_vars)),
-        extendable_table(projected_vars.size())
+        tuple_set(projected_vars.size(), MAX_MEMORY)
     { }
 
     void _begin(Binding& parent_binding) override;
@@ -24,10 +31,18 @@ public:
 
     std::unique_ptr<BindingIter> child_iter;
 
+    // statistics
+    bool spilled = false;
+
 private:
     std::vector<VarId> projected_vars;
-    DistinctBindingHash extendable_table;
+    DistinctTupleSet tuple_set;
+
+    // created when tuple_set is full
+    std::unique_ptr<DistinctBindingHash> extendable_table;
 
     std::vector<ObjectId> current_tuple;
     Binding* parent_binding;
+
+    void spill();
 };
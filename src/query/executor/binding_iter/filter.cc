@@ -26,6 +26,35 @@ bool Filter::_next()
     return false;
 }
 
+uint_fast32_t Filter::_next_batch(BindingBatch& batch)
+{
+    while (child_iter->next_batch(batch) > 0) {
+        // keeps the rows that pass the filters, in the same order
+        uint_fast32_t selected = 0;
+        for (uint_fast32_t i = 0; i < batch.selected; i++) {
+            auto row = batch.selection[i];
+            batch.load_row(row, *parent_binding);
+
+            bool pass_filters = true;
+            for (auto& filter : filters) {
+                auto evaluation = filter->eval(*parent_binding);
+                if (!to_boolean(evaluation).is_true()) {
+                    pass_filters = false;
+                    break;
+                }
+            }
+            if (pass_filters) {
+                batch.selection[selected++] = row;
+            }
+        }
+        batch.selected = selected;
+        if (selected > 0) {
+            return selected;
+        }
+    }
+    return 0;
+}
+
 void Filter::_reset()
 {
     child_iter->reset();
@@ -36,6 +65,11 @@ void Filter::assign_nulls()
     child_iter->assign_nulls();
 }
 
+bool Filter::push_runtime_filter(const RuntimeFilter& filter)
+{
+    return child_iter->push_runtime_filter(filter);
+}
+
 void Filter::print(std::ostream& os, int indent, bool stats) const
 {
     if (stats) {
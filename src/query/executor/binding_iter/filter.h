@@ -22,8 +22,10 @@ public:
 
     void _begin(Binding& parent_binding) override;
     bool _next() override;
+    uint_fast32_t _next_batch(BindingBatch& batch) override;
     void _reset() override;
     void assign_nulls() override;
+    bool push_runtime_filter(const RuntimeFilter& filter) override;
 
     ObjectId (*to_boolean)(ObjectId);
 
@@ -0,0 +1,276 @@
+#include "gather.h"
+
+#include <algorithm>
+#include <chrono>
+
+template<std::size_t N>
+Gather<N>::~Gather()
+{
+    stop();
+}
+
+template<std::size_t N>
+void Gather<N>::_begin(Binding& parent_binding)
+{
+    this->parent_binding = &parent_binding;
+    start();
+}
+
+template<std::size_t N>
+void Gather<N>::_reset()
+{
+    stop();
+    start();
+}
+
+template<std::size_t N>
+void Gather<N>::start()
+{
+    auto total = scans[0]->count_records(*parent_binding);
+    morsels = (total + MORSEL_SIZE - 1) / MORSEL_SIZE;
+    next_morsel = 0;
+
+    stop_requested = false;
+    worker_exception = nullptr;
+    running_workers = pipelines.size();
+
+    for (uint_fast32_t i = 0; i < pipelines.size(); i++) {
+        if (worker_bindings.size() == i) {
+            worker_bindings.push_back(std::make_unique<Binding>(parent_binding->size));
+        }
+        worker_bindings[i]->add_all(*parent_binding);
+    }
+
+    workers.start(pipelines.size(), [this](uint_fast32_t i) { run_worker(i); });
+    started = true;
+}
+
+template<std::size_t N>
+void Gather<N>::stop()
+{
+    if (!started) {
+        return;
+    }
+    started = false;
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stop_requested = true;
+    }
+    workers.interrupt();
+    queue_not_full.notify_all();
+
+    // run_worker() keeps the exceptions of the workers
+    workers.wait();
+
+    // the threads are stopped, the batches can be moved without the lock
+    for (auto& batch : full_batches) {
+        free_batches.push_back(std::move(batch));
+    }
+    full_batches.clear();
+    if (current != nullptr) {
+        free_batches.push_back(std::move(current));
+    }
+    current_pos = 0;
+}
+
+template<std::size_t N>
+void Gather<N>::run_worker(uint_fast32_t index)
+{
+    auto& pipeline = *pipelines[index];
+    auto& scan = *scans[index];
+    auto& binding = *worker_bindings[index];
+    const auto max_queued = QUEUED_BATCHES_PER_WORKER * pipelines.size();
+
+    try {
+        bool begun = false;
+        bool stopped = false;
+        while (!stopped) {
+            auto morsel = next_morsel++;
+            if (morsel >= morsels) {
+                break;
+            }
+            scan.offset = morsel * MORSEL_SIZE;
+            scan.limit = MORSEL_SIZE;
+            if (begun) {
+                pipeline.reset();
+            } else {
+                pipeline.begin(binding);
+                begun = true;
+            }
+
+            while (true) {
+                std::unique_ptr<BindingBatch> batch;
+                {
+                    std::unique_lock<std::mutex> lock(queue_mutex);
+                    queue_not_full.wait(lock, [&] {
+                        return stop_requested || full_batches.size() < max_queued;
+                    });
+                    if (stop_requested) {
+                        stopped = true;
+                        break;
+                    }
+                    if (!free_batches.empty()) {
+                        batch = std::move(free_batches.back());
+                        free_batches.pop_back();
+                    }
+                }
+                if (batch == nullptr) {
+                    batch = std::make_unique<BindingBatch>(binding.size);
+                }
+
+                auto selected = pipeline.next_batch(*batch);
+
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                if (selected == 0) {
+                    free_batches.push_back(std::move(batch));
+                    break;
+                }
+                full_batches.push_back(std::move(batch));
+                queue_not_empty.notify_one();
+            }
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (worker_exception == nullptr && !stop_requested) {
+            worker_exception = std::current_exception();
+        }
+    }
+    // so print() shows the scan as it was built
+    scan.offset = 0;
+    scan.limit = UINT64_MAX;
+
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    running_workers--;
+    queue_not_empty.notify_all();
+}
+
+template<std::size_t N>
+std::unique_ptr<BindingBatch> Gather<N>::pop_batch()
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (full_batches.empty() && running_workers > 0 && worker_exception == nullptr) {
+        // the workers don't see the interruption flag of the consumer, so
+        // it is forwarded while waiting for them
+        if (get_query_ctx().thread_info.interruption_requested) {
+            lock.unlock();
+            workers.interrupt();
+            lock.lock();
+        }
+        queue_not_empty.wait_for(lock, std::chrono::milliseconds(100));
+    }
+
+    if (worker_exception != nullptr) {
+        auto exception = worker_exception;
+        lock.unlock();
+        stop();
+        std::rethrow_exception(exception);
+    }
+
+    if (full_batches.empty()) {
+        return nullptr;
+    }
+    auto batch = std::move(full_batches.front());
+    full_batches.pop_front();
+    queue_not_full.notify_one();
+    return batch;
+}
+
+template<std::size_t N>
+void Gather<N>::release_current()
+{
+    if (current != nullptr) {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        free_batches.push_back(std::move(current));
+    }
+    current_pos = 0;
+}
+
+template<std::size_t N>
+bool Gather<N>::_next()
+{
+    while (current == nullptr || current_pos == current->selected) {
+        release_current();
+        current = pop_batch();
+        if (current == nullptr) {
+            stop();
+            return false;
+        }
+    }
+    current->load_row(current->selection[current_pos++], *parent_binding);
+    return true;
+}
+
+template<std::size_t N>
+uint_fast32_t Gather<N>::_next_batch(BindingBatch& out)
+{
+    out.clear();
+    while (out.size < out.max_size) {
+        if (current == nullptr || current_pos == current->selected) {
+            release_current();
+            current = pop_batch();
+            if (current == nullptr) {
+                stop();
+                break;
+            }
+        }
+        auto count = std::min<uint_fast32_t>(current->selected - current_pos, out.max_size - out.size);
+        for (auto var : current->get_assigned_vars()) {
+            auto src = current->column(var);
+            auto dst = out.write_column(var) + out.size;
+            for (uint_fast32_t i = 0; i < count; i++) {
+                dst[i] = src[current->selection[current_pos + i]];
+            }
+        }
+        out.size += count;
+        current_pos += count;
+    }
+    out.select_all();
+    return out.size;
+}
+
+template<std::size_t N>
+void Gather<N>::assign_nulls()
+{
+    // the pipelines write into the bindings of the workers, so the first one
+    // is started over the parent binding just to assign its nulls
+    stop();
+    pipelines[0]->begin(*parent_binding);
+    pipelines[0]->assign_nulls();
+}
+
+template<std::size_t N>
+bool Gather<N>::push_runtime_filter(const RuntimeFilter& filter)
+{
+    // the filter is only read by the workers
+    bool used = false;
+    for (auto& pipeline : pipelines) {
+        used |= pipeline->push_runtime_filter(filter);
+    }
+    return used;
+}
+
+template<std::size_t N>
+void Gather<N>::print(std::ostream& os, int indent, bool stats) const
+{
+    if (stats) {
+        print_generic_stats(os, indent);
+    }
+    os << std::string(indent, ' ') << "Gather(workers: " << pipelines.size();
+    if (stats) {
+        os << " morsels: " << morsels;
+    }
+    os << ")\n";
+    for (auto& pipeline : pipelines) {
+        pipeline->print(os, indent + 2, stats);
+        if (!stats) {
+            // without statistics the copies are identical
+            break;
+        }
+    }
+}
+
+template class Gather<1>;
+template class Gather<2>;
+template class Gather<3>;
+template class Gather<4>;
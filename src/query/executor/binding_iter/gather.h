@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "query/executor/binding_iter.h"
+#include "query/executor/binding_iter/index_scan.h"
+#include "query/executor/helper_threads.h"
+
+// Exchange operator for intra-query parallelism.
+// Each worker thread runs its own copy of a pipeline that reads an IndexScan
+// (scans[i] is the scan inside pipelines[i]). The records of the scan range
+// are split into morsels of MORSEL_SIZE consecutive records using the B+tree
+// directory counts, and the workers take the next morsel from a shared
+// counter, so the faster workers scan more morsels. The results are sent in
+// batches through a bounded queue and returned in the consumer thread, in no
+// particular order.
+// The workers are HelperThreads, so the pipelines must not use private pages
+// nor create temporal strings.
+template <std::size_t N>
+class Gather : public BindingIter {
+public:
+    static constexpr uint64_t MORSEL_SIZE = 64 * 1024;
+
+    // maximum number of filled batches waiting for the consumer, per worker
+    static constexpr uint_fast32_t QUEUED_BATCHES_PER_WORKER = 2;
+
+    Gather(
+        std::vector<std::unique_ptr<BindingIter>> pipelines,
+        std::vector<IndexScan<N>*>                scans
+    ) :
+        pipelines (std::move(pipelines)),
+        scans     (std::move(scans)) { }
+
+    ~Gather();
+
+    void print(std::ostream& os, int indent, bool stats) const override;
+
+    void _begin(Binding& parent_binding) override;
+    bool _next() override;
+    uint_fast32_t _next_batch(BindingBatch& batch) override;
+    void _reset() override;
+    void assign_nulls() override;
+    bool push_runtime_filter(const RuntimeFilter& filter) override;
+
+    // statistics
+    uint64_t morsels = 0;
+
+private:
+    std::vector<std::unique_ptr<BindingIter>> pipelines;
+
+    std::vector<IndexScan<N>*> scans;
+
+    Binding* parent_binding;
+
+    // each worker has its own copy of the parent binding
+    std::vector<std::unique_ptr<Binding>> worker_bindings;
+
+    // created once, the executions after a reset reuse the threads
+    HelperThreads workers;
+
+    // true between start() and stop()
+    bool started = false;
+
+    std::atomic<uint64_t> next_morsel;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_not_empty;
+    std::condition_variable queue_not_full;
+
+    // batches filled by the workers, waiting for the consumer
+    std::deque<std::unique_ptr<BindingBatch>> full_batches;
+
+    // batches already consumed, reused by the workers
+    std::vector<std::unique_ptr<BindingBatch>> free_batches;
+
+    // protected by queue_mutex
+    uint_fast32_t running_workers = 0;
+    bool stop_requested = false;
+    std::exception_ptr worker_exception;
+
+    // batch being returned by the consumer
+    std::unique_ptr<BindingBatch> current;
+    uint_fast32_t current_pos = 0;
+
+    void start();
+    void stop();
+    void run_worker(uint_fast32_t index);
+
+    // gives back the current batch to the workers
+    void release_current();
+
+    // returns nullptr when every worker finished and all the batches were consumed
+    std::unique_ptr<BindingBatch> pop_batch();
+};
@@ -38,6 +38,13 @@ Join<N>::Join(
     key_chunks_dir.push_back(key_chunk);
     // Set chunk index in 0
     key_chunk_index = 0;
+
+    for (size_t i = 0; i < N; i++) {
+        auto filter = make_unique<RuntimeFilter>(join_vars[i]);
+        if (probe_rel->push_runtime_filter(*filter)) {
+            runtime_filters.push_back({ i, std::move(filter) });
+        }
+    }
 }
 
 template<std::size_t N>
@@ -65,10 +72,19 @@ void Join<N>::_begin(Binding& _parent_binding)
     }
 
     this->parent_binding = &_parent_binding;
-    build_rel->begin(_parent_binding);
-    probe_rel->begin(_parent_binding);
+    if (build_batch == nullptr) {
+        build_batch = std::make_unique<BindingBatch>(_parent_binding.size);
+        probe_batch = std::make_unique<BindingBatch>(_parent_binding.size);
+    }
+    probe_batch->clear();
+    probe_pos = 0;
 
+    build_rel->begin(_parent_binding);
     build_hash_table();
+    fill_runtime_filters();
+
+    // the probe starts after the build to use the runtime filters
+    probe_rel->begin(_parent_binding);
 }
 
 template<std::size_t N>
@@ -100,13 +116,13 @@ bool Join<N>::_next()
                     continue;
                 }
                 // Asks for an entry in the hash table
-                auto iterator = hash_table.find(probe_key);
+                auto rows = find_build_rows(false);
                 // If has an entry, then update enumerating rows
-                if (iterator != hash_table.end()) {
-                    enumerating_rows = (iterator->second).head;
+                if (rows != nullptr) {
+                    enumerating_rows = rows;
                     // Store enumerating rows and last key for
                     // try to avoid asking hash table in the following iterations
-                    last_enumerating_rows = (iterator->second).head;
+                    last_enumerating_rows = rows;
                     for (size_t i = 0; i < N; i++) {
                         last_probe_key.start[i] = probe_key.start[i];
                     }
@@ -119,7 +135,59 @@ bool Join<N>::_next()
 }
 
 template<std::size_t N>
-void Join<N>::_reset()
+uint_fast32_t Join<N>::_next_batch(BindingBatch& batch)
+{
+    batch.clear();
+    while (batch.size < batch.max_size) {
+        if (enumerating_rows != nullptr) {
+            // output row: the probe row and the current enumerating row
+            for (auto var : probe_batch->get_assigned_vars()) {
+                batch.write_column(var)[batch.size] = probe_batch->column(var)[probe_row];
+            }
+            for (uint_fast32_t i = 0; i < build_vars.size(); i++) {
+                batch.write_column(build_vars[i])[batch.size] = ObjectId(enumerating_rows[i]);
+            }
+            batch.size++;
+            enumerating_rows = reinterpret_cast<uint64_t**>(enumerating_rows)[build_vars.size()];
+            continue;
+        }
+
+        if (probe_pos == probe_batch->selected) {
+            // next_batch() empties the batch also at the end, so the calls
+            // after the end must find the position at 0
+            probe_pos = 0;
+            if (probe_rel->next_batch(*probe_batch) == 0) {
+                break;
+            }
+            if (use_radix_table) {
+                hash_probe_batch();
+            }
+        }
+        probe_row = probe_batch->selection[probe_pos++];
+        probe_batch->load_row(probe_row, *parent_binding);
+
+        for (size_t i = 0; i < N; i++) {
+            probe_key.start[i] = (*parent_binding)[join_vars[i]].id;
+        }
+        if (probe_key == last_probe_key) {
+            enumerating_rows = last_enumerating_rows;
+            continue;
+        }
+        auto rows = find_build_rows(true);
+        if (rows != nullptr) {
+            enumerating_rows = rows;
+            last_enumerating_rows = rows;
+            for (size_t i = 0; i < N; i++) {
+                last_probe_key.start[i] = probe_key.start[i];
+            }
+        }
+    }
+    batch.select_all();
+    return batch.size;
+}
+
+template<std::size_t N>
+void Join<N>::clear_hash_table()
 {
     hash_table.clear();
 
@@ -143,6 +211,12 @@ void Join<N>::_reset()
     // Set chunks to first element in array
     key_chunk = key_chunks_dir[0];
     data_chunk = data_chunks_dir[0];
+}
+
+template<std::size_t N>
+void Join<N>::_reset()
+{
+    clear_hash_table();
 
     // Set enumerating rows as nullptr like in begin
     enumerating_rows = nullptr;
@@ -154,11 +228,15 @@ void Join<N>::_reset()
         last_probe_key.start[i] = ObjectId::MASK_NOT_FOUND;
     }
 
+    probe_batch->clear();
+    probe_pos = 0;
+
     // Spread reset to children
     build_rel->reset();
-    probe_rel->reset();
-
     build_hash_table();
+    fill_runtime_filters();
+
+    probe_rel->reset();
 }
 
 template<std::size_t N>
@@ -168,11 +246,76 @@ void Join<N>::assign_nulls()
     probe_rel->assign_nulls();
 }
 
+template<std::size_t N>
+uint64_t* Join<N>::find_build_rows(bool from_batch)
+{
+    if (!use_radix_table) {
+        auto iterator = hash_table.find(probe_key);
+        if (iterator == hash_table.end()) {
+            return nullptr;
+        }
+        return (iterator->second).head;
+    }
+    if (!from_batch) {
+        return radix_table->find(probe_key.start);
+    }
+    auto ahead = probe_pos - 1 + PREFETCH_DISTANCE;
+    if (ahead < probe_batch->selected) {
+        radix_table->prefetch(probe_hashes[ahead]);
+    }
+    return radix_table->find(probe_key.start, probe_hashes[probe_pos - 1]);
+}
+
+template<std::size_t N>
+void Join<N>::hash_probe_batch()
+{
+    probe_hashes.resize(probe_batch->selected);
+
+    uint64_t key[N];
+    for (uint_fast32_t s = 0; s < probe_batch->selected; s++) {
+        auto row = probe_batch->selection[s];
+        for (size_t i = 0; i < N; i++) {
+            key[i] = probe_batch->column(join_vars[i])[row].id;
+        }
+        probe_hashes[s] = radix_table->hash(key);
+    }
+    for (uint_fast32_t s = 0; s < probe_batch->selected && s < PREFETCH_DISTANCE; s++) {
+        radix_table->prefetch(probe_hashes[s]);
+    }
+}
+
+template<std::size_t N>
+void Join<N>::switch_to_radix_table()
+{
+    if (radix_table == nullptr) {
+        radix_table = std::make_unique<RadixHashTable<N>>(build_vars.size());
+    }
+    for (auto& [key, value] : hash_table) {
+        auto row = value.head;
+        while (row != nullptr) {
+            radix_table->add(key.start, row);
+            row = reinterpret_cast<uint64_t**>(row)[build_vars.size()];
+        }
+    }
+    clear_hash_table();
+    use_radix_table = true;
+}
+
 template<std::size_t N>
 void Join<N>::build_hash_table()
 {
     auto data_tuple_size = build_vars.size() + 1;
 
+    use_radix_table = false;
+    if (radix_table != nullptr) {
+        radix_table->clear();
+    }
+    uint64_t build_rows = 0;
+
+    // used to add the rows to radix_table
+    uint64_t radix_key[N];
+    std::vector<uint64_t> radix_data(build_vars.size());
+
     // Only to avoid seg fault in fist iteration due to Key comparision
     std::array<uint64_t, N> dummy_last_key;
     for (size_t i = 0; i < N; i++) {
@@ -188,67 +331,138 @@ void Join<N>::build_hash_table()
     Key<N> last_key(dummy_last_key.data());
     Value* last_value = nullptr;
 
-    while (build_rel->next()) {
-        // Get start index to store key and data
-        auto start_key_index = key_chunk_index * N;
-        auto start_data_index = data_chunk_index * data_tuple_size;
+    while (build_rel->next_batch(*build_batch) > 0) {
+        for (uint_fast32_t b = 0; b < build_batch->selected; b++) {
+            build_batch->load_row(build_batch->selection[b], *parent_binding);
 
-        key.start = &key_chunk[start_key_index];
-        // Store key
-        for (size_t i = 0; i < N; i++) {
-            key_chunk[start_key_index + i] = (*parent_binding)[join_vars[i]].id;
-        }
-        // Store data
-        for (size_t i = 0; i < build_vars.size(); i++) {
-            data_chunk[start_data_index + i] = (*parent_binding)[build_vars[i]].id;
-        }
-        // Set last data value as a null pointer
-        auto casted_chunk = reinterpret_cast<uint64_t**>(data_chunk);
-        casted_chunk[start_data_index + build_vars.size()] = nullptr;
-
-        // Store pointer to the begin of the new row of data added
-        auto data_pointer = &(data_chunk[start_data_index]);
-
-        // Check if data chunk is full and add a new one if is needed
-        data_chunk_index++;
-        if (data_chunk_index == PPage::SIZE) {
-            data_chunk = new uint64_t[data_tuple_size * PPage::SIZE];
-            data_chunks_dir.push_back(data_chunk);
-            data_chunk_index = 0;
-        }
+            // Past RADIX_TABLE_MIN_BYTES the rows are moved to radix_table
+            if (!use_radix_table) {
+                build_rows++;
+                if (build_rows * (N + data_tuple_size) * sizeof(uint64_t) > RADIX_TABLE_MIN_BYTES) {
+                    switch_to_radix_table();
+                }
+            }
+            if (use_radix_table) {
+                for (size_t i = 0; i < N; i++) {
+                    radix_key[i] = (*parent_binding)[join_vars[i]].id;
+                }
+                for (size_t i = 0; i < build_vars.size(); i++) {
+                    radix_data[i] = (*parent_binding)[build_vars[i]].id;
+                }
+                radix_table->add(radix_key, radix_data.data());
+                continue;
+            }
 
-        // Check if last key is equal to current key that will be added
-        if (key == last_key) {
-            // If are equal, only update new value and pass to the next row
-            auto casted_tail = reinterpret_cast<uint64_t**>(last_value->tail);
-            casted_tail[build_vars.size()] = data_pointer;
-            last_value->tail = data_pointer;
-            continue;
-        } else {
-            // If not are the same, update chunk index
-            // and check if key chunk is full
-            key_chunk_index++;
-            if (key_chunk_index == PPage::SIZE) {
-                key_chunk = new uint64_t[N * PPage::SIZE];
-                key_chunks_dir.push_back(key_chunk);
-                key_chunk_index = 0;
+            // Get start index to store key and data
+            auto start_key_index = key_chunk_index * N;
+            auto start_data_index = data_chunk_index * data_tuple_size;
+
+            key.start = &key_chunk[start_key_index];
+            // Store key
+            for (size_t i = 0; i < N; i++) {
+                key_chunk[start_key_index + i] = (*parent_binding)[join_vars[i]].id;
+            }
+            // Store data
+            for (size_t i = 0; i < build_vars.size(); i++) {
+                data_chunk[start_data_index + i] = (*parent_binding)[build_vars[i]].id;
+            }
+            // Set last data value as a null pointer
+            auto casted_chunk = reinterpret_cast<uint64_t**>(data_chunk);
+            casted_chunk[start_data_index + build_vars.size()] = nullptr;
+
+            // Store pointer to the begin of the new row of data added
+            auto data_pointer = &(data_chunk[start_data_index]);
+
+            // Check if data chunk is full and add a new one if is needed
+            data_chunk_index++;
+            if (data_chunk_index == PPage::SIZE) {
+                data_chunk = new uint64_t[data_tuple_size * PPage::SIZE];
+                data_chunks_dir.push_back(data_chunk);
+                data_chunk_index = 0;
             }
 
-            // Try to create a new entry in the hash table
-            auto iterator = hash_table.emplace(key, Value(data_pointer, data_pointer));
-            // If the key already has been inserted, iterator.second = false
-            if (!(iterator.second)) {
-                // If the key already exists, get the value of the hash table
-                // and make an append in the linked list
-                auto casted_tail = reinterpret_cast<uint64_t**>(iterator.first->second.tail);
+            // Check if last key is equal to current key that will be added
+            if (key == last_key) {
+                // If are equal, only update new value and pass to the next row
+                auto casted_tail = reinterpret_cast<uint64_t**>(last_value->tail);
                 casted_tail[build_vars.size()] = data_pointer;
-                iterator.first->second.tail = data_pointer;
+                last_value->tail = data_pointer;
+                continue;
+            } else {
+                // If not are the same, update chunk index
+                // and check if key chunk is full
+                key_chunk_index++;
+                if (key_chunk_index == PPage::SIZE) {
+                    key_chunk = new uint64_t[N * PPage::SIZE];
+                    key_chunks_dir.push_back(key_chunk);
+                    key_chunk_index = 0;
+                }
+
+                // Try to create a new entry in the hash table
+                auto iterator = hash_table.emplace(key, Value(data_pointer, data_pointer));
+                // If the key already has been inserted, iterator.second = false
+                if (!(iterator.second)) {
+                    // If the key already exists, get the value of the hash table
+                    // and make an append in the linked list
+                    auto casted_tail = reinterpret_cast<uint64_t**>(iterator.first->second.tail);
+                    casted_tail[build_vars.size()] = data_pointer;
+                    iterator.first->second.tail = data_pointer;
+                }
+                // Update last_key and last value
+                last_value = &iterator.first->second;
+                last_key.start = key.start;
             }
-            // Update last_key and last value
-            last_value = &iterator.first->second;
-            last_key.start = key.start;
         }
     }
+
+    if (use_radix_table) {
+        radix_table->build();
+    }
+}
+
+template<std::size_t N>
+void Join<N>::fill_runtime_filters()
+{
+    if (runtime_filters.empty()) {
+        return;
+    }
+    if (use_radix_table) {
+        for (auto& [pos, filter] : runtime_filters) {
+            filter->clear(radix_table->key_count());
+        }
+        radix_table->for_each_key([&](const uint64_t* key) {
+            for (auto& [pos, filter] : runtime_filters) {
+                filter->add(key[pos]);
+            }
+        });
+        return;
+    }
+    for (auto& [pos, filter] : runtime_filters) {
+        filter->clear(hash_table.size());
+    }
+    for (auto& [key, value] : hash_table) {
+        for (auto& [pos, filter] : runtime_filters) {
+            filter->add(key.start[pos]);
+        }
+    }
+}
+
+template<std::size_t N>
+void Join<N>::print(std::ostream& os, int indent, bool stats) const
+{
+    if (stats) {
+        print_generic_stats(os, indent);
+    }
+    os << std::string(indent, ' ') << "HashJoin::BGP::InMemory::Join(join_vars:";
+    for (auto& var : join_vars) {
+        os << " " << var;
+    }
+    if (stats && use_radix_table) {
+        os << " radix_partitions: " << radix_table->partition_count();
+    }
+    os << ")\n";
+    build_rel->print(os, indent + 2, stats);
+    probe_rel->print(os, indent + 2, stats);
 }
 
 template class HashJoin::BGP::InMemory::Join<2>;
@@ -1,17 +1,28 @@
 #pragma once
 
 #include <memory>
+#include <utility>
 #include <vector>
 #include <boost/unordered/unordered_flat_map.hpp>
 
 #include "query/executor/binding_iter.h"
 #include "query/executor/binding_iter/hash_join/value.h"
 #include "query/executor/binding_iter/hash_join/bgp/base.h"
+#include "query/executor/binding_iter/hash_join/bgp/radix_hash_table.h"
 
 namespace HashJoin { namespace BGP { namespace InMemory {
 
+// While the build relation is smaller than RADIX_TABLE_MIN_BYTES it is stored
+// in a boost::unordered_flat_map. Past that size the rows are moved to a
+// RadixHashTable, whose partitions fit in the L2 cache, and the probes of
+// _next_batch prefetch the buckets of the following rows.
 template<std::size_t N> class Join : public BindingIter {
 public:
+    static constexpr uint64_t RADIX_TABLE_MIN_BYTES = 1024 * 1024;
+
+    // number of probe rows between the prefetch of a bucket and its probe
+    static constexpr uint_fast32_t PREFETCH_DISTANCE = 16;
+
     Join(
         std::unique_ptr<BindingIter> build_rel,
         std::unique_ptr<BindingIter> probe_rel,
@@ -24,6 +35,7 @@ public:
     void print(std::ostream& os, int indent, bool stats) const override;
     void _begin(Binding& parent_binding) override;
     bool _next() override;
+    uint_fast32_t _next_batch(BindingBatch& batch) override;
     void _reset() override;
     void assign_nulls() override;
 
@@ -32,12 +44,26 @@ public:
     std::unique_ptr<BindingIter> build_rel;
 
 private:
+    // filters of the join vars pushed into probe_rel, filled with the keys of
+    // the hash table before probe_rel is started
+    // (position in join_vars, filter)
+    std::vector<std::pair<size_t, std::unique_ptr<RuntimeFilter>>> runtime_filters;
+
     std::vector<VarId> join_vars;
     std::vector<VarId> build_vars;
     std::vector<VarId> probe_vars;
 
     Binding* parent_binding;
 
+    // build_rel and probe_rel are read with next_batch
+    std::unique_ptr<BindingBatch> build_batch;
+    std::unique_ptr<BindingBatch> probe_batch;
+
+    // position in the selection of probe_batch of the next probe row, used by _next_batch
+    uint_fast32_t probe_pos;
+    // row of probe_batch being enumerated
+    uint_fast32_t probe_row;
+
     // When a key of Probe is found in hash table, the algorithm enters in
     // a 'enumerating state' (enumerating row != nullptr),
     // it means that in each next call a row stored in the
@@ -62,6 +88,27 @@ private:
                                    HashJoin::BGP::Hasher<N>> hash_table;
     void build_hash_table();
 
+    void clear_hash_table();
+
+    // moves the rows of hash_table to radix_table
+    void switch_to_radix_table();
+
+    void fill_runtime_filters();
+
+    // used instead of hash_table when use_radix_table is true
+    std::unique_ptr<RadixHashTable<N>> radix_table;
+    bool use_radix_table = false;
+
+    // hashes of the probe keys of probe_batch, by position in its selection
+    std::vector<uint64_t> probe_hashes;
+
+    // finds the build rows of probe_key, probe_pos being the position
+    // after the probe row when it is called from _next_batch
+    uint64_t* find_build_rows(bool from_batch);
+
+    // computes probe_hashes and prefetches the buckets of the first rows
+    void hash_probe_batch();
+
     // probe key: Avoid to ask for an uint64 array in each next call
     uint64_t pk_start [N];
     uint64_t last_pk_start[N];
@@ -25,6 +25,11 @@ Join1Var::Join1Var(
     data_chunk = new uint64_t[(build_vars.size() + 1) * PPage::SIZE];
     data_chunks_dir.push_back(data_chunk);
     data_chunk_index = 0;
+
+    auto filter = make_unique<RuntimeFilter>(join_var);
+    if (probe_rel->push_runtime_filter(*filter)) {
+        runtime_filter = std::move(filter);
+    }
 }
 
 Join1Var::~Join1Var()
@@ -53,9 +58,11 @@ void Join1Var::_begin(Binding& _parent_binding)
 
     this->parent_binding = &_parent_binding;
     build_rel->begin(_parent_binding);
-    probe_rel->begin(_parent_binding);
-
     build_hash_table();
+    fill_runtime_filter();
+
+    // the probe starts after the build to use the runtime filter
+    probe_rel->begin(_parent_binding);
 }
 
 bool Join1Var::_next()
@@ -101,9 +108,10 @@ void Join1Var::_reset()
 
     // Spread reset to children
     build_rel->reset();
-    probe_rel->reset();
-
     build_hash_table();
+    fill_runtime_filter();
+
+    probe_rel->reset();
 }
 
 void Join1Var::assign_nulls()
@@ -145,3 +153,14 @@ void Join1Var::build_hash_table()
         }
     }
 }
+
+void Join1Var::fill_runtime_filter()
+{
+    if (runtime_filter == nullptr) {
+        return;
+    }
+    runtime_filter->clear(hash_table.size());
+    for (auto& [key, value] : hash_table) {
+        runtime_filter->add(key.id);
+    }
+}
@@ -52,5 +52,10 @@ private:
                               HashJoin::Value,
                               HashJoin::BGP::ObjectIdHasher> hash_table;
     void build_hash_table();
+
+    // filter of join_var pushed into probe_rel, nullptr if it was not accepted
+    std::unique_ptr<RuntimeFilter> runtime_filter;
+
+    void fill_runtime_filter();
 };
 }}}
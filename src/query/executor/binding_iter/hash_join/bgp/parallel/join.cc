@@ -0,0 +1,298 @@
+#include "join.h"
+
+#include "query/executor/binding_iter/gather.h"
+#include "query/executor/binding_iter/hash_join/bgp/parallel/probe.h"
+
+using namespace std;
+using namespace HashJoin::BGP;
+using namespace HashJoin::BGP::Parallel;
+
+template<std::size_t M>
+class IndexBuildScans : public BuildScans {
+public:
+    std::vector<unique_ptr<IndexScan<M>>> scans;
+
+    uint64_t count_morsels(Binding& parent_binding) override
+    {
+        auto total = scans[0]->count_records(parent_binding);
+        return (total + Gather<M>::MORSEL_SIZE - 1) / Gather<M>::MORSEL_SIZE;
+    }
+
+    BindingIter& get_morsel(uint_fast32_t i, uint64_t morsel) override
+    {
+        scans[i]->offset = morsel * Gather<M>::MORSEL_SIZE;
+        scans[i]->limit = Gather<M>::MORSEL_SIZE;
+        return *scans[i];
+    }
+
+    void clear_morsels() override
+    {
+        for (auto& scan : scans) {
+            scan->offset = 0;
+            scan->limit = UINT64_MAX;
+        }
+    }
+
+    const BindingIter& get(uint_fast32_t i) const override
+    {
+        return *scans[i];
+    }
+};
+
+// If build_rel is an IndexScan<M>, returns `threads` copies of it
+template<std::size_t M>
+unique_ptr<BuildScans> try_make_build_scans(BindingIter& build_rel, uint_fast32_t threads)
+{
+    auto index_scan = dynamic_cast<IndexScan<M>*>(&build_rel);
+    if (index_scan == nullptr || index_scan->offset != 0) {
+        return nullptr;
+    }
+    auto res = make_unique<IndexBuildScans<M>>();
+    for (uint_fast32_t i = 0; i < threads; i++) {
+        res->scans.push_back(index_scan->clone());
+    }
+    return res;
+}
+
+// If probe_rel is an IndexScan<M> it is replaced by a Gather of `threads`
+// Probes, each one reading its own copy of the scan
+template<std::size_t M, std::size_t N>
+bool try_make_parallel_probe(
+    unique_ptr<BindingIter>& probe_rel,
+    const PartitionedHashTable<N>& hash_table,
+    const vector<VarId>& join_vars,
+    const vector<VarId>& build_vars,
+    uint_fast32_t threads
+)
+{
+    auto index_scan = dynamic_cast<IndexScan<M>*>(probe_rel.get());
+    if (index_scan == nullptr || index_scan->offset != 0) {
+        return false;
+    }
+    vector<unique_ptr<BindingIter>> pipelines;
+    vector<IndexScan<M>*> scans;
+    for (uint_fast32_t i = 0; i < threads; i++) {
+        auto scan = index_scan->clone();
+        scans.push_back(scan.get());
+        pipelines.push_back(make_unique<Probe<N>>(std::move(scan), hash_table, join_vars, build_vars));
+    }
+    probe_rel = make_unique<Gather<M>>(std::move(pipelines), std::move(scans));
+    return true;
+}
+
+template<std::size_t N>
+Join<N>::Join(
+    unique_ptr<BindingIter> _build_rel,
+    unique_ptr<BindingIter> _probe_rel,
+    vector<VarId>&& _join_vars,
+    vector<VarId>&& _build_vars,
+    uint_fast32_t _threads
+) :
+    build_rel(std::move(_build_rel)),
+    probe_rel(std::move(_probe_rel)),
+    join_vars(std::move(_join_vars)),
+    build_vars(std::move(_build_vars)),
+    threads(_threads)
+{
+    if (threads > 1) {
+        build_scans = try_make_build_scans<1>(*build_rel, threads);
+        if (build_scans == nullptr) build_scans = try_make_build_scans<2>(*build_rel, threads);
+        if (build_scans == nullptr) build_scans = try_make_build_scans<3>(*build_rel, threads);
+        if (build_scans == nullptr) build_scans = try_make_build_scans<4>(*build_rel, threads);
+    }
+    hash_table = make_unique<PartitionedHashTable<N>>(build_vars.size(), build_scans != nullptr ? threads : 1);
+
+    if (threads > 1
+        && (try_make_parallel_probe<1>(probe_rel, *hash_table, join_vars, build_vars, threads)
+            || try_make_parallel_probe<2>(probe_rel, *hash_table, join_vars, build_vars, threads)
+            || try_make_parallel_probe<3>(probe_rel, *hash_table, join_vars, build_vars, threads)
+            || try_make_parallel_probe<4>(probe_rel, *hash_table, join_vars, build_vars, threads)))
+    {
+        push_runtime_filters();
+        return;
+    }
+    probe_rel = make_unique<Probe<N>>(std::move(probe_rel), *hash_table, join_vars, build_vars);
+    push_runtime_filters();
+}
+
+template<std::size_t N>
+void Join<N>::push_runtime_filters()
+{
+    for (size_t i = 0; i < N; i++) {
+        auto filter = make_unique<RuntimeFilter>(join_vars[i]);
+        if (probe_rel->push_runtime_filter(*filter)) {
+            runtime_filters.push_back({ i, std::move(filter) });
+        }
+    }
+}
+
+template<std::size_t N>
+void Join<N>::fill_runtime_filters()
+{
+    if (runtime_filters.empty()) {
+        return;
+    }
+    auto keys = hash_table->key_count();
+    for (auto& [pos, filter] : runtime_filters) {
+        filter->clear(keys);
+    }
+    hash_table->for_each_key([&](const Key<N>& key) {
+        for (auto& [pos, filter] : runtime_filters) {
+            filter->add(key.start[pos]);
+        }
+    });
+}
+
+template<std::size_t N>
+void Join<N>::_begin(Binding& _parent_binding)
+{
+    this->parent_binding = &_parent_binding;
+    if (build_scans != nullptr) {
+        while (build_bindings.size() < threads) {
+            build_bindings.push_back(make_unique<Binding>(_parent_binding.size));
+            build_batches.push_back(make_unique<BindingBatch>(_parent_binding.size));
+        }
+    } else {
+        if (build_batch == nullptr) {
+            build_batch = make_unique<BindingBatch>(_parent_binding.size);
+        }
+        build_rel->begin(_parent_binding);
+    }
+    build_hash_table();
+    fill_runtime_filters();
+
+    // the probes start after the table is built, as they only read it
+    probe_rel->begin(_parent_binding);
+}
+
+template<std::size_t N>
+void Join<N>::_reset()
+{
+    if (build_scans == nullptr) {
+        build_rel->reset();
+    }
+    build_hash_table();
+    fill_runtime_filters();
+
+    probe_rel->reset();
+}
+
+template<std::size_t N>
+bool Join<N>::_next()
+{
+    return probe_rel->next();
+}
+
+template<std::size_t N>
+uint_fast32_t Join<N>::_next_batch(BindingBatch& batch)
+{
+    return probe_rel->next_batch(batch);
+}
+
+template<std::size_t N>
+void Join<N>::assign_nulls()
+{
+    // the probes assign the nulls of build_vars
+    probe_rel->assign_nulls();
+}
+
+template<std::size_t N>
+void Join<N>::build_hash_table()
+{
+    hash_table->clear();
+
+    if (build_scans != nullptr) {
+        build_morsels = build_scans->count_morsels(*parent_binding);
+        next_build_morsel = 0;
+        for (auto& binding : build_bindings) {
+            binding->add_all(*parent_binding);
+        }
+        helpers.start(threads, [this](uint_fast32_t i) { read_build_morsels(i); });
+        try {
+            helpers.wait();
+        } catch (...) {
+            build_scans->clear_morsels();
+            throw;
+        }
+        build_scans->clear_morsels();
+        hash_table->build(helpers, threads);
+        return;
+    }
+
+    uint64_t key[N];
+    vector<uint64_t> data(build_vars.size());
+
+    while (build_rel->next_batch(*build_batch) > 0) {
+        for (uint_fast32_t b = 0; b < build_batch->selected; b++) {
+            build_batch->load_row(build_batch->selection[b], *parent_binding);
+
+            for (size_t i = 0; i < N; i++) {
+                key[i] = (*parent_binding)[join_vars[i]].id;
+            }
+            for (size_t i = 0; i < build_vars.size(); i++) {
+                data[i] = (*parent_binding)[build_vars[i]].id;
+            }
+            hash_table->add(key, data.data());
+        }
+    }
+    hash_table->build(helpers, threads);
+}
+
+template<std::size_t N>
+void Join<N>::read_build_morsels(uint_fast32_t i)
+{
+    auto& binding = *build_bindings[i];
+    auto& batch = *build_batches[i];
+
+    uint64_t key[N];
+    vector<uint64_t> data(build_vars.size());
+
+    bool begun = false;
+    for (auto morsel = next_build_morsel++; morsel < build_morsels; morsel = next_build_morsel++) {
+        auto& scan = build_scans->get_morsel(i, morsel);
+        if (begun) {
+            scan.reset();
+        } else {
+            scan.begin(binding);
+            begun = true;
+        }
+
+        while (scan.next_batch(batch) > 0) {
+            for (uint_fast32_t b = 0; b < batch.selected; b++) {
+                batch.load_row(batch.selection[b], binding);
+
+                for (size_t k = 0; k < N; k++) {
+                    key[k] = binding[join_vars[k]].id;
+                }
+                for (size_t k = 0; k < build_vars.size(); k++) {
+                    data[k] = binding[build_vars[k]].id;
+                }
+                hash_table->add(key, data.data(), i);
+            }
+        }
+    }
+}
+
+template<std::size_t N>
+void Join<N>::print(std::ostream& os, int indent, bool stats) const
+{
+    if (stats) {
+        print_generic_stats(os, indent);
+    }
+    os << std::string(indent, ' ') << "HashJoin::BGP::Parallel::Join(threads: " << threads;
+    if (stats) {
+        os << " build_rows: " << hash_table->size();
+    }
+    os << ")\n";
+    if (build_scans != nullptr) {
+        build_scans->get(0).print(os, indent + 2, stats);
+    } else {
+        build_rel->print(os, indent + 2, stats);
+    }
+    probe_rel->print(os, indent + 2, stats);
+}
+
+template class HashJoin::BGP::Parallel::Join<1>;
+template class HashJoin::BGP::Parallel::Join<2>;
+template class HashJoin::BGP::Parallel::Join<3>;
+template class HashJoin::BGP::Parallel::Join<4>;
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "query/executor/binding_iter.h"
+#include "query/executor/binding_iter/hash_join/bgp/partitioned_hash_table.h"
+#include "query/executor/helper_threads.h"
+
+namespace HashJoin { namespace BGP { namespace Parallel {
+// Copies of a build relation that is an IndexScan, read a morsel at a time
+// by different threads (see Gather)
+class BuildScans {
+public:
+    virtual ~BuildScans() = default;
+
+    virtual uint64_t count_morsels(Binding& parent_binding) = 0;
+
+    // sets the offset and limit of the copy `i` to read the morsel
+    virtual BindingIter& get_morsel(uint_fast32_t i, uint64_t morsel) = 0;
+
+    // removes the offset and limit of the copies
+    virtual void clear_morsels() = 0;
+
+    virtual const BindingIter& get(uint_fast32_t i) const = 0;
+};
+
+/*
+In-memory hash join using up to `threads` threads.
+
+The build relation is partitioned into a PartitionedHashTable, whose
+partitions are then inserted in their hash tables concurrently. If the build
+relation is an IndexScan, it is split in morsels read by `threads` copies of
+the scan, each one adding its rows to the table as a different writer,
+otherwise it is read by the calling thread. If the probe relation is an
+IndexScan, it is split in morsels read by `threads` copies of a Probe inside a
+Gather, otherwise it is probed by the calling thread.
+The threads are HelperThreads, so the relations read by them must not use
+private pages nor create temporal strings.
+*/
+template<std::size_t N> class Join : public BindingIter {
+public:
+    Join(
+        std::unique_ptr<BindingIter> build_rel,
+        std::unique_ptr<BindingIter> probe_rel,
+        std::vector<VarId>&&         join_vars,
+        std::vector<VarId>&&         build_vars,
+        uint_fast32_t                threads
+    );
+
+    void print(std::ostream& os, int indent, bool stats) const override;
+    void _begin(Binding& parent_binding) override;
+    bool _next() override;
+    uint_fast32_t _next_batch(BindingBatch& batch) override;
+    void _reset() override;
+    void assign_nulls() override;
+
+    std::unique_ptr<BindingIter> build_rel;
+
+    // a Probe, or a Gather of Probes
+    std::unique_ptr<BindingIter> probe_rel;
+
+private:
+    std::vector<VarId> join_vars;
+    std::vector<VarId> build_vars;
+
+    uint_fast32_t threads;
+
+    Binding* parent_binding;
+
+    std::unique_ptr<BindingBatch> build_batch;
+
+    // nullptr if build_rel is read by the calling thread
+    std::unique_ptr<BuildScans> build_scans;
+
+    // binding and batch of each thread reading build_scans
+    std::vector<std::unique_ptr<Binding>> build_bindings;
+    std::vector<std::unique_ptr<BindingBatch>> build_batches;
+
+    uint64_t build_morsels;
+    std::atomic<uint64_t> next_build_morsel;
+
+    // read build_scans and build the hash table, created once
+    HelperThreads helpers;
+
+    std::unique_ptr<PartitionedHashTable<N>> hash_table;
+
+    // (position in join_vars, filter) of the filters pushed into probe_rel,
+    // filled with the keys of the hash table before probe_rel is started
+    std::vector<std::pair<size_t, std::unique_ptr<RuntimeFilter>>> runtime_filters;
+
+    void build_hash_table();
+
+    // adds the rows of the morsels of build_scans read by the thread `i`
+    void read_build_morsels(uint_fast32_t i);
+
+    void push_runtime_filters();
+
+    void fill_runtime_filters();
+};
+}}}
@@ -0,0 +1,116 @@
+#include "probe.h"
+
+using namespace HashJoin::BGP::Parallel;
+
+template<std::size_t N>
+void Probe<N>::_begin(Binding& _parent_binding)
+{
+    this->parent_binding = &_parent_binding;
+    if (probe_batch == nullptr) {
+        probe_batch = std::make_unique<BindingBatch>(_parent_binding.size);
+    }
+    probe_batch->clear();
+    probe_pos = 0;
+    enumerating_rows = nullptr;
+
+    probe_rel->begin(_parent_binding);
+}
+
+template<std::size_t N>
+void Probe<N>::_reset()
+{
+    probe_batch->clear();
+    probe_pos = 0;
+    enumerating_rows = nullptr;
+
+    probe_rel->reset();
+}
+
+template<std::size_t N>
+uint64_t* Probe<N>::find_build_rows()
+{
+    for (size_t i = 0; i < N; i++) {
+        probe_key.start[i] = (*parent_binding)[join_vars[i]].id;
+    }
+    return hash_table.find(probe_key);
+}
+
+template<std::size_t N>
+bool Probe<N>::_next()
+{
+    while (enumerating_rows == nullptr) {
+        if (!probe_rel->next()) {
+            return false;
+        }
+        enumerating_rows = find_build_rows();
+    }
+    for (uint_fast32_t i = 0; i < build_vars.size(); i++) {
+        parent_binding->add(build_vars[i], ObjectId(enumerating_rows[i]));
+    }
+    enumerating_rows = reinterpret_cast<uint64_t**>(enumerating_rows)[build_vars.size()];
+    return true;
+}
+
+template<std::size_t N>
+uint_fast32_t Probe<N>::_next_batch(BindingBatch& batch)
+{
+    batch.clear();
+    while (batch.size < batch.max_size) {
+        if (enumerating_rows != nullptr) {
+            // output row: the probe row and the current enumerating row
+            for (auto var : probe_batch->get_assigned_vars()) {
+                batch.write_column(var)[batch.size] = probe_batch->column(var)[probe_row];
+            }
+            for (uint_fast32_t i = 0; i < build_vars.size(); i++) {
+                batch.write_column(build_vars[i])[batch.size] = ObjectId(enumerating_rows[i]);
+            }
+            batch.size++;
+            enumerating_rows = reinterpret_cast<uint64_t**>(enumerating_rows)[build_vars.size()];
+            continue;
+        }
+
+        if (probe_pos == probe_batch->selected) {
+            // next_batch() empties the batch also at the end, so the calls
+            // after the end must find the position at 0
+            probe_pos = 0;
+            if (probe_rel->next_batch(*probe_batch) == 0) {
+                break;
+            }
+        }
+        probe_row = probe_batch->selection[probe_pos++];
+        probe_batch->load_row(probe_row, *parent_binding);
+        enumerating_rows = find_build_rows();
+    }
+    batch.select_all();
+    return batch.size;
+}
+
+template<std::size_t N>
+void Probe<N>::assign_nulls()
+{
+    probe_rel->assign_nulls();
+    for (auto var : build_vars) {
+        parent_binding->add(var, ObjectId::get_null());
+    }
+}
+
+template<std::size_t N>
+bool Probe<N>::push_runtime_filter(const RuntimeFilter& filter)
+{
+    return probe_rel->push_runtime_filter(filter);
+}
+
+template<std::size_t N>
+void Probe<N>::print(std::ostream& os, int indent, bool stats) const
+{
+    if (stats) {
+        print_generic_stats(os, indent);
+    }
+    os << std::string(indent, ' ') << "HashJoin::BGP::Parallel::Probe()\n";
+    probe_rel->print(os, indent + 2, stats);
+}
+
+template class HashJoin::BGP::Parallel::Probe<1>;
+template class HashJoin::BGP::Parallel::Probe<2>;
+template class HashJoin::BGP::Parallel::Probe<3>;
+template class HashJoin::BGP::Parallel::Probe<4>;
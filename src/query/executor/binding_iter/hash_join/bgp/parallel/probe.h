@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "query/executor/binding_iter.h"
+#include "query/executor/binding_iter/hash_join/bgp/partitioned_hash_table.h"
+
+namespace HashJoin { namespace BGP { namespace Parallel {
+// Probe side of a parallel join: joins the results of probe_rel with the rows
+// of a hash table already built. It only reads the table, so several copies
+// can run at the same time inside a Gather, one per worker.
+template<std::size_t N> class Probe : public BindingIter {
+public:
+    Probe(
+        std::unique_ptr<BindingIter>        probe_rel,
+        const PartitionedHashTable<N>&      hash_table,
+        const std::vector<VarId>&           join_vars,
+        const std::vector<VarId>&           build_vars
+    ) :
+        probe_rel  (std::move(probe_rel)),
+        hash_table (hash_table),
+        join_vars  (join_vars),
+        build_vars (build_vars),
+        probe_key  (Key<N>(pk_start)) { }
+
+    void print(std::ostream& os, int indent, bool stats) const override;
+    void _begin(Binding& parent_binding) override;
+    bool _next() override;
+    uint_fast32_t _next_batch(BindingBatch& batch) override;
+    void _reset() override;
+    void assign_nulls() override;
+    bool push_runtime_filter(const RuntimeFilter& filter) override;
+
+    std::unique_ptr<BindingIter> probe_rel;
+
+private:
+    const PartitionedHashTable<N>& hash_table;
+
+    // owned by the Join, shared by all the copies
+    const std::vector<VarId>& join_vars;
+    const std::vector<VarId>& build_vars;
+
+    Binding* parent_binding;
+
+    std::unique_ptr<BindingBatch> probe_batch;
+
+    // position in the selection of probe_batch of the next probe row, used by _next_batch
+    uint_fast32_t probe_pos;
+    // row of probe_batch being enumerated
+    uint_fast32_t probe_row;
+
+    // data of the next build row to return with the current probe row
+    uint64_t* enumerating_rows;
+
+    uint64_t pk_start[N];
+    Key<N> probe_key;
+
+    // returns the first build row matching the probe row in parent_binding
+    uint64_t* find_build_rows();
+};
+}}}
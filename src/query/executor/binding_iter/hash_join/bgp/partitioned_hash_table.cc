@@ -0,0 +1,144 @@
+#include "partitioned_hash_table.h"
+
+#include <atomic>
+
+using namespace HashJoin;
+using namespace HashJoin::BGP;
+
+template<std::size_t N>
+PartitionedHashTable<N>::PartitionedHashTable(std::size_t data_size, uint_fast32_t writers) :
+    data_size(data_size),
+    partitions(PARTITIONS),
+    writer_total_rows(writers)
+{
+    for (auto& partition : partitions) {
+        partition.rows.resize(writers);
+    }
+}
+
+template<std::size_t N>
+PartitionedHashTable<N>::~PartitionedHashTable()
+{
+    for (auto& partition : partitions) {
+        for (auto& rows : partition.rows) {
+            for (auto chunk : rows.chunks_dir) {
+                delete[] (chunk);
+            }
+        }
+    }
+}
+
+template<std::size_t N>
+void PartitionedHashTable<N>::add(const uint64_t* key, const uint64_t* data, uint_fast32_t writer)
+{
+    auto& partition = partitions[get_partition(Key<N>(const_cast<uint64_t*>(key)))];
+    auto& rows = partition.rows[writer];
+
+    auto chunk = rows.rows / CHUNK_ROWS;
+    if (chunk == rows.chunks_dir.size()) {
+        rows.chunks_dir.push_back(new uint64_t[row_size() * CHUNK_ROWS]);
+    }
+    auto row = &rows.chunks_dir[chunk][(rows.rows % CHUNK_ROWS) * row_size()];
+    for (std::size_t i = 0; i < N; i++) {
+        row[i] = key[i];
+    }
+    for (std::size_t i = 0; i < data_size; i++) {
+        row[N + i] = data[i];
+    }
+    reinterpret_cast<uint64_t**>(row)[N + data_size] = nullptr;
+
+    rows.rows++;
+    writer_total_rows[writer]++;
+}
+
+template<std::size_t N>
+void PartitionedHashTable<N>::build_partition(Partition& partition)
+{
+    uint64_t partition_rows = 0;
+    for (auto& rows : partition.rows) {
+        partition_rows += rows.rows;
+    }
+    partition.hash_table.reserve(partition_rows);
+
+    for (auto& rows : partition.rows) {
+        for (uint64_t r = 0; r < rows.rows; r++) {
+            auto row = &rows.chunks_dir[r / CHUNK_ROWS][(r % CHUNK_ROWS) * row_size()];
+            auto data_pointer = row + N;
+
+            auto iterator = partition.hash_table.emplace(Key<N>(row), Value(data_pointer, data_pointer));
+            // If the key already exists, the row is appended to its linked list
+            if (!iterator.second) {
+                auto casted_tail = reinterpret_cast<uint64_t**>(iterator.first->second.tail);
+                casted_tail[data_size] = data_pointer;
+                iterator.first->second.tail = data_pointer;
+            }
+        }
+    }
+}
+
+template<std::size_t N>
+void PartitionedHashTable<N>::build(HelperThreads& helpers, uint_fast32_t threads)
+{
+    if (threads <= 1) {
+        for (auto& partition : partitions) {
+            build_partition(partition);
+        }
+        return;
+    }
+
+    // the partitions have different sizes, so each thread takes the next
+    // partition when it finishes the previous one
+    std::atomic<uint_fast32_t> next_partition(0);
+    auto build_partitions = [&]() {
+        for (auto p = next_partition++; p < PARTITIONS; p = next_partition++) {
+            build_partition(partitions[p]);
+        }
+    };
+
+    helpers.start(threads - 1, [&](uint_fast32_t) { build_partitions(); });
+    try {
+        build_partitions();
+    } catch (...) {
+        helpers.wait();
+        throw;
+    }
+    helpers.wait();
+}
+
+template<std::size_t N>
+uint64_t* PartitionedHashTable<N>::find(const Key<N>& key) const
+{
+    auto& hash_table = partitions[get_partition(key)].hash_table;
+    auto iterator = hash_table.find(key);
+    if (iterator == hash_table.end()) {
+        return nullptr;
+    }
+    return iterator->second.head;
+}
+
+template<std::size_t N>
+void PartitionedHashTable<N>::clear()
+{
+    for (auto& partition : partitions) {
+        partition.hash_table.clear();
+
+        for (auto& rows : partition.rows) {
+            // keep the first chunk to avoid an unnecessary request for space
+            for (size_t i = 1; i < rows.chunks_dir.size(); i++) {
+                delete[] (rows.chunks_dir[i]);
+            }
+            if (rows.chunks_dir.size() > 1) {
+                rows.chunks_dir.resize(1);
+            }
+            rows.rows = 0;
+        }
+    }
+    for (auto& rows : writer_total_rows) {
+        rows = 0;
+    }
+}
+
+template class HashJoin::BGP::PartitionedHashTable<1>;
+template class HashJoin::BGP::PartitionedHashTable<2>;
+template class HashJoin::BGP::PartitionedHashTable<3>;
+template class HashJoin::BGP::PartitionedHashTable<4>;
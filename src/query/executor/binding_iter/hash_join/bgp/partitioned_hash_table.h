@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include "query/executor/binding_iter/hash_join/value.h"
+#include "query/executor/binding_iter/hash_join/bgp/base.h"
+#include "query/executor/helper_threads.h"
+
+namespace HashJoin { namespace BGP {
+/*
+Hash table of a BGP hash join split in 2^PARTITION_BITS partitions by the hash
+of the key, so the partitions can be built concurrently and then probed by
+several threads without synchronization.
+
+Rows are appended with add() by up to `writers` threads, each one with its own
+writer index. Each partition stores the rows of each writer in its own chunks
+as [key | data | next], so the writers don't need synchronization. build()
+inserts the rows of the partitions in their hash tables, a partition at a time
+per thread. After build() the table is read-only and find() is thread-safe.
+*/
+template<std::size_t N>
+class PartitionedHashTable {
+public:
+    static constexpr uint_fast32_t PARTITION_BITS = 6;
+    static constexpr uint_fast32_t PARTITIONS = 1 << PARTITION_BITS;
+
+    // rows stored in each chunk of a partition
+    static constexpr uint64_t CHUNK_ROWS = 4096;
+
+    PartitionedHashTable(std::size_t data_size, uint_fast32_t writers = 1);
+
+    ~PartitionedHashTable();
+
+    // Stores a row, data has data_size values. Different writers can add
+    // rows at the same time
+    void add(const uint64_t* key, const uint64_t* data, uint_fast32_t writer = 0);
+
+    // Inserts the stored rows in the hash tables using this thread and up
+    // to `threads - 1` helpers
+    void build(HelperThreads& helpers, uint_fast32_t threads);
+
+    // Returns the data of the first row with the key, the data of the next
+    // row is at reinterpret_cast<uint64_t**>(data)[data_size]. nullptr if
+    // the key is not present
+    uint64_t* find(const Key<N>& key) const;
+
+    // Removes all the rows
+    void clear();
+
+    uint64_t size() const
+    {
+        uint64_t res = 0;
+        for (auto rows : writer_total_rows) {
+            res += rows;
+        }
+        return res;
+    }
+
+    // number of distinct keys, after build()
+    uint64_t key_count() const
+    {
+        uint64_t res = 0;
+        for (auto& partition : partitions) {
+            res += partition.hash_table.size();
+        }
+        return res;
+    }
+
+    // calls func(const Key<N>&) for each distinct key, after build()
+    template<typename Func>
+    void for_each_key(Func func) const
+    {
+        for (auto& partition : partitions) {
+            for (auto& [key, value] : partition.hash_table) {
+                func(key);
+            }
+        }
+    }
+
+    const std::size_t data_size;
+
+private:
+    struct Rows {
+        std::vector<uint64_t*> chunks_dir;
+        uint64_t rows = 0;
+    };
+
+    struct Partition {
+        // rows[i] has the rows added by the writer i
+        std::vector<Rows> rows;
+
+        boost::unordered_flat_map<Key<N>, Value, Hasher<N>> hash_table;
+    };
+
+    std::vector<Partition> partitions;
+
+    // rows added by each writer
+    std::vector<uint64_t> writer_total_rows;
+
+    // [key | data | next]
+    inline std::size_t row_size() const {
+        return N + data_size + 1;
+    }
+
+    // The hash of Hasher<1> is the key itself, so it is mixed before
+    // taking its highest bits as the partition
+    static inline uint_fast32_t get_partition(const Key<N>& key) {
+        return (Hasher<N>()(key) * 0x9E3779B97F4A7C15ULL) >> (64 - PARTITION_BITS);
+    }
+
+    void build_partition(Partition& partition);
+};
+}}
@@ -0,0 +1,146 @@
+#include "radix_hash_table.h"
+
+using namespace HashJoin;
+using namespace HashJoin::BGP;
+
+template<std::size_t N>
+RadixHashTable<N>::RadixHashTable(std::size_t data_size) :
+    data_size(data_size)
+{
+    clear();
+}
+
+template<std::size_t N>
+void RadixHashTable<N>::add(const uint64_t* key, const uint64_t* data)
+{
+    staged_rows.insert(staged_rows.end(), key, key + N);
+    staged_rows.insert(staged_rows.end(), data, data + data_size);
+    staged_hashes.push_back(hash(key));
+    total_rows++;
+}
+
+template<std::size_t N>
+void RadixHashTable<N>::build()
+{
+    auto staged_row_size = N + data_size;
+
+    partition_bits = 0;
+    while (partition_bits < MAX_PARTITION_BITS
+           && (total_rows * row_size() * sizeof(uint64_t) >> partition_bits) > PARTITION_BYTES)
+    {
+        partition_bits++;
+    }
+    auto partition_count = 1ULL << partition_bits;
+
+    // radix cluster: count the rows of each partition and copy them to
+    // their positions
+    std::vector<uint64_t> offsets(partition_count + 1, 0);
+    for (uint64_t r = 0; r < total_rows; r++) {
+        offsets[get_partition(staged_hashes[r]) + 1]++;
+    }
+    for (uint64_t p = 0; p < partition_count; p++) {
+        offsets[p + 1] += offsets[p];
+    }
+
+    rows.resize(total_rows * row_size());
+    std::vector<uint64_t> positions(offsets.begin(), offsets.end() - 1);
+    for (uint64_t r = 0; r < total_rows; r++) {
+        auto src = &staged_rows[r * staged_row_size];
+        auto dst = &rows[positions[get_partition(staged_hashes[r])]++ * row_size()];
+        for (std::size_t i = 0; i < staged_row_size; i++) {
+            dst[i] = src[i];
+        }
+    }
+
+    // a partition has enough buckets to keep them at most 3/4 full
+    partitions.resize(partition_count);
+    uint64_t bucket_count = 0;
+    for (uint64_t p = 0; p < partition_count; p++) {
+        auto partition_rows = offsets[p + 1] - offsets[p];
+        uint64_t partition_buckets = 1;
+        while (partition_buckets * BUCKET_SLOTS * 3 < partition_rows * 4) {
+            partition_buckets *= 2;
+        }
+        partitions[p].first_bucket = bucket_count;
+        partitions[p].bucket_mask = partition_buckets - 1;
+        bucket_count += partition_buckets;
+    }
+    buckets.assign(bucket_count, Bucket { 0, {} });
+
+    total_keys = 0;
+    for (uint64_t p = 0; p < partition_count; p++) {
+        build_partition(p, offsets[p], offsets[p + 1]);
+    }
+
+    // the staged rows are not needed until the next build, but the space is kept
+    staged_rows.clear();
+    staged_hashes.clear();
+}
+
+template<std::size_t N>
+void RadixHashTable<N>::build_partition(uint_fast32_t p, uint64_t begin, uint64_t end)
+{
+    auto& partition = partitions[p];
+
+    for (uint64_t r = begin; r < end; r++) {
+        auto row = &rows[r * row_size()];
+        auto hash_value = hash(row);
+        auto tag = get_tag(hash_value);
+        auto b = get_bucket(hash_value, partition);
+
+        while (true) {
+            auto& bucket = buckets[partition.first_bucket + b];
+
+            auto matches = zero_bytes(bucket.tags ^ (TAG_LSB * tag));
+            while (matches != 0) {
+                auto slot = MDB_COUNT_TRAILING_ZEROS_64(matches) >> 3;
+                if (equal_key(bucket.rows[slot], row)) {
+                    break;
+                }
+                matches &= matches - 1;
+            }
+            if (matches != 0) {
+                // the row is added as the second of the list of the key,
+                // as the head is the one in the slot
+                auto head = bucket.rows[MDB_COUNT_TRAILING_ZEROS_64(matches) >> 3];
+                auto head_next = reinterpret_cast<uint64_t**>(head + N) + data_size;
+                reinterpret_cast<uint64_t**>(row + N)[data_size] = *head_next;
+                *head_next = row + N;
+                break;
+            }
+
+            auto empty = zero_bytes(bucket.tags);
+            if (empty != 0) {
+                auto slot = MDB_COUNT_TRAILING_ZEROS_64(empty) >> 3;
+                bucket.tags |= tag << (8 * slot);
+                bucket.rows[slot] = row;
+                reinterpret_cast<uint64_t**>(row + N)[data_size] = nullptr;
+                total_keys++;
+                break;
+            }
+            b = (b + 1) & partition.bucket_mask;
+        }
+    }
+}
+
+template<std::size_t N>
+void RadixHashTable<N>::clear()
+{
+    staged_rows.clear();
+    staged_hashes.clear();
+    rows.clear();
+
+    // an empty table has one partition with one empty bucket, so find()
+    // doesn't need to check if the table was built
+    partition_bits = 0;
+    partitions.assign(1, Partition { 0, 0 });
+    buckets.assign(1, Bucket { 0, {} });
+
+    total_rows = 0;
+    total_keys = 0;
+}
+
+template class HashJoin::BGP::RadixHashTable<1>;
+template class HashJoin::BGP::RadixHashTable<2>;
+template class HashJoin::BGP::RadixHashTable<3>;
+template class HashJoin::BGP::RadixHashTable<4>;
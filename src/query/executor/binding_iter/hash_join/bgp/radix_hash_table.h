@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "macros/count_zeros.h"
+#include "macros/prefetch.h"
+#include "query/executor/binding_iter/hash_join/bgp/base.h"
+
+namespace HashJoin { namespace BGP {
+/*
+Hash table of a BGP hash join for build relations that don't fit in the L2
+cache.
+
+Rows are appended with add() and build() radix-clusters them by the highest
+bits of their hash, so the rows of a partition are contiguous and take about
+PARTITION_BYTES. Each partition has its own buckets, placed after the buckets
+of the previous partition, and is built a partition at a time, so the build
+only touches a cache-sized part of the table.
+
+A bucket has BUCKET_SLOTS slots and a word with a one-byte tag per slot, the
+highest bit set and 7 bits of the hash, or 0 if the slot is empty. A probe
+compares the tags of a bucket at once and only reads the rows whose tag is
+equal. Probing loops can call prefetch() with the hash of a key some rows
+before find().
+
+After build() the rows are stored as [key | data | next], as in
+PartitionedHashTable.
+*/
+template<std::size_t N>
+class RadixHashTable {
+public:
+    // target size of the rows of a partition
+    static constexpr uint64_t PARTITION_BYTES = 256 * 1024;
+
+    static constexpr uint_fast32_t MAX_PARTITION_BITS = 12;
+
+    static constexpr uint_fast32_t BUCKET_SLOTS = 8;
+
+    RadixHashTable(std::size_t data_size);
+
+    // Stores a row, data has data_size values
+    void add(const uint64_t* key, const uint64_t* data);
+
+    // Partitions the stored rows and inserts them in the buckets
+    void build();
+
+    // Removes all the rows
+    void clear();
+
+    static inline uint64_t hash(const uint64_t* key)
+    {
+        // The hash of Hasher<1> is the key itself, so it is mixed
+        return Hasher<N>()(Key<N>(const_cast<uint64_t*>(key))) * 0x9E3779B97F4A7C15ULL;
+    }
+
+    // Loads the first bucket of the hash in the cache, after build()
+    inline void prefetch(uint64_t hash) const
+    {
+        MDB_PREFETCH(&buckets[first_bucket(hash)]);
+    }
+
+    // Returns the data of the first row with the key, the data of the next
+    // row is at reinterpret_cast<uint64_t**>(data)[data_size]. nullptr if
+    // the key is not present
+    uint64_t* find(const uint64_t* key, uint64_t hash) const
+    {
+        auto& partition = partitions[get_partition(hash)];
+        auto tag_word = TAG_LSB * get_tag(hash);
+        auto b = get_bucket(hash, partition);
+        while (true) {
+            auto& bucket = buckets[partition.first_bucket + b];
+
+            auto matches = zero_bytes(bucket.tags ^ tag_word);
+            while (matches != 0) {
+                auto slot = MDB_COUNT_TRAILING_ZEROS_64(matches) >> 3;
+                auto row = bucket.rows[slot];
+                if (equal_key(row, key)) {
+                    return row + N;
+                }
+                matches &= matches - 1;
+            }
+            if (zero_bytes(bucket.tags) != 0) {
+                return nullptr;
+            }
+            b = (b + 1) & partition.bucket_mask;
+        }
+    }
+
+    uint64_t* find(const uint64_t* key) const
+    {
+        return find(key, hash(key));
+    }
+
+    uint64_t size() const { return total_rows; }
+
+    uint64_t key_count() const { return total_keys; }
+
+    uint_fast32_t partition_count() const { return partitions.size(); }
+
+    // calls func(const uint64_t* key) for each distinct key, after build()
+    template<typename Func>
+    void for_each_key(Func func) const
+    {
+        for (auto& bucket : buckets) {
+            for (uint_fast32_t slot = 0; slot < BUCKET_SLOTS; slot++) {
+                if ((bucket.tags >> (8 * slot)) & 0xFF) {
+                    func(bucket.rows[slot]);
+                }
+            }
+        }
+    }
+
+    const std::size_t data_size;
+
+private:
+    static constexpr uint64_t TAG_LSB = 0x0101010101010101ULL;
+    static constexpr uint64_t TAG_MSB = 0x8080808080808080ULL;
+
+    struct Bucket {
+        uint64_t tags;
+        uint64_t* rows[BUCKET_SLOTS];
+    };
+
+    struct Partition {
+        uint64_t first_bucket;
+        uint64_t bucket_mask;
+    };
+
+    // rows added since the last build, as [key | data]
+    std::vector<uint64_t> staged_rows;
+    std::vector<uint64_t> staged_hashes;
+
+    // rows ordered by partition, as [key | data | next]
+    std::vector<uint64_t> rows;
+
+    std::vector<Bucket> buckets;
+
+    std::vector<Partition> partitions;
+
+    uint_fast32_t partition_bits = 0;
+
+    uint64_t total_rows = 0;
+    uint64_t total_keys = 0;
+
+    inline std::size_t row_size() const {
+        return N + data_size + 1;
+    }
+
+    inline uint_fast32_t get_partition(uint64_t hash) const {
+        return partition_bits == 0 ? 0 : hash >> (64 - partition_bits);
+    }
+
+    static inline uint64_t get_tag(uint64_t hash) {
+        return (hash & 0x7F) | 0x80;
+    }
+
+    static inline uint64_t get_bucket(uint64_t hash, const Partition& partition) {
+        return (hash >> 7) & partition.bucket_mask;
+    }
+
+    inline uint64_t first_bucket(uint64_t hash) const {
+        auto& partition = partitions[get_partition(hash)];
+        return partition.first_bucket + get_bucket(hash, partition);
+    }
+
+    // has the highest bit set in each byte of x that is 0
+    static inline uint64_t zero_bytes(uint64_t x) {
+        return ~(((x & ~TAG_MSB) + ~TAG_MSB) | x | ~TAG_MSB);
+    }
+
+    static inline bool equal_key(const uint64_t* a, const uint64_t* b) {
+        for (std::size_t i = 0; i < N; i++) {
+            if (a[i] != b[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void build_partition(uint_fast32_t partition, uint64_t begin, uint64_t end);
+};
+}}
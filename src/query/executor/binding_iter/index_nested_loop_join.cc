@@ -5,6 +5,12 @@ void IndexNestedLoopJoin::_begin(Binding& parent_binding)
     this->parent_binding = &parent_binding;
 
     lhs->begin(parent_binding);
+    if (sorted_lhs.enabled()) {
+        sorted_lhs.reset();
+        rhs_begun = false;
+        return;
+    }
+
     if (lhs->next()) {
         rhs = original_rhs.get();
     } else {
@@ -15,6 +21,22 @@ void IndexNestedLoopJoin::_begin(Binding& parent_binding)
 
 bool IndexNestedLoopJoin::_next()
 {
+    if (sorted_lhs.enabled()) {
+        return sorted_lhs.next(
+            *lhs,
+            *parent_binding,
+            [this]() {
+                if (rhs_begun) {
+                    original_rhs->reset();
+                } else {
+                    original_rhs->begin(*parent_binding);
+                    rhs_begun = true;
+                }
+            },
+            [this]() { return original_rhs->next(); }
+        );
+    }
+
     while (true) {
         if (rhs->next()) {
             return true;
@@ -30,6 +52,11 @@ bool IndexNestedLoopJoin::_next()
 void IndexNestedLoopJoin::_reset()
 {
     lhs->reset();
+    if (sorted_lhs.enabled()) {
+        sorted_lhs.reset();
+        return;
+    }
+
     if (lhs->next()) {
         rhs = original_rhs.get();
         rhs->reset();
@@ -49,7 +76,11 @@ void IndexNestedLoopJoin::print(std::ostream& os, int indent, bool stats) const
     if (stats) {
         print_generic_stats(os, indent);
     }
-    os << std::string(indent, ' ') << "IndexNestedLoopJoin()\n";
+    os << std::string(indent, ' ') << "IndexNestedLoopJoin(";
+    if (sorted_lhs.enabled()) {
+        os << "sorted probes";
+    }
+    os << ")\n";
     lhs->print(os, indent + 2, stats);
     original_rhs->print(os, indent + 2, stats);
 }
@@ -4,7 +4,11 @@
 
 #include "query/executor/binding_iter.h"
 #include "query/executor/binding_iter/empty_binding_iter.h"
+#include "query/executor/binding_iter/sorted_probe_buffer.h"
 
+// If rhs is an IndexScan with variables of lhs as input, lhs is read in
+// batches and rhs is probed with the rows sorted by those variables (see
+// SortedProbeBuffer). The results are returned in the order of lhs.
 class IndexNestedLoopJoin : public BindingIter {
 public:
     IndexNestedLoopJoin(
@@ -12,7 +16,8 @@ public:
         std::unique_ptr<BindingIter> rhs
     ) :
         lhs           (std::move(lhs)),
-        original_rhs  (std::move(rhs)) { }
+        original_rhs  (std::move(rhs)),
+        sorted_lhs    (*original_rhs) { }
 
     void print(std::ostream& os, int indent, bool stats) const override;
 
@@ -30,4 +35,9 @@ private:
     Binding* parent_binding;
 
     EmptyBindingIter empty_iter;
+
+    SortedProbeBuffer sorted_lhs;
+
+    // false until rhs is begun with the first row of lhs, when sorted_lhs is enabled
+    bool rhs_begun;
 };
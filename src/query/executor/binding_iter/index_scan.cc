@@ -1,7 +1,20 @@
 #include "index_scan.h"
 
+#include <algorithm>
 #include <cassert>
 
+template<std::size_t N>
+IndexScan<N>::~IndexScan()
+{
+    // the rows of a slice or of a filtered scan are not the rows of the pattern
+    if (feedback_fragment == nullptr || offset != 0 || limit != UINT64_MAX || !runtime_filters.empty()) {
+        return;
+    }
+    if (ended_executions == stat_begin + stat_reset) {
+        feedback_fragment->record(ended_executions, results);
+    }
+}
+
 template<std::size_t N>
 void IndexScan<N>::_begin(Binding& parent_binding)
 {
@@ -22,26 +35,165 @@ void IndexScan<N>::_reset()
         max_ids[i] = ranges[i]->get_max(*parent_binding);
     }
 
+    batch.size = 0;
+    batch_pos = 0;
+    remaining = limit;
+    range_ended = false;
+
+    record_filters.clear();
+    for (auto& [column, filter] : runtime_filters) {
+        if (min_ids[column] != max_ids[column]) {
+            record_filters.push_back({ column, filter });
+        } else if (!filter->may_contain(min_ids[column])) {
+            it.set_null();
+            ++runtime_filtered;
+            return;
+        }
+    }
+
+    auto interruption_requested = &get_query_ctx().thread_info.interruption_requested;
+
+    // ranges searched in increasing order (e.g. by a join probing its
+    // bindings sorted) usually start in the current leaf or in the next one
+    if (offset == 0 && it.seek_forward(interruption_requested, min_ids, max_ids)) {
+        ++leaf_seeks;
+        return;
+    }
+
+    // a fully bound lookup of a missing record is usually discarded by the
+    // Bloom filter of the leaf, without reading it
+    if (offset == 0 && min_ids == max_ids) {
+        if (!bpt.get_record(interruption_requested, min_ids, it)) {
+            it.set_null();
+            ++bloom_skips;
+        }
+        ++bpt_searches;
+        return;
+    }
+
     it = bpt.get_range(
-        &get_query_ctx().thread_info.interruption_requested,
+        interruption_requested,
         min_ids,
-        max_ids
+        max_ids,
+        offset
     );
     ++bpt_searches;
 }
 
+template<std::size_t N>
+bool IndexScan<N>::fetch_batch()
+{
+    do {
+        if (remaining == 0 || it.is_null() || it.next_batch(batch) == 0) {
+            // next_batch() empties the batch, the position must follow it so
+            // the calls after the end don't read past the batch
+            batch.size = 0;
+            batch_pos = 0;
+            if (!range_ended) {
+                range_ended = true;
+                ++ended_executions;
+            }
+            return false;
+        }
+        // the limit counts the records of the range, filtered or not
+        if (batch.size > remaining) {
+            batch.size = remaining;
+        }
+        remaining -= batch.size;
+        batch_pos = 0;
+
+        if (!record_filters.empty()) {
+            uint_fast32_t kept = 0;
+            for (uint_fast32_t r = 0; r < batch.size; r++) {
+                bool keep = true;
+                for (auto& [column, filter] : record_filters) {
+                    if (!filter->may_contain(batch.column(column)[r])) {
+                        keep = false;
+                        break;
+                    }
+                }
+                if (keep) {
+                    for (uint_fast32_t i = 0; i < N; ++i) {
+                        batch.column(i)[kept] = batch.column(i)[r];
+                    }
+                    kept++;
+                }
+            }
+            runtime_filtered += batch.size - kept;
+            batch.size = kept;
+        }
+    } while (batch.size == 0);
+    return true;
+}
+
 template<std::size_t N>
 bool IndexScan<N>::_next()
 {
-    auto next = it.next();
-    if (next != nullptr) {
+    if (batch_pos == batch.size && !fetch_batch()) {
+        return false;
+    }
+    for (uint_fast32_t i = 0; i < N; ++i) {
+        ranges[i]->try_assign(*parent_binding, ObjectId(batch.column(i)[batch_pos]));
+    }
+    ++batch_pos;
+    return true;
+}
+
+template<std::size_t N>
+uint_fast32_t IndexScan<N>::_next_batch(BindingBatch& out)
+{
+    out.clear();
+    while (out.size < out.max_size) {
+        if (batch_pos == batch.size && !fetch_batch()) {
+            break;
+        }
+        auto count = std::min<uint_fast32_t>(batch.size - batch_pos, out.max_size - out.size);
         for (uint_fast32_t i = 0; i < N; ++i) {
-            ranges[i]->try_assign(*parent_binding, ObjectId((*next)[i]));
+            ranges[i]->try_assign_batch(out, out.size, batch.column(i) + batch_pos, count);
         }
-        return true;
-    } else {
-        return false;
+        out.size += count;
+        batch_pos += count;
+    }
+    out.select_all();
+    return out.size;
+}
+
+template<std::size_t N>
+bool IndexScan<N>::push_runtime_filter(const RuntimeFilter& filter)
+{
+    bool used = false;
+    for (uint_fast32_t i = 0; i < N; ++i) {
+        VarId var(0);
+        if (ranges[i]->get_var(var) && var == filter.var) {
+            runtime_filters.push_back({ i, &filter });
+            used = true;
+        }
+    }
+    return used;
+}
+
+template<std::size_t N>
+uint64_t IndexScan<N>::count_records(Binding& parent_binding)
+{
+    std::array<uint64_t, N> min_ids;
+    std::array<uint64_t, N> max_ids;
+
+    for (uint_fast32_t i = 0; i < N; ++i) {
+        min_ids[i] = ranges[i]->get_min(parent_binding);
+        max_ids[i] = ranges[i]->get_max(parent_binding);
     }
+    ++bpt_searches;
+    return bpt.count_records(Record<N>(min_ids), Record<N>(max_ids));
+}
+
+template<std::size_t N>
+std::unique_ptr<IndexScan<N>> IndexScan<N>::clone() const
+{
+    std::array<std::unique_ptr<ScanRange>, N> new_ranges;
+    for (uint_fast32_t i = 0; i < N; ++i) {
+        new_ranges[i] = ranges[i]->clone();
+    }
+    return std::make_unique<IndexScan<N>>(bpt, std::move(new_ranges));
 }
 
 template<std::size_t N>
@@ -57,13 +209,26 @@ void IndexScan<N>::print(std::ostream& os, int indent, bool stats) const
 {
     if (stats) {
         os << std::string(indent, ' ') << "[begin: " << stat_begin << " next: " << stat_next
-           << " reset: " << stat_reset << " results: " << results << " bpt_searches: " << bpt_searches << "]\n";
+           << " reset: " << stat_reset << " results: " << results << " bpt_searches: " << bpt_searches << " bloom_skips: " << bloom_skips;
+        if (leaf_seeks > 0) {
+            os << " leaf_seeks: " << leaf_seeks;
+        }
+        if (!runtime_filters.empty()) {
+            os << " runtime_filtered: " << runtime_filtered;
+        }
+        os << "]\n";
     }
     os << std::string(indent, ' ') << "IndexScan(ranges:";
     for (auto& range : ranges) {
         os << " ";
         range->print(os);
     }
+    if (offset != 0) {
+        os << " offset: " << offset;
+    }
+    if (limit != UINT64_MAX) {
+        os << " limit: " << limit;
+    }
     os << ")\n";
 }
 
@@ -2,7 +2,10 @@
 
 #include <array>
 #include <memory>
+#include <utility>
+#include <vector>
 
+#include "query/cardinality_feedback.h"
 #include "query/executor/binding_iter.h"
 #include "storage/index/bplus_tree/bplus_tree.h"
 #include "query/executor/binding_iter/scan_ranges/scan_range.h"
@@ -17,20 +20,77 @@ public:
         ranges (std::move(ranges)),
         bpt    (bpt) { }
 
+    // the destructor would suppress the implicit move constructor, needed to
+    // keep scans in a vector. The moved scan keeps the feedback_fragment
+    IndexScan(IndexScan&& other) = default;
+
+    ~IndexScan();
+
     void print(std::ostream& os, int indent, bool stats) const override;
 
     void _begin(Binding& parent_binding) override;
     bool _next() override;
+    uint_fast32_t _next_batch(BindingBatch& batch) override;
     void _reset() override;
     void assign_nulls() override;
 
+    // Records with a value rejected by a filter of one of its variables are
+    // skipped. If the variable is assigned, the whole range is skipped
+    bool push_runtime_filter(const RuntimeFilter& filter) override;
+
+    // Number of records in the range, read from the B+tree directory
+    // counts without iterating them. Does not take the offset into account.
+    uint64_t count_records(Binding& parent_binding);
+
+    // records skipped at the start of the range
+    uint64_t offset = 0;
+
+    // maximum number of records returned after the offset. Together with
+    // the offset it selects a positional slice of the range (e.g. a morsel
+    // scanned by a Gather worker)
+    uint64_t limit = UINT64_MAX;
+
+    // returns a new scan of the same ranges, without offset nor limit
+    std::unique_ptr<IndexScan<N>> clone() const;
+
+    // if it is set, the records of the executions that read the whole range
+    // are recorded in the cardinality feedback when the scan is destroyed
+    std::unique_ptr<CardinalityFeedback::Fragment> feedback_fragment;
+
     // statistics
     uint_fast32_t bpt_searches = 0;
+    uint_fast32_t bloom_skips = 0;
+    // searches that started in the leaf of the previous range
+    uint_fast32_t leaf_seeks = 0;
+    uint64_t runtime_filtered = 0;
     std::array<std::unique_ptr<ScanRange>, N> ranges;
 
 private:
     BPlusTree<N>& bpt;
     BptIter<N> it;
 
+    // records are decoded from the B+tree a batch at a time
+    BptBatch<N> batch;
+    uint_fast32_t batch_pos = 0;
+
+    // records left before reaching the limit
+    uint64_t remaining;
+
+    // true if the current execution read the whole range
+    bool range_ended;
+
+    // executions that read the whole range, see feedback_fragment
+    uint64_t ended_executions = 0;
+
+    // (column, filter) of the variables of the ranges
+    std::vector<std::pair<uint_fast32_t, const RuntimeFilter*>> runtime_filters;
+
+    // runtime_filters of the columns that are not fixed in the current range
+    std::vector<std::pair<uint_fast32_t, const RuntimeFilter*>> record_filters;
+
+    // reads the next batch of records in the range, skipping the ones
+    // rejected by record_filters. Returns false at the end of the range
+    bool fetch_batch();
+
     Binding* parent_binding;
 };
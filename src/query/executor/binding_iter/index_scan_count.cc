@@ -0,0 +1,49 @@
+#include "index_scan_count.h"
+
+#include "graph_models/common/conversions.h"
+
+template<std::size_t N>
+void IndexScanCount<N>::_begin(Binding& parent_binding)
+{
+    this->parent_binding = &parent_binding;
+    returned = false;
+}
+
+template<std::size_t N>
+void IndexScanCount<N>::_reset()
+{
+    returned = false;
+}
+
+template<std::size_t N>
+bool IndexScanCount<N>::_next()
+{
+    if (returned) {
+        return false;
+    }
+    returned = true;
+    auto count = scan->count_records(*parent_binding);
+    parent_binding->add(count_var, Common::Conversions::pack_int(count));
+    return true;
+}
+
+template<std::size_t N>
+void IndexScanCount<N>::assign_nulls()
+{
+    parent_binding->add(count_var, ObjectId::get_null());
+}
+
+template<std::size_t N>
+void IndexScanCount<N>::print(std::ostream& os, int indent, bool stats) const
+{
+    if (stats) {
+        print_generic_stats(os, indent);
+    }
+    os << std::string(indent, ' ') << "IndexScanCount(" << count_var << ")\n";
+    scan->print(os, indent + 2, false);
+}
+
+template class IndexScanCount<1>;
+template class IndexScanCount<2>;
+template class IndexScanCount<3>;
+template class IndexScanCount<4>;
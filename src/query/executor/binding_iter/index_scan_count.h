@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+
+#include "query/executor/binding_iter.h"
+#include "query/executor/binding_iter/index_scan.h"
+
+// Returns a single binding with the number of records the child IndexScan
+// would produce, read from the B+tree directory counts instead of
+// iterating the records.
+template <std::size_t N>
+class IndexScanCount : public BindingIter {
+public:
+    IndexScanCount(
+        std::unique_ptr<IndexScan<N>> scan,
+        VarId                         count_var
+    ) :
+        scan      (std::move(scan)),
+        count_var (count_var) { }
+
+    void print(std::ostream& os, int indent, bool stats) const override;
+
+    void _begin(Binding& parent_binding) override;
+    bool _next() override;
+    void _reset() override;
+    void assign_nulls() override;
+
+private:
+    std::unique_ptr<IndexScan<N>> scan;
+
+    VarId count_var;
+
+    Binding* parent_binding;
+
+    bool returned = false;
+};
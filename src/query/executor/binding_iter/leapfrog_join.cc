@@ -1,5 +1,6 @@
 #include "leapfrog_join.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "macros/likely.h"
@@ -30,6 +31,15 @@ void LeapfrogJoin::_begin(Binding& _parent_binding)
         }
     }
 
+    level_filters.assign(var_order.size(), nullptr);
+    for (auto filter : runtime_filters) {
+        for (size_t i = 0; i < var_order.size(); i++) {
+            if (var_order[i] == filter->var) {
+                level_filters[i] = filter;
+            }
+        }
+    }
+
     // open terms
     bool open_terms = true;
     for (auto& lf_iter : leapfrog_iters) {
@@ -161,31 +171,61 @@ bool LeapfrogJoin::find_intersection_for_current_level()
     auto min = iters_for_var[level][p]->get_key();
     auto max = iters_for_var[level][iters_for_var[level].size() - 1]->get_key();
 
-    while (min != max) { // min = max means all are equal
-        assert(max > min);
-        if (MDB_unlikely(*leapfrog_iters[0]->interruption_requested)) {
-            throw InterruptedException();
+    auto filter = level_filters[level];
+    while (true) {
+        while (min != max) { // min = max means all are equal
+            assert(max > min);
+            if (MDB_unlikely(*leapfrog_iters[0]->interruption_requested)) {
+                throw InterruptedException();
+            }
+            seeks++;
+            if (iters_for_var[level][p]->seek(max)) {
+                // after the seek, the previous min is the max
+                auto new_max = iters_for_var[level][p]->get_key();
+                assert(new_max >= max);
+                max = new_max;
+
+                // update the min
+                p = (p + 1) % iters_for_var[level].size();
+                auto new_min = iters_for_var[level][p]->get_key();
+                assert(new_min >= min);
+                min = new_min;
+            } else {
+                return false;
+            }
+        }
+
+        if (filter == nullptr || filter->may_contain(min)) {
+            break;
+        }
+        // the intersection is rejected, the search continues after it
+        runtime_filtered++;
+        if (min >= filter->max) {
+            return false;
         }
         seeks++;
-        if (iters_for_var[level][p]->seek(max)) {
-            // after the seek, the previous min is the max
-            auto new_max = iters_for_var[level][p]->get_key();
-            assert(new_max >= max);
-            max = new_max;
-
-            // update the min
-            p = (p + 1) % iters_for_var[level].size();
-            auto new_min = iters_for_var[level][p]->get_key();
-            assert(new_min >= min);
-            min = new_min;
-        } else {
+        if (!iters_for_var[level][p]->seek(std::max(min + 1, filter->min))) {
             return false;
         }
+        max = iters_for_var[level][p]->get_key();
+        p = (p + 1) % iters_for_var[level].size();
+        min = iters_for_var[level][p]->get_key();
     }
     parent_binding->add(var_order[level], ObjectId(min));
     return true;
 }
 
+bool LeapfrogJoin::push_runtime_filter(const RuntimeFilter& filter)
+{
+    for (int_fast32_t i = 0; i < enumeration_level && i < (int_fast32_t) var_order.size(); i++) {
+        if (var_order[i] == filter.var) {
+            runtime_filters.push_back(&filter);
+            return true;
+        }
+    }
+    return false;
+}
+
 void LeapfrogJoin::assign_nulls()
 {
     for (uint_fast32_t lvl = 0; lvl < var_order.size(); lvl++) {
@@ -197,7 +237,11 @@ void LeapfrogJoin::print(std::ostream& os, int indent, bool stats) const
 {
     if (stats) {
         os << std::string(indent, ' ') << "[begin: " << stat_begin << " next: " << stat_next
-           << " reset: " << stat_reset << " results: " << results << " seeks: " << seeks << "]\n";
+           << " reset: " << stat_reset << " results: " << results << " seeks: " << seeks;
+        if (!runtime_filters.empty()) {
+            os << " runtime_filtered: " << runtime_filtered;
+        }
+        os << "]\n";
     }
     os << std::string(indent, ' ') << "LeapfrogJoin(";
     if (enumeration_level > 0) {
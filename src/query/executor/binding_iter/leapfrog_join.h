@@ -30,7 +30,11 @@ public:
     void _reset() override;
     void assign_nulls() override;
 
+    // filters of intersection vars are checked when a level finds an intersection
+    bool push_runtime_filter(const RuntimeFilter& filter) override;
+
     uint_fast32_t seeks = 0;
+    uint64_t runtime_filtered = 0;
     std::vector<std::unique_ptr<LeapfrogIter>> leapfrog_iters;
 
     // At first it contains variables from intersection_vars
@@ -49,6 +53,11 @@ private:
     // iters_for_var[i] is a list of (not-null) pointers of iterators for the variable at var_order[base_level+i].
     std::vector<std::vector<LeapfrogIter*>> iters_for_var;
 
+    std::vector<const RuntimeFilter*> runtime_filters;
+
+    // level_filters[i] is the filter of var_order[i] or nullptr
+    std::vector<const RuntimeFilter*> level_filters;
+
     void up();
     void down();
     bool find_intersection_for_current_level();
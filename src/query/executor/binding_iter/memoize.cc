@@ -0,0 +1,166 @@
+#include "memoize.h"
+
+void Memoize::_begin(Binding& _parent_binding)
+{
+    this->parent_binding = &_parent_binding;
+
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+    clear_cache();
+
+    child_begun = false;
+    lookup_pending = true;
+}
+
+void Memoize::_reset()
+{
+    // the entry is searched in the first next, so a reset without a next
+    // doesn't evaluate the child
+    lookup_pending = true;
+}
+
+void Memoize::lookup()
+{
+    lookup_pending = false;
+
+    for (size_t i = 0; i < key_vars.size(); i++) {
+        key_buf[i] = (*parent_binding)[key_vars[i]];
+    }
+
+    position = 0;
+    auto it = cache.find(key_buf);
+    if (it != cache.end()) {
+        hits++;
+        current = it->second;
+        entries.splice(entries.begin(), entries, current);
+        child_in_sync = false;
+        return;
+    }
+
+    misses++;
+    entries.push_front(Entry { key_buf, {}, 0, false });
+    current = entries.begin();
+    cache.insert({ key_buf, current });
+    cache_bytes += entry_bytes(*current);
+    evict();
+
+    start_child();
+    child_in_sync = true;
+}
+
+void Memoize::start_child()
+{
+    if (child_begun) {
+        child->reset();
+    } else {
+        child->begin(*parent_binding);
+        child_begun = true;
+    }
+}
+
+bool Memoize::_next()
+{
+    if (lookup_pending) {
+        lookup();
+    }
+
+    if (current == entries.end()) {
+        return child->next();
+    }
+
+    if (position < current->rows) {
+        auto values = &current->values[position * value_vars.size()];
+        for (size_t i = 0; i < value_vars.size(); i++) {
+            parent_binding->add(value_vars[i], values[i]);
+        }
+        position++;
+        return true;
+    }
+
+    if (current->complete) {
+        return false;
+    }
+
+    if (!child_in_sync) {
+        // the rows already saved are skipped
+        start_child();
+        for (uint64_t i = 0; i < position; i++) {
+            if (!child->next()) {
+                current->complete = true;
+                return false;
+            }
+        }
+        child_in_sync = true;
+    }
+
+    if (child->next()) {
+        save_row();
+        return true;
+    }
+    current->complete = true;
+    return false;
+}
+
+void Memoize::save_row()
+{
+    if (current->rows == MAX_ENTRY_ROWS) {
+        // the following rows are returned from the child without saving them
+        cache_bytes -= entry_bytes(*current);
+        cache.erase(current->key);
+        entries.erase(current);
+        current = entries.end();
+        return;
+    }
+
+    cache_bytes -= entry_bytes(*current);
+    for (auto var : value_vars) {
+        current->values.push_back((*parent_binding)[var]);
+    }
+    current->rows++;
+    position++;
+    cache_bytes += entry_bytes(*current);
+    evict();
+}
+
+void Memoize::evict()
+{
+    // current is at the front, so it is never evicted
+    while (cache_bytes > MAX_BYTES && entries.size() > 1) {
+        auto& last = entries.back();
+        cache_bytes -= entry_bytes(last);
+        cache.erase(last.key);
+        entries.pop_back();
+        evictions++;
+    }
+}
+
+void Memoize::clear_cache()
+{
+    cache.clear();
+    entries.clear();
+    cache_bytes = 0;
+    current = entries.end();
+}
+
+void Memoize::assign_nulls()
+{
+    child->assign_nulls();
+}
+
+void Memoize::print(std::ostream& os, int indent, bool stats) const
+{
+    if (stats) {
+        print_generic_stats(os, indent);
+    }
+    os << std::string(indent, ' ') << "Memoize(key: [";
+    for (auto& var : key_vars) {
+        os << ' ' << var;
+    }
+    os << " ]";
+    if (stats) {
+        os << " hits: " << hits << " misses: " << misses << " evictions: " << evictions;
+    }
+    os << ")\n";
+    child->print(os, indent + 2, stats);
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include "query/executor/binding_iter.h"
+#include "third_party/hashes/hash_function_wrapper.h"
+
+// Caches the results of the inner relation of a correlated join (OPTIONAL,
+// NOT EXISTS, semi join and nested loop joins), that is evaluated again for
+// each row of the outer relation.
+//
+// The results of `child` only depend on the values of `key_vars` when it is
+// reset, so they are saved by those values and returned from memory when
+// the same values appear again. For each result the values of `value_vars`
+// are saved. The least recently used entries are evicted when the cache
+// exceeds MAX_BYTES, and an entry with more than MAX_ENTRY_ROWS rows is not
+// saved. If the consumer stops reading before the end (e.g. NOT EXISTS), the
+// entry is kept incomplete and is continued from the child when needed.
+class Memoize : public BindingIter {
+public:
+    static constexpr uint64_t MAX_BYTES = 16 * 1024 * 1024;
+
+    static constexpr uint64_t MAX_ENTRY_ROWS = 4096;
+
+    Memoize(
+        std::unique_ptr<BindingIter> child,
+        std::vector<VarId>&&         key_vars,
+        std::vector<VarId>&&         value_vars
+    ) :
+        child      (std::move(child)),
+        key_vars   (std::move(key_vars)),
+        value_vars (std::move(value_vars)),
+        key_buf    (this->key_vars.size(), ObjectId::get_null()) { }
+
+    void print(std::ostream& os, int indent, bool stats) const override;
+
+    void _begin(Binding& parent_binding) override;
+    bool _next() override;
+    void _reset() override;
+    void assign_nulls() override;
+
+    std::unique_ptr<BindingIter> child;
+
+    // statistics
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+
+private:
+    struct KeyHasher {
+        size_t operator()(const std::vector<ObjectId>& key) const
+        {
+            return HashFunctionWrapper(key.data(), key.size() * sizeof(ObjectId));
+        }
+    };
+
+    struct Entry {
+        std::vector<ObjectId> key;
+
+        // values of value_vars, value_vars.size() for each row
+        std::vector<ObjectId> values;
+
+        uint64_t rows;
+
+        // false if the child was not read until the end
+        bool complete;
+    };
+
+    const std::vector<VarId> key_vars;
+    const std::vector<VarId> value_vars;
+
+    Binding* parent_binding;
+
+    bool child_begun;
+
+    // true after a reset, the entry is searched in the first next
+    bool lookup_pending;
+
+    // the most recently used entry is at the front
+    std::list<Entry> entries;
+
+    boost::unordered_flat_map<std::vector<ObjectId>, std::list<Entry>::iterator, KeyHasher> cache;
+
+    uint64_t cache_bytes;
+
+    std::vector<ObjectId> key_buf;
+
+    // entry being returned, entries.end() if the results are read from
+    // the child without saving them
+    std::list<Entry>::iterator current;
+
+    // row of current to return next
+    uint64_t position;
+
+    // true if the child has returned the first `position` rows of current
+    bool child_in_sync;
+
+    // searches the entry of the values of key_vars, creating it if needed
+    void lookup();
+
+    // begins or resets the child with the current values of key_vars
+    void start_child();
+
+    // saves the row of the child in current, dropping current if too big
+    void save_row();
+
+    void evict();
+
+    void clear_cache();
+
+    static inline uint64_t entry_bytes(const Entry& entry)
+    {
+        return sizeof(Entry) + (entry.key.size() + entry.values.size()) * sizeof(ObjectId);
+    }
+};
@@ -0,0 +1,72 @@
+#include "merge_group.h"
+
+#include <algorithm>
+
+void MergeGroup::begin(BindingIter& _rhs, Binding& _rhs_binding)
+{
+    rhs = &_rhs;
+    rhs_binding = &_rhs_binding;
+    rhs_has_row = rhs->next();
+
+    group_values.clear();
+    group_rows = 0;
+    group_position = 0;
+    group_valid = false;
+}
+
+void MergeGroup::seek(uint64_t key)
+{
+    if (!group_valid || key != group_key) {
+        load_group(key);
+    }
+    group_position = 0;
+}
+
+void MergeGroup::load_group(uint64_t key)
+{
+    while (rhs_has_row && (*rhs_binding)[merge_var].id < key) {
+        rhs_has_row = rhs->next();
+    }
+
+    group_values.clear();
+    group_rows = 0;
+    group_key = key;
+    group_valid = true;
+
+    while (rhs_has_row && (*rhs_binding)[merge_var].id == key) {
+        for (auto var : join_vars) {
+            group_values.push_back((*rhs_binding)[var]);
+        }
+        for (auto var : rhs_only_vars) {
+            group_values.push_back((*rhs_binding)[var]);
+        }
+        group_rows++;
+        rhs_has_row = rhs->next();
+    }
+    max_group_rows = std::max(max_group_rows, group_rows);
+}
+
+bool MergeGroup::next_match(Binding& binding)
+{
+    const auto row_size = join_vars.size() + rhs_only_vars.size();
+
+    while (group_position < group_rows) {
+        auto values = &group_values[group_position++ * row_size];
+
+        bool match = true;
+        for (size_t i = 0; i < join_vars.size(); i++) {
+            auto lhs_oid = binding[join_vars[i]];
+            if (!lhs_oid.is_null() && !values[i].is_null() && lhs_oid != values[i]) {
+                match = false;
+                break;
+            }
+        }
+        if (match) {
+            for (size_t i = 0; i < rhs_only_vars.size(); i++) {
+                binding.add(rhs_only_vars[i], values[join_vars.size() + i]);
+            }
+            return true;
+        }
+    }
+    return false;
+}
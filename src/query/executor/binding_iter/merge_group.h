@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "query/executor/binding_iter.h"
+
+// Rows of the rhs of a MergeJoin or MergeLeftJoin whose value of merge_var
+// is the one of the current lhs row. rhs is read once: the rows with smaller
+// values are skipped and the group is kept in memory, so consecutive lhs rows
+// with the same value reuse it.
+class MergeGroup {
+public:
+    MergeGroup(
+        VarId                     merge_var,
+        const std::vector<VarId>& join_vars,
+        const std::vector<VarId>& rhs_only_vars
+    ) :
+        merge_var     (merge_var),
+        join_vars     (join_vars),
+        rhs_only_vars (rhs_only_vars) { }
+
+    // must be called after rhs is begun or reset with rhs_binding
+    void begin(BindingIter& rhs, Binding& rhs_binding);
+
+    // starts the rows of the group of key, reading it from rhs if it isn't the current group
+    void seek(uint64_t key);
+
+    // writes the values of rhs_only_vars of the next row of the group that
+    // matches the join_vars of the binding, returns false if there are no more
+    bool next_match(Binding& binding);
+
+    // statistics
+    uint64_t max_group_rows = 0;
+
+private:
+    const VarId merge_var;
+
+    // owned by the join
+    const std::vector<VarId>& join_vars;
+    const std::vector<VarId>& rhs_only_vars;
+
+    BindingIter* rhs;
+
+    Binding* rhs_binding;
+
+    // true if rhs_binding has a row of rhs that is not in the group
+    bool rhs_has_row;
+
+    // rows of rhs whose value of merge_var is group_key, with the values of
+    // join_vars and rhs_only_vars of each row
+    std::vector<ObjectId> group_values;
+    uint64_t group_rows;
+    uint64_t group_key;
+    bool group_valid;
+
+    // row of the group to compare with the current lhs row
+    uint64_t group_position;
+
+    // reads the rows of rhs until the end of the ones with merge_var = key
+    void load_group(uint64_t key);
+};
@@ -0,0 +1,63 @@
+#include "merge_join.h"
+
+void MergeJoin::_begin(Binding& _parent_binding)
+{
+    this->parent_binding = &_parent_binding;
+
+    rhs_binding = std::make_unique<Binding>(_parent_binding.size);
+    rhs_binding->add_all(_parent_binding);
+
+    lhs->begin(_parent_binding);
+    rhs->begin(*rhs_binding);
+    group.begin(*rhs, *rhs_binding);
+}
+
+void MergeJoin::_reset()
+{
+    rhs_binding->add_all(*parent_binding);
+
+    lhs->reset();
+    rhs->reset();
+    group.begin(*rhs, *rhs_binding);
+}
+
+bool MergeJoin::_next()
+{
+    while (true) {
+        if (group.next_match(*parent_binding)) {
+            return true;
+        }
+        if (!lhs->next()) {
+            return false;
+        }
+        group.seek((*parent_binding)[merge_var].id);
+    }
+}
+
+void MergeJoin::assign_nulls()
+{
+    lhs->assign_nulls();
+    rhs->assign_nulls();
+    for (auto var : rhs_only_vars) {
+        parent_binding->add(var, ObjectId::get_null());
+    }
+}
+
+void MergeJoin::print(std::ostream& os, int indent, bool stats) const
+{
+    if (stats) {
+        print_generic_stats(os, indent);
+    }
+    os << std::string(indent, ' ') << "MergeJoin(merge_var: " << merge_var;
+    os << ", join_vars: [";
+    for (auto& var : join_vars) {
+        os << ' ' << var;
+    }
+    os << " ]";
+    if (stats) {
+        os << " max_group_rows: " << group.max_group_rows;
+    }
+    os << ")\n";
+    lhs->print(os, indent + 2, stats);
+    rhs->print(os, indent + 2, stats);
+}
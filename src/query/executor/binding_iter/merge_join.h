@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "query/executor/binding_iter.h"
+#include "query/executor/binding_iter/merge_group.h"
+
+// Join of two relations sorted by `merge_var`, that are read once at the
+// same time, without hashing or searching an index for each row.
+//
+// The rows of rhs with the value of merge_var of the current lhs row are
+// kept in memory (see MergeGroup), so consecutive lhs rows with the same
+// value reuse them.
+// If both relations have other variables in common (`join_vars`) they are
+// compared for each pair of rows. rhs is evaluated in its own binding, the
+// values of `rhs_only_vars` are copied to the parent binding.
+class MergeJoin : public BindingIter {
+public:
+    MergeJoin(
+        std::unique_ptr<BindingIter> lhs,
+        std::unique_ptr<BindingIter> rhs,
+        VarId                        merge_var,
+        std::vector<VarId>&&         join_vars,
+        std::vector<VarId>&&         rhs_only_vars
+    ) :
+        lhs           (std::move(lhs)),
+        rhs           (std::move(rhs)),
+        merge_var     (merge_var),
+        join_vars     (std::move(join_vars)),
+        rhs_only_vars (std::move(rhs_only_vars)),
+        group         (merge_var, this->join_vars, this->rhs_only_vars) { }
+
+    void print(std::ostream& os, int indent, bool stats) const override;
+
+    void _begin(Binding& parent_binding) override;
+    bool _next() override;
+    void _reset() override;
+    void assign_nulls() override;
+
+    std::unique_ptr<BindingIter> lhs;
+    std::unique_ptr<BindingIter> rhs;
+
+private:
+    const VarId merge_var;
+    const std::vector<VarId> join_vars;
+    const std::vector<VarId> rhs_only_vars;
+
+    Binding* parent_binding = nullptr;
+
+    std::unique_ptr<Binding> rhs_binding;
+
+    MergeGroup group;
+};
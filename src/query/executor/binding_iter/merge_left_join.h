@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "query/executor/binding_iter.h"
+#include "query/executor/binding_iter/merge_group.h"
+
+// Left outer join of two relations sorted by `merge_var`, works as MergeJoin
+// but the lhs rows without a match in rhs are returned with `rhs_only_vars`
+// set to null.
+class MergeLeftJoin : public BindingIter {
+public:
+    MergeLeftJoin(
+        std::unique_ptr<BindingIter> lhs,
+        std::unique_ptr<BindingIter> rhs,
+        VarId                        merge_var,
+        std::vector<VarId>&&         join_vars,
+        std::vector<VarId>&&         rhs_only_vars
+    ) :
+        lhs           (std::move(lhs)),
+        rhs           (std::move(rhs)),
+        merge_var     (merge_var),
+        join_vars     (std::move(join_vars)),
+        rhs_only_vars (std::move(rhs_only_vars)),
+        group         (merge_var, this->join_vars, this->rhs_only_vars) { }
+
+    void print(std::ostream& os, int indent, bool stats) const override;
+
+    void _begin(Binding& parent_binding) override;
+    bool _next() override;
+    void _reset() override;
+    void assign_nulls() override;
+
+    std::unique_ptr<BindingIter> lhs;
+    std::unique_ptr<BindingIter> rhs;
+
+private:
+    const VarId merge_var;
+    const std::vector<VarId> join_vars;
+    const std::vector<VarId> rhs_only_vars;
+
+    Binding* parent_binding = nullptr;
+
+    std::unique_ptr<Binding> rhs_binding;
+
+    MergeGroup group;
+
+    // true if the current lhs row has no match yet
+    bool must_return_null;
+};
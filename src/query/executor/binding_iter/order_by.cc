@@ -1,5 +1,10 @@
 #include "order_by.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "macros/likely.h"
+#include "query/exceptions.h"
 #include "system/buffer_manager.h"
 
 using namespace std;
@@ -9,18 +14,32 @@ OrderBy::OrderBy(
     set<VarId>&& saved_vars,
     vector<VarId>&& order_vars,
     vector<bool>&& ascending,
-    int64_t (*_compare)(ObjectId, ObjectId)
+    int64_t (*_compare)(ObjectId, ObjectId),
+    SortKey::Normalizer normalizer,
+    uint_fast32_t threads
 ) :
     child_iter(std::move(child_iter)),
     order_info(std::move(order_vars), std::move(ascending), saved_vars),
     first_file_id(buffer_manager.get_tmp_file_id()),
     second_file_id(buffer_manager.get_tmp_file_id()),
-    compare(_compare)
-{ }
+    runs_file_id(&first_file_id),
+    compare(_compare),
+    normalizer(normalizer),
+    comparator { order_info, _compare },
+    threads(threads)
+{
+    if (normalizer != nullptr) {
+        auto key_columns = std::min(order_info.ascending.size(), MAX_KEY_COLUMNS);
+        order_info.key_size = key_columns * SortKey::SIZE / sizeof(ObjectId);
+    }
+    // each tuple also needs its pointers in sorted and merged_chunks
+    auto tuple_size = sizeof(ObjectId) * order_info.tuple_size() + 2 * sizeof(const ObjectId*);
+    buffer_capacity = (SORT_BUFFER_SIZE / tuple_size) * order_info.tuple_size();
+}
 
 OrderBy::~OrderBy()
 {
-    run.reset();
+    readers.clear();
     buffer_manager.remove_tmp(first_file_id);
     buffer_manager.remove_tmp(second_file_id);
 }
@@ -30,55 +49,73 @@ void OrderBy::_begin(Binding& _parent_binding)
     parent_binding = &_parent_binding;
     child_iter->begin(*parent_binding);
 
-    total_pages = 0;
-    run = get_run(buffer_manager.get_ppage(first_file_id, total_pages));
-    run->reset();
-
-    std::vector<ObjectId> object_ids(order_info.saved_vars.size());
+    readers.clear();
+    runs.clear();
+    buffer.clear();
+    runs_file_id = &first_file_id;
+    written_runs = 0;
 
-    // Save all the tuples of child_iter on disk and apply sort to each page
     while (child_iter->next()) {
-        if (run->is_full()) {
-            total_pages++;
-            run->sort();
-            run = get_run(buffer_manager.get_ppage(first_file_id, total_pages));
-            run->reset();
+        if (buffer.size() == buffer_capacity) {
+            sort_buffer();
+            write_run();
+            buffer.clear();
         }
-        for (size_t i = 0; i < order_info.saved_vars.size(); i++) {
-            object_ids[i] = (*parent_binding)[order_info.saved_vars[i]];
-        }
-        run->add(object_ids.data());
+        add_to_buffer();
+    }
+    sort_buffer();
+
+    if (runs.empty()) {
+        // everything fits in memory
+        sorted_position = 0;
+        return;
     }
-    run->sort();
-    total_pages++;
-    run = nullptr;
+
+    write_run();
+    vector<ObjectId>().swap(buffer);
+    vector<const ObjectId*>().swap(sorted);
+    vector<const ObjectId*>().swap(merged_chunks);
 
     merge_sort();
-    run = get_run(buffer_manager.get_ppage(*output_file_id, 0));
+    merge_tree = make_unique<LoserTree>(comparator);
+    open_runs(0, runs.size(), readers, *merge_tree);
 }
 
 void OrderBy::_reset()
 {
-    current_page = 0;
-    page_position = 0;
+    if (runs.empty()) {
+        sorted_position = 0;
+    } else {
+        open_runs(0, runs.size(), readers, *merge_tree);
+    }
 }
 
 bool OrderBy::_next()
 {
-    if (page_position == run->get_tuple_count()) {
-        current_page++;
-        if (current_page >= total_pages) {
+    const ObjectId* tuple;
+    if (runs.empty()) {
+        if (sorted_position == sorted.size()) {
+            return false;
+        }
+        tuple = sorted[sorted_position++] + order_info.key_size;
+    } else {
+        tuple = merge_tree->heads[merge_tree->winner()];
+        if (tuple == nullptr) {
             return false;
         }
-        run = get_run(buffer_manager.get_ppage(*output_file_id, current_page));
-        page_position = 0;
+        tuple += order_info.key_size;
     }
 
-    auto tuple = run->get(page_position);
     for (size_t i = 0; i < order_info.saved_vars.size(); i++) {
         parent_binding->add(order_info.saved_vars[i], tuple[i]);
     }
-    page_position++;
+
+    if (!runs.empty()) {
+        // tuple may be invalid after advancing
+        auto winner = merge_tree->winner();
+        merge_tree->heads[winner] = advance(readers[winner]);
+        merge_tree->replay();
+    }
     return true;
 }
 
@@ -89,52 +126,198 @@ void OrderBy::assign_nulls()
     }
 }
 
-void OrderBy::merge_sort()
+void OrderBy::add_to_buffer()
 {
-    // Iterative merge sort implementation. Run to merge are a power of two
-    uint_fast64_t start_page;
-    uint_fast64_t end_page;
-    uint_fast64_t middle;
-    uint_fast64_t runs_to_merge = 1;
-
-    TupleCollectionMerger merger(order_info, compare);
-
-    bool output_is_in_second = false;
-
-    const TmpFileId* source_pointer = &first_file_id;
-    const TmpFileId* dest_pointer = &second_file_id;
-
-    while (runs_to_merge < total_pages) {
-        runs_to_merge *= 2;
-        start_page = 0;
-        middle = (runs_to_merge / 2) - 1;
-        if (runs_to_merge > total_pages) {
-            runs_to_merge = total_pages;
-            end_page = runs_to_merge - 1;
-        } else {
-            end_page = runs_to_merge - 1;
-        }
-        while (start_page < total_pages) {
-            if (start_page == end_page) {
-                merger.copy_page(start_page, *source_pointer, *dest_pointer);
-            } else {
-                merger.merge(start_page, middle, middle + 1, end_page, *source_pointer, *dest_pointer);
+    auto start = buffer.size();
+    buffer.resize(start + order_info.tuple_size());
+
+    auto key = reinterpret_cast<unsigned char*>(&buffer[start]);
+    for (size_t i = 0; i < order_info.key_columns(); i++) {
+        std::memset(key, 0, SortKey::SIZE);
+        bool exact = normalizer((*parent_binding)[order_info.saved_vars[i]], key);
+        if (!order_info.ascending[i]) {
+            for (size_t b = 0; b < SortKey::COMPARED_BYTES; b++) {
+                key[b] = ~key[b];
             }
-            start_page = end_page + 1;
-            middle = start_page + (runs_to_merge / 2) - 1;
-            end_page += runs_to_merge;
-            if (end_page >= total_pages) {
-                end_page = total_pages - 1;
+        }
+        key[SortKey::COMPARED_BYTES] = exact;
+        key += SortKey::SIZE;
+    }
+
+    auto tuple = &buffer[start + order_info.key_size];
+    for (size_t i = 0; i < order_info.saved_vars.size(); i++) {
+        tuple[i] = (*parent_binding)[order_info.saved_vars[i]];
+    }
+}
+
+void OrderBy::sort_buffer()
+{
+    const auto tuple_size = order_info.tuple_size();
+    const uint64_t tuple_count = buffer.size() / tuple_size;
+
+    sorted.resize(tuple_count);
+    for (uint64_t i = 0; i < tuple_count; i++) {
+        sorted[i] = &buffer[i * tuple_size];
+    }
+
+    auto less = [this](const ObjectId* lhs, const ObjectId* rhs) {
+        return comparator(lhs, rhs) < 0;
+    };
+
+    uint_fast32_t chunks = std::min<uint64_t>(threads, tuple_count / MIN_PARALLEL_SORT_TUPLES);
+    if (chunks <= 1) {
+        std::sort(sorted.begin(), sorted.end(), less);
+        return;
+    }
+
+    // Each chunk is sorted by a different thread, the chunk 0 by this one.
+    // The helpers only read the tuples, and the comparison only reads strings
+    vector<uint64_t> bounds(chunks + 1);
+    for (uint_fast32_t c = 0; c <= chunks; c++) {
+        bounds[c] = tuple_count * c / chunks;
+    }
+
+    sort_helpers.start(chunks - 1, [this, &bounds, &less](uint_fast32_t helper) {
+        std::sort(sorted.begin() + bounds[helper + 1], sorted.begin() + bounds[helper + 2], less);
+    });
+    try {
+        std::sort(sorted.begin(), sorted.begin() + bounds[1], less);
+    } catch (...) {
+        sort_helpers.interrupt();
+        sort_helpers.wait();
+        throw;
+    }
+    sort_helpers.wait();
+    if (MDB_unlikely(get_query_ctx().thread_info.interruption_requested)) {
+        throw InterruptedException();
+    }
+
+    // k-way merge of the sorted chunks
+    LoserTree tree(comparator);
+    vector<uint64_t> positions(bounds.begin(), bounds.end() - 1);
+    for (uint_fast32_t c = 0; c < chunks; c++) {
+        tree.heads.push_back(sorted[positions[c]]);
+    }
+    tree.init();
+
+    merged_chunks.resize(tuple_count);
+    for (uint64_t i = 0; i < tuple_count; i++) {
+        auto winner = tree.winner();
+        merged_chunks[i] = tree.heads[winner];
+        positions[winner]++;
+        tree.heads[winner] = positions[winner] < bounds[winner + 1] ? sorted[positions[winner]] : nullptr;
+        tree.replay();
+    }
+    sorted.swap(merged_chunks);
+}
+
+void OrderBy::write_run()
+{
+    Run run;
+    run.start_page = runs.empty() ? 0 : runs.back().end_page;
+    run.end_page = run.start_page;
+
+    unique_ptr<TupleCollectionPage> page;
+    for (auto tuple : sorted) {
+        if (page == nullptr || page->is_full()) {
+            if (MDB_unlikely(get_query_ctx().thread_info.interruption_requested)) {
+                throw InterruptedException();
             }
-            if (middle >= end_page) {
-                middle = (start_page + end_page) / 2;
+            page = get_run(buffer_manager.get_ppage(*runs_file_id, run.end_page));
+            page->reset();
+            run.end_page++;
+        }
+        page->add(tuple);
+    }
+    if (run.end_page > run.start_page) {
+        runs.push_back(run);
+        written_runs++;
+    }
+}
+
+void OrderBy::merge_sort()
+{
+    merge_passes = 0;
+    while (runs.size() > MAX_MERGE_FAN_IN) {
+        auto output_file_id = runs_file_id == &first_file_id ? &second_file_id : &first_file_id;
+
+        vector<Run> merged_runs;
+        uint64_t next_page = 0;
+        for (size_t first_run = 0; first_run < runs.size(); first_run += MAX_MERGE_FAN_IN) {
+            auto end_run = std::min(first_run + MAX_MERGE_FAN_IN, runs.size());
+            merged_runs.push_back(merge_runs(first_run, end_run, *output_file_id, next_page));
+            next_page = merged_runs.back().end_page;
+        }
+        runs = std::move(merged_runs);
+        runs_file_id = output_file_id;
+        merge_passes++;
+    }
+}
+
+OrderBy::Run OrderBy::merge_runs(
+    size_t first_run,
+    size_t end_run,
+    TmpFileId output_file_id,
+    uint64_t start_page
+)
+{
+    vector<RunReader> run_readers;
+    LoserTree tree(comparator);
+    open_runs(first_run, end_run, run_readers, tree);
+
+    Run res;
+    res.start_page = start_page;
+    res.end_page = start_page;
+
+    unique_ptr<TupleCollectionPage> out;
+    for (auto winner = tree.winner(); tree.heads[winner] != nullptr; winner = tree.winner()) {
+        if (out == nullptr || out->is_full()) {
+            if (MDB_unlikely(get_query_ctx().thread_info.interruption_requested)) {
+                throw InterruptedException();
             }
+            out = get_run(buffer_manager.get_ppage(output_file_id, res.end_page));
+            out->reset();
+            res.end_page++;
         }
-        output_is_in_second = !output_is_in_second;
-        source_pointer = output_is_in_second ? &second_file_id : &first_file_id;
-        dest_pointer = output_is_in_second ? &first_file_id : &second_file_id;
+        out->add(tree.heads[winner]);
+        tree.heads[winner] = advance(run_readers[winner]);
+        tree.replay();
     }
-    output_file_id = output_is_in_second ? &second_file_id : &first_file_id;
+    return res;
+}
+
+void OrderBy::open_runs(size_t first_run, size_t end_run, vector<RunReader>& run_readers, LoserTree& tree)
+{
+    run_readers.clear();
+    tree.heads.clear();
+    for (auto i = first_run; i < end_run; i++) {
+        run_readers.push_back({
+            get_run(buffer_manager.get_ppage(*runs_file_id, runs[i].start_page)),
+            *runs_file_id,
+            runs[i].start_page,
+            runs[i].end_page,
+            0
+        });
+        // runs don't have empty pages
+        tree.heads.push_back(run_readers.back().page->get(0));
+    }
+    tree.init();
+}
+
+const ObjectId* OrderBy::advance(RunReader& reader)
+{
+    reader.position++;
+    if (reader.position < reader.page->get_tuple_count()) {
+        return reader.page->get(reader.position);
+    }
+    reader.current_page++;
+    if (reader.current_page == reader.end_page) {
+        reader.page = nullptr;
+        return nullptr;
+    }
+    reader.page = get_run(buffer_manager.get_ppage(reader.file_id, reader.current_page));
+    reader.position = 0;
+    return reader.page->get(0);
 }
 
 std::unique_ptr<TupleCollectionPage> OrderBy::get_run(PPage& run_page)
@@ -171,6 +354,9 @@ void OrderBy::print(std::ostream& os, int indent, bool stats) const
         os << var;
     }
 
+    if (stats) {
+        os << ", runs: " << written_runs << ", merge_passes: " << merge_passes;
+    }
     os << ")\n";
     child_iter->print(os, indent + 2, stats);
 }
@@ -6,17 +6,40 @@
 
 #include "graph_models/object_id.h"
 #include "query/executor/binding_iter.h"
+#include "query/executor/helper_threads.h"
+#include "query/query_context.h"
 #include "storage/file_id.h"
 #include "storage/tuple_collection/tuple_collection.h"
 
+// Sorts the tuples of child_iter. If a SortKey::Normalizer is given, the
+// normalized keys of the first MAX_KEY_COLUMNS order vars are computed once
+// when a tuple is read and stored before it, so most comparisons are memcmp
+// of the keys. The tuples are read into a buffer of
+// SORT_BUFFER_SIZE bytes and sorted there, using up to `threads` threads.
+// If all the tuples fit in the buffer they are returned from memory,
+// otherwise each full buffer is written as a sorted run of many pages and the
+// runs are merged with a LoserTree, MAX_MERGE_FAN_IN runs at a time. The last
+// merge is not written to disk, its output is returned directly by _next().
 class OrderBy : public BindingIter {
 public:
+    static constexpr size_t SORT_BUFFER_SIZE = 1024 * 1024 * 64; // 64 MB
+
+    // each run being merged keeps a private page pinned
+    static constexpr size_t MAX_MERGE_FAN_IN = 64;
+
+    static constexpr size_t MAX_KEY_COLUMNS = 4;
+
+    // buffers with less tuples per thread are sorted by a single thread
+    static constexpr uint64_t MIN_PARALLEL_SORT_TUPLES = 64 * 1024;
+
     OrderBy(
         std::unique_ptr<BindingIter> child_iter,
         std::set<VarId>&& saved_vars,
         std::vector<VarId>&& order_vars,
         std::vector<bool>&& ascending,
-        int64_t (*_compare)(ObjectId, ObjectId)
+        int64_t (*_compare)(ObjectId, ObjectId),
+        SortKey::Normalizer normalizer = nullptr,
+        uint_fast32_t threads = 1
     );
 
     OrderBy(const OrderBy&) = delete;
@@ -41,26 +64,84 @@ public:
         return (lhs.id > rhs.id) - (lhs.id < rhs.id);
     }
 
+    // statistics
+    uint64_t written_runs = 0;
+    uint64_t merge_passes = 0;
+
 private:
+    // pages [start_page, end_page) of a tmp file
+    struct Run {
+        uint64_t start_page;
+        uint64_t end_page;
+    };
+
+    struct RunReader {
+        std::unique_ptr<TupleCollectionPage> page;
+        TmpFileId file_id;
+        uint64_t current_page;
+        uint64_t end_page;
+        uint64_t position;
+    };
+
     const TmpFileId first_file_id;
 
     const TmpFileId second_file_id;
 
-    std::unique_ptr<TupleCollectionPage> run;
-
-    const TmpFileId* output_file_id;
+    // file having the runs
+    const TmpFileId* runs_file_id;
 
     Binding* parent_binding;
 
-    uint_fast32_t total_pages = 0;
+    int64_t (*compare)(ObjectId, ObjectId);
 
-    uint_fast32_t current_page = 0;
+    SortKey::Normalizer normalizer;
 
-    uint64_t page_position = 0;
+    TupleComparator comparator;
 
-    int64_t (*compare)(ObjectId, ObjectId);
+    uint_fast32_t threads;
+
+    // tuples read from child_iter with their keys, one after the other
+    std::vector<ObjectId> buffer;
+
+    // maximum size of buffer
+    size_t buffer_capacity;
+
+    // the tuples of buffer in order, after calling sort_buffer()
+    std::vector<const ObjectId*> sorted;
+
+    std::vector<const ObjectId*> merged_chunks;
+
+    // threads sorting the chunks of the buffer, created once
+    HelperThreads sort_helpers;
+
+    // empty if all the tuples fit in the buffer
+    std::vector<Run> runs;
+
+    // position in sorted when the runs are not used
+    uint64_t sorted_position = 0;
+
+    // used to merge the runs in _next()
+    std::vector<RunReader> readers;
+
+    std::unique_ptr<LoserTree> merge_tree;
 
     std::unique_ptr<TupleCollectionPage> get_run(PPage& run_page);
 
+    // appends the current tuple of child_iter to buffer
+    void add_to_buffer();
+
+    void sort_buffer();
+
+    void write_run();
+
+    // merges runs while there are more than MAX_MERGE_FAN_IN
     void merge_sort();
+
+    Run merge_runs(size_t first_run, size_t end_run, TmpFileId output_file_id, uint64_t start_page);
+
+    // starts the merge of runs[first_run..end_run) with tree
+    void open_runs(size_t first_run, size_t end_run, std::vector<RunReader>& run_readers, LoserTree& tree);
+
+    // returns the next tuple of the run, or nullptr when it is exhausted
+    const ObjectId* advance(RunReader& reader);
 };
@@ -8,17 +8,17 @@ using namespace Paths;
 // B+Tree
 template<size_t N>
 uint64_t BTreeIndexIterator<N>::get_starting_node() {
-    return (*current)[starting_node_idx];
+    return batch.column(starting_node_idx)[batch_pos];
 }
 
 template<size_t N>
 uint64_t BTreeIndexIterator<N>::get_reached_node() {
-    return (*current)[reached_node_idx];
+    return batch.column(reached_node_idx)[batch_pos];
 }
 
 template<size_t N>
 uint64_t BTreeIndexIterator<N>::get_predicate() {
-    return (*current)[predicate_idx];
+    return batch.column(predicate_idx)[batch_pos];
 }
 
 template<>
@@ -28,7 +28,7 @@ uint64_t BTreeIndexIterator<3>::get_edge() {
 
 template<>
 uint64_t BTreeIndexIterator<4>::get_edge() {
-    return (*current)[3];
+    return batch.column(3)[batch_pos];
 }
 
 
@@ -39,9 +39,12 @@ bool BTreeIndexIterator<N>::next() {
         return false;
     }
 
-    // Advance iterator
-    current = iter.next();
-    if (current != nullptr) {
+    // Advance iterator, decoding a new batch when the current one is consumed
+    if (++batch_pos < batch.size) {
+        return true;
+    }
+    if (iter.next_batch(batch) != 0) {
+        batch_pos = 0;
         return true;
     }
 
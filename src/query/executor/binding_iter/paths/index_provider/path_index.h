@@ -118,8 +118,10 @@ private:
     // B+Tree internal iterator
     BptIter<N> iter;
 
-    // Current result
-    const Record<N>* current;
+    // Records decoded from the B+tree, current result is at batch_pos
+    BptBatch<N> batch;
+
+    uint_fast32_t batch_pos = 0;
 
     size_t starting_node_idx;
 
@@ -25,4 +25,15 @@ public:
     }
 
     void try_assign(Binding&, ObjectId) override { }
+
+    void try_assign_batch(BindingBatch&, uint_fast32_t, const uint64_t*, uint_fast32_t) override { }
+
+    bool get_var(VarId& res) const override {
+        res = var;
+        return true;
+    }
+
+    std::unique_ptr<ScanRange> clone() const override {
+        return std::make_unique<AssignedVar>(var);
+    }
 };
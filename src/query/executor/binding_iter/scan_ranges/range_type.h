@@ -99,4 +99,17 @@ public:
     {
         binding.add(var, obj_id);
     }
+
+    void try_assign_batch(BindingBatch& batch, uint_fast32_t row, const uint64_t* values, uint_fast32_t count) override
+    {
+        auto column = batch.write_column(var) + row;
+        for (uint_fast32_t i = 0; i < count; i++) {
+            column[i] = ObjectId(values[i]);
+        }
+    }
+
+    std::unique_ptr<ScanRange> clone() const override
+    {
+        return std::make_unique<RangeType>(var, type_bitmap);
+    }
 };
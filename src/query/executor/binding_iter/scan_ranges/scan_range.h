@@ -5,6 +5,7 @@
 #include <ostream>
 
 #include "query/executor/binding.h"
+#include "query/executor/binding_batch.h"
 #include "query/id.h"
 
 class ScanRange {
@@ -13,8 +14,18 @@ public:
     virtual uint64_t get_min(Binding& input) = 0;
     virtual uint64_t get_max(Binding& input) = 0;
     virtual void try_assign(Binding& binding, ObjectId) = 0;
+
+    // same as try_assign for `count` values, written in the batch starting at `row`
+    virtual void try_assign_batch(BindingBatch& batch, uint_fast32_t row, const uint64_t* values, uint_fast32_t count) = 0;
     virtual void print(std::ostream& os) const = 0;
 
+    virtual std::unique_ptr<ScanRange> clone() const = 0;
+
+    // returns true if the range is given by a variable, and writes it in var
+    virtual bool get_var(VarId& /*var*/) const {
+        return false;
+    }
+
     static std::unique_ptr<ScanRange> get(Id id, bool assigned);
     static std::unique_ptr<ScanRange> get(ObjectId id);
 };
@@ -24,5 +24,11 @@ public:
 
     void try_assign(Binding&, ObjectId) override { }
 
+    void try_assign_batch(BindingBatch&, uint_fast32_t, const uint64_t*, uint_fast32_t) override { }
+
+    std::unique_ptr<ScanRange> clone() const override {
+        return std::make_unique<Term>(object_id);
+    }
+
     ObjectId get_oid() { return object_id; }
 };
@@ -26,4 +26,20 @@ public:
     void try_assign(Binding& binding, ObjectId obj_id) override {
         binding.add(var, obj_id);
     }
+
+    void try_assign_batch(BindingBatch& batch, uint_fast32_t row, const uint64_t* values, uint_fast32_t count) override {
+        auto column = batch.write_column(var) + row;
+        for (uint_fast32_t i = 0; i < count; i++) {
+            column[i] = ObjectId(values[i]);
+        }
+    }
+
+    bool get_var(VarId& res) const override {
+        res = var;
+        return true;
+    }
+
+    std::unique_ptr<ScanRange> clone() const override {
+        return std::make_unique<UnassignedVar>(var);
+    }
 };
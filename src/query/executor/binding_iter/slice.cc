@@ -1,5 +1,7 @@
 #include "slice.h"
 
+#include <algorithm>
+
 void Slice::_begin(Binding& _parent_binding)
 {
     parent_binding = &_parent_binding;
@@ -33,6 +35,42 @@ bool Slice::_next()
     }
 }
 
+uint_fast32_t Slice::_next_batch(BindingBatch& batch)
+{
+    while (count < limit) {
+        // once the offset is skipped there is no need to ask for more rows than the limit
+        auto max_size = batch.max_size;
+        if (position >= offset) {
+            batch.max_size = std::min<uint64_t>(max_size, limit - count);
+        }
+        auto selected = child_iter->next_batch(batch);
+        batch.max_size = max_size;
+
+        if (selected == 0) {
+            return 0;
+        }
+
+        uint_fast32_t skip = 0;
+        if (position < offset) {
+            skip = std::min<uint64_t>(offset - position, selected);
+            position += skip;
+        }
+        uint_fast32_t remaining = std::min<uint64_t>(selected - skip, limit - count);
+        if (remaining == 0) {
+            continue;
+        }
+        if (skip > 0) {
+            for (uint_fast32_t i = 0; i < remaining; i++) {
+                batch.selection[i] = batch.selection[skip + i];
+            }
+        }
+        batch.selected = remaining;
+        count += remaining;
+        return remaining;
+    }
+    return 0;
+}
+
 void Slice::assign_nulls()
 {
     child_iter->assign_nulls();
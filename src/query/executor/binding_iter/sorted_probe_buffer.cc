@@ -0,0 +1,123 @@
+#include "sorted_probe_buffer.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "query/executor/binding_iter/index_scan.h"
+#include "query/executor/binding_iter/scan_ranges/assigned_var.h"
+#include "query/executor/binding_iter/scan_ranges/term.h"
+
+// writes in key_vars the assigned vars of the ranges before the first one
+// that is not fixed, if iter is an IndexScan<N>
+template<std::size_t N>
+bool get_key_vars(const BindingIter& iter, std::vector<VarId>& key_vars)
+{
+    auto index_scan = dynamic_cast<const IndexScan<N>*>(&iter);
+    if (index_scan == nullptr) {
+        return false;
+    }
+    for (auto& range : index_scan->ranges) {
+        if (dynamic_cast<AssignedVar*>(range.get()) != nullptr) {
+            VarId var(0);
+            range->get_var(var);
+            key_vars.push_back(var);
+        } else if (dynamic_cast<Term*>(range.get()) == nullptr) {
+            break;
+        }
+    }
+    return true;
+}
+
+SortedProbeBuffer::SortedProbeBuffer(const BindingIter& inner)
+{
+    get_key_vars<1>(inner, key_vars)
+        || get_key_vars<2>(inner, key_vars)
+        || get_key_vars<3>(inner, key_vars)
+        || get_key_vars<4>(inner, key_vars);
+}
+
+void SortedProbeBuffer::reset()
+{
+    order.clear();
+    results.clear();
+    row_results.clear();
+    probed.clear();
+    buffer_full = false;
+    current_row = 0;
+    current_value = 0;
+    next_batch_size = MIN_BATCH_SIZE;
+    streaming = false;
+}
+
+bool SortedProbeBuffer::read_batch(BindingIter& outer, const Binding& binding)
+{
+    if (batch == nullptr) {
+        batch = std::make_unique<BindingBatch>(binding.size);
+    }
+    batch->max_size = next_batch_size;
+
+    order.clear();
+    results.clear();
+    row_results.clear();
+    probed.clear();
+    if (outer.next_batch(*batch) == 0) {
+        return false;
+    }
+    order.resize(batch->selected);
+    std::iota(order.begin(), order.end(), 0);
+    row_results.assign(batch->selected, { 0, 0 });
+    probed.assign(batch->selected, false);
+
+    // the key vars not assigned by the batch are the same in all its rows
+    std::vector<const ObjectId*> columns;
+    auto& assigned_vars = batch->get_assigned_vars();
+    for (auto var : key_vars) {
+        if (std::find(assigned_vars.begin(), assigned_vars.end(), var) != assigned_vars.end()) {
+            columns.push_back(batch->column(var));
+        }
+    }
+    auto& selection = batch->selection;
+    std::sort(order.begin(), order.end(), [&](uint_fast32_t a, uint_fast32_t b) {
+        for (auto column : columns) {
+            if (column[selection[a]].id != column[selection[b]].id) {
+                return column[selection[a]].id < column[selection[b]].id;
+            }
+        }
+        return a < b;
+    });
+    return true;
+}
+
+void SortedProbeBuffer::end_batch()
+{
+    if (buffer_full && order.size() > 1) {
+        next_batch_size = std::max<uint_fast32_t>(order.size() / 2, 1);
+    } else {
+        next_batch_size = std::min(next_batch_size * 2, batch->capacity);
+    }
+    current_row = 0;
+    current_value = row_results.empty() ? 0 : row_results[0].first;
+}
+
+bool SortedProbeBuffer::next_buffered(Binding& binding)
+{
+    while (current_row < row_results.size() && probed[current_row]) {
+        if (current_value < row_results[current_row].second) {
+            for (std::size_t i = 0; i < binding.size; i++) {
+                binding.add(VarId(i), results[current_value + i]);
+            }
+            current_value += binding.size;
+            return true;
+        }
+        next_row();
+    }
+    return false;
+}
+
+void SortedProbeBuffer::next_row()
+{
+    current_row++;
+    if (current_row < row_results.size()) {
+        current_value = row_results[current_row].first;
+    }
+}
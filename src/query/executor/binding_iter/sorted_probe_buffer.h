@@ -0,0 +1,142 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "query/executor/binding_batch.h"
+#include "query/executor/binding_iter.h"
+
+// Reads the outer relation of a nested loop join in batches and probes its
+// rows sorted by the variables that fix the first columns of the inner
+// IndexScan, so the index is searched in key order and consecutive searches
+// usually start in the leaf of the previous one (see BptIter::seek_forward).
+// The results of a batch are buffered with the position of their outer row
+// and returned in the order of the outer relation.
+// The first batches are small so a LIMIT doesn't read many rows that won't
+// be used. At most MAX_BUFFERED_RESULTS results are buffered: when the buffer
+// is full the rows not probed yet are probed again in the outer order, with
+// their results returned directly, and the next batches are smaller.
+// A batch of one row is not buffered.
+class SortedProbeBuffer {
+public:
+    static constexpr uint_fast32_t MIN_BATCH_SIZE = 16;
+
+    static constexpr uint64_t MAX_BUFFERED_RESULTS = 64 * 1024;
+
+    // enabled() is false if inner is not an IndexScan with an input variable
+    // in the first columns
+    SortedProbeBuffer(const BindingIter& inner);
+
+    inline bool enabled() const { return !key_vars.empty(); }
+
+    // must be called after outer->begin() or outer->reset()
+    void reset();
+
+    // Writes the next result of the join in the binding, returns false if
+    // there are no more results. Each row of outer is written in the binding
+    // and then start_row() is called, and next_result() until it returns false.
+    // Each time next_result() returns true the binding has a result of the row.
+    template <typename StartRow, typename NextResult>
+    bool next(BindingIter& outer, Binding& binding, StartRow&& start_row, NextResult&& next_result)
+    {
+        while (true) {
+            if (streaming) {
+                if (next_result()) {
+                    return true;
+                }
+                streaming = false;
+                next_row();
+            }
+            if (next_buffered(binding)) {
+                return true;
+            }
+            if (current_row < row_results.size()) {
+                // the row was not probed with the batch, its results are not buffered
+                batch->load_row(batch->selection[current_row], binding);
+                start_row();
+                streaming = true;
+                continue;
+            }
+            if (!read_batch(outer, binding)) {
+                return false;
+            }
+
+            // with one row the results are already in the outer order
+            buffer_full = order.size() == 1;
+            for (auto pos : order) {
+                if (buffer_full) {
+                    break;
+                }
+                batch->load_row(batch->selection[pos], binding);
+                start_row();
+                row_results[pos].first = results.size();
+                while (next_result()) {
+                    if (results.size() >= MAX_BUFFERED_RESULTS * binding.size) {
+                        // the row will be probed again after the buffered rows before it
+                        results.resize(row_results[pos].first);
+                        buffer_full = true;
+                        break;
+                    }
+                    for (std::size_t i = 0; i < binding.size; i++) {
+                        results.push_back(binding[VarId(i)]);
+                    }
+                }
+                if (!buffer_full) {
+                    row_results[pos].second = results.size();
+                    probed[pos] = true;
+                }
+            }
+            end_batch();
+        }
+    }
+
+    // number of values in the buffer, binding.size for each result
+    inline std::size_t buffered_values() const { return results.size(); }
+
+private:
+    // input variables of the inner scan, in the order of its columns
+    std::vector<VarId> key_vars;
+
+    std::unique_ptr<BindingBatch> batch;
+
+    // positions in the selection of batch, in the order the rows are probed
+    std::vector<uint_fast32_t> order;
+
+    // binding.size values for each result of the batch, in the probe order
+    std::vector<ObjectId> results;
+
+    // [begin, end) in results of the values of each outer row of the batch
+    std::vector<std::pair<uint64_t, uint64_t>> row_results;
+
+    // false for the outer rows of the batch that were not probed because
+    // the buffer was full
+    std::vector<bool> probed;
+
+    // true if the buffer was filled before probing all the rows of the batch
+    bool buffer_full;
+
+    // outer row and value in results of the next buffered result
+    uint_fast32_t current_row;
+    uint64_t current_value;
+
+    uint_fast32_t next_batch_size;
+
+    // true while the results of the outer row current_row are returned
+    // directly, without buffering them
+    bool streaming;
+
+    // reads the next batch of outer and sorts its rows in order, returns
+    // false if there are no more rows
+    bool read_batch(BindingIter& outer, const Binding& binding);
+
+    // chooses the size of the next batch and starts returning the results
+    void end_batch();
+
+    // writes the next buffered result in the binding, returns false if there
+    // are no more or the next outer row was not probed
+    bool next_buffered(Binding& binding);
+
+    // moves to the results of the next outer row
+    void next_row();
+};
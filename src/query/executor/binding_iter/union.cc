@@ -40,6 +40,15 @@ void Union::assign_nulls()
     }
 }
 
+bool Union::push_runtime_filter(const RuntimeFilter& filter)
+{
+    bool used = false;
+    for (auto& iter : iters) {
+        used |= iter->push_runtime_filter(filter);
+    }
+    return used;
+}
+
 void Union::print(std::ostream& os, int indent, bool stats) const
 {
     if (stats) {
@@ -17,6 +17,7 @@ public:
     bool _next() override;
     void _reset() override;
     void assign_nulls() override;
+    bool push_runtime_filter(const RuntimeFilter& filter) override;
 
     std::vector<std::unique_ptr<BindingIter>> iters;
     uint_fast32_t current_iter = 0;
@@ -1,5 +1,6 @@
 #include "query/executor/binding_iter/aggregation/aggregation.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/aggregation/hybrid_aggregation.h" // IWYU pragma: keep
+#include "query/executor/binding_iter/aggregation/parallel_aggregation.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/bind.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/cross_product.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/distinct_hash.h" // IWYU pragma: keep
@@ -7,10 +8,12 @@
 #include "query/executor/binding_iter/empty_binding_iter.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/expr_evaluator.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/filter.h" // IWYU pragma: keep
+#include "query/executor/binding_iter/gather.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/hash_join/bgp/hybrid/join.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/hash_join/bgp/hybrid/join_1_var.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/hash_join/bgp/in_memory/join.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/hash_join/bgp/in_memory/join_1_var.h" // IWYU pragma: keep
+#include "query/executor/binding_iter/hash_join/bgp/parallel/join.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/hash_join/generic/hybrid/anti_join.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/hash_join/generic/hybrid/join.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/hash_join/generic/hybrid/left_join.h" // IWYU pragma: keep
@@ -23,8 +26,12 @@
 #include "query/executor/binding_iter/index_left_outer_join.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/index_nested_loop_join.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/index_scan.h" // IWYU pragma: keep
+#include "query/executor/binding_iter/index_scan_count.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/leapfrog_join.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/let.h" // IWYU pragma: keep
+#include "query/executor/binding_iter/memoize.h" // IWYU pragma: keep
+#include "query/executor/binding_iter/merge_join.h" // IWYU pragma: keep
+#include "query/executor/binding_iter/merge_left_join.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/minus.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/nested_loop_join.h" // IWYU pragma: keep
 #include "query/executor/binding_iter/nested_loop_left_join.h" // IWYU pragma: keep
@@ -0,0 +1,113 @@
+#include "helper_threads.h"
+
+#include <chrono>
+
+HelperThreads::~HelperThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop_requested = true;
+        for (auto& helper : helpers) {
+            helper.query_ctx->thread_info.interruption_requested = true;
+        }
+    }
+    task_started.notify_all();
+
+    for (auto& helper : helpers) {
+        helper.thread.join();
+    }
+}
+
+void HelperThreads::start(uint_fast32_t count, std::function<void(uint_fast32_t)> new_task)
+{
+    query_ctx = &get_query_ctx();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    while (helpers.size() < count) {
+        helpers.push_back({ std::thread(), std::make_unique<QueryContext>() });
+        helpers.back().thread = std::thread(&HelperThreads::run_helper, this, helpers.size() - 1);
+    }
+
+    for (uint_fast32_t i = 0; i < count; i++) {
+        auto& ctx = *helpers[i].query_ctx;
+        ctx.thread_info = query_ctx->thread_info;
+        ctx.thread_info.interruption_requested = false;
+        ctx.thread_info.is_helper = true;
+        ctx.start_version = query_ctx->start_version;
+        ctx.result_version = query_ctx->result_version;
+    }
+
+    task = std::move(new_task);
+    task_helpers = count;
+    running_helpers = count;
+    task_exception = nullptr;
+    task_number++;
+    task_started.notify_all();
+}
+
+void HelperThreads::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running_helpers > 0) {
+        // the helpers don't see the interruption flag of the query, so
+        // it is forwarded while waiting for them
+        if (query_ctx->thread_info.interruption_requested) {
+            for (uint_fast32_t i = 0; i < task_helpers; i++) {
+                helpers[i].query_ctx->thread_info.interruption_requested = true;
+            }
+        }
+        task_finished.wait_for(lock, std::chrono::milliseconds(100));
+    }
+
+    if (task_exception != nullptr) {
+        auto exception = task_exception;
+        task_exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+void HelperThreads::interrupt()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (uint_fast32_t i = 0; i < task_helpers; i++) {
+        helpers[i].query_ctx->thread_info.interruption_requested = true;
+    }
+}
+
+void HelperThreads::run_helper(uint_fast32_t index)
+{
+    {
+        // helpers may be reallocated by start()
+        std::lock_guard<std::mutex> lock(mutex);
+        QueryContext::set_query_ctx(helpers[index].query_ctx.get());
+    }
+
+    uint64_t last_task = 0;
+    while (true) {
+        std::function<void(uint_fast32_t)>* current_task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            task_started.wait(lock, [&] {
+                return stop_requested || (task_number != last_task && index < task_helpers);
+            });
+            if (stop_requested) {
+                return;
+            }
+            last_task = task_number;
+            current_task = &task;
+        }
+
+        try {
+            (*current_task)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (task_exception == nullptr) {
+                task_exception = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        running_helpers--;
+        task_finished.notify_all();
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "query/query_context.h"
+
+// Threads that help the thread of a query to evaluate a single operator.
+// The threads are created the first time a task is started and are kept
+// until the operator is destroyed, so the executions after a _reset() reuse
+// them.
+// Each helper has its own QueryContext with the versions and the worker_index
+// of the query, marked as ThreadInfo::is_helper: the tasks can read the
+// temporal strings of the query, but must not use private pages nor create
+// temporal files or strings (the buffer and tmp managers throw if they do).
+class HelperThreads {
+public:
+    HelperThreads() = default;
+
+    HelperThreads(const HelperThreads&) = delete;
+
+    ~HelperThreads();
+
+    // Runs task(i) in the helper i, for i in [0, count), without waiting for
+    // them. Must be called from the thread of the query, and the previous
+    // task must have finished
+    void start(uint_fast32_t count, std::function<void(uint_fast32_t)> task);
+
+    // Waits until every helper finishes the task, forwarding the interruption
+    // of the query to them. Rethrows the first exception thrown by the task
+    void wait();
+
+    // requests the interruption of the task running in the helpers
+    void interrupt();
+
+    // number of helpers running the current task
+    uint_fast32_t running() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return running_helpers;
+    }
+
+private:
+    struct Helper {
+        std::thread thread;
+        std::unique_ptr<QueryContext> query_ctx;
+    };
+
+    std::vector<Helper> helpers;
+
+    std::mutex mutex;
+    std::condition_variable task_started;
+    std::condition_variable task_finished;
+
+    // protected by mutex
+    std::function<void(uint_fast32_t)> task;
+    uint64_t task_number = 0;
+    uint_fast32_t task_helpers = 0;
+    uint_fast32_t running_helpers = 0;
+    bool stop_requested = false;
+    std::exception_ptr task_exception;
+
+    // context of the thread that started the task
+    QueryContext* query_ctx = nullptr;
+
+    void run_helper(uint_fast32_t index);
+};
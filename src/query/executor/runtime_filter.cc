@@ -0,0 +1,20 @@
+#include "runtime_filter.h"
+
+void RuntimeFilter::clear(uint64_t keys)
+{
+    min = UINT64_MAX;
+    max = 0;
+
+    if (keys > MAX_BLOOM_KEYS) {
+        bits.clear();
+        mask = 0;
+        return;
+    }
+
+    uint64_t bit_count = 64;
+    while (bit_count < keys * BITS_PER_KEY) {
+        bit_count *= 2;
+    }
+    bits.assign(bit_count / 64, 0);
+    mask = bit_count - 1;
+}
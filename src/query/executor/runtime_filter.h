@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "query/var_id.h"
+
+// Filter on the values of a variable, built from the join keys of the build
+// side of a hash join once it is read and pushed into the probe side (see
+// BindingIter::push_runtime_filter), so the probe side can drop the results
+// that can't have a match before they are copied into bindings.
+// It keeps the min and max ids added and, if there are not too many keys, a
+// Bloom filter of them. may_contain() has false positives but never false
+// negatives.
+class RuntimeFilter {
+public:
+    // the Bloom filter is not used with more keys, only the min and max
+    static constexpr uint64_t MAX_BLOOM_KEYS = 4 * 1024 * 1024;
+
+    static constexpr uint64_t BITS_PER_KEY = 16;
+
+    static constexpr uint_fast32_t HASHES = 3;
+
+    const VarId var;
+
+    uint64_t min;
+
+    uint64_t max;
+
+    RuntimeFilter(VarId var) :
+        var (var)
+    {
+        clear(0);
+    }
+
+    // removes all keys, `keys` is the number of keys expected to be added
+    void clear(uint64_t keys);
+
+    void add(uint64_t id)
+    {
+        if (id < min) {
+            min = id;
+        }
+        if (id > max) {
+            max = id;
+        }
+        if (!bits.empty()) {
+            auto hash = mix(id);
+            for (uint_fast32_t i = 0; i < HASHES; i++) {
+                auto bit = hash & mask;
+                bits[bit >> 6] |= 1ULL << (bit & 63);
+                hash = (hash >> 21) | (hash << 43);
+            }
+        }
+    }
+
+    bool may_contain(uint64_t id) const
+    {
+        if (id < min || id > max) {
+            return false;
+        }
+        if (!bits.empty()) {
+            auto hash = mix(id);
+            for (uint_fast32_t i = 0; i < HASHES; i++) {
+                auto bit = hash & mask;
+                if ((bits[bit >> 6] & (1ULL << (bit & 63))) == 0) {
+                    return false;
+                }
+                hash = (hash >> 21) | (hash << 43);
+            }
+        }
+        return true;
+    }
+
+private:
+    std::vector<uint64_t> bits;
+
+    // number of bits - 1, it is a power of 2
+    uint64_t mask;
+
+    // finalizer of MurmurHash3, the ids of consecutive objects differ in few bits
+    static inline uint64_t mix(uint64_t key)
+    {
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDULL;
+        key ^= key >> 33;
+        key *= 0xC4CEB9FE1A85EC53ULL;
+        key ^= key >> 33;
+        return key;
+    }
+};
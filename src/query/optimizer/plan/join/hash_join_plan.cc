@@ -1,19 +1,35 @@
 #include "hash_join_plan.h"
 
 #include "query/exceptions.h"
+#include "query/executor/binding_iter/hash_join/bgp/hybrid/join.h"
+#include "query/executor/binding_iter/hash_join/bgp/hybrid/join_1_var.h"
+#include "query/executor/binding_iter/hash_join/bgp/in_memory/join.h"
+#include "query/executor/binding_iter/hash_join/bgp/in_memory/join_1_var.h"
+#include "query/executor/binding_iter/hash_join/bgp/parallel/join.h"
+#include "query/executor/binding_iter/hash_join/generic/hybrid/join.h"
 #include "query/executor/binding_iter/hash_join/generic/in_memory/join.h"
 
 using HashJoin_ = HashJoin::Generic::InMemory::Join;
+using HybridHashJoin_ = HashJoin::Generic::Hybrid::Join;
 
 HashJoinPlan::HashJoinPlan(
     std::unique_ptr<Plan> _lhs,
-    std::unique_ptr<Plan> _rhs
+    std::unique_ptr<Plan> _rhs,
+    double                estimated_output_size,
+    uint_fast32_t         threads
 ) :
-    lhs (std::move(_lhs)),
-    rhs (std::move(_rhs))
+    lhs                   (std::move(_lhs)),
+    rhs                   (std::move(_rhs)),
+    estimated_output_size (estimated_output_size),
+    threads               (threads)
 {
-    estimated_output_size = lhs->estimate_output_size() * rhs->estimate_output_size();
-    estimated_cost = lhs->estimate_cost() + rhs->estimate_cost();
+    // each relation is read once, and each row of rhs is inserted in the table
+    estimated_cost = lhs->estimate_cost() + rhs->estimate_cost() + rhs->estimate_output_size();
+
+    // the partitions that don't fit in memory are written and read again
+    if (!build_fits_in_memory()) {
+        estimated_cost += 2 * (lhs->estimate_output_size() + rhs->estimate_output_size());
+    }
 }
 
 
@@ -48,7 +64,6 @@ void HashJoinPlan::set_input_vars(const std::set<VarId>& /*input_vars*/) {
 
 
 std::unique_ptr<BindingIter> HashJoinPlan::get_binding_iter() const {
-    std::vector<VarId> common_vars;
     std::vector<VarId> only_left_vars;
     std::vector<VarId> only_right_vars;
     std::vector<VarId> join_vars;
@@ -60,27 +75,131 @@ std::unique_ptr<BindingIter> HashJoinPlan::get_binding_iter() const {
         if (rhs_vars.find(left_var) == rhs_vars.end()) {
             only_left_vars.push_back(left_var);
         } else {
-            common_vars.push_back(left_var);
+            join_vars.push_back(left_var);
         }
     }
     for (auto right_var : rhs_vars) {
-        if (lhs_vars.find(right_var) != lhs_vars.end()) {
+        if (lhs_vars.find(right_var) == lhs_vars.end()) {
             only_right_vars.push_back(right_var);
         }
     }
 
-    for (auto common_var : common_vars) {
-        if (lhs_vars.find(common_var) != lhs_vars.end() &&
-            rhs_vars.find(common_var) != rhs_vars.end())
-        {
-            join_vars.push_back(common_var);
+    // the BGP joins evaluate both relations in the parent binding, so the
+    // input vars of the base plans are kept
+    if (threads > 1 && build_fits_in_memory()
+        && rhs->estimate_output_size() >= MIN_PARALLEL_BUILD_ROWS)
+    {
+        switch (join_vars.size()) {
+        case 1:
+            return std::make_unique<HashJoin::BGP::Parallel::Join<1>>(
+                rhs->get_binding_iter(),
+                lhs->get_binding_iter(),
+                std::move(join_vars),
+                std::move(only_right_vars),
+                threads);
+        case 2:
+            return std::make_unique<HashJoin::BGP::Parallel::Join<2>>(
+                rhs->get_binding_iter(),
+                lhs->get_binding_iter(),
+                std::move(join_vars),
+                std::move(only_right_vars),
+                threads);
+        case 3:
+            return std::make_unique<HashJoin::BGP::Parallel::Join<3>>(
+                rhs->get_binding_iter(),
+                lhs->get_binding_iter(),
+                std::move(join_vars),
+                std::move(only_right_vars),
+                threads);
+        case 4:
+            return std::make_unique<HashJoin::BGP::Parallel::Join<4>>(
+                rhs->get_binding_iter(),
+                lhs->get_binding_iter(),
+                std::move(join_vars),
+                std::move(only_right_vars),
+                threads);
+        default:
+            break;
+        }
+    }
+
+    if (build_fits_in_memory()) {
+        switch (join_vars.size()) {
+        case 1:
+            return std::make_unique<HashJoin::BGP::InMemory::Join1Var>(
+                rhs->get_binding_iter(),
+                lhs->get_binding_iter(),
+                join_vars[0],
+                std::move(only_right_vars),
+                std::move(only_left_vars));
+        case 2:
+            return std::make_unique<HashJoin::BGP::InMemory::Join<2>>(
+                rhs->get_binding_iter(),
+                lhs->get_binding_iter(),
+                std::move(join_vars),
+                std::move(only_right_vars),
+                std::move(only_left_vars));
+        case 3:
+            return std::make_unique<HashJoin::BGP::InMemory::Join<3>>(
+                rhs->get_binding_iter(),
+                lhs->get_binding_iter(),
+                std::move(join_vars),
+                std::move(only_right_vars),
+                std::move(only_left_vars));
+        case 4:
+            return std::make_unique<HashJoin::BGP::InMemory::Join<4>>(
+                rhs->get_binding_iter(),
+                lhs->get_binding_iter(),
+                std::move(join_vars),
+                std::move(only_right_vars),
+                std::move(only_left_vars));
+        default:
+            return std::make_unique<HashJoin_>(
+                lhs->get_binding_iter(),
+                rhs->get_binding_iter(),
+                std::move(join_vars),
+                std::move(only_left_vars),
+                std::move(only_right_vars));
         }
     }
 
-    return std::make_unique<HashJoin_>(
-        lhs->get_binding_iter(),
-        rhs->get_binding_iter(),
-        std::move(join_vars),
-        std::move(only_left_vars),
-        std::move(only_right_vars));
+    // the hybrid joins partition both relations to disk when the table of
+    // the build relation (their lhs) exceeds their limit
+    switch (join_vars.size()) {
+    case 1:
+        return std::make_unique<HashJoin::BGP::Hybrid::Join1Var>(
+            rhs->get_binding_iter(),
+            lhs->get_binding_iter(),
+            std::move(join_vars),
+            std::move(only_right_vars),
+            std::move(only_left_vars));
+    case 2:
+        return std::make_unique<HashJoin::BGP::Hybrid::Join<2>>(
+            rhs->get_binding_iter(),
+            lhs->get_binding_iter(),
+            std::move(join_vars),
+            std::move(only_right_vars),
+            std::move(only_left_vars));
+    case 3:
+        return std::make_unique<HashJoin::BGP::Hybrid::Join<3>>(
+            rhs->get_binding_iter(),
+            lhs->get_binding_iter(),
+            std::move(join_vars),
+            std::move(only_right_vars),
+            std::move(only_left_vars));
+    case 4:
+        return std::make_unique<HashJoin::BGP::Hybrid::Join<4>>(
+            rhs->get_binding_iter(),
+            lhs->get_binding_iter(),
+            std::move(join_vars),
+            std::move(only_right_vars),
+            std::move(only_left_vars));
+    default:
+        return std::make_unique<HybridHashJoin_>(
+            rhs->get_binding_iter(),
+            lhs->get_binding_iter(),
+            std::move(join_vars),
+            std::move(only_right_vars),
+            std::move(only_left_vars));
+    }
 }
@@ -2,18 +2,35 @@
 
 #include "query/optimizer/plan/plan.h"
 
+// Hash join of two plans of any shape, rhs is the build relation and lhs is
+// the probe relation. The output size is given by the optimizer, that
+// estimates it once for all the plans of the same relations.
+// If the build relation is estimated to be too big for memory, the join
+// partitions the relations to disk instead of keeping the whole table.
+// Otherwise, if the build relation is big enough and `threads` > 1, the
+// in-memory join is evaluated by several threads.
 class HashJoinPlan : public Plan {
 public:
+    // estimated rows of the build relation up to which the join is in memory
+    static constexpr double MAX_IN_MEMORY_BUILD_ROWS = 4'000'000;
+
+    // estimated rows of the build relation from which the join uses
+    // `threads` threads, with less rows the threads cost more than they save
+    static constexpr double MIN_PARALLEL_BUILD_ROWS = 256 * 1024;
+
     HashJoinPlan(
         std::unique_ptr<Plan> lhs,
-        std::unique_ptr<Plan> rhs
+        std::unique_ptr<Plan> rhs,
+        double                estimated_output_size,
+        uint_fast32_t         threads = 1
     );
 
     HashJoinPlan(const HashJoinPlan& other) :
         lhs                   (other.lhs->clone()),
         rhs                   (other.rhs->clone()),
         estimated_cost        (other.estimated_cost),
-        estimated_output_size (other.estimated_output_size) { }
+        estimated_output_size (other.estimated_output_size),
+        threads               (other.threads) { }
 
     std::unique_ptr<Plan> clone() const override {
         return std::make_unique<HashJoinPlan>(*this);
@@ -37,9 +54,15 @@ public:
     void print(std::ostream& os, int indent) const override;
 
 private:
+    bool build_fits_in_memory() const {
+        return rhs->estimate_output_size() <= MAX_IN_MEMORY_BUILD_ROWS;
+    }
+
     std::unique_ptr<Plan> lhs;
     std::unique_ptr<Plan> rhs;
 
     double estimated_cost;
     double estimated_output_size;
+
+    uint_fast32_t threads;
 };
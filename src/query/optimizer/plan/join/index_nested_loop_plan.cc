@@ -1,6 +1,7 @@
 #include "index_nested_loop_plan.h"
 
 #include "query/exceptions.h"
+#include "query/executor/binding_iter/adaptive_join.h"
 #include "query/executor/binding_iter/index_nested_loop_join.h"
 
 IndexNestedLoopPlan::IndexNestedLoopPlan(
@@ -10,7 +11,16 @@ IndexNestedLoopPlan::IndexNestedLoopPlan(
     lhs  (std::move(_lhs)),
     rhs  (std::move(_rhs))
 {
-    rhs->set_input_vars(lhs->get_vars());
+    if (rhs->is_index_scan()) {
+        scan_rhs = rhs->clone();
+    }
+
+    // the join probes rhs with lhs sorted by its input vars (see SortedProbeBuffer),
+    // but returns the results in the order of lhs
+    auto lhs_vars = lhs->get_vars();
+    order = lhs->get_order();
+
+    rhs->set_input_vars(lhs_vars);
 
     const auto lhs_output_size = lhs->estimate_output_size();
     estimated_output_size = lhs_output_size * rhs->estimate_output_size();
@@ -53,6 +63,31 @@ void IndexNestedLoopPlan::set_input_vars(const std::set<VarId>& /*input_vars*/)
 
 
 std::unique_ptr<BindingIter> IndexNestedLoopPlan::get_binding_iter() const {
+    if (scan_rhs != nullptr) {
+        auto lhs_vars = lhs->get_vars();
+        std::vector<VarId> join_vars;
+        std::vector<VarId> rhs_only_vars;
+        for (auto var : scan_rhs->get_vars()) {
+            if (lhs_vars.find(var) != lhs_vars.end()) {
+                join_vars.push_back(var);
+            } else {
+                rhs_only_vars.push_back(var);
+            }
+        }
+        // without join vars it is a cartesian product, where rhs is read
+        // once anyway
+        if (!join_vars.empty()) {
+            return std::make_unique<AdaptiveJoin>(
+                lhs->get_binding_iter(),
+                rhs->get_binding_iter(),
+                scan_rhs->get_binding_iter(),
+                std::move(join_vars),
+                std::move(rhs_only_vars),
+                lhs->estimate_output_size(),
+                scan_rhs->estimate_output_size()
+            );
+        }
+    }
     return std::make_unique<IndexNestedLoopJoin>(
         lhs->get_binding_iter(),
         rhs->get_binding_iter()
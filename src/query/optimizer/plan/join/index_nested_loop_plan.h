@@ -12,6 +12,8 @@ public:
     IndexNestedLoopPlan(const IndexNestedLoopPlan& other) :
         lhs                   (other.lhs->clone()),
         rhs                   (other.rhs->clone()),
+        scan_rhs              (other.scan_rhs == nullptr ? nullptr : other.scan_rhs->clone()),
+        order                 (other.order),
         estimated_cost        (other.estimated_cost),
         estimated_output_size (other.estimated_output_size)  { }
 
@@ -28,6 +30,8 @@ public:
     std::set<VarId> get_vars() const override;
     void set_input_vars(const std::set<VarId>& input_vars) override;
 
+    std::vector<VarId> get_order() const override { return order; }
+
     std::unique_ptr<BindingIter> get_binding_iter() const override;
 
     bool get_leapfrog_iter(std::vector<std::unique_ptr<LeapfrogIter>>&,
@@ -40,6 +44,13 @@ private:
     std::unique_ptr<Plan> lhs;
     std::unique_ptr<Plan> rhs;
 
+    // rhs without the vars of lhs as input, used by the AdaptiveJoin if
+    // rhs is an index scan
+    std::unique_ptr<Plan> scan_rhs;
+
+    // the order of lhs, if the join keeps it
+    std::vector<VarId> order;
+
     double estimated_cost;
     double estimated_output_size;
 };
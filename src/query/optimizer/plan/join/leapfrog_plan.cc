@@ -0,0 +1,65 @@
+#include "leapfrog_plan.h"
+
+#include "query/exceptions.h"
+#include "query/optimizer/plan/join_order/leapfrog_optimizer.h"
+
+LeapfrogPlan::LeapfrogPlan(
+    std::vector<std::unique_ptr<Plan>>&& _base_plans,
+    std::unique_ptr<Plan>                _fallback,
+    double                               estimated_output_size
+) :
+    base_plans            (std::move(_base_plans)),
+    fallback              (std::move(_fallback)),
+    estimated_output_size (estimated_output_size)
+{
+    // each relation is read at most once, seeking the values of the other ones
+    estimated_cost = estimated_output_size;
+    for (auto& plan : base_plans) {
+        estimated_cost += plan->estimate_cost();
+    }
+}
+
+
+void LeapfrogPlan::print(std::ostream& os, int indent) const {
+    for (int i = 0; i < indent; ++i) {
+        os << ' ';
+    }
+    os << "Leapfrog(\n";
+    for (size_t i = 0; i < base_plans.size(); i++) {
+        if (i != 0) {
+            os << ",\n";
+        }
+        base_plans[i]->print(os, indent + 2);
+    }
+    os << "\n";
+    for (int i = 0; i < indent; ++i) {
+        os << ' ';
+    }
+    os << ")";
+}
+
+
+std::set<VarId> LeapfrogPlan::get_vars() const {
+    std::set<VarId> result;
+    for (auto& plan : base_plans) {
+        for (auto var : plan->get_vars()) {
+            result.insert(var);
+        }
+    }
+    return result;
+}
+
+
+void LeapfrogPlan::set_input_vars(const std::set<VarId>& /*input_vars*/) {
+    throw LogicException("Leapfrog only works for left deep plans.");
+}
+
+
+std::unique_ptr<BindingIter> LeapfrogPlan::get_binding_iter() const {
+    // the input vars were given to the base plans before the optimization
+    auto leapfrog_iter = LeapfrogOptimizer::try_get_iter_with_assigned(base_plans);
+    if (leapfrog_iter != nullptr) {
+        return leapfrog_iter;
+    }
+    return fallback->get_binding_iter();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "query/optimizer/plan/plan.h"
+
+// Worst case optimal join of a set of base plans with a LeapfrogJoin. As
+// leapfrog may not be possible with the indexes of the base plans, the plan
+// `fallback` for the same relations is used in that case
+class LeapfrogPlan : public Plan {
+public:
+    LeapfrogPlan(
+        std::vector<std::unique_ptr<Plan>>&& base_plans,
+        std::unique_ptr<Plan>                fallback,
+        double                               estimated_output_size
+    );
+
+    LeapfrogPlan(const LeapfrogPlan& other) :
+        fallback              (other.fallback->clone()),
+        estimated_cost        (other.estimated_cost),
+        estimated_output_size (other.estimated_output_size)
+    {
+        for (auto& plan : other.base_plans) {
+            base_plans.push_back(plan->clone());
+        }
+    }
+
+    std::unique_ptr<Plan> clone() const override {
+        return std::make_unique<LeapfrogPlan>(*this);
+    }
+
+    // only meant to be used by base plans, not joins
+    int relation_size() const override { return 0; }
+
+    double estimate_cost()        const override { return estimated_cost; }
+    double estimate_output_size() const override { return estimated_output_size; }
+
+    std::set<VarId> get_vars() const override;
+    void set_input_vars(const std::set<VarId>& input_vars) override;
+
+    std::unique_ptr<BindingIter> get_binding_iter() const override;
+
+    bool get_leapfrog_iter(std::vector<std::unique_ptr<LeapfrogIter>>&,
+                           std::vector<VarId>&,
+                           uint_fast32_t&) const override { return false; }
+
+    void print(std::ostream& os, int indent) const override;
+
+private:
+    std::vector<std::unique_ptr<Plan>> base_plans;
+
+    std::unique_ptr<Plan> fallback;
+
+    double estimated_cost;
+    double estimated_output_size;
+};
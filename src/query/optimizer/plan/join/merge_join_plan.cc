@@ -0,0 +1,94 @@
+#include "merge_join_plan.h"
+
+#include "query/exceptions.h"
+#include "query/executor/binding_iter/merge_join.h"
+
+MergeJoinPlan::MergeJoinPlan(
+    std::unique_ptr<Plan> _lhs,
+    std::unique_ptr<Plan> _rhs,
+    VarId                 merge_var
+) :
+    lhs       (std::move(_lhs)),
+    rhs       (std::move(_rhs)),
+    merge_var (merge_var)
+{
+    // the output is estimated as in the IndexNestedLoopPlan, to compare both
+    auto rhs_with_input = rhs->clone();
+    rhs_with_input->set_input_vars(lhs->get_vars());
+    estimated_output_size = lhs->estimate_output_size() * rhs_with_input->estimate_output_size();
+
+    // each relation is read once
+    estimated_cost = lhs->estimate_cost() + rhs->estimate_cost();
+}
+
+
+std::unique_ptr<Plan> MergeJoinPlan::try_create(const Plan& lhs, const Plan& rhs)
+{
+    auto rhs_vars = rhs.get_vars();
+    for (auto var : lhs.get_vars()) {
+        if (rhs_vars.find(var) == rhs_vars.end()) {
+            continue;
+        }
+        auto sorted_lhs = lhs.clone();
+        auto sorted_rhs = rhs.clone();
+        if (sorted_lhs->order_by(var) && sorted_rhs->order_by(var)) {
+            return std::make_unique<MergeJoinPlan>(std::move(sorted_lhs), std::move(sorted_rhs), var);
+        }
+    }
+    return nullptr;
+}
+
+
+void MergeJoinPlan::print(std::ostream& os, int indent) const {
+    for (int i = 0; i < indent; ++i) {
+        os << ' ';
+    }
+    os << "MergeJoin(" << merge_var << ",\n";
+    lhs->print(os, indent + 2);
+    os << ",\n";
+    rhs->print(os, indent + 2);
+    os << "\n";
+    for (int i = 0; i < indent; ++i) {
+        os << ' ';
+    }
+    os << ")";
+}
+
+
+std::set<VarId> MergeJoinPlan::get_vars() const {
+    auto result = lhs->get_vars();
+    for (auto var : rhs->get_vars()) {
+        result.insert(var);
+    }
+    return result;
+}
+
+
+void MergeJoinPlan::set_input_vars(const std::set<VarId>& /*input_vars*/) {
+    throw LogicException("MergeJoin only works for left deep plans.");
+}
+
+
+std::unique_ptr<BindingIter> MergeJoinPlan::get_binding_iter() const {
+    auto lhs_vars = lhs->get_vars();
+    std::vector<VarId> join_vars;
+    std::vector<VarId> rhs_only_vars;
+    for (auto var : rhs->get_vars()) {
+        if (var == merge_var) {
+            continue;
+        }
+        if (lhs_vars.find(var) != lhs_vars.end()) {
+            join_vars.push_back(var);
+        } else {
+            rhs_only_vars.push_back(var);
+        }
+    }
+
+    return std::make_unique<MergeJoin>(
+        lhs->get_binding_iter(),
+        rhs->get_binding_iter(),
+        merge_var,
+        std::move(join_vars),
+        std::move(rhs_only_vars)
+    );
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "query/optimizer/plan/plan.h"
+
+// Join of lhs and rhs when both are sorted by `merge_var`, rhs is read once
+// instead of being searched for each row of lhs
+class MergeJoinPlan : public Plan {
+public:
+    // lhs and rhs must be sorted by merge_var (see Plan::order_by)
+    MergeJoinPlan(
+        std::unique_ptr<Plan> lhs,
+        std::unique_ptr<Plan> rhs,
+        VarId                 merge_var
+    );
+
+    // returns a MergeJoinPlan of clones of lhs and rhs if both can be sorted
+    // by a common var, or nullptr
+    static std::unique_ptr<Plan> try_create(const Plan& lhs, const Plan& rhs);
+
+    MergeJoinPlan(const MergeJoinPlan& other) :
+        lhs                   (other.lhs->clone()),
+        rhs                   (other.rhs->clone()),
+        merge_var             (other.merge_var),
+        estimated_cost        (other.estimated_cost),
+        estimated_output_size (other.estimated_output_size) { }
+
+    std::unique_ptr<Plan> clone() const override {
+        return std::make_unique<MergeJoinPlan>(*this);
+    }
+
+    // only meant to be used by base plans, not joins
+    int relation_size() const override { return 0; }
+
+    double estimate_cost()        const override { return estimated_cost; }
+    double estimate_output_size() const override { return estimated_output_size; }
+
+    std::set<VarId> get_vars() const override;
+    void set_input_vars(const std::set<VarId>& input_vars) override;
+
+    // the rows of rhs with the same merge_var are returned for each lhs row
+    std::vector<VarId> get_order() const override { return lhs->get_order(); }
+
+    std::unique_ptr<BindingIter> get_binding_iter() const override;
+
+    bool get_leapfrog_iter(std::vector<std::unique_ptr<LeapfrogIter>>&,
+                           std::vector<VarId>&,
+                           uint_fast32_t&) const override { return false; }
+
+    void print(std::ostream& os, int indent) const override;
+
+private:
+    std::unique_ptr<Plan> lhs;
+    std::unique_ptr<Plan> rhs;
+
+    VarId merge_var;
+
+    double estimated_cost;
+    double estimated_output_size;
+};
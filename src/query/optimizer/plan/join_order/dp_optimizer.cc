@@ -0,0 +1,281 @@
+#include "dp_optimizer.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+
+#include "macros/count_zeros.h"
+#include "query/optimizer/plan/join/hash_join_plan.h"
+#include "query/optimizer/plan/join/index_nested_loop_plan.h"
+#include "query/optimizer/plan/join/leapfrog_plan.h"
+#include "query/optimizer/plan/join/merge_join_plan.h"
+#include "query/optimizer/plan/join_order/greedy_optimizer.h"
+
+// the BGP hash joins are instantiated up to 4 join vars
+static constexpr std::size_t MAX_HASH_JOIN_VARS = 4;
+
+static inline std::size_t count_plans(uint64_t subset)
+{
+    return std::bitset<64>(subset).count();
+}
+
+DPOptimizer::DPOptimizer(const std::vector<std::unique_ptr<Plan>>& base_plans, uint_fast32_t threads) :
+    base_plans (base_plans),
+    plans_size (base_plans.size()),
+    threads    (threads) { }
+
+
+std::unique_ptr<Plan> DPOptimizer::get_plan()
+{
+    assert(!base_plans.empty());
+    if (plans_size == 1) {
+        return base_plans[0]->clone();
+    }
+    if (plans_size > MAX_PLANS) {
+        return GreedyOptimizer::get_plan(base_plans);
+    }
+
+    std::vector<std::set<VarId>> plan_vars;
+    for (auto& plan : base_plans) {
+        plan_vars.push_back(plan->get_vars());
+    }
+    neighbors.assign(plans_size, 0);
+    for (size_t i = 0; i < plans_size; i++) {
+        for (size_t j = i + 1; j < plans_size; j++) {
+            for (auto var : plan_vars[i]) {
+                if (plan_vars[j].find(var) != plan_vars[j].end()) {
+                    neighbors[i] |= Subset(1) << j;
+                    neighbors[j] |= Subset(1) << i;
+                    break;
+                }
+            }
+        }
+    }
+
+    const Subset all_plans = (Subset(1) << plans_size) - 1;
+    if (!is_connected(all_plans)) {
+        return GreedyOptimizer::get_plan(base_plans);
+    }
+
+    // plans are numbered so that B_i (the plans before i, and i) is (2 << i) - 1
+    for (size_t i = plans_size; i-- > 0;) {
+        emit_csg(Subset(1) << i);
+        enumerate_csg_rec(Subset(1) << i, (Subset(2) << i) - 1);
+        if (too_many_pairs) {
+            return GreedyOptimizer::get_plan(base_plans);
+        }
+    }
+
+    // the plans of a subset are completed before it is used in a bigger one
+    std::sort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) {
+        auto a_union = a.first | a.second;
+        auto b_union = b.first | b.second;
+        auto a_size = count_plans(a_union);
+        auto b_size = count_plans(b_union);
+        return a_size < b_size || (a_size == b_size && a_union < b_union);
+    });
+
+    for (size_t i = 0; i < plans_size; i++) {
+        best_plans.insert({ Subset(1) << i, base_plans[i]->clone() });
+    }
+
+    for (size_t i = 0; i < pairs.size(); i++) {
+        auto [subset, complement] = pairs[i];
+        join(subset, complement);
+        join(complement, subset);
+
+        auto joined = subset | complement;
+        if (i + 1 == pairs.size() || (pairs[i + 1].first | pairs[i + 1].second) != joined) {
+            try_leapfrog(joined);
+        }
+    }
+
+    return std::move(best_plans[all_plans]);
+}
+
+
+DPOptimizer::Subset DPOptimizer::get_neighborhood(Subset subset, Subset excluded) const
+{
+    Subset res = 0;
+    for (auto rest = subset; rest != 0; rest &= rest - 1) {
+        res |= neighbors[MDB_COUNT_TRAILING_ZEROS_64(rest)];
+    }
+    return res & ~(subset | excluded);
+}
+
+
+bool DPOptimizer::is_connected(Subset subset) const
+{
+    if (subset == 0) {
+        return false;
+    }
+    Subset reached = subset & (~subset + 1);
+    while (true) {
+        auto next = (reached | get_neighborhood(reached, 0)) & subset;
+        if (next == reached) {
+            return reached == subset;
+        }
+        reached = next;
+    }
+}
+
+
+std::set<VarId> DPOptimizer::get_vars(Subset subset) const
+{
+    std::set<VarId> res;
+    for (auto rest = subset; rest != 0; rest &= rest - 1) {
+        for (auto var : base_plans[MDB_COUNT_TRAILING_ZEROS_64(rest)]->get_vars()) {
+            res.insert(var);
+        }
+    }
+    return res;
+}
+
+
+double DPOptimizer::get_output_size(Subset subset)
+{
+    auto it = output_sizes.find(subset);
+    if (it != output_sizes.end()) {
+        return it->second;
+    }
+
+    double res;
+    if (count_plans(subset) == 1) {
+        res = base_plans[MDB_COUNT_TRAILING_ZEROS_64(subset)]->estimate_output_size();
+    } else {
+        // a connected graph always has a node whose removal keeps it connected
+        Subset last = 0;
+        Subset rest = 0;
+        for (auto candidates = subset; candidates != 0; candidates &= candidates - 1) {
+            last = candidates & (~candidates + 1);
+            rest = subset & ~last;
+            if (is_connected(rest)) {
+                break;
+            }
+        }
+        auto last_plan = base_plans[MDB_COUNT_TRAILING_ZEROS_64(last)]->clone();
+        last_plan->set_input_vars(get_vars(rest));
+        res = get_output_size(rest) * last_plan->estimate_output_size();
+    }
+    output_sizes.insert({ subset, res });
+    return res;
+}
+
+
+void DPOptimizer::enumerate_csg_rec(Subset subset, Subset excluded)
+{
+    auto neighborhood = get_neighborhood(subset, excluded);
+    if (neighborhood == 0) {
+        return;
+    }
+    for (auto s = neighborhood; s != 0; s = (s - 1) & neighborhood) {
+        emit_csg(subset | s);
+    }
+    for (auto s = neighborhood; s != 0 && !too_many_pairs; s = (s - 1) & neighborhood) {
+        enumerate_csg_rec(subset | s, excluded | neighborhood);
+    }
+}
+
+
+void DPOptimizer::emit_csg(Subset subset)
+{
+    auto min_plan = MDB_COUNT_TRAILING_ZEROS_64(subset);
+    auto excluded = subset | ((Subset(2) << min_plan) - 1);
+    auto neighborhood = get_neighborhood(subset, excluded);
+
+    // neighbors are visited from the last one
+    for (auto rest = neighborhood; rest != 0 && !too_many_pairs;) {
+        auto i = 63 - MDB_COUNT_LEADING_ZEROS_64(rest);
+        auto complement = Subset(1) << i;
+        rest &= ~complement;
+
+        emit_csg_cmp(subset, complement);
+        enumerate_cmp_rec(subset, complement, excluded | (((Subset(2) << i) - 1) & neighborhood));
+    }
+}
+
+
+void DPOptimizer::enumerate_cmp_rec(Subset subset, Subset complement, Subset excluded)
+{
+    auto neighborhood = get_neighborhood(complement, excluded);
+    if (neighborhood == 0) {
+        return;
+    }
+    for (auto s = neighborhood; s != 0; s = (s - 1) & neighborhood) {
+        emit_csg_cmp(subset, complement | s);
+    }
+    for (auto s = neighborhood; s != 0 && !too_many_pairs; s = (s - 1) & neighborhood) {
+        enumerate_cmp_rec(subset, complement | s, excluded | neighborhood);
+    }
+}
+
+
+void DPOptimizer::emit_csg_cmp(Subset subset, Subset complement)
+{
+    if (pairs.size() == MAX_PAIRS) {
+        too_many_pairs = true;
+        return;
+    }
+    pairs.push_back({ subset, complement });
+}
+
+
+void DPOptimizer::join(Subset lhs, Subset rhs)
+{
+    auto& lhs_plan = *best_plans[lhs];
+    auto& rhs_plan = *best_plans[rhs];
+    auto joined = lhs | rhs;
+
+    // only base plans accept input vars
+    if (count_plans(rhs) == 1) {
+        update_best_plan(joined, std::make_unique<IndexNestedLoopPlan>(lhs_plan.clone(), rhs_plan.clone()));
+
+        auto merge_join_plan = MergeJoinPlan::try_create(lhs_plan, rhs_plan);
+        if (merge_join_plan != nullptr) {
+            update_best_plan(joined, std::move(merge_join_plan));
+        }
+    }
+
+    auto lhs_vars = lhs_plan.get_vars();
+    size_t join_vars = 0;
+    for (auto var : rhs_plan.get_vars()) {
+        if (lhs_vars.find(var) != lhs_vars.end()) {
+            join_vars++;
+        }
+    }
+    if (join_vars > 0 && join_vars <= MAX_HASH_JOIN_VARS) {
+        update_best_plan(
+            joined,
+            std::make_unique<HashJoinPlan>(lhs_plan.clone(), rhs_plan.clone(), get_output_size(joined), threads)
+        );
+    }
+}
+
+
+void DPOptimizer::try_leapfrog(Subset subset)
+{
+    std::vector<std::unique_ptr<Plan>> plans;
+    for (auto rest = subset; rest != 0; rest &= rest - 1) {
+        auto& plan = base_plans[MDB_COUNT_TRAILING_ZEROS_64(rest)];
+        if (!plan->is_index_scan()) {
+            return;
+        }
+        plans.push_back(plan->clone());
+    }
+
+    // the best join is kept in case leapfrog is not possible
+    auto& fallback = best_plans[subset];
+    update_best_plan(
+        subset,
+        std::make_unique<LeapfrogPlan>(std::move(plans), fallback->clone(), get_output_size(subset))
+    );
+}
+
+
+void DPOptimizer::update_best_plan(Subset subset, std::unique_ptr<Plan> plan)
+{
+    auto& best_plan = best_plans[subset];
+    if (best_plan == nullptr || plan->estimate_cost() < best_plan->estimate_cost()) {
+        best_plan = std::move(plan);
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "query/optimizer/plan/plan.h"
+
+/*
+Chooses the join of the base plans with dynamic programming over bushy
+plans. The query graph has a node for each base plan and an edge between
+plans with a variable in common. Its connected subgraphs and their connected
+complements are enumerated as in DPccp (Moerkotte & Neumann, "Analysis of
+Two Existing and One New Dynamic Programming Algorithm for the Generation of
+Optimal Bushy Join Trees without Cross Products"), so cross products are
+never considered.
+
+For each pair of subsets the candidates are:
+- IndexNestedLoopPlan, if the inner relation is a single base plan.
+- MergeJoinPlan, if both relations can be sorted by a common variable.
+- HashJoinPlan, if they have between 1 and 4 variables in common, using up
+  to `threads` threads.
+- LeapfrogPlan of all the base plans, if they are index scans.
+
+The output size of each subset is estimated once, as the IndexNestedLoopPlan
+would estimate it, so the different plans of a subset are compared by cost.
+
+When the query graph is not connected, or there are more than MAX_PLANS base
+plans or more than MAX_PAIRS pairs of subsets, the GreedyOptimizer is used.
+*/
+class DPOptimizer {
+public:
+    static constexpr std::size_t MAX_PLANS = 20;
+
+    static constexpr std::size_t MAX_PAIRS = 100'000;
+
+    DPOptimizer(const std::vector<std::unique_ptr<Plan>>& base_plans, uint_fast32_t threads = 1);
+
+    std::unique_ptr<Plan> get_plan();
+
+private:
+    // subsets of base plans are represented by a bitmask of their indexes
+    using Subset = uint64_t;
+
+    const std::vector<std::unique_ptr<Plan>>& base_plans;
+
+    const std::size_t plans_size;
+
+    const uint_fast32_t threads;
+
+    // plans adjacent to each base plan in the query graph
+    std::vector<Subset> neighbors;
+
+    // pairs of connected subsets that are adjacent and disjoint
+    std::vector<std::pair<Subset, Subset>> pairs;
+
+    bool too_many_pairs = false;
+
+    std::unordered_map<Subset, std::unique_ptr<Plan>> best_plans;
+
+    std::unordered_map<Subset, double> output_sizes;
+
+    Subset get_neighborhood(Subset subset, Subset excluded) const;
+
+    bool is_connected(Subset subset) const;
+
+    std::set<VarId> get_vars(Subset subset) const;
+
+    double get_output_size(Subset subset);
+
+    // DPccp enumeration, see the paper for the meaning of each procedure
+    void enumerate_csg_rec(Subset subset, Subset excluded);
+    void emit_csg(Subset subset);
+    void enumerate_cmp_rec(Subset subset, Subset complement, Subset excluded);
+    void emit_csg_cmp(Subset subset, Subset complement);
+
+    // compares the joins with lhs as outer relation and rhs as inner relation
+    void join(Subset lhs, Subset rhs);
+
+    void try_leapfrog(Subset subset);
+
+    void update_best_plan(Subset subset, std::unique_ptr<Plan> plan);
+};
@@ -3,6 +3,7 @@
 #include <limits>
 
 #include "query/optimizer/plan/join/index_nested_loop_plan.h"
+#include "query/optimizer/plan/join/merge_join_plan.h"
 
 std::unique_ptr<Plan> GreedyOptimizer::get_plan(const std::vector<std::unique_ptr<Plan>>& real_base_plans)
 {
@@ -51,6 +52,13 @@ std::unique_ptr<Plan> GreedyOptimizer::get_plan(const std::vector<std::unique_pt
                     best_index = j;
                     best_step_plan = std::move(nested_loop_plan);
                 }
+
+                auto merge_join_plan = MergeJoinPlan::try_create(*root_plan, *base_plans[j]);
+                if (merge_join_plan != nullptr && merge_join_plan->estimate_cost() < best_cost) {
+                    best_cost = merge_join_plan->estimate_cost();
+                    best_index = j;
+                    best_step_plan = std::move(merge_join_plan);
+                }
                 // auto hash_join_plan = make_unique<HashJoinPlan>(
                 //     root_plan->clone(),
                 //     base_plans[j]->clone()
@@ -1,5 +1,6 @@
 #include "leapfrog_optimizer.h"
 
+#include <algorithm>
 #include <map>
 
 #include "query/executor/binding_iter/index_nested_loop_join.h"
@@ -319,7 +320,8 @@ unique_ptr<BindingIter> LeapfrogOptimizer::try_get_iter_with_assigned(
     for (auto&& [var, plans] : var2plans) {
         double best_cost = std::numeric_limits<double>::infinity();
         for (auto plan : plans) {
-            auto cost = plan->estimate_cost();
+            // the intersection can't have more values than any of the relations
+            auto cost = std::min(plan->estimate_cost(), plan->estimate_distinct_values(var));
             if (cost < best_cost) {
                 best_cost = cost;
             }
@@ -26,6 +26,10 @@ public:
 
     virtual double estimate_output_size() const = 0;
 
+    // estimates how many distinct values `var` has in the output, by default
+    // as if all of them were distinct
+    virtual double estimate_distinct_values(VarId /*var*/) const { return estimate_output_size(); }
+
     // returns a set with the variables mentioned in the relation, excluding the input vars
     virtual std::set<VarId> get_vars() const = 0;
 
@@ -44,6 +48,21 @@ public:
     // only meant to be used by base plans, not joins
     virtual int relation_size() const = 0;
 
+    // true if the relation is read from an index even if no var is assigned,
+    // so a join can read it once instead of searching it for each input
+    virtual bool is_index_scan() const { return false; }
+
+    // returns the variables by which the rows of the relation are sorted, the first
+    // one is the most significant. Input vars are not included, as they don't change
+    virtual std::vector<VarId> get_order() const { return {}; }
+
+    // tries to make the relation return its rows sorted by `var` first, changing the
+    // index used if needed. Returns false if it is not possible
+    virtual bool order_by(VarId var) {
+        auto order = get_order();
+        return !order.empty() && order[0] == var;
+    }
+
     bool cartesian_product_needed(const Plan& other) {
         auto other_vars = other.get_vars();
         for (auto var : get_vars()) {
@@ -107,7 +107,8 @@ void PathBindingIterConstructor::visit(OpReturn& op_return)
             std::move(group_saved_vars),
             std::move(group_vars_vector),
             std::move(ascending),
-            &OrderBy::internal_compare
+            &OrderBy::internal_compare,
+            &SortKey::normalize_id
         );
     }
 
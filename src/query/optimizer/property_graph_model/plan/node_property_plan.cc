@@ -19,10 +19,21 @@ double NodePropertyPlan::estimate_cost() const
 
 double NodePropertyPlan::estimate_output_size() const
 {
-    if (gql_model.catalog.node_key2total_count.count(key.get_OID().get_value())) {
-        return gql_model.catalog.node_key2total_count[key.get_OID().get_value()];
+    const auto key_id = key.get_OID().get_value();
+    auto it = gql_model.catalog.node_key2total_count.find(key_id);
+    if (it == gql_model.catalog.node_key2total_count.end()) {
+        return 0;
     }
-    return 0;
+    const double key_count = it->second;
+
+    // the properties are divided between the distinct values of the key
+    if (value_assigned) {
+        auto sketch = gql_model.catalog.node_key2distinct_values.find(key_id);
+        if (sketch != gql_model.catalog.node_key2distinct_values.end() && sketch->second.estimate() >= 1) {
+            return key_count / sketch->second.estimate();
+        }
+    }
+    return key_count;
 }
 
 std::set<VarId> NodePropertyPlan::get_vars() const
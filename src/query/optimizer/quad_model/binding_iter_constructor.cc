@@ -1,5 +1,6 @@
 #include "binding_iter_constructor.h"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
@@ -49,6 +50,34 @@ std::vector<std::pair<VarId, std::unique_ptr<BindingExpr>>>
     exprs.clear();
     return res;
 }
+
+// If iter is an IndexScan<N> with enough records for more than one morsel, it
+// is replaced by a Gather running up to quad_model.MAX_PARALLELISM copies of the scan
+template <std::size_t N>
+bool try_parallelize_scan(std::unique_ptr<BindingIter>& iter)
+{
+    auto index_scan = dynamic_cast<IndexScan<N>*>(iter.get());
+    if (index_scan == nullptr || quad_model.MAX_PARALLELISM <= 1) {
+        return false;
+    }
+    Binding empty_binding(get_query_ctx().get_var_size());
+    auto morsels = (index_scan->count_records(empty_binding) + Gather<N>::MORSEL_SIZE - 1)
+                 / Gather<N>::MORSEL_SIZE;
+    auto workers = std::min<uint64_t>(quad_model.MAX_PARALLELISM, morsels);
+    if (workers <= 1) {
+        return false;
+    }
+
+    std::vector<std::unique_ptr<BindingIter>> pipelines;
+    std::vector<IndexScan<N>*> scans;
+    for (uint64_t i = 0; i < workers; i++) {
+        auto scan = index_scan->clone();
+        scans.push_back(scan.get());
+        pipelines.push_back(std::move(scan));
+    }
+    iter = std::make_unique<Gather<N>>(std::move(pipelines), std::move(scans));
+    return true;
+}
 } // namespace MQL
 
 BindingIterConstructor::BindingIterConstructor()
@@ -476,11 +505,18 @@ void BindingIterConstructor::visit(OpReturn& op_return)
             std::move(group_saved_vars),
             std::move(group_vars_vector),
             std::move(ascending),
-            &OrderBy::internal_compare
+            &OrderBy::internal_compare,
+            &SortKey::normalize_id,
+            quad_model.MAX_PARALLELISM
         );
     }
 
     if (aggregations.size() > 0 || group_vars.size() > 0) {
+        // the aggregation does not depend on the order of its input, so a large
+        // scan is read by several threads
+        try_parallelize_scan<1>(tmp) || try_parallelize_scan<2>(tmp) || try_parallelize_scan<3>(tmp)
+            || try_parallelize_scan<4>(tmp);
+
         tmp = std::make_unique<Aggregation>(std::move(tmp), std::move(aggregations), std::move(group_vars));
     }
     if (aggregations.size() > 0 || group_vars.size() > 0) {
@@ -506,7 +542,9 @@ void BindingIterConstructor::visit(OpReturn& op_return)
             std::move(order_by_saved_vars),
             std::move(order_by_vars),
             std::move(op_order_by->ascending_order),
-            &Comparisons::compare
+            &Comparisons::compare,
+            nullptr,
+            quad_model.MAX_PARALLELISM
         );
     }
 
@@ -105,6 +105,20 @@ double EdgePlan::estimate_output_size() const
     } else if (type_assigned) { // end special cases
         if (type.is_OID()) {
             double count = quad_model.catalog.connections_with_type(type.get_OID().id);
+
+            // the edges are divided between the distinct from and to of the type
+            if (from_assigned || to_assigned) {
+                double distinct_values = 1;
+                if (from_assigned) {
+                    distinct_values *= quad_model.catalog.distinct_from_with_type(type.get_OID().id);
+                }
+                if (to_assigned) {
+                    distinct_values *= quad_model.catalog.distinct_to_with_type(type.get_OID().id);
+                }
+                if (distinct_values >= 1) {
+                    return count / distinct_values;
+                }
+            }
             return count / heuristic_divisor;
         } else {
             return total_connections / heuristic_divisor;
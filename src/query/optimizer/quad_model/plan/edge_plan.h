@@ -27,6 +27,8 @@ public:
         return 4;
     }
 
+    bool is_index_scan() const override { return true; }
+
     double estimate_cost() const override;
     double estimate_output_size() const override;
 
@@ -19,6 +19,8 @@ public:
 
     int relation_size() const override { return 2; }
 
+    bool is_index_scan() const override { return true; }
+
     double estimate_cost() const override;
     double estimate_output_size() const override;
 
@@ -58,12 +58,13 @@ double PropertyPlan::estimate_output_size() const {
         if (key.is_OID()) {
             auto it = quad_model.catalog.key2total_count.find(key.get_OID().id);
             if (it != quad_model.catalog.key2total_count.end()) {
-                total_values = it->second;
+                key_count = it->second;
             }
 
-            it = quad_model.catalog.key2total_count.find(key.get_OID().id);
-            if (it != quad_model.catalog.key2total_count.end()) {
-                key_count = it->second;
+            // without a sketch of the key all its values are considered distinct
+            total_values = quad_model.catalog.distinct_values_with_key(key.get_OID().id);
+            if (total_values < 1) {
+                total_values = key_count;
             }
         } else {
             // TODO: this case (key is an assigned variable) is not possible yet, but we may need to cover it in the future
@@ -21,6 +21,8 @@ public:
 
     int relation_size() const override { return 3; }
 
+    bool is_index_scan() const override { return true; }
+
     double estimate_cost() const override;
     double estimate_output_size() const override;
 
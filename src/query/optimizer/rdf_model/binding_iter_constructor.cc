@@ -1,7 +1,9 @@
 #include "binding_iter_constructor.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <limits>
 #include <sys/types.h>
 
 #include "graph_models/rdf_model/comparisons.h"
@@ -9,13 +11,16 @@
 #include "graph_models/rdf_model/rdf_model.h"
 #include "misc/set_operations.h"
 #include "query/exceptions.h"
+#include "query/executor/binding_iter/aggregation/sparql/agg_count_all.h"
 #include "query/executor/binding_iter/binding_expr/binding_expr_var.h"
 #include "query/executor/binding_iters.h"
-#include "query/optimizer/plan/join_order/greedy_optimizer.h"
+#include "query/optimizer/plan/join_order/dp_optimizer.h"
 #include "query/optimizer/plan/join_order/leapfrog_optimizer.h"
+#include "query/optimizer/rdf_model/check_non_deterministic.h"
 #include "query/optimizer/rdf_model/expr_to_binding_expr.h"
 #include "query/optimizer/rdf_model/plan/path_plan.h"
 #include "query/optimizer/rdf_model/plan/triple_plan.h"
+#include "query/parser/expr/sparql/exprs.h"
 #include "query/parser/op/sparql/ops.h"
 
 using namespace SPARQL;
@@ -27,6 +32,96 @@ BindingIterConstructor::BindingIterConstructor()
     begin_at_left.resize(get_query_ctx().get_var_size());
 }
 
+// Wraps the iter of rhs, that is evaluated again for each row of the lhs of a
+// join, so its results are reused when the values of its input vars repeat.
+// The input vars are the fixable vars of rhs and the other vars of rhs that
+// `outer_vars` (the vars bound before rhs is evaluated) may have bound, e.g.
+// a var of lhs used in a FILTER of rhs. If rhs may return different results
+// for the same input (RAND(), UUID(), STRUUID() or BNODE()) it is not wrapped.
+std::unique_ptr<BindingIter> memoize_rhs(
+    std::unique_ptr<BindingIter> rhs_iter,
+    Op& rhs,
+    const std::set<VarId>& rhs_fixable_vars,
+    const std::set<VarId>& outer_vars
+)
+{
+    CheckNonDeterministic check_non_deterministic;
+    rhs.accept_visitor(check_non_deterministic);
+    if (check_non_deterministic.found) {
+        return rhs_iter;
+    }
+
+    auto value_vars = set_difference(rhs.get_scope_vars(), rhs_fixable_vars);
+    auto key_vars = set_union(
+        rhs_fixable_vars,
+        set_difference(set_intersection(rhs.get_all_vars(), outer_vars), value_vars)
+    );
+    return std::make_unique<Memoize>(std::move(rhs_iter), set_to_vector(key_vars), set_to_vector(value_vars));
+}
+
+// Adds to `ranges` the values allowed by the comparisons of a var with a numeric
+// or datetime constant (e.g. ?x > 5) in the conjunctions of `expr`
+void add_filter_ranges(Expr* expr, std::map<VarId, ValueHistogram::Range>& ranges)
+{
+    if (auto expr_and = dynamic_cast<ExprAnd*>(expr)) {
+        add_filter_ranges(expr_and->lhs.get(), ranges);
+        add_filter_ranges(expr_and->rhs.get(), ranges);
+        return;
+    }
+
+    Expr* lhs;
+    Expr* rhs;
+    bool lower_bound; // true if lhs is greater than rhs
+    if (auto expr_greater = dynamic_cast<ExprGreater*>(expr)) {
+        lhs = expr_greater->lhs.get();
+        rhs = expr_greater->rhs.get();
+        lower_bound = true;
+    } else if (auto expr_greater_or_equal = dynamic_cast<ExprGreaterOrEqual*>(expr)) {
+        lhs = expr_greater_or_equal->lhs.get();
+        rhs = expr_greater_or_equal->rhs.get();
+        lower_bound = true;
+    } else if (auto expr_less = dynamic_cast<ExprLess*>(expr)) {
+        lhs = expr_less->lhs.get();
+        rhs = expr_less->rhs.get();
+        lower_bound = false;
+    } else if (auto expr_less_or_equal = dynamic_cast<ExprLessOrEqual*>(expr)) {
+        lhs = expr_less_or_equal->lhs.get();
+        rhs = expr_less_or_equal->rhs.get();
+        lower_bound = false;
+    } else {
+        return;
+    }
+
+    auto expr_var = dynamic_cast<ExprVar*>(lhs);
+    auto expr_term = dynamic_cast<ExprTerm*>(rhs);
+    if (expr_var == nullptr) {
+        // the constant is at the left, as in 5 < ?x
+        expr_var = dynamic_cast<ExprVar*>(rhs);
+        expr_term = dynamic_cast<ExprTerm*>(lhs);
+        lower_bound = !lower_bound;
+    }
+    if (expr_var == nullptr || expr_term == nullptr) {
+        return;
+    }
+
+    ValueHistogram::Kind kind;
+    double value;
+    if (!ValueHistogram::get_value(expr_term->term, &kind, &value)) {
+        return;
+    }
+
+    constexpr auto infinity = std::numeric_limits<double>::infinity();
+    auto& range = ranges.insert({ expr_var->var, { kind, -infinity, infinity } }).first->second;
+    if (range.kind != kind) {
+        return;
+    }
+    if (lower_bound) {
+        range.low = std::max(range.low, value);
+    } else {
+        range.high = std::min(range.high, value);
+    }
+}
+
 std::vector<std::pair<VarId, std::unique_ptr<BindingExpr>>>
     get_non_redundant_exprs(std::vector<std::pair<VarId, std::unique_ptr<BindingExpr>>>&& exprs)
 {
@@ -47,6 +142,122 @@ std::vector<std::pair<VarId, std::unique_ptr<BindingExpr>>>
     return res;
 }
 
+// If iter is an IndexScan<N> it is replaced by an IndexScanCount<N>, which reads
+// the number of records from the B+tree directory instead of iterating them
+template <std::size_t N>
+bool try_count_from_index(std::unique_ptr<BindingIter>& iter, VarId count_var)
+{
+    if (dynamic_cast<IndexScan<N>*>(iter.get()) == nullptr) {
+        return false;
+    }
+    std::unique_ptr<IndexScan<N>> index_scan(static_cast<IndexScan<N>*>(iter.release()));
+    iter = std::make_unique<IndexScanCount<N>>(std::move(index_scan), count_var);
+    return true;
+}
+
+// If iter is an IndexScan<N> the offset is pushed into it, so the skipped
+// records are never read
+template <std::size_t N>
+bool try_push_offset_into_index(BindingIter* iter, uint64_t offset)
+{
+    auto index_scan = dynamic_cast<IndexScan<N>*>(iter);
+    if (index_scan == nullptr) {
+        return false;
+    }
+    index_scan->offset = offset;
+    return true;
+}
+
+// Number of threads used to read index_scan, at most rdf_model.MAX_PARALLELISM
+// and one per morsel. Only for root queries, so the ranges don't depend on
+// outer bindings
+template <std::size_t N>
+uint64_t get_scan_workers(IndexScan<N>& index_scan)
+{
+    if (index_scan.offset != 0 || rdf_model.MAX_PARALLELISM <= 1) {
+        return 1;
+    }
+    Binding empty_binding(get_query_ctx().get_var_size());
+    auto morsels = (index_scan.count_records(empty_binding) + Gather<N>::MORSEL_SIZE - 1)
+                 / Gather<N>::MORSEL_SIZE;
+    return std::min<uint64_t>(rdf_model.MAX_PARALLELISM, morsels);
+}
+
+// If iter is an IndexScan<N> with enough records for more than one morsel, it
+// is replaced by a Gather running copies of the scan in several threads
+template <std::size_t N>
+bool try_parallelize_scan(std::unique_ptr<BindingIter>& iter)
+{
+    auto index_scan = dynamic_cast<IndexScan<N>*>(iter.get());
+    if (index_scan == nullptr) {
+        return false;
+    }
+    auto workers = get_scan_workers(*index_scan);
+    if (workers <= 1) {
+        return false;
+    }
+
+    std::vector<std::unique_ptr<BindingIter>> pipelines;
+    std::vector<IndexScan<N>*> scans;
+    for (uint64_t i = 0; i < workers; i++) {
+        auto scan = index_scan->clone();
+        scans.push_back(scan.get());
+        pipelines.push_back(std::move(scan));
+    }
+    iter = std::make_unique<Gather<N>>(std::move(pipelines), std::move(scans));
+    return true;
+}
+
+// If iter is an IndexScan<N> with enough records for more than one morsel and
+// the aggregates only read variables, iter is replaced by a ParallelAggregation
+// with a HybridAggregation of iter as fallback
+template <std::size_t N>
+bool try_parallelize_aggregation(
+    std::unique_ptr<BindingIter>&          iter,
+    std::map<VarId, std::unique_ptr<Agg>>& aggregations,
+    std::set<VarId>&                       group_vars,
+    std::set<VarId>&                       group_saved_vars
+)
+{
+    auto index_scan = dynamic_cast<IndexScan<N>*>(iter.get());
+    if (index_scan == nullptr) {
+        return false;
+    }
+    for (auto&& [var, agg] : aggregations) {
+        auto expr = agg->get_expr();
+        if (expr != nullptr && dynamic_cast<const BindingExprVar*>(expr) == nullptr) {
+            return false;
+        }
+    }
+    auto workers = get_scan_workers(*index_scan);
+    if (workers <= 1) {
+        return false;
+    }
+
+    std::vector<std::unique_ptr<IndexScan<N>>> scans;
+    std::vector<std::map<VarId, std::unique_ptr<UAgg>>> u_aggregations(workers);
+    for (uint64_t i = 0; i < workers; i++) {
+        scans.push_back(index_scan->clone());
+        for (auto&& [var, agg] : aggregations) {
+            u_aggregations[i].insert({ var, agg->get_uagg() });
+        }
+    }
+    auto parallel_group_vars = group_vars;
+    auto fallback = std::make_unique<HybridAggregation>(
+        std::move(iter),
+        std::move(aggregations),
+        std::move(group_vars),
+        std::move(group_saved_vars)
+    );
+    iter = std::make_unique<ParallelAggregation<N>>(
+        std::move(fallback),
+        std::move(scans),
+        std::move(u_aggregations),
+        std::move(parallel_group_vars)
+    );
+    return true;
+}
+
 bool BindingIterConstructor::is_aggregation_or_group_var(VarId var) const
 {
     if (aggregations.find(var) != aggregations.end()) {
@@ -119,6 +330,14 @@ void BindingIterConstructor::make_solution_modifier_operators(
             need_order_agg = true;
     }
 
+    // the input is already grouped if it is sorted by the group vars first
+    bool grouped_input = false;
+    if (op_group_by && group_vars.size() > 0 && group_input_order.size() >= group_vars.size()) {
+        grouped_input = std::set<VarId>(group_input_order.begin(), group_input_order.begin() + group_vars.size())
+                     == group_vars;
+    }
+    group_input_order.clear();
+
     if (op_group_by) {
         std::vector<bool> ascending(group_vars.size(), true); // TODO: avoid?
 
@@ -132,22 +351,53 @@ void BindingIterConstructor::make_solution_modifier_operators(
             group_vars_vector.push_back(var);
         }
 
-        if (need_order_agg) {
+        if (need_order_agg && !grouped_input) {
             // TODO: use special order for group by?
             tmp = std::make_unique<OrderBy>(
                 std::move(tmp),
                 std::move(group_saved_vars),
                 std::move(group_vars_vector),
                 std::move(ascending),
-                &OrderBy::internal_compare
+                &OrderBy::internal_compare,
+                &SortKey::normalize_id,
+                rdf_model.MAX_PARALLELISM
             );
         }
         op_group_by = nullptr;
     }
 
+    // A COUNT(*) without groups over a single triple pattern is answered with the index counts
+    if (group_vars.size() == 0 && aggregations.size() == 1
+        && dynamic_cast<AggCountAll*>(aggregations.begin()->second.get()) != nullptr)
+    {
+        auto count_var = aggregations.begin()->first;
+        if (try_count_from_index<1>(tmp, count_var)
+            || try_count_from_index<2>(tmp, count_var)
+            || try_count_from_index<3>(tmp, count_var))
+        {
+            aggregations.clear();
+        }
+    }
+
     // Create the Aggregation if necessary.
     if (aggregations.size() > 0 || group_vars.size() > 0) {
-        if (need_order_agg) {
+        // a grouped input is aggregated as it is read, without a hash table
+        bool ordered_aggregation = need_order_agg || grouped_input;
+
+        // the aggregation does not depend on the order of its input, so a large
+        // scan is read by several threads
+        bool parallel_aggregation = is_root_query && !ordered_aggregation
+            && (try_parallelize_aggregation<1>(tmp, aggregations, group_vars, group_saved_vars)
+                || try_parallelize_aggregation<2>(tmp, aggregations, group_vars, group_saved_vars)
+                || try_parallelize_aggregation<3>(tmp, aggregations, group_vars, group_saved_vars));
+
+        if (!parallel_aggregation && !ordered_aggregation && is_root_query) {
+            try_parallelize_scan<1>(tmp) || try_parallelize_scan<2>(tmp) || try_parallelize_scan<3>(tmp);
+        }
+
+        if (parallel_aggregation) {
+            // tmp is the ParallelAggregation
+        } else if (ordered_aggregation) {
             tmp = std::make_unique<Aggregation>(
                 std::move(tmp),
                 std::move(aggregations),
@@ -220,7 +470,9 @@ void BindingIterConstructor::make_solution_modifier_operators(
             std::move(order_saved_vars),
             std::move(order_vars),
             std::move(op_order_by->ascending_order),
-            &SPARQL::Comparisons::compare
+            &SPARQL::Comparisons::compare,
+            &SPARQL::Comparisons::normalize,
+            rdf_model.MAX_PARALLELISM
         );
         op_order_by = nullptr; // important for subqueries
     }
@@ -252,6 +504,15 @@ void BindingIterConstructor::make_solution_modifier_operators(
         if (limit > rdf_model.MAX_LIMIT && is_root_query) {
             limit = rdf_model.MAX_LIMIT;
         }
+        // when the results come directly from a single triple pattern the
+        // offset can be skipped using the index counts
+        if (has_offset && !distinct
+            && (try_push_offset_into_index<1>(tmp.get(), offset)
+                || try_push_offset_into_index<2>(tmp.get(), offset)
+                || try_push_offset_into_index<3>(tmp.get(), offset)))
+        {
+            offset = 0;
+        }
         tmp = std::make_unique<Slice>(std::move(tmp), offset, limit);
     }
 }
@@ -375,7 +636,21 @@ void BindingIterConstructor::visit(OpSelect& op_select)
 
 void BindingIterConstructor::visit(OpGroupBy& op_group_by)
 {
+    // if the input is sorted by the group vars the aggregation doesn't need
+    // to sort or hash it
+    interesting_order.clear();
+    for (auto&& [expr, alias] : op_group_by.items) {
+        auto casted = dynamic_cast<ExprVar*>(expr.get());
+        if (casted == nullptr || alias) {
+            interesting_order.clear();
+            break;
+        }
+        interesting_order.push_back(casted->var);
+    }
+    interesting_order_op = op_group_by.op.get();
+
     op_group_by.op->accept_visitor(*this);
+    group_input_order = get_tmp_order(*op_group_by.op);
     grouping = true;
     this->op_group_by = &op_group_by;
 
@@ -440,9 +715,31 @@ void BindingIterConstructor::visit(OpBasicGraphPattern& op_basic_graph_pattern)
     std::vector<std::unique_ptr<Plan>> base_plans;
 
     for (auto& op_triple : op_basic_graph_pattern.triples) {
-        base_plans.push_back(
-            std::make_unique<TriplePlan>(op_triple.subject, op_triple.predicate, op_triple.object)
-        );
+        auto triple_plan = std::make_unique<TriplePlan>(op_triple.subject, op_triple.predicate, op_triple.object);
+
+        // triples with the same subject var form a star, estimated with the characteristic sets
+        if (op_triple.subject.is_var() && op_triple.predicate.is_OID()) {
+            std::vector<std::pair<VarId, uint64_t>> star;
+            for (auto& other_triple : op_basic_graph_pattern.triples) {
+                if (&other_triple != &op_triple
+                    && other_triple.subject == op_triple.subject
+                    && other_triple.predicate.is_OID()
+                    && other_triple.object.is_var()
+                    && other_triple.object != other_triple.subject)
+                {
+                    star.push_back({ other_triple.object.get_var(), other_triple.predicate.get_OID().id });
+                }
+            }
+            triple_plan->set_star(std::move(star));
+        }
+
+        if (op_triple.predicate.is_OID() && op_triple.object.is_var()) {
+            auto range = filter_ranges.find(op_triple.object.get_var());
+            if (range != filter_ranges.end()) {
+                triple_plan->set_object_range(range->second);
+            }
+        }
+        base_plans.push_back(std::move(triple_plan));
     }
     for (auto& op_path : op_basic_graph_pattern.paths) {
         auto path = op_path.path.get();
@@ -459,6 +756,9 @@ void BindingIterConstructor::visit(OpBasicGraphPattern& op_basic_graph_pattern)
     }
 
     assert(tmp == nullptr);
+    tmp_order.clear();
+    tmp_output_size = 0;
+    tmp_order_op = &op_basic_graph_pattern;
 
     const auto build_bgp_iter = [&]() {
         for (auto& plan : base_plans) {
@@ -472,12 +772,37 @@ void BindingIterConstructor::visit(OpBasicGraphPattern& op_basic_graph_pattern)
             } else {
                 tmp = LeapfrogOptimizer::try_get_iter_without_assigned(base_plans);
             }
+            // the rows are sorted by the intersection vars
+            if (auto leapfrog_join = dynamic_cast<LeapfrogJoin*>(tmp.get())) {
+                tmp_order.assign(
+                    leapfrog_join->var_order.begin(),
+                    leapfrog_join->var_order.begin() + leapfrog_join->enumeration_level
+                );
+            }
         }
 
         if (tmp == nullptr) {
-            std::unique_ptr<Plan> root_plan = nullptr;
-            root_plan = GreedyOptimizer::get_plan(base_plans);
+            DPOptimizer dp_optimizer(base_plans, rdf_model.MAX_PARALLELISM);
+            std::unique_ptr<Plan> root_plan = dp_optimizer.get_plan();
+
+            // any permutation of a single triple reads the same rows
+            if (base_plans.size() == 1 && interesting_order_op == &op_basic_graph_pattern) {
+                const std::set<VarId> interesting_vars(interesting_order.begin(), interesting_order.end());
+                for (auto var : interesting_order) {
+                    if (!root_plan->order_by(var)) {
+                        continue;
+                    }
+                    auto order = root_plan->get_order();
+                    if (order.size() >= interesting_vars.size()
+                        && std::set<VarId>(order.begin(), order.begin() + interesting_vars.size()) == interesting_vars)
+                    {
+                        break;
+                    }
+                }
+            }
             tmp = root_plan->get_binding_iter();
+            tmp_order = root_plan->get_order();
+            tmp_output_size = root_plan->estimate_output_size();
         }
     };
 
@@ -544,7 +869,18 @@ void BindingIterConstructor::visit(OpProcedure& op_procedure)
 
 void BindingIterConstructor::visit(OpFilter& op_filter)
 {
+    // a filter keeps the order of its input
+    if (interesting_order_op == &op_filter) {
+        interesting_order_op = op_filter.op.get();
+    }
+    if (dynamic_cast<OpBasicGraphPattern*>(op_filter.op.get()) != nullptr) {
+        for (auto& expr : op_filter.filters) {
+            add_filter_ranges(expr.get(), filter_ranges);
+        }
+    }
     op_filter.op->accept_visitor(*this);
+    filter_ranges.clear();
+    auto order = get_tmp_order(*op_filter.op);
 
     std::vector<std::unique_ptr<BindingExpr>> binding_exprs;
 
@@ -559,6 +895,9 @@ void BindingIterConstructor::visit(OpFilter& op_filter)
         std::move(tmp),
         std::move(binding_exprs)
     );
+
+    tmp_order = std::move(order);
+    tmp_order_op = &op_filter;
 }
 
 void BindingIterConstructor::visit(OpUnion& op_union)
@@ -618,7 +957,12 @@ void BindingIterConstructor::visit(OpSequence& op_sequence)
             auto rhs_only_vars = set_difference(op_scope_vars, join_vars);
             old_tmp = std::make_unique<NestedLoopJoin>(
                 std::move(old_tmp),
-                std::move(tmp),
+                memoize_rhs(
+                    std::move(tmp),
+                    *op,
+                    fixable_vars,
+                    set_union(original_safe_assigned_vars, acc_scope_vars)
+                ),
                 set_to_vector(fixable_vars),
                 set_to_vector(unsafe_join_vars),
                 set_to_vector(original_safe_assigned_vars),
@@ -635,6 +979,14 @@ void BindingIterConstructor::visit(OpSequence& op_sequence)
     tmp = std::move(old_tmp);
 }
 
+std::vector<VarId> BindingIterConstructor::get_tmp_order(const Op& op) const
+{
+    if (tmp_order_op == &op) {
+        return tmp_order;
+    }
+    return {};
+}
+
 JoinVars BindingIterConstructor::calculate_join_vars(Op& lhs, Op& rhs)
 {
     JoinVars vars;
@@ -677,20 +1029,66 @@ void BindingIterConstructor::visit(OpOptional& op_optional)
     op_optional.lhs->accept_visitor(*this);
 
     auto lhs_iter = std::move(tmp);
+    auto lhs_order = get_tmp_order(*op_optional.lhs);
+    auto lhs_output_size = tmp_output_size;
+
+    // An OPTIONAL of one triple joined by the first var in the order of lhs can
+    // read the triple once with a MergeLeftJoin, instead of searching it for each
+    // row of lhs
+    if (!lhs_order.empty()
+        && vars.unsafe_join_vars.empty()
+        && vars.safe_join_vars.size() == 1
+        && *vars.safe_join_vars.begin() == lhs_order[0])
+    {
+        auto rhs_bgp = dynamic_cast<OpBasicGraphPattern*>(op_optional.rhs.get());
+        if (rhs_bgp != nullptr && rhs_bgp->triples.size() == 1 && rhs_bgp->paths.empty()) {
+            auto merge_var = lhs_order[0];
+            auto& triple = rhs_bgp->triples[0];
+
+            TriplePlan search_plan(triple.subject, triple.predicate, triple.object);
+            search_plan.set_input_vars(vars.rhs_fixable_vars);
+
+            TriplePlan scan_plan(triple.subject, triple.predicate, triple.object);
+            scan_plan.set_input_vars(set_difference(vars.rhs_fixable_vars, { merge_var }));
+
+            if (scan_plan.order_by(merge_var)
+                && scan_plan.estimate_cost() < lhs_output_size * search_plan.estimate_cost())
+            {
+                tmp = std::make_unique<MergeLeftJoin>(
+                    std::move(lhs_iter),
+                    scan_plan.get_binding_iter(),
+                    merge_var,
+                    std::vector<VarId>(),
+                    set_to_vector(vars.rhs_only_vars)
+                );
+                safe_assigned_vars = std::move(vars.after_left_safe_vars);
+                tmp_order = std::move(lhs_order);
+                tmp_output_size = lhs_output_size;
+                tmp_order_op = &op_optional;
+                return;
+            }
+        }
+    }
 
-    safe_assigned_vars = std::move(vars.rhs_fixable_vars);
+    safe_assigned_vars = vars.rhs_fixable_vars;
     op_optional.rhs->accept_visitor(*this);
+    auto rhs_iter = memoize_rhs(
+        std::move(tmp),
+        *op_optional.rhs,
+        vars.rhs_fixable_vars,
+        set_union(vars.parent_safe_vars, op_optional.lhs->get_scope_vars())
+    );
 
     if (vars.unsafe_join_vars.size() == 0) {
         tmp = std::make_unique<IndexLeftOuterJoin>(
             std::move(lhs_iter),
-            std::move(tmp),
+            std::move(rhs_iter),
             set_to_vector(vars.rhs_only_vars)
         );
     } else {
         tmp = std::make_unique<NestedLoopLeftJoin>(
             std::move(lhs_iter),
-            std::move(tmp),
+            std::move(rhs_iter),
             set_to_vector(vars.safe_join_vars),
             set_to_vector(vars.unsafe_join_vars),
             set_to_vector(vars.parent_safe_vars),
@@ -699,7 +1097,11 @@ void BindingIterConstructor::visit(OpOptional& op_optional)
         );
     }
 
+    // the rows of lhs are read in order
     safe_assigned_vars = std::move(vars.after_left_safe_vars);
+    tmp_order = std::move(lhs_order);
+    tmp_output_size = lhs_output_size;
+    tmp_order_op = &op_optional;
 }
 
 void BindingIterConstructor::visit(OpMinus& op_minus)
@@ -740,12 +1142,18 @@ void BindingIterConstructor::visit(OpNotExists& op_not_exists)
 
     auto lhs_iter = std::move(tmp);
 
-    safe_assigned_vars = std::move(vars.rhs_fixable_vars);
+    safe_assigned_vars = vars.rhs_fixable_vars;
     op_not_exists.rhs->accept_visitor(*this);
+    auto rhs_iter = memoize_rhs(
+        std::move(tmp),
+        *op_not_exists.rhs,
+        vars.rhs_fixable_vars,
+        set_union(vars.parent_safe_vars, op_not_exists.lhs->get_scope_vars())
+    );
 
     tmp = std::make_unique<NotExists>(
         std::move(lhs_iter),
-        std::move(tmp),
+        std::move(rhs_iter),
         set_to_vector(vars.unsafe_join_vars)
     );
 
@@ -761,12 +1169,18 @@ void BindingIterConstructor::visit(OpSemiJoin& op_semi_join)
 
     auto lhs_iter = std::move(tmp);
 
-    safe_assigned_vars = std::move(vars.rhs_fixable_vars);
+    safe_assigned_vars = vars.rhs_fixable_vars;
     op_semi_join.rhs->accept_visitor(*this);
+    auto rhs_iter = memoize_rhs(
+        std::move(tmp),
+        *op_semi_join.rhs,
+        vars.rhs_fixable_vars,
+        set_union(vars.parent_safe_vars, op_semi_join.lhs->get_scope_vars())
+    );
 
     tmp = std::make_unique<NestedLoopSemiJoin>(
         std::move(lhs_iter),
-        std::move(tmp),
+        std::move(rhs_iter),
         set_to_vector(vars.unsafe_join_vars)
     );
 
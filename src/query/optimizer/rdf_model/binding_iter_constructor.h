@@ -7,6 +7,7 @@
 #include "query/executor/binding_iter.h"
 #include "query/executor/binding_iter/aggregation/agg.h"
 #include "query/parser/op/sparql/op.h"
+#include "storage/catalog/value_histogram.h"
 
 namespace SPARQL {
 struct JoinVars {
@@ -49,6 +50,25 @@ public:
     // After visiting an Op, the result must be written into tmp
     std::unique_ptr<BindingIter> tmp;
 
+    // Order of the rows of tmp (see Plan::get_order) and their estimated count.
+    // Only the visits of some ops set them, so they are valid only if tmp_order_op
+    // is the op visited last (see get_tmp_order)
+    std::vector<VarId> tmp_order;
+    double tmp_output_size = 0;
+    Op* tmp_order_op = nullptr;
+
+    // Order of the input of the GROUP BY, empty if it is not known
+    std::vector<VarId> group_input_order;
+
+    // Vars whose order is useful to the parent of interesting_order_op (e.g. a
+    // GROUP BY). A single triple pattern is read sorted by them if possible
+    std::vector<VarId> interesting_order;
+    Op* interesting_order_op = nullptr;
+
+    // Values allowed for each var by the FILTER whose child is the BGP being
+    // visited, to estimate the selectivity of its triples
+    std::map<VarId, ValueHistogram::Range> filter_ranges;
+
     // For path_manager to print in the correct direction
     std::vector<bool> begin_at_left;
 
@@ -96,6 +116,9 @@ public:
     // Used to handle common functionality of SELECTs and SUB-SELECTs
     void handle_select(OpSelect& op_select);
 
+    // Returns the order of tmp after visiting `op`, empty if it is not known
+    std::vector<VarId> get_tmp_order(const Op& op) const;
+
     // Calculates the various variable sets needed when making joins.
     JoinVars calculate_join_vars(Op& lhs, Op& rhs);
 
@@ -139,7 +162,9 @@ public:
     void visit(OpTriple&) override { }
 
     // Update Ops
+    void visit(OpCompactIndex&) override { }
     void visit(OpCreateHNSWIndex&) override { }
+    void visit(OpCreatePermutationIndex&) override { }
     void visit(OpCreateTextIndex&) override { }
     void visit(OpDeleteData&) override { }
     void visit(OpInsertData&) override { }
@@ -0,0 +1,165 @@
+#include "check_non_deterministic.h"
+
+#include "query/parser/op/sparql/ops.h"
+
+using namespace SPARQL;
+
+void CheckNonDeterministic::visit(OpConstruct& op_construct)
+{
+    op_construct.op->accept_visitor(*this);
+}
+
+void CheckNonDeterministic::visit(OpDescribe& op_describe)
+{
+    if (op_describe.op) {
+        op_describe.op->accept_visitor(*this);
+    }
+}
+
+void CheckNonDeterministic::visit(OpAsk& op_ask)
+{
+    op_ask.op->accept_visitor(*this);
+}
+
+void CheckNonDeterministic::visit(OpEmpty& op_empty)
+{
+    if (op_empty.deleted_op.has_value()) {
+        op_empty.deleted_op.value()->accept_visitor(*this);
+    }
+}
+
+void CheckNonDeterministic::visit(OpFilter& op_filter)
+{
+    op_filter.op->accept_visitor(*this);
+
+    CheckNonDeterministicExpr expr_visitor(*this);
+    for (auto& expr : op_filter.filters) {
+        expr->accept_visitor(expr_visitor);
+    }
+}
+
+void CheckNonDeterministic::visit(OpJoin& op_join)
+{
+    op_join.lhs->accept_visitor(*this);
+    op_join.rhs->accept_visitor(*this);
+}
+
+void CheckNonDeterministic::visit(OpSemiJoin& op_semi_join)
+{
+    op_semi_join.lhs->accept_visitor(*this);
+    op_semi_join.rhs->accept_visitor(*this);
+}
+
+void CheckNonDeterministic::visit(OpMinus& op_minus)
+{
+    op_minus.lhs->accept_visitor(*this);
+    op_minus.rhs->accept_visitor(*this);
+}
+
+void CheckNonDeterministic::visit(OpNotExists& op_not_exists)
+{
+    op_not_exists.lhs->accept_visitor(*this);
+    op_not_exists.rhs->accept_visitor(*this);
+}
+
+void CheckNonDeterministic::visit(OpUnion& op_union)
+{
+    for (auto& child : op_union.unions) {
+        child->accept_visitor(*this);
+    }
+}
+
+void CheckNonDeterministic::visit(OpOptional& op_optional)
+{
+    op_optional.lhs->accept_visitor(*this);
+    op_optional.rhs->accept_visitor(*this);
+}
+
+void CheckNonDeterministic::visit(OpOrderBy& op_order_by)
+{
+    op_order_by.op->accept_visitor(*this);
+
+    CheckNonDeterministicExpr expr_visitor(*this);
+    for (auto& item : op_order_by.items) {
+        if (std::holds_alternative<std::unique_ptr<Expr>>(item)) {
+            std::get<std::unique_ptr<Expr>>(item)->accept_visitor(expr_visitor);
+        }
+    }
+}
+
+void CheckNonDeterministic::visit(OpFrom& op_from)
+{
+    op_from.op->accept_visitor(*this);
+}
+
+void CheckNonDeterministic::visit(OpGraph& op_graph)
+{
+    op_graph.op->accept_visitor(*this);
+}
+
+void CheckNonDeterministic::visit(OpGroupBy& op_group_by)
+{
+    op_group_by.op->accept_visitor(*this);
+
+    CheckNonDeterministicExpr expr_visitor(*this);
+    for (auto& [expr, alias] : op_group_by.items) {
+        expr->accept_visitor(expr_visitor);
+    }
+}
+
+void CheckNonDeterministic::visit(OpHaving& op_having)
+{
+    op_having.op->accept_visitor(*this);
+
+    CheckNonDeterministicExpr expr_visitor(*this);
+    for (auto& expr : op_having.exprs) {
+        expr->accept_visitor(expr_visitor);
+    }
+}
+
+void CheckNonDeterministic::visit(OpProcedure& op_procedure)
+{
+    CheckNonDeterministicExpr expr_visitor(*this);
+    for (auto& expr : op_procedure.argument_exprs) {
+        expr->accept_visitor(expr_visitor);
+    }
+}
+
+void CheckNonDeterministic::visit(OpSelect& op_select)
+{
+    op_select.op->accept_visitor(*this);
+
+    CheckNonDeterministicExpr expr_visitor(*this);
+    for (auto& expr : op_select.vars_exprs) {
+        if (expr != nullptr) {
+            expr->accept_visitor(expr_visitor);
+        }
+    }
+}
+
+void CheckNonDeterministic::visit(OpSequence& op_sequence)
+{
+    for (auto& op : op_sequence.ops) {
+        op->accept_visitor(*this);
+    }
+}
+
+void CheckNonDeterministic::visit(OpBind& op_bind)
+{
+    op_bind.op->accept_visitor(*this);
+
+    CheckNonDeterministicExpr expr_visitor(*this);
+    op_bind.expr->accept_visitor(expr_visitor);
+}
+
+///////////////////// CheckNonDeterministicExpr /////////////////////
+
+void CheckNonDeterministicExpr::visit(ExprNotExists& e)
+{
+    e.op->accept_visitor(op_visitor);
+}
+
+void CheckNonDeterministicExpr::visit(ExprExists& e)
+{
+    e.op->accept_visitor(op_visitor);
+}
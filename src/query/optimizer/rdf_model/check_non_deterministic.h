@@ -0,0 +1,72 @@
+#pragma once
+
+#include "query/parser/op/sparql/op_visitor.h"
+#include "query/rewriter/sparql/op/default_expr_visitor.h"
+
+namespace SPARQL {
+/*
+Sets found to true if some expression of the visited op, including the ones
+inside [NOT] EXISTS, may return a different value each time it is evaluated
+with the same variable values: RAND(), UUID(), STRUUID() or BNODE().
+The results of such ops can't be reused (see Memoize).
+*/
+class CheckNonDeterministic : public OpVisitor {
+public:
+    bool found = false;
+
+    void visit(OpConstruct&) override;
+    void visit(OpDescribe&) override;
+    void visit(OpEmpty&) override;
+    void visit(OpFilter&) override;
+    void visit(OpJoin&) override;
+    void visit(OpSemiJoin&) override;
+    void visit(OpMinus&) override;
+    void visit(OpNotExists&) override;
+    void visit(OpUnion&) override;
+    void visit(OpOptional&) override;
+    void visit(OpOrderBy&) override;
+    void visit(OpFrom&) override;
+    void visit(OpGraph&) override;
+    void visit(OpGroupBy&) override;
+    void visit(OpHaving&) override;
+    void visit(OpProcedure&) override;
+    void visit(OpSelect&) override;
+    void visit(OpSequence&) override;
+    void visit(OpAsk&) override;
+    void visit(OpBind&) override;
+
+    void visit(OpBasicGraphPattern&) override { }
+    void visit(OpPath&) override { }
+    void visit(OpService&) override { }
+    void visit(OpShow&) override { }
+    void visit(OpTriple&) override { }
+    void visit(OpUnitTable&) override { }
+    void visit(OpValues&) override { }
+
+    void visit(OpCompactIndex&) override { }
+    void visit(OpCreateHNSWIndex&) override { }
+    void visit(OpCreatePermutationIndex&) override { }
+    void visit(OpCreateTextIndex&) override { }
+    void visit(OpDeleteData&) override { }
+    void visit(OpInsertData&) override { }
+    void visit(OpUpdate&) override { }
+};
+
+class CheckNonDeterministicExpr : public DefaultExprVisitor {
+public:
+    CheckNonDeterministic& op_visitor;
+
+    CheckNonDeterministicExpr(CheckNonDeterministic& op_visitor) :
+        op_visitor(op_visitor)
+    { }
+
+    void visit(ExprBNode&) override { op_visitor.found = true; }
+    void visit(ExprRand&) override { op_visitor.found = true; }
+    void visit(ExprStrUUID&) override { op_visitor.found = true; }
+    void visit(ExprUUID&) override { op_visitor.found = true; }
+
+    void visit(ExprNotExists& e) override;
+    void visit(ExprExists& e) override;
+};
+
+} // namespace SPARQL
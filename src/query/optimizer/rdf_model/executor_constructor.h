@@ -47,7 +47,9 @@ public:
     void visit(OpUnitTable&) override { }
     void visit(OpValues&) override { }
 
+    void visit(OpCompactIndex&) override { }
     void visit(OpCreateHNSWIndex&) override { }
+    void visit(OpCreatePermutationIndex&) override { }
     void visit(OpCreateTextIndex&) override { }
     void visit(OpDeleteData&) override { }
     void visit(OpInsertData&) override { }
@@ -1,5 +1,7 @@
 #include "triple_plan.h"
 
+#include <algorithm>
+
 #include "graph_models/rdf_model/rdf_model.h"
 #include "query/executor/binding_iter/index_scan.h"
 #include "query/query_context.h"
@@ -50,7 +52,12 @@ double TriplePlan::estimate_cost() const {
 
 double TriplePlan::estimate_output_size() const {
     if (!cached_output_estimation_is_valid) {
-        cached_output_estimation = _estimate_output_size();
+        // the rows observed in previous executions of the pattern replace the estimation
+        auto signature = get_signature();
+        auto actual_rows = signature.empty() ? std::nullopt
+                                             : rdf_model.cardinality_feedback.get_actual_rows(signature);
+        cached_output_estimation = actual_rows ? *actual_rows : _estimate_output_size();
+        cached_output_estimation *= estimate_filter_selectivity();
         cached_output_estimation_is_valid = true;
     }
 
@@ -118,6 +125,26 @@ double TriplePlan::_estimate_output_size() const {
     case 2: {
         auto bpt_estimation = estimate_with_bpt();
         if (assigned_vars == 1) { // not_assigned_vars == 0
+            // the fraction of the triples of the predicate with the object
+            // for each subject of the star
+            if (auto star_estimation = estimate_with_characteristic_sets()) {
+                auto predicate_count = catalog.get_predicate_count(predicate.get_OID().id);
+                if (predicate_count > 0) {
+                    return *star_estimation * bpt_estimation / predicate_count;
+                }
+            }
+            // the triples are divided between the distinct values of the assigned var
+            if (predicate.is_OID() && index == Index::NORMAL) {
+                double distinct_values = 0;
+                if (subject.is_var()) {
+                    distinct_values = catalog.get_distinct_subjects(predicate.get_OID().id);
+                } else if (object.is_var()) {
+                    distinct_values = catalog.get_distinct_objects(predicate.get_OID().id);
+                }
+                if (distinct_values >= 1) {
+                    return bpt_estimation / distinct_values;
+                }
+            }
             return bpt_estimation * H1;
         } else { // assigned_vars == 0, not_assigned_vars == 1
             return bpt_estimation;
@@ -133,6 +160,24 @@ double TriplePlan::_estimate_output_size() const {
             //     predicate_count = 0;
             // }
             predicate_count = catalog.get_predicate_count(predicate.get_OID().id);
+
+            if (auto star_estimation = estimate_with_characteristic_sets()) {
+                return assigned_vars == 2 ? *star_estimation * H1 : *star_estimation;
+            }
+
+            // the triples are divided between the distinct values of the assigned vars
+            if (assigned_vars > 0 && index == Index::NORMAL) {
+                double distinct_values = 1;
+                if (subject_assigned) {
+                    distinct_values *= catalog.get_distinct_subjects(predicate.get_OID().id);
+                }
+                if (object_assigned) {
+                    distinct_values *= catalog.get_distinct_objects(predicate.get_OID().id);
+                }
+                if (distinct_values >= 1) {
+                    return predicate_count / distinct_values;
+                }
+            }
         } else {
             predicate_count = estimate_with_bpt();
         }
@@ -198,6 +243,17 @@ void TriplePlan::set_input_vars(const std::set<VarId>& input_vars) {
     if (previous_assigned_count != after_assigned_count) {
         cached_output_estimation_is_valid = false;
     }
+
+    for (auto&& [var, star_predicate] : star) {
+        if (input_vars.find(var) == input_vars.end()) {
+            continue;
+        }
+        auto it = std::lower_bound(star_input_predicates.begin(), star_input_predicates.end(), star_predicate);
+        if (it == star_input_predicates.end() || *it != star_predicate) {
+            star_input_predicates.insert(it, star_predicate);
+            cached_output_estimation_is_valid = false;
+        }
+    }
 }
 
 
@@ -227,6 +283,102 @@ inline uint64_t get_oid(Id id, uint64_t default_value) {
 }
 
 
+double TriplePlan::estimate_distinct_values(VarId var) const {
+    const auto output_size = estimate_output_size();
+    if (!predicate.is_OID() || index != Index::NORMAL) {
+        return output_size;
+    }
+
+    double distinct_values = 0;
+    if (subject.is_var() && subject.get_var() == var) {
+        distinct_values = rdf_model.catalog.get_distinct_subjects(predicate.get_OID().id);
+    } else if (object.is_var() && object.get_var() == var) {
+        distinct_values = rdf_model.catalog.get_distinct_objects(predicate.get_OID().id);
+    }
+    if (distinct_values <= 0) {
+        return output_size;
+    }
+    return std::min(output_size, distinct_values);
+}
+
+
+std::optional<double> TriplePlan::estimate_with_characteristic_sets() const {
+    if (!subject.is_var() || !subject_assigned || !predicate.is_OID() || index != Index::NORMAL) {
+        return std::nullopt;
+    }
+
+    // the other triples with the same predicate don't restrict the subject more
+    const auto predicate_id = predicate.get_OID().id;
+    std::vector<uint64_t> star_predicates;
+    for (auto star_predicate : star_input_predicates) {
+        if (star_predicate != predicate_id) {
+            star_predicates.push_back(star_predicate);
+        }
+    }
+    if (star_predicates.empty()) {
+        return std::nullopt;
+    }
+
+    const auto& catalog = rdf_model.catalog;
+    const auto star_results = catalog.estimate_star(star_predicates);
+    if (star_results <= 0) {
+        return std::nullopt;
+    }
+    star_predicates.insert(std::lower_bound(star_predicates.begin(), star_predicates.end(), predicate_id), predicate_id);
+    return catalog.estimate_star(star_predicates) / star_results;
+}
+
+
+double TriplePlan::estimate_filter_selectivity() const {
+    // an assigned object was already filtered where it was bound
+    if (!object_range || !object.is_var() || object_assigned || !predicate.is_OID() || index != Index::NORMAL) {
+        return 1;
+    }
+
+    const auto& catalog = rdf_model.catalog;
+    const auto predicate_id = predicate.get_OID().id;
+    const double predicate_count = catalog.get_predicate_count(predicate_id);
+    const auto histogram = catalog.get_predicate_histogram(predicate_id, object_range->kind);
+    if (histogram == nullptr || predicate_count == 0) {
+        return 1;
+    }
+
+    // the objects of other kinds don't pass the filter
+    const auto selected_values = histogram->values * histogram->estimate_range(object_range->low, object_range->high);
+    return std::clamp(selected_values / predicate_count, 1 / predicate_count, 1.0);
+}
+
+
+CardinalityFeedback::Signature TriplePlan::get_signature() const {
+    // (TERM, id) for a constant and (VAR, n) or (ASSIGNED_VAR, n) for a var that
+    // first appears in the position n, followed by star_input_predicates
+    enum : uint64_t { TERM, VAR, ASSIGNED_VAR };
+
+    const Id ids[3] = { subject, predicate, object };
+    const bool assigned[3] = { subject_assigned, predicate_assigned, object_assigned };
+
+    CardinalityFeedback::Signature signature;
+    for (uint64_t i = 0; i < 3; i++) {
+        if (ids[i].is_OID()) {
+            if (ids[i].get_OID().is_tmp()) {
+                return {};
+            }
+            signature.push_back(TERM);
+            signature.push_back(ids[i].get_OID().id);
+            continue;
+        }
+        uint64_t position = 0;
+        while (ids[position] != ids[i]) {
+            position++;
+        }
+        signature.push_back(assigned[i] ? ASSIGNED_VAR : VAR);
+        signature.push_back(position);
+    }
+    signature.insert(signature.end(), star_input_predicates.begin(), star_input_predicates.end());
+    return signature;
+}
+
+
 double TriplePlan::estimate_with_bpt() const {
     Record<2> min2;
     Record<2> max2;
@@ -375,6 +527,120 @@ double TriplePlan::estimate_with_bpt() const {
     return index_used->estimate_records(min, max);
 }
 
+std::vector<TriplePlan::Permutation> TriplePlan::get_available_permutations() const {
+    const bool assigned[3] = { subject_assigned, predicate_assigned, object_assigned };
+
+    std::vector<Permutation> permutations;
+    auto add = [&](BPlusTree<3>* bpt, std::array<int, 3> columns) {
+        if (bpt == nullptr) {
+            return;
+        }
+        // the assigned columns must be the first ones
+        for (int i = 1; i < 3; i++) {
+            if (assigned[columns[i]] && !assigned[columns[i - 1]]) {
+                return;
+            }
+        }
+        permutations.push_back({ bpt, columns });
+    };
+
+    // default permutation, see the table of get_binding_iter()
+    if (subject_assigned) {
+        if (!predicate_assigned && object_assigned) {
+            add(rdf_model.osp.get(), { 2, 0, 1 });
+        } else {
+            add(rdf_model.spo.get(), { 0, 1, 2 });
+        }
+    } else if (predicate_assigned) {
+        add(rdf_model.pos.get(), { 1, 2, 0 });
+    } else if (object_assigned) {
+        add(rdf_model.osp.get(), { 2, 0, 1 });
+    } else {
+        add(rdf_model.spo.get(), { 0, 1, 2 });
+    }
+
+    add(rdf_model.spo.get(), { 0, 1, 2 });
+    add(rdf_model.pos.get(), { 1, 2, 0 });
+    add(rdf_model.osp.get(), { 2, 0, 1 });
+    add(rdf_model.get_pso(), { 1, 0, 2 });
+    add(rdf_model.get_sop(), { 0, 2, 1 });
+    add(rdf_model.get_ops(), { 2, 1, 0 });
+    return permutations;
+}
+
+
+TriplePlan::Permutation TriplePlan::get_permutation() const {
+    const Id ids[3] = { subject, predicate, object };
+    const bool assigned[3] = { subject_assigned, predicate_assigned, object_assigned };
+
+    auto permutations = get_available_permutations();
+    if (ordered) {
+        for (auto& permutation : permutations) {
+            for (auto column : permutation.columns) {
+                if (!assigned[column]) {
+                    if (ids[column].get_var() == order_var) {
+                        return permutation;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    return permutations[0];
+}
+
+
+std::vector<VarId> TriplePlan::get_order() const {
+    // the assigned columns are first in every index, so they are skipped
+    std::vector<VarId> order;
+    auto add = [&order](Id id, bool assigned) {
+        if (!assigned && std::find(order.begin(), order.end(), id.get_var()) == order.end()) {
+            order.push_back(id.get_var());
+        }
+    };
+
+    switch (index) {
+    case Index::EQUAL_SPO:
+        add(subject, subject_assigned);
+        break;
+    case Index::EQUAL_SP:
+        add(subject, subject_assigned);
+        add(object,  object_assigned);
+        break;
+    case Index::EQUAL_SO:
+        add(subject,   subject_assigned);
+        add(predicate, predicate_assigned);
+        break;
+    case Index::EQUAL_PO:
+        add(predicate, predicate_assigned);
+        add(subject,   subject_assigned);
+        break;
+    case Index::NORMAL: {
+        const Id ids[3] = { subject, predicate, object };
+        const bool assigned[3] = { subject_assigned, predicate_assigned, object_assigned };
+        for (auto column : get_permutation().columns) {
+            add(ids[column], assigned[column]);
+        }
+        break;
+    }
+    }
+    return order;
+}
+
+
+bool TriplePlan::order_by(VarId var) {
+    ordered = true;
+    order_var = var;
+
+    auto order = get_order();
+    if (order.empty() || order[0] != var) {
+        ordered = false;
+        return false;
+    }
+    return true;
+}
+
+
 /**
  * ╔═╦══════════════════╦═══════════════════╦══════════════════╦═════════╗
  * ║ ║  SubjectAssigned ║ PredicateAssigned ║  ObjectAssigned  ║  Index  ║
@@ -438,55 +704,24 @@ std::unique_ptr<BindingIter> TriplePlan::get_binding_iter() const {
         }
     } else {
         // No special case
-        if (subject_assigned) {
-            // 1-4
-            if (predicate_assigned) {
-                // 1-2
-                ranges[0] = ScanRange::get(subject, subject_assigned);
-                ranges[1] = ScanRange::get(predicate, predicate_assigned);
-                ranges[2] = ScanRange::get(object, object_assigned);
-                return std::make_unique<IndexScan<3>>(*rdf_model.spo, std::move(ranges));
-            } else {
-                // 3-4
-                if (object_assigned) {
-                    // 3
-                    ranges[0] = ScanRange::get(object, object_assigned);
-                    ranges[1] = ScanRange::get(subject, subject_assigned);
-                    ranges[2] = ScanRange::get(predicate, predicate_assigned);
-                    return std::make_unique<IndexScan<3>>(*rdf_model.osp, std::move(ranges));
-                } else {
-                    // 4
-                    ranges[0] = ScanRange::get(subject, subject_assigned);
-                    ranges[1] = ScanRange::get(predicate, predicate_assigned);
-                    ranges[2] = ScanRange::get(object, object_assigned);
-                    return std::make_unique<IndexScan<3>>(*rdf_model.spo, std::move(ranges));
-                }
-            }
-        } else {
-            // 5-8
-            if (predicate_assigned) {
-                // 5-6
-                ranges[0] = ScanRange::get(predicate, predicate_assigned);
-                ranges[1] = ScanRange::get(object, object_assigned);
-                ranges[2] = ScanRange::get(subject, subject_assigned);
-                return std::make_unique<IndexScan<3>>(*rdf_model.pos, std::move(ranges));
-            } else {
-                // 7-8
-                if (object_assigned) {
-                    // 7
-                    ranges[0] = ScanRange::get(object, object_assigned);
-                    ranges[1] = ScanRange::get(subject, subject_assigned);
-                    ranges[2] = ScanRange::get(predicate, predicate_assigned);
-                    return std::make_unique<IndexScan<3>>(*rdf_model.osp, std::move(ranges));
-                } else {
-                    // 8
-                    ranges[0] = ScanRange::get(subject, subject_assigned);
-                    ranges[1] = ScanRange::get(predicate, predicate_assigned);
-                    ranges[2] = ScanRange::get(object, object_assigned);
-                    return std::make_unique<IndexScan<3>>(*rdf_model.spo, std::move(ranges));
-                }
-            }
+        auto permutation = get_permutation();
+        const Id ids[3] = { subject, predicate, object };
+        const bool assigned[3] = { subject_assigned, predicate_assigned, object_assigned };
+        for (int i = 0; i < 3; i++) {
+            auto column = permutation.columns[i];
+            ranges[i] = ScanRange::get(ids[column], assigned[column]);
+        }
+        auto index_scan = std::make_unique<IndexScan<3>>(*permutation.bpt, std::move(ranges));
+
+        auto signature = get_signature();
+        if (!signature.empty()) {
+            index_scan->feedback_fragment = std::make_unique<CardinalityFeedback::Fragment>(
+                CardinalityFeedback::Fragment { &rdf_model.cardinality_feedback,
+                                                std::move(signature),
+                                                _estimate_output_size() }
+            );
         }
+        return index_scan;
     }
     return nullptr;
 }
@@ -644,27 +879,27 @@ bool TriplePlan::get_leapfrog_iter(
         return true;
     }
     // pso
-    else if (rdf_model.pso != nullptr && predicate_index <= subject_index && subject_index <= object_index) {
+    else if (rdf_model.get_pso() != nullptr && predicate_index <= subject_index && subject_index <= object_index) {
         assign(predicate_index, predicate);
         assign(subject_index,   subject);
         assign(object_index,    object);
-        leapfrog_iters.push_back(get_iter_from_triple(*rdf_model.pso));
+        leapfrog_iters.push_back(get_iter_from_triple(*rdf_model.get_pso()));
         return true;
     }
     // sop
-    else if (rdf_model.sop != nullptr && subject_index <= object_index && object_index <= predicate_index) {
+    else if (rdf_model.get_sop() != nullptr && subject_index <= object_index && object_index <= predicate_index) {
         assign(subject_index,   subject);
         assign(object_index,    object);
         assign(predicate_index, predicate);
-        leapfrog_iters.push_back(get_iter_from_triple(*rdf_model.sop));
+        leapfrog_iters.push_back(get_iter_from_triple(*rdf_model.get_sop()));
         return true;
     }
     // ops
-    else if (rdf_model.ops != nullptr && object_index <= predicate_index && predicate_index <= subject_index) {
+    else if (rdf_model.get_ops() != nullptr && object_index <= predicate_index && predicate_index <= subject_index) {
         assign(object_index,    object);
         assign(predicate_index, predicate);
         assign(subject_index,   subject);
-        leapfrog_iters.push_back(get_iter_from_triple(*rdf_model.ops));
+        leapfrog_iters.push_back(get_iter_from_triple(*rdf_model.get_ops()));
         return true;
     }
     else {
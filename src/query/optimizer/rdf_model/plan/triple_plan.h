@@ -1,6 +1,14 @@
 #pragma once
 
+#include <array>
+#include <optional>
+#include <utility>
+
+#include "query/cardinality_feedback.h"
 #include "query/optimizer/plan/plan.h"
+#include "storage/catalog/value_histogram.h"
+
+template <std::size_t N> class BPlusTree;
 
 namespace SPARQL {
 class TriplePlan : public Plan {
@@ -23,6 +31,12 @@ public:
         subject_assigned   (other.subject_assigned),
         predicate_assigned (other.predicate_assigned),
         object_assigned    (other.object_assigned),
+        index              (other.index),
+        ordered            (other.ordered),
+        order_var          (other.order_var),
+        star                              (other.star),
+        star_input_predicates             (other.star_input_predicates),
+        object_range                      (other.object_range),
         cached_output_estimation          (other.cached_output_estimation),
         cached_output_estimation_is_valid (other.cached_output_estimation_is_valid) { }
 
@@ -33,14 +47,36 @@ public:
 
     int relation_size() const override { return 3; }
 
+    bool is_index_scan() const override { return true; }
+
     double estimate_cost() const override;
     double estimate_output_size() const override;
 
+    double estimate_distinct_values(VarId var) const override;
+
     std::set<VarId> get_vars() const override;
     void set_input_vars(const std::set<VarId>& input_vars) override;
 
     std::unique_ptr<BindingIter> get_binding_iter() const override;
 
+    std::vector<VarId> get_order() const override;
+
+    bool order_by(VarId var) override;
+
+    // sets the object var and predicate of the other triples of the BGP with the
+    // same subject var and a constant predicate, to estimate star joins
+    void set_star(std::vector<std::pair<VarId, uint64_t>>&& star_triples) {
+        star = std::move(star_triples);
+        cached_output_estimation_is_valid = false;
+    }
+
+    // sets the values of the object var allowed by the FILTERs of the BGP, to
+    // estimate their selectivity with the histograms of the predicate
+    void set_object_range(const ValueHistogram::Range& range) {
+        object_range = range;
+        cached_output_estimation_is_valid = false;
+    }
+
     bool get_leapfrog_iter(std::vector<std::unique_ptr<LeapfrogIter>>& leapfrog_iters,
                            std::vector<VarId>&                         var_order,
                            uint_fast32_t&                              enumeration_level) const override;
@@ -58,6 +94,33 @@ private:
 
     Index index;
 
+    // true if order_by() chose a permutation sorted by order_var
+    bool ordered = false;
+    VarId order_var = VarId(0);
+
+    // a B+tree of triples and the position of the subject (0), predicate (1)
+    // and object (2) in its columns, only used for Index::NORMAL
+    struct Permutation {
+        BPlusTree<3>* bpt;
+        std::array<int, 3> columns;
+    };
+
+    // returns the permutation used by get_binding_iter() for Index::NORMAL
+    Permutation get_permutation() const;
+
+    // returns the permutations that can be searched with the assigned vars,
+    // the default one first
+    std::vector<Permutation> get_available_permutations() const;
+
+    // see set_star
+    std::vector<std::pair<VarId, uint64_t>> star;
+
+    // sorted predicates of the star triples whose object is an input var
+    std::vector<uint64_t> star_input_predicates;
+
+    // see set_object_range
+    std::optional<ValueHistogram::Range> object_range;
+
     mutable double cached_output_estimation;
 
     mutable bool cached_output_estimation_is_valid = false;
@@ -66,5 +129,18 @@ private:
 
     // only estimates considering terms, ignoring if var is assigned or not
     double estimate_with_bpt() const;
+
+    // estimates the triples of the predicate for each subject given by the star
+    // triples in star_input_predicates, using the characteristic sets. Returns
+    // nothing if the subject is not given by a star join
+    std::optional<double> estimate_with_characteristic_sets() const;
+
+    // fraction of the triples whose object is in object_range, 1 if there is
+    // no range or it can't be estimated
+    double estimate_filter_selectivity() const;
+
+    // identifies the pattern in the cardinality feedback, without the names of
+    // the vars. Empty if the pattern has a term that is not in the database
+    CardinalityFeedback::Signature get_signature() const;
 };
 } // namespace SPARQL
@@ -25,7 +25,9 @@ public:
     void visit(OpInsertData&) override { }
     void visit(OpDeleteData&) override { }
     void visit(OpCreateTextIndex&) override { }
+    void visit(OpCompactIndex&) override { }
     void visit(OpCreateHNSWIndex&) override { }
+    void visit(OpCreatePermutationIndex&) override { }
     void visit(OpOptional&) override { }
     void visit(OpOrderBy&) override { }
     void visit(OpGroupBy&) override { }
@@ -662,6 +662,30 @@ Any UpdateVisitor::visitCreateIndexQuery(SUP::CreateIndexQueryContext* ctx)
             hnsw_index_opts.max_candidates,
             metric_type
         ));
+    } else if (index_type_lowercased == "permutation") {
+        if (index_name != "pso" && index_name != "sop" && index_name != "ops") {
+            throw QueryException("Invalid permutation \"" + index_name + "\", expected one of: pso, sop, ops");
+        }
+        if ((index_name == "pso" && rdf_model.get_pso() != nullptr)
+            || (index_name == "sop" && rdf_model.get_sop() != nullptr)
+            || (index_name == "ops" && rdf_model.get_ops() != nullptr))
+        {
+            throw QueryException("Permutation \"" + index_name + "\" already exists");
+        }
+        if (!ctx->createIndexOptions()->createIndexOption().empty()) {
+            throw QueryException("Permutation indexes don't have options");
+        }
+        op_update->updates.emplace_back(std::make_unique<OpCreatePermutationIndex>(std::move(index_name)));
+    } else if (index_type_lowercased == "compact") {
+        if (index_name != "spo" && index_name != "pos" && index_name != "osp"
+            && index_name != "pso" && index_name != "sop" && index_name != "ops")
+        {
+            throw QueryException("Invalid permutation \"" + index_name + "\", expected one of: spo, pos, osp, pso, sop, ops");
+        }
+        if (!ctx->createIndexOptions()->createIndexOption().empty()) {
+            throw QueryException("Index compaction doesn't have options");
+        }
+        op_update->updates.emplace_back(std::make_unique<OpCompactIndex>(std::move(index_name)));
     } else {
         throw QueryException("Invalid index type \"" + index_type + "\"");
     }
@@ -2,7 +2,9 @@
 
 namespace SPARQL {
 
+class OpCompactIndex;
 class OpCreateHNSWIndex;
+class OpCreatePermutationIndex;
 class OpCreateTextIndex;
 class OpDeleteData;
 class OpInsertData;
@@ -40,7 +42,9 @@ class OpVisitor {
 public:
     virtual ~OpVisitor() = default;
 
+    virtual void visit(OpCompactIndex&) = 0;
     virtual void visit(OpCreateHNSWIndex&) = 0;
+    virtual void visit(OpCreatePermutationIndex&) = 0;
     virtual void visit(OpCreateTextIndex&) = 0;
     virtual void visit(OpDeleteData&) = 0;
     virtual void visit(OpInsertData&) = 0;
@@ -28,7 +28,9 @@
 #include "query/parser/op/sparql/op_unit_table.h" // IWYU pragma: export
 #include "query/parser/op/sparql/op_values.h" // IWYU pragma: export
 
+#include "query/parser/op/sparql/update/op_compact_index.h" // IWYU pragma: export
 #include "query/parser/op/sparql/update/op_create_hnsw_index.h" // IWYU pragma: export
+#include "query/parser/op/sparql/update/op_create_permutation_index.h" // IWYU pragma: export
 #include "query/parser/op/sparql/update/op_create_text_index.h" // IWYU pragma: export
 #include "query/parser/op/sparql/update/op_delete_data.h" // IWYU pragma: export
 #include "query/parser/op/sparql/update/op_insert_data.h" // IWYU pragma: export
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+
+#include "query/parser/op/sparql/op.h"
+
+namespace SPARQL {
+
+// Rewrites the B+tree of a triple permutation into dense leaves
+class OpCompactIndex : public Op {
+public:
+    const std::string permutation;
+
+    OpCompactIndex(std::string&& permutation_) :
+        permutation { std::move(permutation_) }
+    { }
+
+    std::unique_ptr<Op> clone() const override
+    {
+        auto permutation_clone = permutation;
+        return std::make_unique<OpCompactIndex>(std::move(permutation_clone));
+    }
+
+    void accept_visitor(OpVisitor& visitor) override
+    {
+        visitor.visit(*this);
+    }
+
+    std::set<VarId> get_all_vars() const override
+    {
+        return {};
+    }
+
+    std::set<VarId> get_scope_vars() const override
+    {
+        return {};
+    }
+
+    std::set<VarId> get_safe_vars() const override
+    {
+        return {};
+    }
+
+    std::set<VarId> get_fixable_vars() const override
+    {
+        return {};
+    }
+
+    std::ostream& print_to_ostream(std::ostream& os, int indent = 0) const override
+    {
+        os << std::string(indent, ' ');
+        os << "OpCompactIndex(permutation: " << permutation << ")\n";
+        return os;
+    }
+};
+} // namespace SPARQL
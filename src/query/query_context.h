@@ -24,6 +24,13 @@ struct ThreadInfo {
 
     uint_fast32_t worker_index = 0;
 
+    // true in the threads helping a worker with a single operator (see
+    // HelperThreads). They share the worker_index of the query to read its
+    // temporal strings, but must not use its private pages nor create
+    // temporal files or strings, as those are not thread-safe. The buffer and
+    // tmp managers throw a LogicException if they do
+    bool is_helper = false;
+
     std::chrono::system_clock::time_point timeout;
     std::chrono::system_clock::time_point time_start;
 };
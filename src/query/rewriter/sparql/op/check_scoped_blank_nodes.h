@@ -49,7 +49,9 @@ public:
     void visit(OpPath&) override { }
     void visit(OpTriple&) override { }
 
+    void visit(OpCompactIndex&) override { }
     void visit(OpCreateHNSWIndex&) override { }
+    void visit(OpCreatePermutationIndex&) override { }
     void visit(OpCreateTextIndex&) override { }
     void visit(OpDeleteData&) override { }
     void visit(OpInsertData&) override { }
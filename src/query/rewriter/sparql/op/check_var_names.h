@@ -49,7 +49,9 @@ public:
     void visit(OpInsertData&) override { }
     void visit(OpDeleteData&) override { }
     void visit(OpCreateTextIndex&) override { }
+    void visit(OpCompactIndex&) override { }
     void visit(OpCreateHNSWIndex&) override { }
+    void visit(OpCreatePermutationIndex&) override { }
 
 private:
     std::set<VarId> declared_vars;
@@ -38,7 +38,9 @@ public:
     void visit(OpTriple&) override { }
     void visit(OpUnitTable&) override { }
 
+    void visit(OpCompactIndex&) override { }
     void visit(OpCreateHNSWIndex&) override { }
+    void visit(OpCreatePermutationIndex&) override { }
     void visit(OpCreateTextIndex&) override { }
     void visit(OpDeleteData&) override { }
     void visit(OpInsertData&) override { }
@@ -1,5 +1,6 @@
 #include "catalog.h"
 
+#include <cstring>
 #include <stdexcept>
 
 #include "graph_models/exceptions.h"
@@ -210,6 +211,39 @@ boost::unordered_flat_map<uint64_t, uint64_t> Catalog::read_map()
     return res;
 }
 
+boost::unordered_flat_map<uint64_t, HyperLogLog> Catalog::read_sketch_map()
+{
+    boost::unordered_flat_map<uint64_t, HyperLogLog> res;
+    auto size = read_uint64();
+    for (size_t i = 0; i < size; i++) {
+        auto k = read_uint64();
+        HyperLogLog sketch;
+        file.read(reinterpret_cast<char*>(sketch.registers.data()), sketch.registers.size());
+        res.insert({ k, sketch });
+    }
+    return res;
+}
+
+boost::unordered_flat_map<uint64_t, ValueHistogram> Catalog::read_histogram_map()
+{
+    boost::unordered_flat_map<uint64_t, ValueHistogram> res;
+    auto size = read_uint64();
+    for (size_t i = 0; i < size; i++) {
+        auto k = read_uint64();
+        ValueHistogram histogram;
+        histogram.values = read_uint64();
+        auto bounds_size = read_uint64();
+        for (size_t j = 0; j < bounds_size; j++) {
+            auto bits = read_uint64();
+            double bound;
+            std::memcpy(&bound, &bits, sizeof(bound));
+            histogram.bounds.push_back(bound);
+        }
+        res.insert({ k, std::move(histogram) });
+    }
+    return res;
+}
+
 void Catalog::write_uint8(const uint8_t n)
 {
     file.put(static_cast<char>(n));
@@ -256,6 +290,30 @@ void Catalog::write_map(const boost::unordered_flat_map<uint64_t, uint64_t>& map
     }
 }
 
+void Catalog::write_sketch_map(const boost::unordered_flat_map<uint64_t, HyperLogLog>& map)
+{
+    write_uint64(map.size());
+    for (auto&& [k, sketch] : map) {
+        write_uint64(k);
+        file.write(reinterpret_cast<const char*>(sketch.registers.data()), sketch.registers.size());
+    }
+}
+
+void Catalog::write_histogram_map(const boost::unordered_flat_map<uint64_t, ValueHistogram>& map)
+{
+    write_uint64(map.size());
+    for (auto&& [k, histogram] : map) {
+        write_uint64(k);
+        write_uint64(histogram.values);
+        write_uint64(histogram.bounds.size());
+        for (auto bound : histogram.bounds) {
+            uint64_t bits;
+            std::memcpy(&bits, &bound, sizeof(bits));
+            write_uint64(bits);
+        }
+    }
+}
+
 boost::unordered_flat_map<string, uint64_t> Catalog::convert_strvec_to_map(const vector<string>& strvec)
 {
     boost::unordered_flat_map<string, uint64_t> res;
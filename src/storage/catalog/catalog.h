@@ -7,6 +7,9 @@
 
 #include <boost/unordered/unordered_flat_map.hpp>
 
+#include "storage/catalog/hyper_log_log.h"
+#include "storage/catalog/value_histogram.h"
+
 /*
 Catalog layout in MillenniumDB 1.X.Y:
 - 6 bytes: magic number (0x100DECADE5DB)
@@ -52,6 +55,8 @@ protected:
     std::string read_string();
     std::vector<std::string> read_strvec();
     boost::unordered_flat_map<uint64_t, uint64_t> read_map();
+    boost::unordered_flat_map<uint64_t, HyperLogLog> read_sketch_map();
+    boost::unordered_flat_map<uint64_t, ValueHistogram> read_histogram_map();
 
     void write_uint8(const uint8_t);
     void write_uint32(const uint32_t);
@@ -59,6 +64,8 @@ protected:
     void write_string(const std::string&);
     void write_strvec(const std::vector<std::string>& strvec);
     void write_map(const boost::unordered_flat_map<uint64_t, uint64_t>&);
+    void write_sketch_map(const boost::unordered_flat_map<uint64_t, HyperLogLog>&);
+    void write_histogram_map(const boost::unordered_flat_map<uint64_t, ValueHistogram>&);
 
     boost::unordered_flat_map<std::string, uint64_t> convert_strvec_to_map(const std::vector<std::string>& strvec);
 
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "macros/count_zeros.h"
+
+// HyperLogLog sketch (Flajolet et al., 2007) to estimate how many distinct
+// values a column has. It uses 2^PRECISION registers of one byte, with a
+// standard error of about 1.04 / sqrt(2^PRECISION). Values can be added but
+// not removed, so after deletions the estimation may be higher than the
+// real number.
+class HyperLogLog {
+public:
+    static constexpr uint_fast32_t PRECISION = 8;
+
+    static constexpr uint_fast32_t REGISTERS = 1 << PRECISION;
+
+    std::array<uint8_t, REGISTERS> registers {};
+
+    void add(uint64_t value)
+    {
+        const auto hash = mix(value);
+        const auto index = hash >> (64 - PRECISION);
+
+        // the bit set at the end bounds the rank when the rest of the hash is 0
+        const auto rest = (hash << PRECISION) | (uint64_t(1) << (PRECISION - 1));
+        const uint8_t rank = MDB_COUNT_LEADING_ZEROS_64(rest) + 1;
+        if (rank > registers[index]) {
+            registers[index] = rank;
+        }
+    }
+
+    double estimate() const
+    {
+        constexpr double alpha = 0.7213 / (1.0 + 1.079 / REGISTERS);
+
+        double sum = 0;
+        uint_fast32_t empty_registers = 0;
+        for (auto rank : registers) {
+            sum += std::ldexp(1.0, -rank);
+            empty_registers += rank == 0;
+        }
+
+        const double estimation = alpha * REGISTERS * REGISTERS / sum;
+
+        // linear counting is more precise for small cardinalities
+        if (estimation <= 2.5 * REGISTERS && empty_registers > 0) {
+            return REGISTERS * std::log(static_cast<double>(REGISTERS) / empty_registers);
+        }
+        return estimation;
+    }
+
+private:
+    // finalizer of MurmurHash3. The sketches are saved in the catalog, so the
+    // hash can't depend on the build as HashFunctionWrapper does
+    static inline uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDULL;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "graph_models/common/conversions.h"
+#include "graph_models/object_id.h"
+
+// Equi-depth histogram of the numeric or datetime values of a column, to
+// estimate the selectivity of range filters. The values are divided in
+// buckets with the same number of values, bucket i has the values between
+// bounds[i] and bounds[i + 1]. Datetimes are represented by their seconds
+// on the timeline, so both kinds of values are kept in different histograms.
+class ValueHistogram {
+public:
+    static constexpr size_t MAX_BUCKETS = 64;
+
+    // kinds of values that can be compared between them
+    enum class Kind : uint8_t {
+        NUMERIC,
+        DATETIME,
+    };
+
+    static constexpr size_t KINDS = 2;
+
+    // values of a kind between low and high (inclusive), the bounds may be infinite
+    struct Range {
+        Kind kind;
+        double low;
+        double high;
+    };
+
+    // number of values of the column, the bounds may come from a sample of them
+    uint64_t values = 0;
+
+    std::vector<double> bounds;
+
+    ValueHistogram() = default;
+
+    // `sample` must be sorted and not empty
+    ValueHistogram(const std::vector<double>& sample, uint64_t values) :
+        values (values)
+    {
+        const auto buckets = std::min(MAX_BUCKETS, sample.size());
+        for (size_t i = 0; i < buckets; i++) {
+            bounds.push_back(sample[i * sample.size() / buckets]);
+        }
+        bounds.push_back(sample.back());
+    }
+
+    // estimated fraction of the values between low and high (inclusive),
+    // assuming the values are uniform inside each bucket
+    double estimate_range(double low, double high) const
+    {
+        if (bounds.size() < 2 || low > high) {
+            return 0;
+        }
+        const auto buckets = bounds.size() - 1;
+
+        double fraction = 0;
+        for (size_t i = 0; i < buckets; i++) {
+            const auto bucket_low = bounds[i];
+            const auto bucket_high = bounds[i + 1];
+            if (high < bucket_low || low > bucket_high) {
+                continue;
+            }
+            if (bucket_low == bucket_high) {
+                fraction += 1;
+            } else {
+                fraction += (std::min(high, bucket_high) - std::max(low, bucket_low))
+                          / (bucket_high - bucket_low);
+            }
+        }
+        return fraction / buckets;
+    }
+
+    // returns false if `oid` is not an inlined numeric or datetime, the other
+    // ones would need to be read from the string manager
+    static bool get_value(ObjectId oid, Kind* kind, double* value)
+    {
+        switch (oid.get_type()) {
+        case ObjectId::MASK_NEGATIVE_INT:
+        case ObjectId::MASK_POSITIVE_INT:
+            *kind = Kind::NUMERIC;
+            *value = Common::Conversions::unpack_int(oid);
+            return true;
+        case ObjectId::MASK_DECIMAL_INLINED:
+            *kind = Kind::NUMERIC;
+            *value = Common::Conversions::unpack_decimal_inlined(oid).to_double();
+            return true;
+        case ObjectId::MASK_FLOAT:
+            *kind = Kind::NUMERIC;
+            *value = Common::Conversions::unpack_float(oid);
+            return true;
+        default:
+            break;
+        }
+        if ((oid.id & ObjectId::GENERIC_TYPE_MASK) == ObjectId::MASK_DT) {
+            *kind = Kind::DATETIME;
+            *value = DateTime(oid.id).create_7_properties().time_on_timeline_seconds();
+            return true;
+        }
+        return false;
+    }
+};
@@ -1,17 +1,38 @@
 #include "bplus_tree.h"
 
+#include <algorithm>
+#include <bitset>
 #include <cassert>
+#include <cstring>
+#include <fstream>
 
 #include "macros/likely.h"
 #include "query/exceptions.h"
+#include "storage/index/bplus_tree/bplus_tree_bloom.h"
 #include "storage/index/record.h"
 #include "system/buffer_manager.h"
 #include "system/file_manager.h"
 
 template <std::size_t N>
 BPlusTree<N>::BPlusTree(const std::string& name) :
-    dir_file_id  (file_manager.get_file_id(name + ".dir")),
-    leaf_file_id (file_manager.get_file_id(name + ".leaf")) { }
+    dir_file_id   (file_manager.get_file_id(name + ".dir")),
+    leaf_file_id  (file_manager.get_file_id(name + ".leaf")),
+    bloom_file_id (file_manager.get_file_id(name + ".bloom"))
+{
+    // the header is never modified after the filters are built, so it is read
+    // directly from the file instead of a versioned page
+    typename BPlusTreeBloom<N>::Header header = { 0 };
+    std::ifstream bloom_file(file_manager.get_file_path(name + ".bloom"), std::ios::binary);
+    bloom_file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    bloom_filter_bytes = header.filter_bytes;
+    bloom_enabled = bloom_file.good() && BPlusTreeBloom<N>::valid_filter_bytes(bloom_filter_bytes);
+    if (bloom_enabled) {
+        const auto filters_per_page = BPlusTreeBloom<N>::get_filters_per_page(bloom_filter_bytes);
+        const auto filter_pages = file_manager.count_pages(bloom_file_id) - BPlusTreeBloom<N>::HEADER_PAGES;
+        bloom_enabled = filter_pages * filters_per_page >= file_manager.count_pages(leaf_file_id);
+    }
+}
 
 
 template <std::size_t N>
@@ -36,6 +57,24 @@ BptIter<N> BPlusTree<N>::get_range(bool* interruption_requested,
 }
 
 
+template <std::size_t N>
+BptIter<N> BPlusTree<N>::get_range(bool* interruption_requested,
+                                   const Record<N>& min,
+                                   const Record<N>& max,
+                                   uint64_t offset) const noexcept {
+    BPlusTreeDir<N> root(
+        leaf_file_id,
+        &buffer_manager.get_page_readonly(dir_file_id, 0)
+    );
+    if (offset == 0) {
+        auto leaf_and_pos = root.search_leaf(min);
+        return BptIter<N>(interruption_requested, std::move(leaf_and_pos), max);
+    }
+    auto leaf_and_pos = root.search_leaf_at(root.count_before(min, false) + offset);
+    return BptIter<N>(interruption_requested, std::move(leaf_and_pos), max);
+}
+
+
 template <std::size_t N>
 bool BPlusTree<N>::insert(const Record<N>& record) {
     // although root can be modified in insert, we start as readonly, and
@@ -44,9 +83,92 @@ bool BPlusTree<N>::insert(const Record<N>& record) {
         leaf_file_id,
         &buffer_manager.get_page_readonly(dir_file_id, 0)
     );
+    const auto leaf_pages = file_manager.count_pages(leaf_file_id);
+
     bool error;
     root.insert(record, error);
-    return !error;
+    if (error || !bloom_enabled) {
+        return !error;
+    }
+
+    // leaves created by a split need the records moved into them
+    const auto new_leaf_pages = file_manager.count_pages(leaf_file_id);
+    for (auto leaf_page = leaf_pages; leaf_page < new_leaf_pages; leaf_page++) {
+        BPlusTreeLeaf<N> leaf(&buffer_manager.get_page_readonly(leaf_file_id, leaf_page));
+        bloom_add_leaf(leaf_page, leaf);
+    }
+    bloom_add(root.search_leaf_page(record), record);
+    return true;
+}
+
+
+template <std::size_t N>
+VPage& BPlusTree<N>::get_bloom_page_editable(uint32_t leaf_page) {
+    const auto filters_per_page = BPlusTreeBloom<N>::get_filters_per_page(bloom_filter_bytes);
+    const auto bloom_page_number = BPlusTreeBloom<N>::HEADER_PAGES + leaf_page / filters_per_page;
+    while (file_manager.count_pages(bloom_file_id) <= bloom_page_number) {
+        buffer_manager.unpin(buffer_manager.append_vpage(bloom_file_id));
+    }
+    // the page is versioned, transactions reading older versions don't see the new bits
+    return buffer_manager.get_page_editable(bloom_file_id, bloom_page_number);
+}
+
+
+template <std::size_t N>
+void BPlusTree<N>::bloom_add(uint32_t leaf_page, const Record<N>& record) {
+    auto& page = get_bloom_page_editable(leaf_page);
+    const auto filters_per_page = BPlusTreeBloom<N>::get_filters_per_page(bloom_filter_bytes);
+    auto filter = page.get_bytes() + (leaf_page % filters_per_page) * bloom_filter_bytes;
+    BPlusTreeBloom<N>::add(filter, bloom_filter_bytes, record);
+    buffer_manager.unpin(page);
+}
+
+
+template <std::size_t N>
+void BPlusTree<N>::bloom_add_leaf(uint32_t leaf_page, const BPlusTreeLeaf<N>& leaf) {
+    auto& page = get_bloom_page_editable(leaf_page);
+    const auto filters_per_page = BPlusTreeBloom<N>::get_filters_per_page(bloom_filter_bytes);
+    auto filter = page.get_bytes() + (leaf_page % filters_per_page) * bloom_filter_bytes;
+    for (uint_fast32_t i = 0; i < leaf.get_value_count(); i++) {
+        BPlusTreeBloom<N>::add(filter, bloom_filter_bytes, leaf.get_record(i));
+    }
+    buffer_manager.unpin(page);
+}
+
+
+template <std::size_t N>
+bool BPlusTree<N>::bloom_may_contain(uint32_t leaf_page, const Record<N>& record) const {
+    const auto filters_per_page = BPlusTreeBloom<N>::get_filters_per_page(bloom_filter_bytes);
+    const auto bloom_page_number = BPlusTreeBloom<N>::HEADER_PAGES + leaf_page / filters_per_page;
+    if (bloom_page_number >= file_manager.count_pages(bloom_file_id)) {
+        return true;
+    }
+    auto& page = buffer_manager.get_page_readonly(bloom_file_id, bloom_page_number);
+    auto filter = page.get_bytes() + (leaf_page % filters_per_page) * bloom_filter_bytes;
+    auto res = BPlusTreeBloom<N>::may_contain(filter, bloom_filter_bytes, record);
+    buffer_manager.unpin(page);
+    return res;
+}
+
+
+template <std::size_t N>
+bool BPlusTree<N>::get_record(bool* interruption_requested,
+                              const Record<N>& record,
+                              BptIter<N>& it) const
+{
+    BPlusTreeDir<N> root(
+        leaf_file_id,
+        &buffer_manager.get_page_readonly(dir_file_id, 0)
+    );
+    auto leaf_page = root.search_leaf_page(record);
+    if (bloom_enabled && !bloom_may_contain(leaf_page, record)) {
+        return false;
+    }
+
+    BPlusTreeLeaf<N> leaf(&buffer_manager.get_page_readonly(leaf_file_id, leaf_page));
+    auto index = leaf.search_index(record);
+    it = BptIter<N>(interruption_requested, SearchLeafResult<N>(std::move(leaf), index), record);
+    return true;
 }
 
 
@@ -72,18 +194,6 @@ bool BPlusTree<N>::check(std::ostream& os) const {
 }
 
 
-uint64_t powi(uint64_t base, size_t exp) {
-    uint64_t res = 1;
-    while (exp) {
-        if (exp & 1)
-            res *= base;
-        exp >>= 1;
-        base *= base;
-    }
-    return res;
-}
-
-
 template <std::size_t N>
 double BPlusTree<N>::estimate_records(const Record<N>& min,
                                       const Record<N>& max) const
@@ -96,29 +206,220 @@ double BPlusTree<N>::estimate_records(const Record<N>& min,
 }
 
 
+// The directories keep the record count of each child, so the estimation is exact
 template <std::size_t N>
 double BPlusTree<N>::estimate_records(const BPlusTreeDir<N>& root,
                                       const Record<N>& min,
                                       const Record<N>& max)
 {
-    std::vector<int> min_idxs;
-    std::vector<int> max_idxs;
+    if (max < min) {
+        return 0;
+    }
+    return root.count_before(max, true) - root.count_before(min, false);
+}
+
+
+template <std::size_t N>
+uint64_t BPlusTree<N>::count_records(const Record<N>& min,
+                                     const Record<N>& max) const
+{
+    if (max < min) {
+        return 0;
+    }
+    BPlusTreeDir<N> root(
+        leaf_file_id,
+        &buffer_manager.get_page_readonly(dir_file_id, 0)
+    );
+    return root.count_before(max, true) - root.count_before(min, false);
+}
 
-    root.get_branch_indexes(min, min_idxs);
-    root.get_branch_indexes(max, max_idxs);
 
-    assert(min_idxs.size() == max_idxs.size());
-    assert(min_idxs.size() > 0);
+template <std::size_t N>
+uint64_t BPlusTree<N>::get_total_count() const {
+    BPlusTreeDir<N> root(
+        leaf_file_id,
+        &buffer_manager.get_page_readonly(dir_file_id, 0)
+    );
+    return root.get_total_count();
+}
 
-    double estimated_min = 0;
-    double estimated_max = 0;
-    size_t current_exponent = max_idxs.size() - 1;
-    for (size_t i = 0; i < min_idxs.size(); i++) {
-        estimated_min += min_idxs[i] * powi(dir_max_records+1, current_exponent);
-        estimated_max += max_idxs[i] * powi(dir_max_records+1, current_exponent);
-        current_exponent--;
+
+template <std::size_t N>
+void BPlusTree<N>::count_reachable_pages(const BPlusTreeDir<N>& dir,
+                                         uint64_t& dir_pages,
+                                         uint64_t& leaf_pages) const
+{
+    dir_pages++;
+    for (uint32_t i = 0; i <= *dir.key_count; i++) {
+        if (dir.children[i] < 0) {
+            // negative number: pointer to dir
+            BPlusTreeDir<N> child(
+                leaf_file_id,
+                &buffer_manager.get_page_readonly(dir_file_id, dir.children[i]*-1)
+            );
+            count_reachable_pages(child, dir_pages, leaf_pages);
+        } else {
+            // positive number: pointer to leaf
+            leaf_pages++;
+        }
     }
-    return 1 + (estimated_max - estimated_min) * leaf_max_records;
+}
+
+
+template <std::size_t N>
+BPlusTreeCompaction BPlusTree<N>::compact(char* scratch, uint64_t scratch_size) {
+    assert(scratch_size >= N * 8);
+    BPlusTreeCompaction res;
+    {
+        BPlusTreeDir<N> root(
+            leaf_file_id,
+            &buffer_manager.get_page_readonly(dir_file_id, 0)
+        );
+        count_reachable_pages(root, res.dir_pages_before, res.leaf_pages_before);
+        res.records = root.get_total_count();
+        if (res.records == 0) {
+            res.leaf_pages_after = res.leaf_pages_before;
+            res.dir_pages_after  = res.dir_pages_before;
+            return res;
+        }
+    }
+
+    // first record, page pointer and record count of a child of the new directory
+    struct ChildEntry {
+        Record<N> first;
+        int32_t   child;
+        uint64_t  count;
+    };
+    std::vector<ChildEntry> level;
+
+    // the decompressed records of the leaf being filled
+    unsigned char* buffer = reinterpret_cast<unsigned char*>(scratch);
+    const uint64_t max_buffered_records = scratch_size / (N * 8);
+
+    std::bitset<N * 8> bitset;
+    uint64_t buffered_records = 0;
+
+    // the last leaf written, its next_leaf is set when the following leaf is appended
+    BPlusTreeLeaf<N> last_leaf;
+
+    auto write_leaf = [&]() {
+        auto& page = buffer_manager.append_vpage(leaf_file_id);
+        BPlusTreeLeaf<N> leaf(&page);
+        leaf.update_leaf(leaf, bitset, buffered_records, buffer);
+        *leaf.next_leaf = 0;
+
+        if (last_leaf.page != nullptr) {
+            *last_leaf.next_leaf = page.get_page_number();
+        }
+
+        Record<N> first;
+        std::memcpy(&first, buffer, N * 8);
+        level.push_back({ first, static_cast<int32_t>(page.get_page_number()), buffered_records });
+
+        if (bloom_enabled) {
+            bloom_add_leaf(page.get_page_number(), leaf);
+        }
+        last_leaf = std::move(leaf);
+        res.leaf_pages_after++;
+        res.pages_appended++;
+    };
+
+    // splits the records in leaves with the same greedy fill as the bulk import, taking
+    // records while the compressed leaf fits. on_leaf() is called with each leaf in buffer
+    auto fill_leaves = [&](auto&& on_leaf) {
+        bool interruption_requested = false;
+        Record<N> min;
+        Record<N> max;
+        min.fill(0);
+        max.fill(UINT64_MAX);
+        buffered_records = 0;
+        auto it = get_range(&interruption_requested, min, max);
+        for (auto record = it.next(); record != nullptr; record = it.next()) {
+            auto record_bytes = reinterpret_cast<const unsigned char*>(record->data());
+            if (buffered_records > 0) {
+                auto new_bitset = bitset;
+                for (size_t j = 0; j < N * 8; j++) {
+                    if (new_bitset[j] && record_bytes[j] != buffer[j]) {
+                        new_bitset.set(j, 0);
+                    }
+                }
+                if (buffered_records < max_buffered_records
+                    && BPlusTreeLeaf<N>::get_page_size(new_bitset, buffered_records + 1) <= VPage::SIZE)
+                {
+                    bitset = new_bitset;
+                    std::memcpy(buffer + buffered_records * (N * 8), record_bytes, N * 8);
+                    buffered_records++;
+                    continue;
+                }
+                on_leaf();
+            }
+            bitset.set();
+            std::memcpy(buffer, record_bytes, N * 8);
+            buffered_records = 1;
+        }
+        on_leaf();
+    };
+
+    // the old pages are not freed, so a tree that wouldn't lose at least
+    // MIN_COMPACTION_GAIN of its leaves is not rewritten
+    uint64_t new_leaf_pages = 0;
+    fill_leaves([&]() { new_leaf_pages++; });
+    if (new_leaf_pages > res.leaf_pages_before * (1 - MIN_COMPACTION_GAIN)) {
+        res.leaf_pages_after = res.leaf_pages_before;
+        res.dir_pages_after  = res.dir_pages_before;
+        return res;
+    }
+    fill_leaves(write_leaf);
+
+    // sets the keys, children and counts of dir from the entries in [begin, end)
+    auto fill_dir = [](BPlusTreeDir<N>& dir, const ChildEntry* begin, const ChildEntry* end) {
+        *dir.key_count = end - begin - 1;
+        for (auto entry = begin; entry != end; ++entry) {
+            auto i = entry - begin;
+            dir.children[i] = entry->child;
+            dir.counts[i]   = entry->count;
+            if (i > 0) {
+                std::memcpy(&dir.keys[(i - 1) * N], entry->first.data(), N * sizeof(uint64_t));
+            }
+        }
+    };
+
+    // build the directory levels bottom-up until the children fit in the root,
+    // spreading the children evenly between the pages of each level
+    constexpr uint64_t max_children = dir_max_records + 1;
+    while (level.size() > max_children) {
+        const uint64_t dir_pages = (level.size() + max_children - 1) / max_children;
+        const uint64_t children_per_dir = (level.size() + dir_pages - 1) / dir_pages;
+
+        std::vector<ChildEntry> upper_level;
+        for (uint64_t from = 0; from < level.size(); from += children_per_dir) {
+            uint64_t to = std::min<uint64_t>(from + children_per_dir, level.size());
+
+            auto& page = buffer_manager.append_vpage(dir_file_id);
+            BPlusTreeDir<N> dir(leaf_file_id, &page);
+            fill_dir(dir, level.data() + from, level.data() + to);
+
+            uint64_t count = 0;
+            for (auto i = from; i < to; i++) {
+                count += level[i].count;
+            }
+            upper_level.push_back({ level[from].first, static_cast<int32_t>(page.get_page_number())*-1, count });
+            res.dir_pages_after++;
+            res.pages_appended++;
+        }
+        level = std::move(upper_level);
+    }
+
+    // publish the new tree, older versions of the root still point to the old pages
+    BPlusTreeDir<N> root(
+        leaf_file_id,
+        &buffer_manager.get_page_readonly(dir_file_id, 0)
+    );
+    root.upgrade_to_editable();
+    fill_dir(root, level.data(), level.data() + level.size());
+    res.dir_pages_after++;
+
+    return res;
 }
 
 
@@ -152,6 +453,36 @@ void BptIter<N>::operator=(BptIter&& other) noexcept {
     current_leaf.set_redundant_record(current_record);
 }
 
+template <std::size_t N>
+bool BptIter<N>::seek_forward(bool* _interruption_requested, const Record<N>& min, const Record<N>& _max) {
+    if (current_leaf.is_null() || current_leaf.get_value_count() == 0
+        || min < current_leaf.get_record(0))
+    {
+        return false;
+    }
+
+    if (current_leaf.get_record(current_leaf.get_value_count() - 1) < min) {
+        if (current_leaf.has_next()) {
+            current_leaf.update_to_next_leaf();
+            current_leaf.set_redundant_record(current_record);
+            if (current_leaf.get_value_count() == 0
+                || current_leaf.get_record(current_leaf.get_value_count() - 1) < min)
+            {
+                return false;
+            }
+            current_pos = current_leaf.search_index_from(0, min);
+        } else {
+            // min is greater than all the records of the tree
+            current_pos = current_leaf.get_value_count();
+        }
+    } else {
+        current_pos = current_leaf.search_index(min);
+    }
+    interruption_requested = _interruption_requested;
+    max = _max;
+    return true;
+}
+
 template <std::size_t N>
 const Record<N>* BptIter<N>::next() {
     while (true) {
@@ -187,6 +518,69 @@ const Record<N>* BptIter<N>::next() {
 }
 
 
+template <std::size_t N>
+uint_fast32_t BptIter<N>::next_batch(BptBatch<N>& batch) {
+    // true if the record at `row` of the batch is greater than max
+    auto greater_than_max = [&](uint_fast32_t row) {
+        for (size_t i = 0; i < N; ++i) {
+            auto value = batch.column(i)[row];
+            if (value < max[i]) {
+                return false;
+            } else if (value > max[i]) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    batch.size = 0;
+    while (batch.size < batch.capacity) {
+        if (MDB_unlikely(*interruption_requested)) {
+            throw InterruptedException();
+        }
+        auto value_count = current_leaf.get_value_count();
+        if (current_pos < value_count) {
+            uint_fast32_t to = std::min<uint_fast32_t>(value_count,
+                                                       current_pos + (batch.capacity - batch.size));
+            current_leaf.decode_records(current_pos, to, batch.column(0) + batch.size, batch.capacity);
+
+            uint_fast32_t begin = batch.size;
+            uint_fast32_t end   = batch.size + (to - current_pos);
+
+            // records are sorted, so if the last one is not greater than max none of them is
+            if (MDB_unlikely(greater_than_max(end - 1))) {
+                // binary search for the first record greater than max
+                while (begin < end) {
+                    auto middle = begin + (end - begin) / 2;
+                    if (greater_than_max(middle)) {
+                        end = middle;
+                    } else {
+                        begin = middle + 1;
+                    }
+                }
+                // current_pos stays at the first record greater than max,
+                // so the following calls will return 0 (same as next())
+                current_pos += begin - batch.size;
+                batch.size = begin;
+                return batch.size;
+            }
+            batch.size = end;
+            current_pos = to;
+        }
+        else if (current_leaf.has_next()) {
+            current_leaf.update_to_next_leaf();
+            current_pos = 0;
+            // keep current_record valid in case next() is called after this
+            current_leaf.set_redundant_record(current_record);
+        }
+        else {
+            break;
+        }
+    }
+    return batch.size;
+}
+
+
 template class BPlusTree<1>;
 template class BPlusTree<2>;
 template class BPlusTree<3>;
@@ -4,12 +4,57 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <vector>
 
 #include "storage/file_id.h"
 #include "storage/index/bplus_tree/bplus_tree_dir.h"
 #include "storage/index/bplus_tree/bplus_tree_leaf.h"
 #include "storage/index/record.h"
 
+// Column-major buffer filled by BptIter::next_batch.
+// column(i)[j] is the i-th component of the j-th record in the batch.
+template <std::size_t N> class BptBatch {
+public:
+    static constexpr uint_fast32_t DEFAULT_CAPACITY = 256;
+
+    BptBatch(uint_fast32_t capacity = DEFAULT_CAPACITY) :
+        capacity (capacity),
+        data     (N * capacity) { }
+
+    const uint_fast32_t capacity;
+
+    // number of valid records in the batch
+    uint_fast32_t size = 0;
+
+    inline uint64_t* column(std::size_t i) {
+        return data.data() + i * capacity;
+    }
+
+    inline const uint64_t* column(std::size_t i) const {
+        return data.data() + i * capacity;
+    }
+
+private:
+    std::vector<uint64_t> data;
+};
+
+
+// Result of BPlusTree::compact. The before/after page counts only include the
+// pages reachable from the root, a full scan reads every leaf page once.
+struct BPlusTreeCompaction {
+    uint64_t records = 0;
+
+    // pages appended to the leaf and dir files, the old pages are not freed
+    uint64_t pages_appended = 0;
+
+    uint64_t leaf_pages_before = 0;
+    uint64_t leaf_pages_after  = 0;
+
+    uint64_t dir_pages_before = 0;
+    uint64_t dir_pages_after  = 0;
+};
+
+
 template <std::size_t N> class BptIter {
 public:
     // shouldn't use a BptIter constructed like this.
@@ -27,6 +72,19 @@ public:
 
     const Record<N>* next();
 
+    // Decodes up to batch.capacity records into the batch, continuing from the
+    // same position as next(). Returns the number of records written,
+    // 0 means there are no more records.
+    uint_fast32_t next_batch(BptBatch<N>& batch);
+
+    // Moves the iterator to the range [min, max] if it starts in the current
+    // leaf or in the next one, without searching from the root. Returns false
+    // if the range must be obtained with BPlusTree::get_range. Meant for
+    // ranges searched in increasing order, it also works after set_null().
+    bool seek_forward(bool* interruption_requested,
+                      const Record<N>& min,
+                      const Record<N>& max);
+
     inline bool is_null() const {
         return interruption_requested == nullptr;
     }
@@ -49,13 +107,23 @@ template <std::size_t N> class BPlusTree {
 public:
     // (MDB_PAGE_SIZE - SIZE_OF(value_count) - SIZE_OF(next_leaf)) / (SIZE_OF(UINT64) * N)
     static constexpr auto leaf_max_records = (VPage::SIZE - 2*sizeof(int32_t) ) / (sizeof(uint64_t)*N);
-    static constexpr auto dir_max_records  = (VPage::SIZE - 2*sizeof(int32_t) ) / (sizeof(uint64_t)*N + sizeof(int32_t));
+
+    // (MDB_PAGE_SIZE - SIZE_OF(key_count) - SIZE_OF(last_child) - SIZE_OF(last_child_count))
+    //   / (SIZE_OF(UINT64) * N + SIZE_OF(child) + SIZE_OF(child_count))
+    static constexpr auto dir_max_records  = (VPage::SIZE - 2*sizeof(int32_t) - sizeof(uint64_t))
+                                             / (sizeof(uint64_t)*N + sizeof(int32_t) + sizeof(uint64_t));
+
+    // compact() only rewrites the B+tree if it reduces the leaf pages by this fraction
+    static constexpr double MIN_COMPACTION_GAIN = 0.1;
 
     BPlusTree(const std::string& name);
 
     const FileId dir_file_id;
     const FileId leaf_file_id;
 
+    // Bloom filters of the leaves, see BPlusTreeBloom
+    const FileId bloom_file_id;
+
     // returns true if record was inserted, false if record was already there
     bool insert(const Record<N>& record);
 
@@ -70,6 +138,20 @@ public:
                          const Record<N>& min,
                          const Record<N>& max) const noexcept;
 
+    // same as previous get_range but skipping the first `offset` records of the range,
+    // without reading them
+    BptIter<N> get_range(bool* interruption_requested,
+                         const Record<N>& min,
+                         const Record<N>& max,
+                         uint64_t offset) const noexcept;
+
+    // returns the exact number of records r such that min <= r <= max
+    uint64_t count_records(const Record<N>& min,
+                           const Record<N>& max) const;
+
+    // returns the total number of records in the B+tree
+    uint64_t get_total_count() const;
+
     double estimate_records(const Record<N>& min,
                             const Record<N>& max) const;
 
@@ -77,6 +159,43 @@ public:
                                    const Record<N>& min,
                                    const Record<N>& max);
 
+    // Searches a single record. Returns false if the Bloom filter of the leaf where
+    // the record would be rules it out, without reading the leaf. Otherwise `it`
+    // iterates the record if it is in the B+tree, and nothing if it is not
+    bool get_record(bool* interruption_requested, const Record<N>& record, BptIter<N>& it) const;
+
+    // Rewrites the B+tree into dense leaves appended at the end of the leaf file,
+    // linked in physical order, and a new directory built bottom-up over them.
+    // The new tree is published by editing the root page, so transactions reading
+    // an older version keep using the old pages. The old pages are not reused, so
+    // the tree is left as it is if the leaves are already dense (pages_appended is 0).
+    // `buffer` holds the decompressed records of the leaf being written, it
+    // must have `buffer_size` bytes and at least room for one record.
+    BPlusTreeCompaction compact(char* buffer, uint64_t buffer_size);
+
     // It doesn't simply return the root, it is an unique_ptr so it pins the page
     std::unique_ptr<BPlusTreeDir<N>> get_root() const noexcept;
+
+private:
+    // false if the bloom file does not cover every leaf (e.g. the database was
+    // created before the filters existed). Then the filters are not used nor updated
+    bool bloom_enabled;
+
+    // size of the Bloom filter of each leaf, read from the header of the bloom file
+    uint64_t bloom_filter_bytes;
+
+    // returns the page with the Bloom filter of the leaf, appending the missing pages
+    VPage& get_bloom_page_editable(uint32_t leaf_page);
+
+    // adds the record to the Bloom filter of the leaf
+    void bloom_add(uint32_t leaf_page, const Record<N>& record);
+
+    // adds every record of the leaf to its Bloom filter
+    void bloom_add_leaf(uint32_t leaf_page, const BPlusTreeLeaf<N>& leaf);
+
+    // returns false only if the record is not in the leaf
+    bool bloom_may_contain(uint32_t leaf_page, const Record<N>& record) const;
+
+    // adds the directory and leaf pages reachable from dir to the counters
+    void count_reachable_pages(const BPlusTreeDir<N>& dir, uint64_t& dir_pages, uint64_t& leaf_pages) const;
 };
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "storage/page/versioned_page.h"
+#include "third_party/hashes/hash_function_wrapper.h"
+
+// Bloom filter with the records of a B+tree leaf.
+// The first page of the <name>.bloom file is a header with the size of the
+// filters of the B+tree, chosen from the records per leaf when the filters are
+// built (see filter_bytes_for). The filters follow the header in the order of
+// the leaf page numbers, get_filters_per_page() filters in each page.
+// The pages are versioned like the leaves, so a transaction reads the filters
+// of the leaf versions it sees and is never blocked by the updates. Bits are
+// only set and never cleared (not on deletes nor on splits), so the filter of
+// a leaf always has every record of the leaf.
+template <std::size_t N>
+class BPlusTreeBloom {
+public:
+    static constexpr uint64_t MIN_FILTER_BYTES = 64;
+
+    static constexpr uint64_t MAX_FILTER_BYTES = 1024;
+
+    // with 7 hashes the false positive rate is about 1% when a leaf has
+    // all the records its filter was sized for
+    static constexpr uint64_t BITS_PER_RECORD = 10;
+
+    static constexpr uint64_t HASHES = 7;
+
+    static constexpr uint64_t HEADER_PAGES = 1;
+
+    static_assert(VPage::SIZE % MAX_FILTER_BYTES == 0, "filters can't span pages");
+
+    struct Header {
+        uint64_t filter_bytes;
+    };
+
+    // smallest power of 2 with BITS_PER_RECORD bits for each record
+    static constexpr uint64_t filter_bytes_for(uint64_t records_per_leaf) noexcept {
+        uint64_t filter_bytes = MIN_FILTER_BYTES;
+        while (filter_bytes < MAX_FILTER_BYTES && filter_bytes * 8 < records_per_leaf * BITS_PER_RECORD) {
+            filter_bytes *= 2;
+        }
+        return filter_bytes;
+    }
+
+    // false if the header was not written by this version of the filters
+    static bool valid_filter_bytes(uint64_t filter_bytes) noexcept {
+        return filter_bytes >= MIN_FILTER_BYTES
+            && filter_bytes <= MAX_FILTER_BYTES
+            && (filter_bytes & (filter_bytes - 1)) == 0;
+    }
+
+    static constexpr uint64_t get_filters_per_page(uint64_t filter_bytes) noexcept {
+        return VPage::SIZE / filter_bytes;
+    }
+
+    static inline void add(char* filter, uint64_t filter_bytes, const std::array<uint64_t, N>& record) noexcept {
+        auto hash = HashFunctionWrapper(record.data(), sizeof(uint64_t) * N);
+        // double hashing, the second hash must be odd so every probe is different
+        auto h1 = hash;
+        auto h2 = (hash >> 32) | 1;
+        const auto mask = filter_bytes * 8 - 1;
+        for (uint64_t i = 0; i < HASHES; i++) {
+            auto bit = (h1 + i * h2) & mask;
+            filter[bit / 8] |= static_cast<char>(1 << (bit % 8));
+        }
+    }
+
+    static inline bool may_contain(const char* filter, uint64_t filter_bytes, const std::array<uint64_t, N>& record) noexcept {
+        auto hash = HashFunctionWrapper(record.data(), sizeof(uint64_t) * N);
+        auto h1 = hash;
+        auto h2 = (hash >> 32) | 1;
+        const auto mask = filter_bytes * 8 - 1;
+        for (uint64_t i = 0; i < HASHES; i++) {
+            auto bit = (h1 + i * h2) & mask;
+            if ((filter[bit / 8] & (1 << (bit % 8))) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ORs the halves of `filter` until it has `filter_bytes`. Because the sizes
+    // are powers of 2, the folded filter has the bits of the same records
+    static inline void fold(char* filter, uint64_t from_bytes, uint64_t filter_bytes) noexcept {
+        while (from_bytes > filter_bytes) {
+            from_bytes /= 2;
+            for (uint64_t i = 0; i < from_bytes; i++) {
+                filter[i] |= filter[from_bytes + i];
+            }
+        }
+    }
+};
@@ -1,5 +1,6 @@
 #include "bplus_tree_dir.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <utility>
@@ -26,11 +27,16 @@ void BPlusTreeDir<N>::upgrade_to_editable() {
 
         keys = reinterpret_cast<uint64_t*>(page->get_bytes());
 
-        key_count = reinterpret_cast<uint32_t*>(reinterpret_cast<uint32_t*>(page->get_bytes()
-                        + (sizeof(uint64_t) * BPlusTree<N>::dir_max_records * N)));
+        counts = reinterpret_cast<uint64_t*>(page->get_bytes()
+                        + (sizeof(uint64_t) * BPlusTree<N>::dir_max_records * N));
+
+        key_count = reinterpret_cast<uint32_t*>(page->get_bytes()
+                        + (sizeof(uint64_t) * BPlusTree<N>::dir_max_records * N)
+                        + (sizeof(uint64_t) * (BPlusTree<N>::dir_max_records + 1)));
 
         children = reinterpret_cast<int32_t*>(page->get_bytes()
                         + (sizeof(uint64_t) * BPlusTree<N>::dir_max_records * N)
+                        + (sizeof(uint64_t) * (BPlusTree<N>::dir_max_records + 1))
                         + sizeof(uint32_t));
     }
 }
@@ -43,16 +49,23 @@ bool BPlusTreeDir<N>::delete_record(const Record<N>& record) {
 
     auto page_pointer = children[index];
 
+    bool deleted;
     if (page_pointer < 0) { // negative number: pointer to dir
         auto& child_page = buffer_manager.get_page_readonly(dir_file_id, page_pointer*-1);
         BPlusTreeDir<N> child(leaf_file_id, &child_page);
-        return child.delete_record(record);
+        deleted = child.delete_record(record);
     }
     else { // positive number: pointer to leaf
         auto& child_page = buffer_manager.get_page_readonly(leaf_file_id, page_pointer);
         BPlusTreeLeaf<N> child(&child_page);
-        return child.delete_record(record);
+        deleted = child.delete_record(record);
     }
+
+    if (deleted) {
+        upgrade_to_editable();
+        --counts[index];
+    }
+    return deleted;
 }
 
 
@@ -75,6 +88,11 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
         split = child.insert(record, error);
     }
 
+    if (split == nullptr && !error) {
+        upgrade_to_editable();
+        ++counts[index];
+    }
+
     if (split != nullptr) {
         uint_fast32_t splitted_index = search_child_index(split->record);
         uint_fast32_t splitted_index2 = search_child_index(split->record2);
@@ -91,6 +109,9 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
             update_child(splitted_index+1, split->encoded_page_number);
             ++(*key_count);
 
+            refresh_count(splitted_index);
+            refresh_count(splitted_index+1);
+
             return nullptr;
         }
         // Case 2: no need to split this node, 2 keys are inserted
@@ -109,6 +130,10 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
             update_child(splitted_index + 1, split->encoded_page_number);
             ++*key_count;
 
+            for (auto i = splitted_index; i <= std::min<uint_fast32_t>(splitted_index2 + 2, *key_count); i++) {
+                refresh_count(i);
+            }
+
             return nullptr;
         }
         // Case 3: we need to split this node and this node is the root
@@ -119,7 +144,7 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
 
             // splitted key is the last key
             if (splitted_index == *key_count) {
-                last_keys[0] = record;
+                last_keys[0] = split->record;
                 last_dirs[0] = split->encoded_page_number;
             }
             else {
@@ -227,6 +252,11 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
             children[0] = static_cast<int32_t>(new_lhs_dir.page->get_page_number()) * -1;
             children[1] = static_cast<int32_t>(new_rhs_dir.page->get_page_number()) * -1;
 
+            new_lhs_dir.refresh_counts();
+            new_rhs_dir.refresh_counts();
+            counts[0] = new_lhs_dir.get_total_count();
+            counts[1] = new_rhs_dir.get_total_count();
+
             return nullptr;
         }
         // Case 4: normal split (this node is not the root)
@@ -237,7 +267,7 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
 
             // splitted key is the last key
             if (splitted_index == *key_count) {
-                last_keys[0] = record;
+                last_keys[0] = split->record;
                 last_dirs[0] = split->encoded_page_number;
             }
             else {
@@ -316,6 +346,9 @@ std::unique_ptr<BPlusTreeSplit<N>> BPlusTreeDir<N>::insert(const Record<N>& reco
                 ++*new_dir.key_count;
             }
 
+            refresh_counts();
+            new_dir.refresh_counts();
+
             // key at middle_index is returned
             std::array<uint64_t, N> split_key;
             std::memcpy(
@@ -362,6 +395,100 @@ template <std::size_t N>
 void BPlusTreeDir<N>::shift_right_children(int_fast32_t from, int_fast32_t to) {
     for (int_fast32_t i = to; i >= from; i--) {
         children[i+1] = children[i];
+        counts[i+1] = counts[i];
+    }
+}
+
+
+template <std::size_t N>
+uint64_t BPlusTreeDir<N>::read_child_count(int32_t page_pointer) const {
+    if (page_pointer < 0) { // negative number: pointer to dir
+        auto& child_page = buffer_manager.get_page_readonly(dir_file_id, page_pointer*-1);
+        BPlusTreeDir<N> child(leaf_file_id, &child_page);
+        return child.get_total_count();
+    }
+    else { // positive number: pointer to leaf
+        auto& child_page = buffer_manager.get_page_readonly(leaf_file_id, page_pointer);
+        BPlusTreeLeaf<N> child(&child_page);
+        return child.get_value_count();
+    }
+}
+
+
+template <std::size_t N>
+void BPlusTreeDir<N>::refresh_count(int_fast32_t index) {
+    counts[index] = read_child_count(children[index]);
+}
+
+
+template <std::size_t N>
+void BPlusTreeDir<N>::refresh_counts() {
+    for (uint_fast32_t i = 0; i <= *key_count; i++) {
+        refresh_count(i);
+    }
+}
+
+
+template <std::size_t N>
+uint64_t BPlusTreeDir<N>::get_total_count() const {
+    uint64_t res = 0;
+    for (uint_fast32_t i = 0; i <= *key_count; i++) {
+        res += counts[i];
+    }
+    return res;
+}
+
+
+template <std::size_t N>
+uint64_t BPlusTreeDir<N>::count_before(const Record<N>& r, bool inclusive) const {
+    auto dir_index = search_child_index(r);
+    auto page_pointer = children[dir_index];
+
+    uint64_t res = 0;
+    for (size_t i = 0; i < dir_index; i++) {
+        res += counts[i];
+    }
+
+    if (page_pointer < 0) { // negative number: pointer to dir
+        auto& child_page = buffer_manager.get_page_readonly(dir_file_id, page_pointer*-1);
+        BPlusTreeDir<N> child(leaf_file_id, &child_page);
+        return res + child.count_before(r, inclusive);
+    }
+    else { // positive number: pointer to leaf
+        auto& child_page = buffer_manager.get_page_readonly(leaf_file_id, page_pointer);
+        BPlusTreeLeaf<N> child(&child_page);
+        auto value_count = child.get_value_count();
+        if (value_count == 0) {
+            return res;
+        }
+        uint64_t index = child.search_index(r);
+        if (inclusive && index < value_count && child.get_record(index) == r) {
+            index++;
+        }
+        return res + index;
+    }
+}
+
+
+template <std::size_t N>
+SearchLeafResult<N> BPlusTreeDir<N>::search_leaf_at(uint64_t position) const noexcept {
+    uint_fast32_t dir_index = 0;
+    while (dir_index < *key_count && position >= counts[dir_index]) {
+        position -= counts[dir_index];
+        dir_index++;
+    }
+    auto page_pointer = children[dir_index];
+
+    if (page_pointer < 0) { // negative number: pointer to dir
+        auto& child_page = buffer_manager.get_page_readonly(dir_file_id, page_pointer*-1);
+        auto child = BPlusTreeDir<N>(leaf_file_id, &child_page);
+        return child.search_leaf_at(position);
+    }
+    else { // positive number: pointer to leaf
+        auto& child_page = buffer_manager.get_page_readonly(leaf_file_id, page_pointer);
+        BPlusTreeLeaf<N> child(&child_page);
+        uint_fast32_t index = std::min<uint64_t>(position, child.get_value_count());
+        return SearchLeafResult(std::move(child), index);
     }
 }
 
@@ -385,6 +512,22 @@ SearchLeafResult<N> BPlusTreeDir<N>::search_leaf(const Record<N>& min) const noe
 }
 
 
+template <std::size_t N>
+uint32_t BPlusTreeDir<N>::search_leaf_page(const Record<N>& record) const noexcept {
+    auto dir_index = search_child_index(record);
+    auto page_pointer = children[dir_index];
+
+    if (page_pointer < 0) { // negative number: pointer to dir
+        auto& child_page = buffer_manager.get_page_readonly(dir_file_id, page_pointer*-1);
+        BPlusTreeDir<N> child(leaf_file_id, &child_page);
+        return child.search_leaf_page(record);
+    }
+    else { // positive number: pointer to leaf
+        return page_pointer;
+    }
+}
+
+
 template <std::size_t N>
 SearchLeafResult<N> BPlusTreeDir<N>::search_leaf(
     std::vector< std::unique_ptr<BPlusTreeDir<N>> >& stack,
@@ -549,6 +692,17 @@ bool BPlusTreeDir<N>::check(std::ostream& os) const {
         }
     }
 
+    // check counts are consistent with the children
+    for (uint_fast32_t i = 0; i <= *key_count; i++) {
+        auto child_count = read_child_count(children[i]);
+        if (counts[i] != child_count) {
+            os << "  ERROR: inconsistency between count and child record count at BPlusTreeDir(page: "
+               << page->get_page_number() << ")\n";
+            os << "    " << counts[i] << " != " << child_count << "\n";
+            return false;
+        }
+    }
+
     // propagate checking to children
     for (uint_fast32_t i = 0; i <= *key_count; i++) {
         auto page_pointer = children[i];
@@ -570,20 +724,6 @@ bool BPlusTreeDir<N>::check(std::ostream& os) const {
 }
 
 
-template <std::size_t N>
-void BPlusTreeDir<N>::get_branch_indexes(const Record<N>& r, std::vector<int>& idxs) const {
-    auto dir_index = search_child_index(r);
-    auto page_pointer = children[dir_index];
-
-    idxs.push_back(dir_index);
-    if (page_pointer < 0) { // negative number: pointer to dir
-        auto& child_page = buffer_manager.get_page_readonly(dir_file_id, page_pointer*-1);
-        BPlusTreeDir<N> child(leaf_file_id, &child_page);
-        child.get_branch_indexes(r, idxs);
-    }
-}
-
-
 template class BPlusTreeDir<1>;
 template class BPlusTreeDir<2>;
 template class BPlusTreeDir<3>;
@@ -16,12 +16,21 @@ class BPlusTreeDir {
 friend class BPlusTree<N>;
 
 public:
+    // Page layout:
+    // - keys:      dir_max_records * N * uint64_t
+    // - counts:    (dir_max_records + 1) * uint64_t, records in the subtree of each child
+    // - key_count: uint32_t
+    // - children:  (dir_max_records + 1) * int32_t
     BPlusTreeDir(FileId leaf_file_id, VPage* page) :
         keys         (reinterpret_cast<uint64_t*>(page->get_bytes())),
-        key_count    (reinterpret_cast<uint32_t*>(page->get_bytes()
+        counts       (reinterpret_cast<uint64_t*>(page->get_bytes()
                         + (sizeof(uint64_t) * BPlusTree<N>::dir_max_records * N))),
+        key_count    (reinterpret_cast<uint32_t*>(page->get_bytes()
+                        + (sizeof(uint64_t) * BPlusTree<N>::dir_max_records * N)
+                        + (sizeof(uint64_t) * (BPlusTree<N>::dir_max_records + 1)))),
         children     (reinterpret_cast<int32_t*>(page->get_bytes()
                         + (sizeof(uint64_t) * BPlusTree<N>::dir_max_records * N)
+                        + (sizeof(uint64_t) * (BPlusTree<N>::dir_max_records + 1))
                         + sizeof(uint32_t))),
         page         (page),
         dir_file_id  (page->page_id.file_id),
@@ -44,6 +53,21 @@ public:
     SearchLeafResult<N> search_leaf(std::vector< std::unique_ptr<BPlusTreeDir<N>> >&,
                                     const Record<N>& min) const noexcept;
 
+    // returns the page number of the leaf where `record` would be, without reading the leaf
+    uint32_t search_leaf_page(const Record<N>& record) const noexcept;
+
+    // returns the leaf containing the record at `position` (starting from 0) in this
+    // directory's subtree, and the index of the record inside that leaf.
+    // If there is no such record the position returned is at the end of the last leaf
+    SearchLeafResult<N> search_leaf_at(uint64_t position) const noexcept;
+
+    // returns how many records in this directory's subtree are less than r,
+    // or less than or equal to r if inclusive is true
+    uint64_t count_before(const Record<N>& r, bool inclusive) const;
+
+    // returns how many records are in this directory's subtree
+    uint64_t get_total_count() const;
+
     // returns true if min_key <= r <= max_key. If key_count==0, will return false.
     // used in leapfrog to know if the search can be done from here or from a upper directory in the branch
     bool check_range(const Record<N>& r) const;
@@ -53,6 +77,7 @@ public:
 
 private:
     uint64_t* keys;
+    uint64_t* counts;
     uint32_t* key_count;
     int32_t*  children;
 
@@ -68,6 +93,12 @@ private:
     void update_key(int_fast32_t index, const Record<N>& record);
     void update_child(int_fast32_t index, int_fast32_t dir);
 
-    // used for cardinality estimation
-    void get_branch_indexes(const Record<N>& record, std::vector<int>& idxs) const;
+    // returns the number of records in the subtree of the child pointed by page_pointer
+    uint64_t read_child_count(int32_t page_pointer) const;
+
+    // sets counts[index] reading the child page
+    void refresh_count(int_fast32_t index);
+
+    // sets all the counts reading every child page
+    void refresh_counts();
 };
@@ -133,6 +133,39 @@ void BPlusTreeLeaf<N>::update_record(uint_fast32_t pos, Record<N>& out) const {
 }
 
 
+template <std::size_t N>
+void BPlusTreeLeaf<N>::decode_records(uint_fast32_t from,
+                                      uint_fast32_t to,
+                                      uint64_t*     columns,
+                                      std::size_t   stride) const
+{
+    // positions of the non redundant bytes are the same for every record of the leaf
+    uint8_t unique_positions[N * sizeof(uint64_t)];
+    size_t unique_count = 0;
+    for (size_t i = 0; i < N * sizeof(uint64_t); ++i) {
+        if (!redundant_bitset[i]) {
+            unique_positions[unique_count++] = i;
+        }
+    }
+
+    Record<N> current;
+    set_redundant_record(current);
+    unsigned char* current_char = (unsigned char*) &current;
+
+    const unsigned char* record_bytes = records + from * unique_count;
+    for (uint_fast32_t pos = from; pos < to; ++pos) {
+        for (size_t b = 0; b < unique_count; ++b) {
+            current_char[unique_positions[b]] = record_bytes[b];
+        }
+        record_bytes += unique_count;
+
+        for (size_t i = 0; i < N; ++i) {
+            columns[i * stride + (pos - from)] = current[i];
+        }
+    }
+}
+
+
 template <std::size_t N>
 bool BPlusTreeLeaf<N>::delete_record(const Record<N>& record) {
     if (*value_count == 0) {
@@ -390,8 +423,10 @@ unique_ptr<BPlusTreeSplit<N>> BPlusTreeLeaf<N>::insert(const Record<N>& record,
     right_bitset.set();
     bitset_tmp.set();
 
-    uint64_t n_records_left = 0;
-    uint64_t n_records_right = 0;
+    // all the records fit on a side if its loop doesn't break, which happens
+    // when they fill exactly VPage::SIZE
+    uint64_t n_records_left = *value_count + 1;
+    uint64_t n_records_right = *value_count + 1;
 
     for (uint64_t i = 0; i < *value_count + 1; ++i) {
         unsigned char* current_record = buffer + i * (N * 8);
@@ -555,6 +590,44 @@ search_index_begin:
 }
 
 
+template <std::size_t N>
+uint_fast32_t BPlusTreeLeaf<N>::search_index_from(uint_fast32_t from, const Record<N>& record) const noexcept {
+    const uint_fast32_t count = *value_count;
+    Record<N> search_record;
+    set_redundant_record(search_record);
+
+    auto less_than_record = [&](uint_fast32_t pos) {
+        update_record(pos, search_record);
+        return search_record < record;
+    };
+
+    // gallop until finding a position that is not smaller than record,
+    // everything before `lo` is known to be smaller
+    uint_fast32_t lo = from;
+    uint_fast32_t hi = from;
+    uint_fast32_t step = 1;
+    while (hi < count && less_than_record(hi)) {
+        lo = hi + 1;
+        hi = lo + step;
+        step *= 2;
+    }
+    if (hi > count) {
+        hi = count;
+    }
+
+    // binary search in [lo, hi), hi is not smaller than record or is the end of the leaf
+    while (lo < hi) {
+        auto middle = lo + (hi - lo) / 2;
+        if (less_than_record(middle)) {
+            lo = middle + 1;
+        } else {
+            hi = middle;
+        }
+    }
+    return lo;
+}
+
+
 template <std::size_t N>
 void BPlusTreeLeaf<N>::shift_right_records(int_fast32_t from, int_fast32_t to) {
     uint64_t record_step = N * 8 - redundant_count;
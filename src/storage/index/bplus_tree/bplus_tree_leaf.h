@@ -86,6 +86,7 @@ public:
 
     void update_to_next_leaf();
 
+    inline bool is_null()             const { return page == nullptr; }
     inline VPage& get_page()          const { return *page; }
     inline uint32_t get_value_count() const { return *value_count; }
     inline bool has_next()            const { return *next_leaf != 0; }
@@ -114,12 +115,21 @@ public:
     // Updates out with the non redundant bytes
     void update_record(uint_fast32_t pos, Record<N>& out) const;
 
+    // Decodes the records in [from, to) in column-major order:
+    // the i-th component of record `from + j` is written at columns[i * stride + j]
+    void decode_records(uint_fast32_t from, uint_fast32_t to, uint64_t* columns, std::size_t stride) const;
+
     // Search for the first record that is equal or greater than the parameter received.
     // May give an invalid index, meaning there is no such record is on this page.
     // If the next leaf is not null, the desired record should be the first record of that leaf,
     // otherwise the record is not in the B+tree.
     uint_fast32_t search_index(const Record<N>& record) const noexcept;
 
+    // Same as search_index, but only looks at positions >= from, assuming the records before
+    // from are smaller than the parameter received. Gallops forward from `from` before doing a
+    // binary search, so it's cheaper than search_index when the result is close to `from`.
+    uint_fast32_t search_index_from(uint_fast32_t from, const Record<N>& record) const noexcept;
+
     // returns true if min_record <= r <= max_record. If the leaf is empty will return false.
     // used in leapfrog to know if the search can be done from here or from a upper directory in the branch
     bool check_range(const Record<N>& r) const;
@@ -138,7 +148,7 @@ private:
     VPage* page;
     FileId leaf_file_id;
 
-    uint32_t get_page_size(std::bitset<N * 8> bitset, uint32_t n_records);
+    static uint32_t get_page_size(std::bitset<N * 8> bitset, uint32_t n_records);
     std::bitset<N * 8> create_new_bitset(const Record<N>& reference, uint64_t from, uint64_t to);
 
     void update_leaf(BPlusTreeLeaf<N>& leaf, std::bitset<N * 8>& bitset, uint64_t n_records, unsigned char* buffer);
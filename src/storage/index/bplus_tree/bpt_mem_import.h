@@ -1,13 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <ios>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
+#include "storage/index/bplus_tree/bplus_tree_bloom.h"
 #include "storage/page/versioned_page.h"
 
 template <std::size_t N>
@@ -17,6 +22,9 @@ public:
 
     BPTLeafWriter(const std::string& filename) {
         file.open(filename, std::ios::out|std::ios::binary);
+        if (file.fail()) {
+            throw std::runtime_error("Could not open file " + filename);
+        }
         buffer = new char[VPage::SIZE];
     }
 
@@ -49,6 +57,99 @@ private:
     char* buffer;
 };
 
+// Writes the Bloom filters of the leaves (see BPlusTreeBloom). The filters are
+// written with MAX_FILTER_BYTES, and when every leaf was added they are folded
+// to the size for the average records per leaf and the header is written.
+template <std::size_t N>
+class BPTBloomWriter {
+public:
+    using Bloom = BPlusTreeBloom<N>;
+
+    BPTBloomWriter(const std::string& filename) : filename (filename) {
+        file.open(filename, std::ios::in|std::ios::out|std::ios::trunc|std::ios::binary);
+        if (file.fail()) {
+            throw std::runtime_error("Could not open file " + filename);
+        }
+        buffer = new char[VPage::SIZE];
+        memset(buffer, 0, VPage::SIZE);
+        // the header is written at the end
+        file.write(buffer, VPage::SIZE);
+    }
+
+    ~BPTBloomWriter() {
+        if (filters_in_buffer > 0) {
+            file.write(buffer, VPage::SIZE);
+        }
+        const auto filter_bytes = Bloom::filter_bytes_for((total_records + leaves - 1) / std::max<uint64_t>(leaves, 1));
+        const auto pages = fold(filter_bytes);
+
+        memset(buffer, 0, VPage::SIZE);
+        typename Bloom::Header header = { filter_bytes };
+        std::memcpy(buffer, &header, sizeof(header));
+        file.seekp(0);
+        file.write(buffer, VPage::SIZE);
+        file.close();
+        delete[] buffer;
+
+        std::filesystem::resize_file(filename, (Bloom::HEADER_PAGES + pages) * VPage::SIZE);
+    }
+
+    // must be called once for every leaf written, in page order
+    void add_leaf(const std::array<uint64_t, N>* records, uint64_t count) {
+        auto filter = buffer + filters_in_buffer * Bloom::MAX_FILTER_BYTES;
+        for (uint64_t i = 0; i < count; i++) {
+            Bloom::add(filter, Bloom::MAX_FILTER_BYTES, records[i]);
+        }
+        total_records += count;
+        leaves++;
+        if (++filters_in_buffer == Bloom::get_filters_per_page(Bloom::MAX_FILTER_BYTES)) {
+            file.write(buffer, VPage::SIZE);
+            memset(buffer, 0, VPage::SIZE);
+            filters_in_buffer = 0;
+        }
+    }
+
+private:
+    std::string filename;
+
+    std::fstream file;
+
+    char* buffer;
+
+    uint64_t filters_in_buffer = 0;
+
+    uint64_t total_records = 0;
+
+    uint64_t leaves = 0;
+
+    // Folds the filters in place and returns the pages they use. A folded
+    // page never has filters of a page that was not read yet
+    uint64_t fold(uint64_t filter_bytes) {
+        const auto from_per_page = Bloom::get_filters_per_page(Bloom::MAX_FILTER_BYTES);
+        const auto to_per_page   = Bloom::get_filters_per_page(filter_bytes);
+
+        std::vector<char> folded(VPage::SIZE, 0);
+        uint64_t folded_pages = 0;
+        for (uint64_t leaf = 0; leaf < leaves; leaf++) {
+            if (leaf % from_per_page == 0) {
+                file.seekg((Bloom::HEADER_PAGES + leaf / from_per_page) * VPage::SIZE);
+                file.read(buffer, VPage::SIZE);
+            }
+            auto filter = buffer + (leaf % from_per_page) * Bloom::MAX_FILTER_BYTES;
+            Bloom::fold(filter, Bloom::MAX_FILTER_BYTES, filter_bytes);
+            std::memcpy(folded.data() + (leaf % to_per_page) * filter_bytes, filter, filter_bytes);
+
+            if (leaf % to_per_page == to_per_page - 1 || leaf == leaves - 1) {
+                file.seekp((Bloom::HEADER_PAGES + folded_pages) * VPage::SIZE);
+                file.write(folded.data(), VPage::SIZE);
+                std::fill(folded.begin(), folded.end(), 0);
+                folded_pages++;
+            }
+        }
+        return folded_pages;
+    }
+};
+
 template <std::size_t N>
 struct SplitData {
     const std::array<uint64_t, N>* record;
@@ -72,14 +173,39 @@ private:
     std::fstream file;
     std::vector<char*> pages;
 
+    // record count of each leaf, indexed by leaf page number
+    std::vector<uint64_t> leaf_counts;
+
+    // writes the counts of every child of the dir and returns their sum
+    uint64_t write_counts(int32_t dir_page_number) {
+        auto key_count = get_key_count(dir_page_number);
+        auto children  = get_children(dir_page_number);
+        auto counts    = get_counts(dir_page_number);
+
+        uint64_t total = 0;
+        for (uint32_t i = 0; i <= *key_count; i++) {
+            if (children[i] < 0) {
+                // negative number: pointer to dir
+                counts[i] = write_counts(children[i]*-1);
+            } else {
+                // positive number: pointer to leaf
+                counts[i] = static_cast<size_t>(children[i]) < leaf_counts.size()
+                            ? leaf_counts[children[i]]
+                            : 0;
+            }
+            total += counts[i];
+        }
+        return total;
+    }
+
 public:
-    static constexpr auto max_records = (VPage::SIZE - 2*sizeof(int32_t) )
-                                         / (sizeof(uint64_t)*N + sizeof(int32_t));
+    static constexpr auto max_records = (VPage::SIZE - 2*sizeof(int32_t) - sizeof(uint64_t))
+                                         / (sizeof(uint64_t)*N + sizeof(int32_t) + sizeof(uint64_t));
 
     BPTDirWriter(const std::string& filename) {
         file.open(filename, std::ios::out|std::ios::binary);
         if (file.fail()) {
-            std::cout << "Error opening file " << filename << std::endl;
+            throw std::runtime_error("Could not open file " + filename);
         }
         auto root = new char[VPage::SIZE];
         memset(root, 0, VPage::SIZE);
@@ -87,6 +213,7 @@ public:
     }
 
     ~BPTDirWriter() {
+        write_counts(0);
         for (auto page : pages) {
             file.write(page, VPage::SIZE);
             delete[] page;
@@ -98,17 +225,29 @@ public:
         return reinterpret_cast<uint64_t*>(pages[dir_page_number]);
     }
 
+    uint64_t* get_counts(int32_t dir_page_number) {
+        return reinterpret_cast<uint64_t*>(pages[dir_page_number]
+                                           + (sizeof(uint64_t) * max_records * N));
+    }
+
     uint32_t* get_key_count(int32_t dir_page_number) {
         return reinterpret_cast<uint32_t*>(pages[dir_page_number]
-                                           + (sizeof(uint64_t) * max_records * N));
+                                           + (sizeof(uint64_t) * max_records * N)
+                                           + (sizeof(uint64_t) * (max_records + 1)));
     }
 
     int32_t* get_children(int32_t dir_page_number) {
         return reinterpret_cast<int32_t*>(pages[dir_page_number]
                                           + (sizeof(uint64_t) * max_records * N)
+                                          + (sizeof(uint64_t) * (max_records + 1))
                                           + sizeof(uint32_t));
     }
 
+    // must be called once for every leaf written, in page order
+    void add_leaf(uint64_t records) {
+        leaf_counts.push_back(records);
+    }
+
     SplitData<N> bulk_insert(const std::array<uint64_t, N>* record,
                              int32_t dir_page_number,
                              int32_t leaf_page_number)
@@ -0,0 +1,77 @@
+#include "distinct_tuple_set.h"
+
+#include <algorithm>
+#include <cassert>
+
+DistinctTupleSet::DistinctTupleSet(uint_fast32_t tuple_size, size_t max_bytes) :
+    tuple_size (tuple_size)
+{
+    const auto slot_bytes = sizeof(uint64_t) + tuple_size * sizeof(ObjectId);
+    max_capacity = INITIAL_CAPACITY;
+    while (max_capacity * 2 * slot_bytes <= max_bytes) {
+        max_capacity *= 2;
+    }
+    reset();
+}
+
+void DistinctTupleSet::reset()
+{
+    capacity = INITIAL_CAPACITY;
+    tuple_count = 0;
+    hashes.assign(capacity, 0);
+    tuples.resize(capacity * tuple_size);
+    tuples.shrink_to_fit();
+    hashes.shrink_to_fit();
+}
+
+bool DistinctTupleSet::is_in_or_insert(const ObjectId* tuple, uint64_t hash)
+{
+    if (need_grow()) {
+        grow();
+    }
+
+    const uint64_t stored_hash = hash | 1;
+    const uint64_t mask = capacity - 1;
+    auto pos = (stored_hash >> 1) & mask;
+    while (true) {
+        if (hashes[pos] == 0) {
+            hashes[pos] = stored_hash;
+            std::copy(tuple, tuple + tuple_size, tuples.data() + pos * tuple_size);
+            tuple_count++;
+            return false;
+        }
+        if (hashes[pos] == stored_hash && std::equal(tuple, tuple + tuple_size, tuples.data() + pos * tuple_size)) {
+            return true;
+        }
+        pos = (pos + 1) & mask;
+    }
+}
+
+void DistinctTupleSet::grow()
+{
+    assert(capacity * 2 <= max_capacity);
+
+    std::vector<uint64_t> old_hashes(capacity * 2, 0);
+    std::vector<ObjectId> old_tuples(capacity * 2 * tuple_size);
+    old_hashes.swap(hashes);
+    old_tuples.swap(tuples);
+
+    const auto old_capacity = capacity;
+    capacity *= 2;
+    const uint64_t mask = capacity - 1;
+    for (uint64_t i = 0; i < old_capacity; i++) {
+        if (old_hashes[i] == 0) {
+            continue;
+        }
+        auto pos = (old_hashes[i] >> 1) & mask;
+        while (hashes[pos] != 0) {
+            pos = (pos + 1) & mask;
+        }
+        hashes[pos] = old_hashes[i];
+        std::copy(
+            old_tuples.data() + i * tuple_size,
+            old_tuples.data() + (i + 1) * tuple_size,
+            tuples.data() + pos * tuple_size
+        );
+    }
+}
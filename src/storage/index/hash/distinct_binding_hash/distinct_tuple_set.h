@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "graph_models/object_id.h"
+
+// In-memory set of tuples with a fixed number of ObjectIds, using open
+// addressing with linear probing. The tuples are stored one after the other
+// in a single array, and the hash of each slot is kept apart to skip most
+// tuple comparisons.
+// The set doubles its capacity when it is 70% full, but never uses more than
+// the `max_bytes` given to the constructor, see full().
+class DistinctTupleSet {
+public:
+    static constexpr uint64_t INITIAL_CAPACITY = 1024;
+
+    DistinctTupleSet(uint_fast32_t tuple_size, size_t max_bytes);
+
+    // Clears all stored tuples
+    void reset();
+
+    // true if inserting a new tuple needs more than max_bytes
+    bool full() const
+    {
+        return need_grow() && capacity * 2 > max_capacity;
+    }
+
+    // returns true if tuple is present, insert it otherwise.
+    // Must not be called when full()
+    bool is_in_or_insert(const ObjectId* tuple, uint64_t hash);
+
+    inline uint64_t size() const noexcept
+    {
+        return tuple_count;
+    }
+
+    // calls func(const ObjectId*) for each stored tuple
+    template<typename Func>
+    void for_each(Func func) const
+    {
+        for (uint64_t i = 0; i < capacity; i++) {
+            if (hashes[i] != 0) {
+                func(tuples.data() + i * tuple_size);
+            }
+        }
+    }
+
+private:
+    const uint_fast32_t tuple_size;
+
+    uint64_t max_capacity;
+
+    // always a power of 2
+    uint64_t capacity;
+
+    uint64_t tuple_count;
+
+    // 0 is an empty slot, the stored hashes have the lowest bit set
+    std::vector<uint64_t> hashes;
+
+    std::vector<ObjectId> tuples;
+
+    bool need_grow() const
+    {
+        return (tuple_count + 1) * 10 > capacity * 7;
+    }
+
+    void grow();
+};
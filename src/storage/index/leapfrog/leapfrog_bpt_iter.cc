@@ -122,8 +122,50 @@ bool LeapfrogBptIter<N>::seek(uint64_t key)
 template<std::size_t N>
 bool LeapfrogBptIter<N>::internal_search(const Record<N>& min, const Record<N>& max)
 {
+    auto value_count = current_leaf.get_value_count();
+
+    // Finger search: most seeks land close after the current position, so when min is not
+    // before the current tuple, gallop from the current position, or from the start of the next leaf
+    if (current_pos_in_leaf < value_count && current_tuple <= min) {
+        if (min <= current_leaf.get_record(value_count - 1)) {
+            auto new_current_pos_in_leaf = current_leaf.search_index_from(current_pos_in_leaf, min);
+            Record<N> new_current_tuple = current_leaf.get_record(new_current_pos_in_leaf);
+            if (new_current_tuple <= max) {
+                // current_leaf stays the same
+                current_tuple = new_current_tuple;
+                current_pos_in_leaf = new_current_pos_in_leaf;
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+        if (current_leaf.has_next()) {
+            auto next_leaf = current_leaf.clone();
+            next_leaf.update_to_next_leaf();
+            auto next_value_count = next_leaf.get_value_count();
+
+            // min is greater than every record in current_leaf, so if it is not greater than
+            // the last record in next_leaf the result must be inside next_leaf.
+            // The directory_stack is not updated, but it is still valid to search from it
+            // because the climbing only looks at the ranges of the directories.
+            if (next_value_count > 0 && min <= next_leaf.get_record(next_value_count - 1)) {
+                auto new_current_pos_in_leaf = next_leaf.search_index_from(0, min);
+                Record<N> new_current_tuple = next_leaf.get_record(new_current_pos_in_leaf);
+                if (new_current_tuple <= max) {
+                    current_tuple = new_current_tuple;
+                    current_leaf = std::move(next_leaf);
+                    current_pos_in_leaf = new_current_pos_in_leaf;
+                    return true;
+                } else {
+                    return false;
+                }
+            }
+        }
+        // the result is further away, search from the directories
+    }
     // if leaf.min <= min <= leaf.max, search inside the leaf and return
-    if (current_leaf.check_range(min)) {
+    else if (current_leaf.check_range(min)) {
         auto new_current_pos_in_leaf = current_leaf.search_index(min);
         Record<N> new_current_tuple = current_leaf.get_record(new_current_pos_in_leaf);
         if (new_current_tuple <= max) {
@@ -134,41 +176,41 @@ bool LeapfrogBptIter<N>::internal_search(const Record<N>& min, const Record<N>&
         } else {
             return false;
         }
-    } else {
-        // else search in the stack for a dir where dir.min <= min <= dir.max
-        // a dir may not have records (i.e when having one leaf as child), in that case it will return the a record with zeros
-        // and conditions will be false, so its ok
-        // if we don't find it we stay with the root (lowest item in the stack)
-        while (directory_stack.size() > 1 && !directory_stack.back()->check_range(min)) {
-            directory_stack.pop_back();
-        }
+    }
 
-        // then search until reaching the leaf_number and index of the record.
-        auto leaf_and_pos = directory_stack.back()->search_leaf(directory_stack, min);
-        auto new_current_leaf = std::move(leaf_and_pos.leaf);
-        auto new_current_pos_in_leaf = leaf_and_pos.result_index;
-
-        // check new_current_pos_in_leaf is a valid position
-        // we may need to go to the first record of the next leaf
-        if (new_current_pos_in_leaf >= new_current_leaf.get_value_count()) {
-            if (new_current_leaf.has_next()) {
-                new_current_leaf.update_to_next_leaf();
-                new_current_pos_in_leaf = 0;
-            } else {
-                return false;
-            }
-        }
+    // otherwise search in the stack for a dir where dir.min <= min <= dir.max
+    // a dir may not have records (i.e when having one leaf as child), in that case it will return the a record with zeros
+    // and conditions will be false, so its ok
+    // if we don't find it we stay with the root (lowest item in the stack)
+    while (directory_stack.size() > 1 && !directory_stack.back()->check_range(min)) {
+        directory_stack.pop_back();
+    }
 
-        Record<N> new_current_tuple = new_current_leaf.get_record(new_current_pos_in_leaf);
-        if (new_current_tuple <= max) {
-            current_tuple = new_current_tuple;
-            current_leaf = std::move(new_current_leaf);
-            current_pos_in_leaf = new_current_pos_in_leaf;
-            return true;
+    // then search until reaching the leaf_number and index of the record.
+    auto leaf_and_pos = directory_stack.back()->search_leaf(directory_stack, min);
+    auto new_current_leaf = std::move(leaf_and_pos.leaf);
+    auto new_current_pos_in_leaf = leaf_and_pos.result_index;
+
+    // check new_current_pos_in_leaf is a valid position
+    // we may need to go to the first record of the next leaf
+    if (new_current_pos_in_leaf >= new_current_leaf.get_value_count()) {
+        if (new_current_leaf.has_next()) {
+            new_current_leaf.update_to_next_leaf();
+            new_current_pos_in_leaf = 0;
         } else {
             return false;
         }
     }
+
+    Record<N> new_current_tuple = new_current_leaf.get_record(new_current_pos_in_leaf);
+    if (new_current_tuple <= max) {
+        current_tuple = new_current_tuple;
+        current_leaf = std::move(new_current_leaf);
+        current_pos_in_leaf = new_current_pos_in_leaf;
+        return true;
+    } else {
+        return false;
+    }
 }
 
 template<size_t N>
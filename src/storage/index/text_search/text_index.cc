@@ -34,6 +34,7 @@ std::unique_ptr<TextIndex> TextIndex::create(
 
     file_manager.init_file(std::string(relative_index_path / BPT_NAME) + ".dir");
     file_manager.init_file(std::string(relative_index_path / BPT_NAME) + ".leaf");
+    file_manager.init_file(std::string(relative_index_path / BPT_NAME) + ".bloom");
     auto bpt = std::make_unique<BPlusTree<2>>(relative_index_path / BPT_NAME);
 
     auto* normalize_func = get_normalize_func(normalize_type);
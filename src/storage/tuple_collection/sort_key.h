@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "graph_models/object_id.h"
+
+// Normalized sort keys. A normalizer encodes a value in COMPARED_BYTES bytes
+// such that if compare(a, b) < 0 then memcmp(key(a), key(b)) <= 0, so the
+// keys decide the order whenever they are different and the compare function
+// is only needed when they are equal.
+// A normalizer returns true if its key is exact: two values with equal exact
+// keys compare as equal.
+// The keys are stored in SIZE bytes, with the exact flag in the last one.
+class SortKey {
+public:
+    static constexpr size_t SIZE = 16;
+
+    static constexpr size_t COMPARED_BYTES = SIZE - 1;
+
+    using Normalizer = bool (*)(ObjectId oid, unsigned char* key);
+
+    // normalizer for OrderBy::internal_compare
+    static bool normalize_id(ObjectId oid, unsigned char* key)
+    {
+        write_uint64(oid.id, key);
+        return true;
+    }
+
+    // writes the big-endian bytes of value, so memcmp orders them as integers
+    static inline void write_uint64(uint64_t value, unsigned char* out)
+    {
+        for (int i = 7; i >= 0; i--) {
+            out[i] = value & 0xFF;
+            value >>= 8;
+        }
+    }
+
+    // bits of value ordered as unsigned integers in the same way as the doubles,
+    // with -0.0 equal to 0.0
+    static inline uint64_t double_bits(double value)
+    {
+        if (value == 0) {
+            value = 0;
+        }
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & (1ULL << 63)) ? ~bits : bits | (1ULL << 63);
+    }
+
+    // writes at most `size` bytes of str, the rest of the `size` bytes are zeros.
+    // Returns true if str is fully encoded, which needs it to not have zeros
+    static inline bool write_prefix(const char* str, size_t str_size, unsigned char* out, size_t size)
+    {
+        if (str_size > size) {
+            std::memcpy(out, str, size);
+            return false;
+        }
+        std::memcpy(out, str, str_size);
+        std::memset(out + str_size, 0, size - str_size);
+        return std::memchr(str, '\0', str_size) == nullptr;
+    }
+};
@@ -31,8 +31,8 @@ TupleCollectionPage::~TupleCollectionPage()
 void TupleCollectionPage::add(const ObjectId* tuple)
 {
     // Add a new tuple in the last position of the page
-    const size_t offset = (*tuple_count) * info.saved_vars.size();
-    for (size_t i = 0; i < info.saved_vars.size(); i++) {
+    const size_t offset = (*tuple_count) * info.tuple_size();
+    for (size_t i = 0; i < info.tuple_size(); i++) {
         tuples[offset + i] = tuple[i];
     }
     (*tuple_count)++;
@@ -40,7 +40,7 @@ void TupleCollectionPage::add(const ObjectId* tuple)
 
 const ObjectId* TupleCollectionPage::get(uint64_t n) const
 {
-    return &tuples[n * info.saved_vars.size()];
+    return &tuples[n * info.tuple_size()];
 }
 
 void TupleCollectionPage::reset()
@@ -51,9 +51,9 @@ void TupleCollectionPage::reset()
 
 void TupleCollectionPage::swap(int x, int y)
 {
-    size_t pos_x = x * info.saved_vars.size();
-    size_t pos_y = y * info.saved_vars.size();
-    for (size_t i = 0; i < info.saved_vars.size(); i++) {
+    size_t pos_x = x * info.tuple_size();
+    size_t pos_y = y * info.tuple_size();
+    for (size_t i = 0; i < info.tuple_size(); i++) {
         std::swap(tuples[pos_x + i], tuples[pos_y + i]);
     }
 }
@@ -68,7 +68,7 @@ void TupleCollectionPage::sort()
 bool TupleCollectionPage::less_or_equal(const ObjectId* lhs, const ObjectId* rhs) const
 {
     for (size_t i = 0; i < info.ascending.size(); i++) {
-        auto cmp = compare(lhs[i], rhs[i]);
+        auto cmp = compare(lhs[info.key_size + i], rhs[info.key_size + i]);
         if (cmp < 0) {
             return info.ascending[i];
         } else if (cmp > 0) {
@@ -213,3 +213,39 @@ std::unique_ptr<TupleCollectionPage> TupleCollectionMerger::get_run(PPage& run_p
 {
     return make_unique<TupleCollectionPage>(run_page, info, compare);
 }
+
+void LoserTree::init()
+{
+    const uint_fast32_t k = heads.size();
+    losers.assign(k, 0);
+
+    // leaves are the nodes k..2k-1, the internal node n has the children 2n and 2n+1
+    std::vector<uint_fast32_t> winners(2 * k);
+    for (uint_fast32_t i = 0; i < k; i++) {
+        winners[k + i] = i;
+    }
+    for (uint_fast32_t n = k - 1; n > 0; n--) {
+        auto left = winners[2 * n];
+        auto right = winners[2 * n + 1];
+        if (less(right, left)) {
+            winners[n] = right;
+            losers[n] = left;
+        } else {
+            winners[n] = left;
+            losers[n] = right;
+        }
+    }
+    losers[0] = k == 1 ? 0 : winners[1];
+}
+
+void LoserTree::replay()
+{
+    const uint_fast32_t k = heads.size();
+    auto winner = losers[0];
+    for (auto n = (winner + k) / 2; n > 0; n /= 2) {
+        if (less(losers[n], winner)) {
+            std::swap(losers[n], winner);
+        }
+    }
+    losers[0] = winner;
+}
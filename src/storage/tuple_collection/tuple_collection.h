@@ -13,6 +13,7 @@
 #include "query/var_id.h"
 #include "storage/file_id.h"
 #include "storage/page/private_page.h"
+#include "storage/tuple_collection/sort_key.h"
 
 struct OrderInfo {
     // saved_vars must start with the order_vars
@@ -20,6 +21,10 @@ struct OrderInfo {
 
     std::vector<bool> ascending;
 
+    // ObjectIds at the start of each stored tuple with the normalized sort
+    // keys of its first order vars (see SortKey), 0 if there are no keys
+    size_t key_size = 0;
+
     OrderInfo(
         std::vector<VarId>&& order_vars,
         std::vector<bool>&& ascending,
@@ -44,6 +49,100 @@ struct OrderInfo {
             }
         }
     }
+
+    // ObjectIds of a stored tuple
+    inline size_t tuple_size() const
+    {
+        return key_size + saved_vars.size();
+    }
+
+    inline size_t key_columns() const
+    {
+        return key_size * sizeof(ObjectId) / SortKey::SIZE;
+    }
+};
+
+// Three-way comparison of two stored tuples following the order of `info`.
+// The normalized keys are compared first, compare is only called from the
+// first column whose keys are equal but not exact
+struct TupleComparator {
+    const OrderInfo& info;
+
+    int64_t (*compare)(ObjectId, ObjectId);
+
+    inline int64_t operator()(const ObjectId* lhs, const ObjectId* rhs) const
+    {
+        auto lhs_key = reinterpret_cast<const unsigned char*>(lhs);
+        auto rhs_key = reinterpret_cast<const unsigned char*>(rhs);
+
+        size_t i = 0;
+        for (; i < info.key_columns(); i++) {
+            auto cmp = std::memcmp(lhs_key, rhs_key, SortKey::COMPARED_BYTES);
+            if (cmp != 0) {
+                return cmp;
+            }
+            if (!lhs_key[SortKey::COMPARED_BYTES] || !rhs_key[SortKey::COMPARED_BYTES]) {
+                break;
+            }
+            lhs_key += SortKey::SIZE;
+            rhs_key += SortKey::SIZE;
+        }
+
+        lhs += info.key_size;
+        rhs += info.key_size;
+        for (; i < info.ascending.size(); i++) {
+            auto cmp = compare(lhs[i], rhs[i]);
+            if (cmp != 0) {
+                return info.ascending[i] ? cmp : -cmp;
+            }
+        }
+        return 0;
+    }
+};
+
+// Tournament tree of losers used to merge k sorted sequences of tuples with
+// log2(k) comparisons per tuple.
+// heads[i] is the current tuple of the sequence i, or nullptr when the sequence
+// is exhausted. After the caller advances the sequence winner() it must update
+// its head and call replay().
+class LoserTree {
+public:
+    std::vector<const ObjectId*> heads;
+
+    LoserTree(const TupleComparator& comparator) :
+        comparator(comparator)
+    { }
+
+    // builds the tree with the current heads, heads must not be empty
+    void init();
+
+    // sequence with the smallest head, if its head is nullptr all are exhausted
+    inline uint_fast32_t winner() const noexcept
+    {
+        return losers[0];
+    }
+
+    void replay();
+
+private:
+    const TupleComparator& comparator;
+
+    // losers[0] is the winner, losers[n] is the loser of the internal node n
+    std::vector<uint_fast32_t> losers;
+
+    // exhausted sequences are greater than any other, ties are broken
+    // by the position of the sequence
+    inline bool less(uint_fast32_t a, uint_fast32_t b) const
+    {
+        if (heads[a] == nullptr) {
+            return false;
+        }
+        if (heads[b] == nullptr) {
+            return true;
+        }
+        auto cmp = comparator(heads[a], heads[b]);
+        return cmp < 0 || (cmp == 0 && a < b);
+    }
 };
 
 class TupleCollectionPage {
@@ -56,7 +155,7 @@ public:
 
     bool is_full() const
     {
-        return sizeof(tuple_count) + (sizeof(ObjectId) * info.saved_vars.size() * (1 + *tuple_count))
+        return sizeof(tuple_count) + (sizeof(ObjectId) * info.tuple_size() * (1 + *tuple_count))
              > PPage::SIZE;
     }
 
@@ -69,7 +168,7 @@ public:
 
     bool less_or_equal(const ObjectId* lhs, const ObjectId* rhs) const;
 
-    // expects a tuple with values corresponding to saved_vars
+    // expects key_size ObjectIds with the keys followed by the values of saved_vars
     void add(const ObjectId* tuple);
 
     void sort();
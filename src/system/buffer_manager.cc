@@ -4,6 +4,7 @@
 
 #include "macros/aligned_alloc.h"
 #include "misc/fatal_error.h"
+#include "query/exceptions.h"
 #include "query/query_context.h"
 #include "system/file_manager.h"
 
@@ -489,6 +490,9 @@ PPage& BufferManager::get_ppage(TmpFileId tmp_file_id, uint64_t page_number) /*n
 {
     const TmpPageId tmp_page_id(tmp_file_id.id, page_number);
     const auto worker = get_query_ctx().thread_info.worker_index;
+    if (get_query_ctx().thread_info.is_helper) {
+        throw LogicException("Private pages can't be used by helper threads");
+    }
 
     auto it = pp_map[worker].find(tmp_page_id);
     if (it == pp_map[worker].end()) {
@@ -547,6 +551,9 @@ PPage& BufferManager::get_ppage(TmpFileId tmp_file_id, uint64_t page_number) /*n
 TmpFileId BufferManager::get_tmp_file_id()
 {
     auto worker = get_query_ctx().thread_info.worker_index;
+    if (get_query_ctx().thread_info.is_helper) {
+        throw LogicException("Temporal files can't be created by helper threads");
+    }
     auto file_id = tmp_info[worker].size();
     tmp_info[worker].emplace_back();
     return TmpFileId(file_id);
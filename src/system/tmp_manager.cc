@@ -2,6 +2,7 @@
 
 #include <cassert>
 
+#include "query/exceptions.h"
 #include "query/query_context.h"
 
 // memory for the object
@@ -65,6 +66,9 @@ uint64_t TmpManager::print_to_buffer(char* buffer, uint64_t id)
 uint64_t TmpManager::get_str_id(const std::string& str)
 {
     auto idx = get_query_ctx().thread_info.worker_index;
+    if (get_query_ctx().thread_info.is_helper) {
+        throw LogicException("Temporal strings can't be created by helper threads");
+    }
     auto& _info = info[idx];
     auto id = _info.str_to_id.find(str);
     if (id != _info.str_to_id.end()) {
@@ -78,6 +82,9 @@ uint64_t TmpManager::get_str_id(const std::string& str)
 
 TmpLists& TmpManager::get_tmp_list() {
     auto idx = get_query_ctx().thread_info.worker_index;
+    if (get_query_ctx().thread_info.is_helper) {
+        throw LogicException("Temporal lists can't be used by helper threads");
+    }
     if (tmp_lists[idx] == nullptr) {
         tmp_lists[idx] = std::make_unique<TmpLists>();
     }
@@ -0,0 +1,327 @@
+/**
+ * Validate AdaptiveJoin against an IndexNestedLoopJoin of the same relations:
+ * the results must be the same and in the same order, before and after the
+ * switch to the hash table, which must happen when lhs reaches switch_rows,
+ * and must not happen if scan_rhs has more than MAX_BUILD_ROWS rows.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "query/executor/binding_iter/adaptive_join.h"
+#include "query/executor/binding_iter/index_nested_loop_join.h"
+#include "query/executor/binding_iter/index_scan.h"
+#include "query/executor/binding_iter/scan_ranges/assigned_var.h"
+#include "query/executor/binding_iter/scan_ranges/unassigned_var.h"
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+using Result = std::pair<uint64_t, uint64_t>;
+
+const std::string DB_FOLDER = "adaptive_join_db";
+
+const VarId X = VarId(0);
+const VarId Y = VarId(1);
+
+// keys of rhs, lhs also has keys without a match
+const uint64_t RHS_KEYS = 2000;
+const uint64_t LHS_KEYS = 2500;
+
+// the estimations give the minimum switch_rows
+const uint64_t SWITCH_ROWS = AdaptiveJoin::MIN_SWITCH_ROWS;
+
+std::unique_ptr<BPlusTree<2>> bpt;
+
+uint64_t rhs_records = 0;
+
+
+// (x, y) with 0 to 4 values of y for each x, in no particular order so the
+// order of the results depends on the index
+std::vector<Record<2>> get_records() {
+    std::vector<Record<2>> records;
+    for (uint64_t key = 0; key < RHS_KEYS; key++) {
+        for (uint64_t i = 0; i < key % 5; i++) {
+            records.push_back({ key, (key * 7919 + i * 104729) % 100'000 });
+        }
+    }
+    rhs_records = records.size();
+    return records;
+}
+
+
+std::vector<uint64_t> get_lhs_keys(uint64_t rows) {
+    std::vector<uint64_t> keys;
+    for (uint64_t i = 0; i < rows; i++) {
+        keys.push_back((i * 7919) % LHS_KEYS);
+    }
+    return keys;
+}
+
+
+// Returns the values of X in order
+class OuterIter : public BindingIter {
+public:
+    OuterIter(const std::vector<uint64_t>& keys) :
+        keys (keys) { }
+
+    void _begin(Binding& _parent_binding) override
+    {
+        parent_binding = &_parent_binding;
+        pos = 0;
+    }
+
+    void _reset() override
+    {
+        pos = 0;
+    }
+
+    bool _next() override
+    {
+        if (pos == keys.size()) {
+            return false;
+        }
+        parent_binding->add(X, ObjectId(keys[pos++]));
+        return true;
+    }
+
+    void assign_nulls() override
+    {
+        parent_binding->add(X, ObjectId::get_null());
+    }
+
+    void print(std::ostream& os, int indent, bool) const override
+    {
+        os << std::string(indent, ' ') << "OuterIter()\n";
+    }
+
+private:
+    const std::vector<uint64_t>& keys;
+    Binding* parent_binding;
+    std::size_t pos;
+};
+
+
+// scan_rhs with more than MAX_BUILD_ROWS rows, of a key that lhs doesn't have
+class BigScanIter : public BindingIter {
+public:
+    void _begin(Binding& _parent_binding) override
+    {
+        parent_binding = &_parent_binding;
+        row = 0;
+    }
+
+    void _reset() override
+    {
+        row = 0;
+    }
+
+    bool _next() override
+    {
+        if (row > AdaptiveJoin::MAX_BUILD_ROWS) {
+            return false;
+        }
+        parent_binding->add(X, ObjectId(LHS_KEYS));
+        parent_binding->add(Y, ObjectId(row++));
+        return true;
+    }
+
+    void assign_nulls() override
+    {
+        parent_binding->add(X, ObjectId::get_null());
+        parent_binding->add(Y, ObjectId::get_null());
+    }
+
+    void print(std::ostream& os, int indent, bool) const override
+    {
+        os << std::string(indent, ' ') << "BigScanIter()\n";
+    }
+
+private:
+    Binding* parent_binding;
+    uint64_t row;
+};
+
+
+// rhs with x as input
+std::unique_ptr<IndexScan<2>> make_rhs() {
+    std::array<std::unique_ptr<ScanRange>, 2> ranges;
+    ranges[0] = std::make_unique<AssignedVar>(X);
+    ranges[1] = std::make_unique<UnassignedVar>(Y);
+    return std::make_unique<IndexScan<2>>(*bpt, std::move(ranges));
+}
+
+
+// rhs without input vars
+std::unique_ptr<IndexScan<2>> make_scan_rhs() {
+    std::array<std::unique_ptr<ScanRange>, 2> ranges;
+    ranges[0] = std::make_unique<UnassignedVar>(X);
+    ranges[1] = std::make_unique<UnassignedVar>(Y);
+    return std::make_unique<IndexScan<2>>(*bpt, std::move(ranges));
+}
+
+
+std::vector<Result> read_results(BindingIter& join, Binding& binding) {
+    std::vector<Result> results;
+    while (join.next()) {
+        results.push_back({ binding[X].id, binding[Y].id });
+    }
+    return results;
+}
+
+
+// results of the plain index nested loop join
+std::vector<Result> expected_results(const std::vector<uint64_t>& lhs_keys) {
+    IndexNestedLoopJoin join(std::make_unique<OuterIter>(lhs_keys), make_rhs());
+    Binding binding(2);
+    join.begin(binding);
+    return read_results(join, binding);
+}
+
+
+struct Expectation {
+    std::string name;
+
+    uint64_t lhs_rows;
+
+    double estimated_lhs_rows;
+
+    // lhs rows probed in the index before the switch, all of them if it doesn't switch
+    uint64_t index_probes;
+
+    // number of times scan_rhs is read
+    uint64_t scans;
+
+    bool big_scan;
+};
+
+
+bool check_join(const Expectation& expectation) {
+    auto lhs_keys = get_lhs_keys(expectation.lhs_rows);
+    auto expected = expected_results(lhs_keys);
+
+    std::unique_ptr<BindingIter> scan_rhs;
+    if (expectation.big_scan) {
+        scan_rhs = std::make_unique<BigScanIter>();
+    } else {
+        scan_rhs = make_scan_rhs();
+    }
+    AdaptiveJoin join(
+        std::make_unique<OuterIter>(lhs_keys),
+        make_rhs(),
+        std::move(scan_rhs),
+        { X },
+        { Y },
+        expectation.estimated_lhs_rows,
+        100
+    );
+
+    auto error = false;
+
+    Binding binding(2);
+    join.begin(binding);
+    for (int execution = 0; execution < 2; execution++) {
+        auto name = expectation.name + (execution > 0 ? " after reset" : "");
+        auto rhs_starts = join.rhs->stat_begin + join.rhs->stat_reset;
+        auto scan_starts = join.scan_rhs->stat_begin + join.scan_rhs->stat_reset;
+
+        auto results = read_results(join, binding);
+        if (results != expected) {
+            error = true;
+            std::cerr << name << ": received " << results.size() << " results, expected " << expected.size() << "\n";
+            auto mismatch = std::mismatch(results.begin(), results.end(), expected.begin(), expected.end());
+            std::cerr << "  first difference at result " << (mismatch.first - results.begin()) << "\n";
+        }
+
+        auto index_probes = join.rhs->stat_begin + join.rhs->stat_reset - rhs_starts;
+        if (index_probes != expectation.index_probes) {
+            error = true;
+            std::cerr << name << ": " << index_probes << " index probes, expected " << expectation.index_probes << "\n";
+        }
+        auto scans = join.scan_rhs->stat_begin + join.scan_rhs->stat_reset - scan_starts;
+        if (scans != expectation.scans) {
+            error = true;
+            std::cerr << name << ": scan_rhs read " << scans << " times, expected " << expectation.scans << "\n";
+        }
+        if (join.lhs_rows != expectation.lhs_rows) {
+            error = true;
+            std::cerr << name << ": " << join.lhs_rows << " lhs rows, expected " << expectation.lhs_rows << "\n";
+        }
+        if (scans > 0) {
+            auto expected_build_rows = expectation.big_scan ? AdaptiveJoin::MAX_BUILD_ROWS : rhs_records;
+            if (join.build_rows != expected_build_rows) {
+                error = true;
+                std::cerr << name << ": " << join.build_rows << " build rows, expected " << expected_build_rows << "\n";
+            }
+        }
+        join.reset();
+    }
+
+    return error;
+}
+
+
+bool switch_at_switch_rows() {
+    // the row number SWITCH_ROWS is the first probed in the hash table
+    return check_join({ "Switch at switch_rows", 3 * SWITCH_ROWS, 1, SWITCH_ROWS - 1, 1, false });
+}
+
+
+bool switch_from_estimation() {
+    // lhs must exceed the estimation by ESTIMATION_ERROR_FACTOR
+    auto estimated_lhs_rows = 150.0;
+    auto switch_rows = static_cast<uint64_t>(estimated_lhs_rows * AdaptiveJoin::ESTIMATION_ERROR_FACTOR);
+    return check_join({ "Switch after the estimation", 2 * switch_rows, estimated_lhs_rows, switch_rows - 1, 1, false });
+}
+
+
+bool no_switch() {
+    auto rows = SWITCH_ROWS - 1;
+    return check_join({ "No switch", rows, 1, rows, 0, false });
+}
+
+
+bool max_build_rows() {
+    // the table is discarded and the nested loop goes on
+    auto rows = 2 * SWITCH_ROWS;
+    return check_join({ "Too many build rows", rows, 1, rows, 1, true });
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&switch_at_switch_rows);
+    tests.push_back(&switch_from_estimation);
+    tests.push_back(&no_switch);
+    tests.push_back(&max_build_rows);
+
+    auto error = false;
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        bpt = build_bpt<2>("test_bpt", get_records());
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    bpt.reset();
+    return error;
+}
@@ -0,0 +1,212 @@
+/**
+ * Validate the hash tables of the in-memory BGP hash join, RadixHashTable and
+ * PartitionedHashTable, against a std::map: every row of a key is found
+ * following the next pointers, missing keys are not found, and the distinct
+ * keys are iterated once.
+ */
+
+#include <array>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "query/executor/binding_iter/hash_join/bgp/partitioned_hash_table.h"
+#include "query/executor/binding_iter/hash_join/bgp/radix_hash_table.h"
+#include "query/executor/helper_threads.h"
+#include "query/query_context.h"
+
+using namespace HashJoin::BGP;
+
+typedef bool TestFunction();
+
+const std::size_t DATA_SIZE = 2;
+
+template<std::size_t N>
+using Rows = std::map<std::array<uint64_t, N>, std::multiset<std::array<uint64_t, DATA_SIZE>>>;
+
+// adds `count` random rows with repeated keys to the table and to `expected`
+template<std::size_t N, typename AddFunc>
+void add_rows(uint64_t count, uint64_t seed, Rows<N>& expected, AddFunc add) {
+    std::mt19937_64 rng(seed);
+    for (uint64_t i = 0; i < count; i++) {
+        std::array<uint64_t, N> key;
+        for (auto& value : key) {
+            value = rng() % (count / 3 + 1);
+        }
+        std::array<uint64_t, DATA_SIZE> data = { i, rng() };
+        add(key.data(), data.data(), i);
+        expected[key].insert(data);
+    }
+}
+
+
+// returns true if the rows returned by find() are not the expected ones
+template<std::size_t N, typename FindFunc>
+bool check_find(const Rows<N>& expected, FindFunc find) {
+    auto error = false;
+
+    for (auto& [key, expected_data] : expected) {
+        std::multiset<std::array<uint64_t, DATA_SIZE>> received;
+        auto key_copy = key;
+        for (auto data = find(key_copy.data()); data != nullptr;
+             data = reinterpret_cast<uint64_t**>(data)[DATA_SIZE])
+        {
+            received.insert({ data[0], data[1] });
+        }
+        if (received != expected_data) {
+            error = true;
+            std::cerr << "Key " << key[0] << " has " << received.size() << " rows, expected "
+                      << expected_data.size() << "\n";
+        }
+    }
+
+    // keys greater than every inserted key
+    for (uint64_t i = 0; i < 1000; i++) {
+        std::array<uint64_t, N> key;
+        key.fill(UINT64_MAX - i);
+        if (find(key.data()) != nullptr) {
+            error = true;
+            std::cerr << "Missing key " << key[0] << " found\n";
+        }
+    }
+
+    return error;
+}
+
+
+template<std::size_t N>
+bool check_keys(const Rows<N>& expected, const std::vector<std::array<uint64_t, N>>& keys, uint64_t key_count) {
+    auto error = false;
+
+    std::set<std::array<uint64_t, N>> distinct_keys(keys.begin(), keys.end());
+    if (keys.size() != expected.size() || distinct_keys.size() != expected.size() || key_count != expected.size()) {
+        error = true;
+        std::cerr << "Iterated " << keys.size() << " keys, " << distinct_keys.size() << " distinct, key_count "
+                  << key_count << ", expected " << expected.size() << "\n";
+    }
+    for (auto& key : distinct_keys) {
+        if (expected.find(key) == expected.end()) {
+            error = true;
+            std::cerr << "Iterated key " << key[0] << " was not inserted\n";
+        }
+    }
+
+    return error;
+}
+
+
+template<std::size_t N>
+bool radix_hash_table() {
+    auto error = false;
+
+    RadixHashTable<N> table(DATA_SIZE);
+
+    // the second time the table is reused after clear()
+    for (uint64_t rows : { 200000UL, 5000UL }) {
+        table.clear();
+
+        Rows<N> expected;
+        add_rows<N>(rows, rows + N, expected, [&](const uint64_t* key, const uint64_t* data, uint64_t) {
+            table.add(key, data);
+        });
+        table.build();
+
+        if (table.size() != rows) {
+            error = true;
+            std::cerr << "RadixHashTable<" << N << "> has " << table.size() << " rows, expected " << rows << "\n";
+        }
+        if (rows == 200000 && table.partition_count() < 2) {
+            error = true;
+            std::cerr << "RadixHashTable<" << N << "> with " << rows << " rows has one partition\n";
+        }
+
+        if (check_find<N>(expected, [&](const uint64_t* key) { return table.find(key); })) {
+            error = true;
+            std::cerr << "  in RadixHashTable<" << N << "> with " << rows << " rows\n";
+        }
+
+        std::vector<std::array<uint64_t, N>> keys;
+        table.for_each_key([&](const uint64_t* key) {
+            std::array<uint64_t, N> key_copy;
+            std::copy(key, key + N, key_copy.begin());
+            keys.push_back(key_copy);
+        });
+        if (check_keys<N>(expected, keys, table.key_count())) {
+            error = true;
+            std::cerr << "  in RadixHashTable<" << N << "> with " << rows << " rows\n";
+        }
+    }
+
+    return error;
+}
+
+
+template<std::size_t N>
+bool partitioned_hash_table() {
+    const uint_fast32_t writers = 3;
+
+    auto error = false;
+
+    HelperThreads helpers;
+    PartitionedHashTable<N> table(DATA_SIZE, writers);
+
+    // the second time the table is reused after clear()
+    for (uint64_t rows : { 100000UL, 5000UL }) {
+        table.clear();
+
+        Rows<N> expected;
+        add_rows<N>(rows, rows + N, expected, [&](const uint64_t* key, const uint64_t* data, uint64_t i) {
+            table.add(key, data, i % writers);
+        });
+        table.build(helpers, writers);
+
+        if (table.size() != rows) {
+            error = true;
+            std::cerr << "PartitionedHashTable<" << N << "> has " << table.size() << " rows, expected " << rows << "\n";
+        }
+
+        if (check_find<N>(expected, [&](uint64_t* key) { return table.find(Key<N>(key)); })) {
+            error = true;
+            std::cerr << "  in PartitionedHashTable<" << N << "> with " << rows << " rows\n";
+        }
+
+        std::vector<std::array<uint64_t, N>> keys;
+        table.for_each_key([&](const Key<N>& key) {
+            std::array<uint64_t, N> key_copy;
+            std::copy(key.start, key.start + N, key_copy.begin());
+            keys.push_back(key_copy);
+        });
+        if (check_keys<N>(expected, keys, table.key_count())) {
+            error = true;
+            std::cerr << "  in PartitionedHashTable<" << N << "> with " << rows << " rows\n";
+        }
+    }
+
+    return error;
+}
+
+
+int main() {
+    // HelperThreads copy the thread info of the query
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&radix_hash_table<1>);
+    tests.push_back(&radix_hash_table<2>);
+    tests.push_back(&partitioned_hash_table<1>);
+    tests.push_back(&partitioned_hash_table<3>);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    return error;
+}
@@ -0,0 +1,367 @@
+/**
+ * Validate BindingIter::next_batch against next(): IndexScan, Filter, Bind,
+ * Slice and the row adapter of the other iters must return the same rows in
+ * the same order, without exceeding the max_size of the batch, and keep
+ * returning 0 after the last row, also after a reset.
+ */
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "query/executor/binding_iter/bind.h"
+#include "query/executor/binding_iter/filter.h"
+#include "query/executor/binding_iter/index_scan.h"
+#include "query/executor/binding_iter/scan_ranges/assigned_var.h"
+#include "query/executor/binding_iter/scan_ranges/unassigned_var.h"
+#include "query/executor/binding_iter/slice.h"
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+using Row = std::tuple<uint64_t, uint64_t, uint64_t>;
+
+const std::string DB_FOLDER = "binding_batch_db";
+
+const VarId X = VarId(0);
+const VarId Y = VarId(1);
+const VarId Z = VarId(2);
+
+// several B+tree leaves and several batches
+const uint64_t TOTAL_RECORDS = 5000;
+
+std::unique_ptr<BPlusTree<2>> bpt;
+
+
+// records (i / 5, i * 3)
+std::vector<Record<2>> get_records() {
+    std::vector<Record<2>> records;
+    for (uint64_t i = 0; i < TOTAL_RECORDS; i++) {
+        records.push_back({ i / 5, i * 3 });
+    }
+    return records;
+}
+
+
+// true if `var` is a multiple of `mod`
+class MultipleExpr : public BindingExpr {
+public:
+    MultipleExpr(VarId var, uint64_t mod) :
+        var (var),
+        mod (mod) { }
+
+    void accept_visitor(BindingExprVisitor&) override { }
+
+    ObjectId eval(const Binding& binding) override {
+        return ObjectId(binding[var].id % mod == 0 ? ObjectId::BOOL_TRUE : ObjectId::BOOL_FALSE);
+    }
+
+    void print(std::ostream& os, std::vector<BindingIter*>&) const override {
+        os << var << " % " << mod << " = 0";
+    }
+
+private:
+    VarId var;
+    uint64_t mod;
+};
+
+
+// `var` + 1000
+class PlusExpr : public BindingExpr {
+public:
+    PlusExpr(VarId var) : var (var) { }
+
+    void accept_visitor(BindingExprVisitor&) override { }
+
+    ObjectId eval(const Binding& binding) override {
+        return ObjectId(binding[var].id + 1000);
+    }
+
+    void print(std::ostream& os, std::vector<BindingIter*>&) const override {
+        os << var << " + 1000";
+    }
+
+private:
+    VarId var;
+};
+
+
+ObjectId to_boolean(ObjectId oid) {
+    return oid;
+}
+
+
+// Returns (i, i * 2) with next(), so next_batch() is the row adapter
+class RowsIter : public BindingIter {
+public:
+    RowsIter(uint64_t rows) : rows (rows) { }
+
+    void _begin(Binding& _parent_binding) override {
+        parent_binding = &_parent_binding;
+        pos = 0;
+    }
+
+    void _reset() override {
+        pos = 0;
+    }
+
+    bool _next() override {
+        if (pos == rows) {
+            return false;
+        }
+        parent_binding->add(X, ObjectId(pos));
+        parent_binding->add(Y, ObjectId(pos * 2));
+        pos++;
+        return true;
+    }
+
+    void assign_nulls() override {
+        parent_binding->add(X, ObjectId::get_null());
+        parent_binding->add(Y, ObjectId::get_null());
+    }
+
+    void print(std::ostream& os, int indent, bool) const override {
+        os << std::string(indent, ' ') << "RowsIter()\n";
+    }
+
+private:
+    uint64_t rows;
+    Binding* parent_binding;
+    uint64_t pos;
+};
+
+
+std::unique_ptr<IndexScan<2>> make_scan(bool x_assigned) {
+    std::array<std::unique_ptr<ScanRange>, 2> ranges;
+    if (x_assigned) {
+        ranges[0] = std::make_unique<AssignedVar>(X);
+    } else {
+        ranges[0] = std::make_unique<UnassignedVar>(X);
+    }
+    ranges[1] = std::make_unique<UnassignedVar>(Y);
+    return std::make_unique<IndexScan<2>>(*bpt, std::move(ranges));
+}
+
+
+std::unique_ptr<BindingIter> make_filter(std::unique_ptr<BindingIter> child, VarId var, uint64_t mod) {
+    std::vector<std::unique_ptr<BindingExpr>> filters;
+    filters.push_back(std::make_unique<MultipleExpr>(var, mod));
+    return std::make_unique<Filter>(&to_boolean, std::move(child), std::move(filters));
+}
+
+
+Row read_row(const Binding& binding) {
+    return { binding[X].id, binding[Y].id, binding[Z].id };
+}
+
+
+// the parent binding has X = `x` before begin
+std::vector<Row> read_rows(BindingIter& iter, uint64_t x) {
+    Binding binding(3);
+    binding.add(X, ObjectId(x));
+    iter.begin(binding);
+
+    std::vector<Row> rows;
+    while (iter.next()) {
+        rows.push_back(read_row(binding));
+    }
+    return rows;
+}
+
+
+// reads the batches of an execution, and checks that the following calls return 0
+bool read_batches(
+    BindingIter&       iter,
+    Binding&           binding,
+    BindingBatch&      batch,
+    std::vector<Row>&  rows,
+    const std::string& name
+) {
+    auto error = false;
+    while (iter.next_batch(batch) > 0) {
+        if (batch.selected > batch.max_size || batch.size > batch.max_size) {
+            error = true;
+            std::cerr << name << ": a batch has " << batch.size << " rows and " << batch.selected
+                      << " selected, the max_size is " << batch.max_size << "\n";
+        }
+        for (uint_fast32_t i = 0; i < batch.selected; i++) {
+            batch.load_row(batch.selection[i], binding);
+            rows.push_back(read_row(binding));
+        }
+    }
+    for (int i = 0; i < 2; i++) {
+        if (iter.next_batch(batch) != 0) {
+            error = true;
+            std::cerr << name << ": next_batch returned rows after the end\n";
+        }
+    }
+    return error;
+}
+
+
+// compares next_batch() of the iter made by make_iter with next(), twice with a reset
+bool check_batches(
+    const std::string&                            name,
+    std::function<std::unique_ptr<BindingIter>()> make_iter,
+    uint64_t                                      x = 0,
+    uint_fast32_t                                 max_size = BindingBatch::DEFAULT_CAPACITY
+) {
+    auto expected_iter = make_iter();
+    auto expected = read_rows(*expected_iter, x);
+
+    auto iter = make_iter();
+    Binding binding(3);
+    binding.add(X, ObjectId(x));
+    iter->begin(binding);
+
+    BindingBatch batch(3);
+    batch.max_size = max_size;
+
+    auto error = false;
+    for (int execution = 0; execution < 2; execution++) {
+        auto execution_name = name + (execution > 0 ? " after reset" : "");
+
+        std::vector<Row> rows;
+        if (read_batches(*iter, binding, batch, rows, execution_name)) {
+            error = true;
+        }
+        if (rows != expected) {
+            error = true;
+            std::cerr << execution_name << ": next_batch returned " << rows.size()
+                      << " rows, next returned " << expected.size() << "\n";
+            for (std::size_t i = 0; i < rows.size() && i < expected.size(); i++) {
+                if (rows[i] != expected[i]) {
+                    std::cerr << "  first difference at row " << i << "\n";
+                    break;
+                }
+            }
+        }
+        iter->reset();
+    }
+
+    return error;
+}
+
+
+bool index_scan() {
+    auto error = false;
+    if (check_batches("IndexScan", []() { return make_scan(false); })) {
+        error = true;
+    }
+    // records that don't fill a batch
+    if (check_batches("IndexScan with X assigned", []() { return make_scan(true); }, 321)) {
+        error = true;
+    }
+    if (check_batches("IndexScan of a missing X", []() { return make_scan(true); }, TOTAL_RECORDS)) {
+        error = true;
+    }
+    if (check_batches("IndexScan with max_size 100", []() { return make_scan(false); }, 0, 100)) {
+        error = true;
+    }
+    return error;
+}
+
+
+bool filter_and_bind() {
+    auto error = false;
+    auto make_bind = []() {
+        return std::make_unique<Bind>(make_filter(make_scan(false), Y, 7), std::make_unique<PlusExpr>(Y), Z);
+    };
+    if (check_batches("Filter", []() { return make_filter(make_scan(false), Y, 7); })) {
+        error = true;
+    }
+    // no row passes the filter
+    if (check_batches("Filter without rows", []() { return make_filter(make_scan(false), Y, TOTAL_RECORDS * 5); })) {
+        error = true;
+    }
+    if (check_batches("Bind", make_bind)) {
+        error = true;
+    }
+    if (check_batches("Bind with max_size 100", make_bind, 0, 100)) {
+        error = true;
+    }
+    return error;
+}
+
+
+bool slice() {
+    auto error = false;
+    std::vector<std::pair<uint64_t, uint64_t>> slices = {
+        { 0, 10 },
+        { 300, 1000 },
+        { 1024, 1024 },
+        { 4990, 100 },
+        { 6000, 100 },
+    };
+    for (auto& [offset, limit] : slices) {
+        auto name = "Slice offset " + std::to_string(offset) + " limit " + std::to_string(limit);
+        auto make_slice = [offset = offset, limit = limit]() {
+            return std::make_unique<Slice>(make_scan(false), offset, limit);
+        };
+        if (check_batches(name, make_slice)) {
+            error = true;
+        }
+    }
+    // the offset skips filtered rows
+    auto make_slice = []() {
+        return std::make_unique<Slice>(make_filter(make_scan(false), Y, 2), 700, 900);
+    };
+    if (check_batches("Slice of Filter", make_slice)) {
+        error = true;
+    }
+    return error;
+}
+
+
+bool row_adapter() {
+    auto error = false;
+    if (check_batches("Row adapter", []() { return std::make_unique<RowsIter>(2500); })) {
+        error = true;
+    }
+    if (check_batches("Row adapter without rows", []() { return std::make_unique<RowsIter>(0); })) {
+        error = true;
+    }
+    if (check_batches("Filter of the row adapter", []() { return make_filter(std::make_unique<RowsIter>(2500), X, 3); })) {
+        error = true;
+    }
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&index_scan);
+    tests.push_back(&filter_and_bind);
+    tests.push_back(&slice);
+    tests.push_back(&row_adapter);
+
+    auto error = false;
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        bpt = build_bpt<2>("test_bpt", get_records());
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    bpt.reset();
+    return error;
+}
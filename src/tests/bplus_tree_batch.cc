@@ -0,0 +1,184 @@
+/**
+ * Validate BptIter::next_batch against BptIter::next: the same records in the
+ * same order for batches that cross leaves, ranges that end in the middle of a
+ * batch, empty ranges, and iterators that mix both methods.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+const std::string DB_FOLDER = "bplus_tree_batch_db";
+
+std::unique_ptr<BPlusTree<2>> bpt;
+
+// the records expected in bpt
+std::set<Record<2>> records;
+
+
+std::vector<std::pair<Record<2>, Record<2>>> get_ranges() {
+    return {
+        { { 0, 0 }, { UINT64_MAX, UINT64_MAX } },
+        { { 7, 3 }, { 7, 3 } },
+        { { 7, 3 }, { 9, 2 } },
+        { { 100, 0 }, { 1500, UINT64_MAX } },
+        { { 1999, 5 }, { 2000, UINT64_MAX } },
+        // empty ranges, between records and after the last one
+        { { 5, 20 }, { 5, 30 } },
+        { { 50000, 0 }, { UINT64_MAX, UINT64_MAX } },
+    };
+}
+
+
+std::vector<Record<2>> read_next(const Record<2>& min, const Record<2>& max) {
+    bool interruption_requested = false;
+    auto it = bpt->get_range(&interruption_requested, min, max);
+
+    std::vector<Record<2>> result;
+    for (auto record = it.next(); record != nullptr; record = it.next()) {
+        result.push_back(*record);
+    }
+    return result;
+}
+
+
+// reads the range with batches of `capacity` records, if `mix_next` is true
+// reads a record with next() between the batches
+bool read_batches(
+    const Record<2>& min,
+    const Record<2>& max,
+    uint_fast32_t capacity,
+    bool mix_next,
+    std::vector<Record<2>>& result
+) {
+    auto error = false;
+    bool interruption_requested = false;
+    auto it = bpt->get_range(&interruption_requested, min, max);
+
+    BptBatch<2> batch(capacity);
+    while (true) {
+        auto size = it.next_batch(batch);
+        if (size != batch.size || size > capacity) {
+            error = true;
+            std::cerr << "Batch of capacity " << capacity << " returned " << size
+                      << " with size " << batch.size << "\n";
+        }
+        if (size == 0) {
+            break;
+        }
+        for (uint_fast32_t i = 0; i < size; i++) {
+            result.push_back({ batch.column(0)[i], batch.column(1)[i] });
+        }
+        if (mix_next) {
+            auto record = it.next();
+            if (record == nullptr) {
+                break;
+            }
+            result.push_back(*record);
+        }
+    }
+
+    // an exhausted iterator keeps returning nothing
+    if (it.next_batch(batch) != 0 || it.next() != nullptr) {
+        error = true;
+        std::cerr << "Exhausted iterator returned more records\n";
+    }
+    return error;
+}
+
+
+bool batches_match_next() {
+    auto error = false;
+
+    for (auto& [min, max] : get_ranges()) {
+        auto expected = read_next(min, max);
+
+        std::vector<Record<2>> in_range;
+        for (auto it = records.lower_bound(min); it != records.end() && *it <= max; ++it) {
+            in_range.push_back(*it);
+        }
+        if (expected != in_range) {
+            error = true;
+            std::cerr << "next() from " << min << " to " << max << " returned " << expected.size()
+                      << " records, expected " << in_range.size() << "\n";
+        }
+
+        // 1 and 7 end batches in the middle of the leaves, 1000 spans several leaves
+        for (uint_fast32_t capacity : { 1, 7, 256, 1000 }) {
+            for (bool mix_next : { false, true }) {
+                std::vector<Record<2>> received;
+                if (read_batches(min, max, capacity, mix_next, received)) {
+                    error = true;
+                }
+                if (received != expected) {
+                    error = true;
+                    std::cerr << "next_batch(" << capacity << ")" << (mix_next ? " with next()" : "")
+                              << " from " << min << " to " << max << " returned " << received.size()
+                              << " records, expected " << expected.size() << "\n";
+                }
+            }
+        }
+    }
+
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    for (uint64_t i = 0; i < 20000; i++) {
+        records.insert({ i / 10, i % 10 });
+    }
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&batches_match_next);
+
+    auto error = false;
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        bpt = build_bpt<2>("test_bpt", records);
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    {
+        auto version_scope = buffer_manager.init_version_editable();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        // the split leaves are half full
+        for (uint64_t i = 0; i < 20000; i++) {
+            Record<2> record = { (i * 7) % 2000, 10 + i % 3 };
+            bpt->insert(record);
+            records.insert(record);
+        }
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    bpt.reset();
+    return error;
+}
@@ -0,0 +1,227 @@
+/**
+ * Validate the Bloom filters of the B+tree leaves: the filters never reject a
+ * record that was added, not even after they are folded to a smaller size,
+ * and B+tree lookups of missing records are mostly answered by the filters.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/bplus_tree/bplus_tree_bloom.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+using Bloom = BPlusTreeBloom<2>;
+
+const std::string DB_FOLDER = "bplus_tree_bloom_db";
+
+std::unique_ptr<BPlusTree<2>> bpt;
+
+// the records expected in bpt
+std::set<Record<2>> records;
+
+bool filter_sizes() {
+    std::vector<std::pair<uint64_t, uint64_t>> tests = {
+        { 0, 64 },
+        { 51, 64 },
+        { 52, 128 },
+        { 102, 128 },
+        { 103, 256 },
+        { 254, 512 },
+        { 10000, 1024 },
+    };
+
+    auto error = false;
+
+    for (auto& [records_per_leaf, expected] : tests) {
+        auto received = Bloom::filter_bytes_for(records_per_leaf);
+        if (received != expected) {
+            error = true;
+            std::cerr << "Filter bytes for " << records_per_leaf << " records, received " << received
+                      << ", expected " << expected << "\n";
+        }
+        if (!Bloom::valid_filter_bytes(received)) {
+            error = true;
+            std::cerr << "Filter bytes " << received << " are not valid\n";
+        }
+    }
+
+    for (uint64_t filter_bytes : { 0UL, 32UL, 96UL, 2048UL }) {
+        if (Bloom::valid_filter_bytes(filter_bytes)) {
+            error = true;
+            std::cerr << "Filter bytes " << filter_bytes << " should not be valid\n";
+        }
+    }
+
+    return error;
+}
+
+
+bool add_and_fold() {
+    auto error = false;
+
+    std::vector<char> filter(Bloom::MAX_FILTER_BYTES, 0);
+    for (uint64_t i = 0; i < 200; i++) {
+        Bloom::add(filter.data(), Bloom::MAX_FILTER_BYTES, { i, i * 31 });
+    }
+
+    for (uint64_t filter_bytes = Bloom::MAX_FILTER_BYTES; filter_bytes >= Bloom::MIN_FILTER_BYTES; filter_bytes /= 2) {
+        auto folded = filter;
+        Bloom::fold(folded.data(), Bloom::MAX_FILTER_BYTES, filter_bytes);
+
+        for (uint64_t i = 0; i < 200; i++) {
+            if (!Bloom::may_contain(folded.data(), filter_bytes, { i, i * 31 })) {
+                error = true;
+                std::cerr << "Filter of " << filter_bytes << " bytes rejects the added record ("
+                          << i << ", " << i * 31 << ")\n";
+            }
+        }
+    }
+
+    // 200 records in 256 bytes have about 10 bits per record
+    auto folded = filter;
+    Bloom::fold(folded.data(), Bloom::MAX_FILTER_BYTES, 256);
+    uint64_t false_positives = 0;
+    for (uint64_t i = 0; i < 10000; i++) {
+        if (Bloom::may_contain(folded.data(), 256, { i, i * 31 + 1 })) {
+            false_positives++;
+        }
+    }
+    if (false_positives > 500) {
+        error = true;
+        std::cerr << "Filter of 256 bytes accepts " << false_positives << " of 10000 missing records\n";
+    }
+
+    return error;
+}
+
+
+// values that differ in every byte, so the leaves are not compressed to more
+// records than their filters were sized for
+uint64_t spread(uint64_t value) {
+    return value * 0x9E37'79B9'7F4A'7C15;
+}
+
+
+// returns true if get_record() finds the record in bpt
+bool lookup(const Record<2>& record, bool& rejected_by_filter) {
+    bool interruption_requested = false;
+    BptIter<2> it;
+    rejected_by_filter = !bpt->get_record(&interruption_requested, record, it);
+    if (rejected_by_filter) {
+        return false;
+    }
+    auto found = it.next();
+    return found != nullptr && *found == record;
+}
+
+
+bool no_false_negatives() {
+    auto error = false;
+
+    for (auto& record : records) {
+        bool rejected_by_filter;
+        if (!lookup(record, rejected_by_filter)) {
+            error = true;
+            std::cerr << "Record " << record << " not found"
+                      << (rejected_by_filter ? " (rejected by the filter)" : "") << "\n";
+        }
+    }
+
+    return error;
+}
+
+
+bool missing_records() {
+    auto error = false;
+
+    uint64_t rejected = 0;
+    uint64_t missing = 0;
+    for (uint64_t i = 0; i < 20000; i++) {
+        Record<2> record = { i / 10, spread(100 + i % 10) };
+        if (records.find(record) != records.end()) {
+            continue;
+        }
+        missing++;
+
+        bool rejected_by_filter;
+        if (lookup(record, rejected_by_filter)) {
+            error = true;
+            std::cerr << "Missing record " << record << " found\n";
+        }
+        if (rejected_by_filter) {
+            rejected++;
+        }
+    }
+
+    if (rejected * 10 < missing * 9) {
+        error = true;
+        std::cerr << "Only " << rejected << " of " << missing << " missing records rejected by the filters\n";
+    }
+
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    for (uint64_t i = 0; i < 20000; i++) {
+        records.insert({ i / 10, spread(i % 10) });
+    }
+
+    auto error = false;
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&filter_sizes);
+    tests.push_back(&add_and_fold);
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        bpt = build_bpt<2>("test_bpt", records);
+
+        if (no_false_negatives()) {
+            error = true;
+        }
+        if (missing_records()) {
+            error = true;
+        }
+    }
+
+    {
+        auto version_scope = buffer_manager.init_version_editable();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        // the inserted records are added to the filters, also when the leaves split
+        for (uint64_t i = 0; i < 20000; i++) {
+            Record<2> record = { (i * 7) % 2000, spread(10 + i % 5) };
+            bpt->insert(record);
+            records.insert(record);
+        }
+
+        if (no_false_negatives()) {
+            error = true;
+        }
+    }
+
+    bpt.reset();
+    return error;
+}
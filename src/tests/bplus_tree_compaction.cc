@@ -0,0 +1,193 @@
+/**
+ * Validate BPlusTree::compact: a B+tree fragmented by deletes is rewritten with
+ * fewer leaves and the same records, and a B+tree that is already dense is
+ * left as it is.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+const std::string DB_FOLDER = "bplus_tree_compaction_db";
+
+std::unique_ptr<BPlusTree<2>> bpt;
+
+// the records expected in bpt
+std::set<Record<2>> records;
+
+// buffer for the decompressed records of a leaf
+std::vector<char> scratch(VPage::SIZE * 4);
+
+
+std::ostream& operator<<(std::ostream& os, const BPlusTreeCompaction& compaction) {
+    return os << compaction.records << " records, leaf pages " << compaction.leaf_pages_before
+              << " -> " << compaction.leaf_pages_after << ", dir pages " << compaction.dir_pages_before
+              << " -> " << compaction.dir_pages_after << ", " << compaction.pages_appended << " pages appended";
+}
+
+
+// checks the structure, the counts and a full scan of bpt
+bool check_records() {
+    auto error = false;
+
+    if (!bpt->check(std::cerr)) {
+        error = true;
+        std::cerr << "Check of the B+tree failed\n";
+    }
+
+    if (bpt->get_total_count() != records.size()) {
+        error = true;
+        std::cerr << "Total count " << bpt->get_total_count() << ", expected " << records.size() << "\n";
+    }
+
+    std::vector<std::pair<Record<2>, Record<2>>> ranges = {
+        { { 0, 0 }, { UINT64_MAX, UINT64_MAX } },
+        { { 7, 0 }, { 7, UINT64_MAX } },
+        { { 100, 3 }, { 1500, 7 } },
+        { { 1999, 0 }, { UINT64_MAX, UINT64_MAX } },
+    };
+    for (auto& [min, max] : ranges) {
+        uint64_t expected = 0;
+        for (auto it = records.lower_bound(min); it != records.end() && *it <= max; ++it) {
+            expected++;
+        }
+        auto received = bpt->count_records(min, max);
+        if (received != expected) {
+            error = true;
+            std::cerr << "Count " << min << " to " << max << ", received " << received
+                      << ", expected " << expected << "\n";
+        }
+    }
+
+    bool interruption_requested = false;
+    auto it = bpt->get_range(&interruption_requested, { 0, 0 }, { UINT64_MAX, UINT64_MAX });
+    std::vector<Record<2>> received;
+    for (auto record = it.next(); record != nullptr; record = it.next()) {
+        received.push_back(*record);
+    }
+    if (received != std::vector<Record<2>>(records.begin(), records.end())) {
+        error = true;
+        std::cerr << "Full scan returned " << received.size() << " records, expected " << records.size() << "\n";
+    }
+
+    return error;
+}
+
+
+bool dense_tree_not_rewritten() {
+    auto error = check_records();
+
+    auto compaction = bpt->compact(scratch.data(), scratch.size());
+    if (compaction.pages_appended != 0 || compaction.leaf_pages_after != compaction.leaf_pages_before
+        || compaction.records != records.size())
+    {
+        error = true;
+        std::cerr << "Compaction of a dense B+tree: " << compaction << "\n";
+    }
+
+    return error;
+}
+
+
+bool fragmented_tree() {
+    auto error = false;
+
+    // deleting most records leaves the leaves almost empty
+    for (auto it = records.begin(); it != records.end();) {
+        if ((*it)[1] % 5 != 0) {
+            if (!bpt->delete_record(*it)) {
+                error = true;
+                std::cerr << "Delete " << *it << " returned false\n";
+            }
+            it = records.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    error |= check_records();
+
+    auto compaction = bpt->compact(scratch.data(), scratch.size());
+    if (compaction.pages_appended == 0
+        || compaction.leaf_pages_after * 2 > compaction.leaf_pages_before
+        || compaction.records != records.size())
+    {
+        error = true;
+        std::cerr << "Compaction of a fragmented B+tree: " << compaction << "\n";
+    }
+    error |= check_records();
+
+    // the tree is dense now, a second compaction doesn't append pages
+    auto second_compaction = bpt->compact(scratch.data(), scratch.size());
+    if (second_compaction.pages_appended != 0
+        || second_compaction.leaf_pages_before != compaction.leaf_pages_after)
+    {
+        error = true;
+        std::cerr << "Second compaction: " << second_compaction << "\n";
+    }
+
+    // the compacted tree can still be updated
+    for (uint64_t i = 0; i < 5000; i++) {
+        Record<2> record = { (i * 7) % 2000, 10 + i % 3 };
+        bpt->insert(record);
+        records.insert(record);
+    }
+    error |= check_records();
+
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    for (uint64_t i = 0; i < 20000; i++) {
+        records.insert({ i / 10, i % 10 });
+    }
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        bpt = build_bpt<2>("test_bpt", records);
+    }
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&dense_tree_not_rewritten);
+    tests.push_back(&fragmented_tree);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        auto version_scope = buffer_manager.init_version_editable();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    {
+        // a new version reads the compacted tree
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        if (check_records()) {
+            error = true;
+        }
+    }
+
+    bpt.reset();
+    return error;
+}
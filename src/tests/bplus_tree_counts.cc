@@ -0,0 +1,182 @@
+/**
+ * Validate the record counts of the B+tree directory pages: exact range counts
+ * and ranges that start at an offset, after the bulk import and after inserts
+ * and deletes that split the leaves and the directory.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+const std::string DB_FOLDER = "bplus_tree_counts_db";
+
+std::unique_ptr<BPlusTree<2>> bpt;
+
+// the records expected in bpt
+std::set<Record<2>> records;
+
+std::vector<std::pair<Record<2>, Record<2>>> get_ranges() {
+    return {
+        { { 0, 0 }, { UINT64_MAX, UINT64_MAX } },
+        { { 0, 0 }, { 0, UINT64_MAX } },
+        { { 7, 0 }, { 7, UINT64_MAX } },
+        { { 7, 3 }, { 7, 3 } },
+        { { 7, 3 }, { 9, 2 } },
+        { { 100, 0 }, { 1500, UINT64_MAX } },
+        { { 1999, 5 }, { 2000, UINT64_MAX } },
+        { { 5000, 0 }, { 6000, 0 } },
+        { { 9000, 0 }, { UINT64_MAX, UINT64_MAX } },
+    };
+}
+
+
+std::vector<Record<2>> get_expected(const Record<2>& min, const Record<2>& max) {
+    std::vector<Record<2>> expected;
+    for (auto it = records.lower_bound(min); it != records.end() && *it <= max; ++it) {
+        expected.push_back(*it);
+    }
+    return expected;
+}
+
+
+bool exact_counts() {
+    auto error = false;
+
+    if (bpt->get_total_count() != records.size()) {
+        error = true;
+        std::cerr << "Total count " << bpt->get_total_count() << ", expected " << records.size() << "\n";
+    }
+
+    for (auto& [min, max] : get_ranges()) {
+        auto expected = get_expected(min, max).size();
+
+        auto received = bpt->count_records(min, max);
+        if (received != expected) {
+            error = true;
+            std::cerr << "Count " << min << " to " << max << ", received " << received
+                      << ", expected " << expected << "\n";
+        }
+
+        auto estimated = bpt->estimate_records(min, max);
+        if (estimated != static_cast<double>(expected)) {
+            error = true;
+            std::cerr << "Estimate " << min << " to " << max << ", received " << estimated
+                      << ", expected " << expected << "\n";
+        }
+    }
+
+    return error;
+}
+
+
+bool range_offsets() {
+    auto error = false;
+    bool interruption_requested = false;
+
+    for (auto& [min, max] : get_ranges()) {
+        auto expected = get_expected(min, max);
+
+        for (uint64_t offset : { 0UL, 1UL, 254UL, 255UL, 256UL, 1000UL, 12345UL }) {
+            auto it = bpt->get_range(&interruption_requested, min, max, offset);
+
+            std::vector<Record<2>> received;
+            for (auto record = it.next(); record != nullptr; record = it.next()) {
+                received.push_back(*record);
+            }
+
+            std::vector<Record<2>> expected_from_offset;
+            if (offset < expected.size()) {
+                expected_from_offset.assign(expected.begin() + offset, expected.end());
+            }
+
+            if (received != expected_from_offset) {
+                error = true;
+                std::cerr << "Range " << min << " to " << max << " with offset " << offset
+                          << ", received " << received.size() << " records, expected "
+                          << expected_from_offset.size() << "\n";
+            }
+        }
+    }
+
+    return error;
+}
+
+
+bool check_structure() {
+    if (!bpt->check(std::cerr)) {
+        std::cerr << "Check of the B+tree failed\n";
+        return true;
+    }
+    return false;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    for (uint64_t i = 0; i < 20000; i++) {
+        records.insert({ i / 10, i % 10 });
+    }
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&exact_counts);
+    tests.push_back(&range_offsets);
+    tests.push_back(&check_structure);
+
+    auto error = false;
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        bpt = build_bpt<2>("test_bpt", records);
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    {
+        auto version_scope = buffer_manager.init_version_editable();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        // interleaved keys split most leaves, and the new leaves split the root
+        for (uint64_t i = 0; i < 40000; i++) {
+            Record<2> record = { (i * 7) % 10000, 10 + i % 3 };
+            if (bpt->insert(record) != records.insert(record).second) {
+                error = true;
+                std::cerr << "Insert " << record << " returned a wrong value\n";
+            }
+        }
+        for (uint64_t i = 0; i < 3000; i++) {
+            Record<2> record = { i * 3, i % 11 };
+            if (bpt->delete_record(record) != (records.erase(record) == 1)) {
+                error = true;
+                std::cerr << "Delete " << record << " returned a wrong value\n";
+            }
+        }
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    bpt.reset();
+    return error;
+}
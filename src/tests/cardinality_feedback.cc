@@ -0,0 +1,167 @@
+/**
+ * Validate the store of CardinalityFeedback: the average of the observed rows
+ * of a fragment, the eviction of the least recently observed fragments, and
+ * saving and loading the file.
+ */
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "query/cardinality_feedback.h"
+#include "system/file_manager.h"
+
+typedef bool TestFunction();
+
+const std::string DB_FOLDER = "cardinality_feedback_db";
+
+const std::string FEEDBACK_FILE = "cardinality_feedback.dat";
+
+bool check_rows(const CardinalityFeedback& feedback, const CardinalityFeedback::Signature& signature, double expected) {
+    auto received = feedback.get_actual_rows(signature);
+    if (!received) {
+        std::cerr << "Signature of size " << signature.size() << " was not observed, expected "
+                  << expected << " rows\n";
+        return true;
+    }
+    if (std::abs(*received - expected) > 1e-9) {
+        std::cerr << "Signature of size " << signature.size() << " has " << *received
+                  << " rows, expected " << expected << "\n";
+        return true;
+    }
+    return false;
+}
+
+
+bool average_rows() {
+    auto error = false;
+    CardinalityFeedback feedback("average_rows.dat");
+
+    CardinalityFeedback::Signature a = { 1, 2, 3 };
+    CardinalityFeedback::Signature b = { 1, 2 };
+
+    if (feedback.get_actual_rows(a)) {
+        error = true;
+        std::cerr << "Signature was observed before recording it\n";
+    }
+
+    feedback.record(a, 10, 100);
+    error |= check_rows(feedback, a, 100);
+
+    // the new observations have weight NEW_OBSERVATION_WEIGHT
+    feedback.record(a, 10, 200);
+    error |= check_rows(feedback, a, 100 + CardinalityFeedback::NEW_OBSERVATION_WEIGHT * 100);
+
+    // a prefix is another signature
+    if (feedback.get_actual_rows(b)) {
+        error = true;
+        std::cerr << "Prefix of an observed signature was observed\n";
+    }
+
+    // fragments record the rows of a single execution
+    CardinalityFeedback::Fragment fragment { &feedback, b, 5 };
+    fragment.record(0, 1000);
+    if (feedback.get_actual_rows(b)) {
+        error = true;
+        std::cerr << "Fragment without executions was recorded\n";
+    }
+    fragment.record(4, 1000);
+    error |= check_rows(feedback, b, 250);
+
+    return error;
+}
+
+
+bool evict_least_recent() {
+    auto error = false;
+    CardinalityFeedback feedback("evict_least_recent.dat");
+
+    for (uint64_t i = 0; i < CardinalityFeedback::MAX_ENTRIES; i++) {
+        feedback.record({ i }, 1, i);
+    }
+    // observing the first one again makes the second the least recent
+    feedback.record({ 0 }, 1, 0);
+    feedback.record({ CardinalityFeedback::MAX_ENTRIES }, 1, 1);
+
+    error |= check_rows(feedback, { 0 }, 0);
+    error |= check_rows(feedback, { 2 }, 2);
+    error |= check_rows(feedback, { CardinalityFeedback::MAX_ENTRIES }, 1);
+    if (feedback.get_actual_rows({ 1 })) {
+        error = true;
+        std::cerr << "Least recently observed signature was not evicted\n";
+    }
+
+    return error;
+}
+
+
+bool save_and_load() {
+    auto error = false;
+
+    {
+        CardinalityFeedback feedback(FEEDBACK_FILE);
+        for (uint64_t i = 0; i < 1000; i++) {
+            feedback.record({ i, i * 7, 42 }, 1, i * 0.5);
+        }
+        // saved by the destructor
+    }
+
+    auto feedback = std::make_unique<CardinalityFeedback>(FEEDBACK_FILE);
+    for (uint64_t i = 0; i < 1000; i++) {
+        error |= check_rows(*feedback, { i, i * 7, 42 }, i * 0.5);
+    }
+
+    // the order of the entries is kept, so the oldest one is evicted first
+    for (uint64_t i = 0; i < CardinalityFeedback::MAX_ENTRIES - 1000; i++) {
+        feedback->record({ i, 1 }, 1, 1);
+    }
+    feedback->record({ 999, 999 * 7, 42 }, 1, 999 * 0.5);
+    feedback->record({ 0, 0, 0, 0 }, 1, 1);
+    if (feedback->get_actual_rows({ 0, 0, 42 })) {
+        error = true;
+        std::cerr << "Oldest loaded signature was not evicted\n";
+    }
+    error |= check_rows(*feedback, { 1, 7, 42 }, 0.5);
+    feedback.reset();
+
+    // a corrupt file is discarded
+    {
+        std::ofstream ofs(file_manager.get_file_path(FEEDBACK_FILE), std::ios::trunc | std::ios::binary);
+        uint64_t entries = 1;
+        uint64_t signature_size = CardinalityFeedback::MAX_SIGNATURE_SIZE + 1;
+        ofs.write(reinterpret_cast<const char*>(&entries), sizeof(entries));
+        ofs.write(reinterpret_cast<const char*>(&signature_size), sizeof(signature_size));
+    }
+    CardinalityFeedback corrupt(FEEDBACK_FILE);
+    if (corrupt.get_actual_rows({ 1, 7, 42 })) {
+        error = true;
+        std::cerr << "Corrupt file was loaded\n";
+    }
+
+    return error;
+}
+
+
+int main() {
+    std::filesystem::remove_all(DB_FOLDER);
+    FileManager::init(DB_FOLDER);
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&average_rows);
+    tests.push_back(&evict_least_recent);
+    tests.push_back(&save_and_load);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    return error;
+}
@@ -0,0 +1,265 @@
+/**
+ * Validate the characteristic sets of RdfCatalog: the sets grouped by
+ * CharacteristicSetStat must give the exact size of the star joins when the
+ * subjects of a set have the same triples per predicate, only the sets with
+ * more subjects must be kept, the sets must be the same after the catalog is
+ * saved and read, and moving subjects between sets must give the estimations
+ * of the sets of the updated triples.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "graph_models/rdf_model/rdf_catalog.h"
+#include "import/stats_processor.h"
+#include "query/query_context.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+// predicates of each subject and its number of triples with each one
+using Subjects = std::map<uint64_t, std::map<uint64_t, uint64_t>>;
+
+const std::string DB_FOLDER = "characteristic_sets_db";
+
+const uint64_t SUBJECTS = 2000;
+const uint64_t PREDICATES = 5;
+
+// the subject s has the predicates of the bits of s % SETS + 1
+const uint64_t SETS = 23;
+
+
+// the triples of a subject with a predicate only depend on the predicate,
+// so the averages of the sets are exact
+Subjects get_subjects() {
+    Subjects subjects;
+    for (uint64_t s = 0; s < SUBJECTS; s++) {
+        auto mask = s % SETS + 1;
+        for (uint64_t p = 0; p < PREDICATES; p++) {
+            if ((mask >> p) & 1) {
+                subjects[s][p] = 1 + p % 3;
+            }
+        }
+    }
+    return subjects;
+}
+
+
+// the triples in SPO order
+std::vector<std::array<uint64_t, 3>> get_triples(const Subjects& subjects) {
+    std::vector<std::array<uint64_t, 3>> triples;
+    for (auto& [s, predicates] : subjects) {
+        for (auto& [p, count] : predicates) {
+            for (uint64_t o = 0; o < count; o++) {
+                triples.push_back({ s, p, o });
+            }
+        }
+    }
+    return triples;
+}
+
+
+std::vector<CharacteristicSet> get_sets(const Subjects& subjects, size_t max_sets = RdfCatalog::MAX_CHARACTERISTIC_SETS) {
+    Import::CharacteristicSetStat stat;
+    for (auto& triple : get_triples(subjects)) {
+        stat.process_tuple(triple);
+    }
+    stat.end(max_sets);
+    return std::move(stat.characteristic_sets);
+}
+
+
+// results of the star join of `predicates` over the subjects
+double get_star_size(const Subjects& subjects, const std::vector<uint64_t>& predicates) {
+    double res = 0;
+    for (auto& [s, subject_predicates] : subjects) {
+        double subject_results = 1;
+        for (auto p : predicates) {
+            auto it = subject_predicates.find(p);
+            subject_results *= it == subject_predicates.end() ? 0 : it->second;
+        }
+        res += subject_results;
+    }
+    return res;
+}
+
+
+// every non empty sorted list of predicates, and one with a missing predicate
+std::vector<std::vector<uint64_t>> get_stars() {
+    std::vector<std::vector<uint64_t>> stars;
+    for (uint64_t mask = 1; mask < (1 << PREDICATES); mask++) {
+        std::vector<uint64_t> star;
+        for (uint64_t p = 0; p < PREDICATES; p++) {
+            if ((mask >> p) & 1) {
+                star.push_back(p);
+            }
+        }
+        stars.push_back(star);
+    }
+    stars.push_back({ 0, PREDICATES });
+    return stars;
+}
+
+
+bool check_estimations(const RdfCatalog& catalog, const Subjects& subjects, const std::string& name) {
+    for (auto& star : get_stars()) {
+        auto expected = get_star_size(subjects, star);
+        auto estimation = catalog.estimate_star(star);
+        if (std::abs(estimation - expected) > 1e-9 * std::max(1.0, expected)) {
+            std::cerr << name << ": the star of " << star.size() << " predicates starting with " << star[0]
+                      << " is estimated in " << estimation << ", it has " << expected << " results\n";
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool star_estimations() {
+    auto subjects = get_subjects();
+    auto sets = get_sets(subjects);
+
+    auto error = false;
+    if (sets.size() != SETS) {
+        error = true;
+        std::cerr << "The stat found " << sets.size() << " sets, expected " << SETS << "\n";
+    }
+
+    RdfCatalog catalog("estimations_catalog.dat", 3);
+    catalog.set_characteristic_sets(std::move(sets));
+    if (check_estimations(catalog, subjects, "Imported sets")) {
+        error = true;
+    }
+    return error;
+}
+
+
+bool max_sets() {
+    auto sets = get_sets(get_subjects(), 10);
+    if (sets.size() != 10) {
+        std::cerr << "The stat kept " << sets.size() << " sets, expected 10\n";
+        return true;
+    }
+    auto min_kept = UINT64_MAX;
+    for (auto& set : sets) {
+        min_kept = std::min(min_kept, set.subjects);
+    }
+    // the sets of the first SUBJECTS % SETS masks have one more subject
+    auto expected_min = SUBJECTS / SETS + (SUBJECTS % SETS >= 10 ? 1 : 0);
+    if (min_kept != expected_min) {
+        std::cerr << "The stat kept a set of " << min_kept << " subjects, expected at least " << expected_min << "\n";
+        return true;
+    }
+    return false;
+}
+
+
+bool save_and_read() {
+    auto subjects = get_subjects();
+    {
+        // saved by the destructor
+        RdfCatalog catalog("saved_catalog.dat", 3);
+        catalog.set_characteristic_sets(get_sets(subjects));
+    }
+    RdfCatalog catalog("saved_catalog.dat");
+    return check_estimations(catalog, subjects, "Read sets");
+}
+
+
+// moves the subject `s` of `subjects` to `new_predicates` in `catalog`
+void update_subject(
+    RdfCatalog&                           catalog,
+    Subjects&                             subjects,
+    uint64_t                              s,
+    const std::map<uint64_t, uint64_t>&   new_predicates
+) {
+    std::vector<std::pair<uint64_t, uint64_t>> old_list(subjects[s].begin(), subjects[s].end());
+    std::vector<std::pair<uint64_t, uint64_t>> new_list(new_predicates.begin(), new_predicates.end());
+    catalog.update_characteristic_set(old_list, new_list);
+    if (new_predicates.empty()) {
+        subjects.erase(s);
+    } else {
+        subjects[s] = new_predicates;
+    }
+}
+
+
+bool updates() {
+    auto subjects = get_subjects();
+
+    RdfCatalog catalog("updated_catalog.dat", 3);
+    catalog.set_characteristic_sets(get_sets(subjects));
+
+    auto error = false;
+
+    // to an existing set, with the triples per predicate of the set
+    for (uint64_t s = 0; s < 100; s++) {
+        update_subject(catalog, subjects, s, subjects[s + 1]);
+    }
+    if (check_estimations(catalog, subjects, "Subjects moved to other sets")) {
+        error = true;
+    }
+
+    // deleted subjects
+    for (uint64_t s = 100; s < 200; s++) {
+        update_subject(catalog, subjects, s, {});
+    }
+    if (check_estimations(catalog, subjects, "Deleted subjects")) {
+        error = true;
+    }
+
+    // new subjects in a new set, with a new predicate
+    std::map<uint64_t, uint64_t> new_set = { { 0, 1 }, { PREDICATES, 2 } };
+    for (uint64_t s = SUBJECTS; s < SUBJECTS + 50; s++) {
+        update_subject(catalog, subjects, s, new_set);
+    }
+    if (check_estimations(catalog, subjects, "New set")) {
+        error = true;
+    }
+    if (std::abs(catalog.estimate_star({ 0, PREDICATES }) - 100) > 1e-9) {
+        error = true;
+        std::cerr << "The star of the new set is estimated in " << catalog.estimate_star({ 0, PREDICATES }) << "\n";
+    }
+
+    // the sets are the ones the stat gives for the updated subjects
+    RdfCatalog imported_catalog("imported_catalog.dat", 3);
+    imported_catalog.set_characteristic_sets(get_sets(subjects));
+    for (auto& star : get_stars()) {
+        if (std::abs(catalog.estimate_star(star) - imported_catalog.estimate_star(star)) > 1e-9 * imported_catalog.estimate_star(star)) {
+            error = true;
+            std::cerr << "The updated sets estimate a star of " << star.size() << " predicates in "
+                      << catalog.estimate_star(star) << ", the imported ones in " << imported_catalog.estimate_star(star) << "\n";
+            break;
+        }
+    }
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&star_estimations);
+    tests.push_back(&max_sets);
+    tests.push_back(&save_and_read);
+    tests.push_back(&updates);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    return error;
+}
@@ -0,0 +1,232 @@
+/**
+ * Validate RdfModel::create_permutation: the pso, sop and ops B+trees built
+ * from spo have every triple in the order of their columns, and a build that
+ * fails removes its temporary file and the files of the B+trees it wrote.
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "graph_models/rdf_model/rdf_model.h"
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+const std::string DB_FOLDER = "create_permutation_db";
+
+// (subject, predicate, object)
+std::set<Record<3>> triples;
+
+
+// writes the B+trees and the catalog of a database with 3 permutations, like the import
+void create_database() {
+    std::vector<Record<3>> pos, osp;
+    for (auto& [s, p, o] : triples) {
+        pos.push_back({ p, o, s });
+        osp.push_back({ o, s, p });
+    }
+    build_bpt<3>("spo", triples);
+    build_bpt<3>("pos", pos);
+    build_bpt<3>("osp", osp);
+
+    build_bpt<1>("equal_spo", std::vector<Record<1>>());
+    for (auto name : { "equal_sp", "equal_so", "equal_po", "equal_sp_inverted", "equal_so_inverted", "equal_po_inverted" }) {
+        build_bpt<2>(name, std::vector<Record<2>>());
+    }
+
+    // saved by the destructor
+    RdfCatalog catalog("catalog.dat", 3);
+    catalog.set_triples_count(triples.size());
+}
+
+
+// the files of the permutation that are removed if the build fails
+std::vector<std::string> get_files(const std::string& permutation) {
+    return {
+        file_manager.get_file_path(permutation + ".dir"),
+        file_manager.get_file_path(permutation + ".leaf"),
+        file_manager.get_file_path(permutation + ".bloom"),
+    };
+}
+
+
+// checks that bpt has every triple, with its columns in the order of `columns`
+bool check_permutation(const std::string& name, BPlusTree<3>* bpt, std::array<uint64_t, 3> columns) {
+    if (bpt == nullptr) {
+        std::cerr << "Permutation " << name << " is not available\n";
+        return true;
+    }
+    auto error = false;
+
+    std::set<Record<3>> expected;
+    for (auto& triple : triples) {
+        expected.insert({ triple[columns[0]], triple[columns[1]], triple[columns[2]] });
+    }
+
+    bool interruption_requested = false;
+    auto it = bpt->get_range(&interruption_requested, { 0, 0, 0 }, { UINT64_MAX, UINT64_MAX, UINT64_MAX });
+    std::vector<Record<3>> received;
+    for (auto record = it.next(); record != nullptr; record = it.next()) {
+        received.push_back(*record);
+    }
+
+    if (received != std::vector<Record<3>>(expected.begin(), expected.end())) {
+        error = true;
+        std::cerr << "Permutation " << name << " has " << received.size() << " records, expected "
+                  << expected.size() << " in order\n";
+    }
+    if (bpt->get_total_count() != expected.size()) {
+        error = true;
+        std::cerr << "Permutation " << name << " counts " << bpt->get_total_count() << " records\n";
+    }
+    if (!bpt->check(std::cerr)) {
+        error = true;
+        std::cerr << "Check of permutation " << name << " failed\n";
+    }
+    return error;
+}
+
+
+// the build of ops fails after pso and sop were written
+bool failed_build() {
+    auto error = false;
+
+    // a directory can't be opened as the leaf file
+    std::filesystem::create_directory(file_manager.get_file_path("ops.leaf"));
+
+    try {
+        rdf_model.create_permutation("ops");
+        error = true;
+        std::cerr << "Build of ops didn't fail\n";
+    } catch (const std::exception&) {
+    }
+
+    std::vector<std::string> files = { file_manager.get_file_path("tmp_permutation_triples") };
+    for (auto permutation : { "pso", "sop", "ops" }) {
+        for (auto& file : get_files(permutation)) {
+            files.push_back(file);
+        }
+    }
+    for (auto& file : files) {
+        if (std::filesystem::exists(file)) {
+            error = true;
+            std::cerr << "File " << file << " was not removed\n";
+        }
+    }
+
+    if (rdf_model.get_pso() != nullptr || rdf_model.get_sop() != nullptr || rdf_model.get_ops() != nullptr) {
+        error = true;
+        std::cerr << "A permutation of the failed build was published\n";
+    }
+    if (rdf_model.catalog.permutations != 3) {
+        error = true;
+        std::cerr << "Catalog has " << rdf_model.catalog.permutations << " permutations\n";
+    }
+
+    return error;
+}
+
+
+bool create_pso() {
+    auto error = false;
+
+    auto created = rdf_model.create_permutation("pso");
+    if (created != std::vector<std::string> { "pso" }) {
+        error = true;
+        std::cerr << "Created " << created.size() << " permutations, expected pso\n";
+    }
+    if (rdf_model.catalog.permutations != 4) {
+        error = true;
+        std::cerr << "Catalog has " << rdf_model.catalog.permutations << " permutations, expected 4\n";
+    }
+    if (std::filesystem::exists(file_manager.get_file_path("tmp_permutation_triples"))) {
+        error = true;
+        std::cerr << "Temporary file was not removed\n";
+    }
+    error |= check_permutation("pso", rdf_model.get_pso(), { 1, 0, 2 });
+
+    return error;
+}
+
+
+bool create_sop_and_ops() {
+    auto error = false;
+
+    // pso already exists
+    auto created = rdf_model.create_permutation("sop");
+    if (created != std::vector<std::string> { "sop", "ops" }) {
+        error = true;
+        std::cerr << "Created " << created.size() << " permutations, expected sop and ops\n";
+    }
+    if (rdf_model.catalog.permutations != 6) {
+        error = true;
+        std::cerr << "Catalog has " << rdf_model.catalog.permutations << " permutations, expected 6\n";
+    }
+    error |= check_permutation("sop", rdf_model.get_sop(), { 0, 2, 1 });
+    error |= check_permutation("ops", rdf_model.get_ops(), { 2, 1, 0 });
+
+    if (!rdf_model.create_permutation("ops").empty()) {
+        error = true;
+        std::cerr << "Existing permutations were created again\n";
+    }
+
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    for (uint64_t i = 0; i < 30000; i++) {
+        triples.insert({ i % 1000, (i / 1000) % 7, (i * 7919) % 5003 });
+    }
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        create_database();
+    }
+
+    auto model_destroyer = RdfModel::init();
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&failed_build);
+    tests.push_back(&create_pso);
+    tests.push_back(&create_sop_and_ops);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        auto version_scope = buffer_manager.init_version_editable();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    {
+        // a query that starts after the updates reads the new permutations
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        if (check_permutation("pso", rdf_model.get_pso(), { 1, 0, 2 })
+            || check_permutation("ops", rdf_model.get_ops(), { 2, 1, 0 }))
+        {
+            error = true;
+        }
+    }
+
+    return error;
+}
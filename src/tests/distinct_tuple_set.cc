@@ -0,0 +1,162 @@
+/**
+ * Validate DistinctTupleSet, the in-memory set of DistinctHash, against a
+ * std::set, including hashes that collide, its growth, its memory limit and
+ * its reset.
+ */
+
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "storage/index/hash/distinct_binding_hash/distinct_tuple_set.h"
+
+typedef bool TestFunction();
+
+const uint_fast32_t TUPLE_SIZE = 3;
+
+typedef uint64_t HashFunction(const std::vector<ObjectId>&);
+
+uint64_t good_hash(const std::vector<ObjectId>& tuple) {
+    uint64_t hash = 0;
+    for (auto& oid : tuple) {
+        hash = (hash ^ oid.id) * 0x9E3779B97F4A7C15ULL;
+    }
+    return hash;
+}
+
+// many different tuples have the same hash
+uint64_t bad_hash(const std::vector<ObjectId>& tuple) {
+    return tuple[0].id % 7;
+}
+
+
+std::vector<ObjectId> random_tuple(std::mt19937& rng) {
+    std::vector<ObjectId> tuple;
+    for (uint_fast32_t i = 0; i < TUPLE_SIZE; i++) {
+        tuple.push_back(ObjectId(rng() % 50));
+    }
+    return tuple;
+}
+
+
+// inserts random tuples until the set is full or `count` tuples were tried,
+// returns true if the set doesn't behave as std::set
+bool insert_tuples(DistinctTupleSet& set, HashFunction* hash, uint64_t count, std::set<std::vector<ObjectId>>& expected) {
+    std::mt19937 rng(count);
+    auto error = false;
+
+    for (uint64_t i = 0; i < count && !set.full(); i++) {
+        auto tuple = random_tuple(rng);
+
+        auto received = set.is_in_or_insert(tuple.data(), hash(tuple));
+        auto inserted = expected.insert(tuple).second;
+        if (received == inserted) {
+            error = true;
+            std::cerr << "Tuple " << i << " was " << (inserted ? "new" : "already inserted")
+                      << ", is_in_or_insert returned " << received << "\n";
+        }
+    }
+
+    if (set.size() != expected.size()) {
+        error = true;
+        std::cerr << "Size " << set.size() << ", expected " << expected.size() << "\n";
+    }
+
+    std::set<std::vector<ObjectId>> stored;
+    set.for_each([&](const ObjectId* tuple) {
+        stored.insert(std::vector<ObjectId>(tuple, tuple + TUPLE_SIZE));
+    });
+    if (stored != expected) {
+        error = true;
+        std::cerr << "for_each returned " << stored.size() << " tuples, expected " << expected.size() << "\n";
+    }
+
+    return error;
+}
+
+
+bool insertions() {
+    auto error = false;
+
+    for (auto hash : { &good_hash, &bad_hash }) {
+        // enough memory to grow several times
+        DistinctTupleSet set(TUPLE_SIZE, 64 * 1024 * 1024);
+        std::set<std::vector<ObjectId>> expected;
+        // with the bad hash every insertion probes a long run of slots
+        auto count = hash == &good_hash ? 50000 : 3000;
+        if (insert_tuples(set, hash, count, expected)) {
+            error = true;
+            std::cerr << "  with the " << (hash == &good_hash ? "good" : "bad") << " hash\n";
+        }
+        if (set.full()) {
+            error = true;
+            std::cerr << "Set with 64 MB is full with " << set.size() << " tuples\n";
+        }
+    }
+
+    return error;
+}
+
+
+bool memory_limit() {
+    const size_t max_bytes = 64 * 1024;
+    const auto slot_bytes = sizeof(uint64_t) + TUPLE_SIZE * sizeof(ObjectId);
+
+    DistinctTupleSet set(TUPLE_SIZE, max_bytes);
+    std::set<std::vector<ObjectId>> expected;
+    auto error = insert_tuples(set, &good_hash, 50000, expected);
+
+    if (!set.full()) {
+        error = true;
+        std::cerr << "Set of " << max_bytes << " bytes is not full with " << set.size() << " tuples\n";
+    }
+    // at most 70% of the slots that fit in max_bytes are used
+    if (set.size() * slot_bytes * 10 > max_bytes * 7) {
+        error = true;
+        std::cerr << "Set of " << max_bytes << " bytes has " << set.size() << " tuples\n";
+    }
+
+    return error;
+}
+
+
+bool reset() {
+    DistinctTupleSet set(TUPLE_SIZE, 64 * 1024 * 1024);
+    std::set<std::vector<ObjectId>> expected;
+    auto error = insert_tuples(set, &good_hash, 10000, expected);
+
+    set.reset();
+    if (set.size() != 0) {
+        error = true;
+        std::cerr << "Size after reset " << set.size() << "\n";
+    }
+
+    // the tuples inserted before the reset are new again
+    expected.clear();
+    if (insert_tuples(set, &good_hash, 10000, expected)) {
+        error = true;
+        std::cerr << "  after reset\n";
+    }
+
+    return error;
+}
+
+
+int main() {
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&insertions);
+    tests.push_back(&memory_limit);
+    tests.push_back(&reset);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    return error;
+}
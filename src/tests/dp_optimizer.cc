@@ -0,0 +1,371 @@
+/**
+ * Validate DPOptimizer: on chain, star and cycle query graphs the cost of its
+ * plan must be the minimum found by an exhaustive enumeration of the joins of
+ * every connected subset of the base plans, and it must fall back to the
+ * GreedyOptimizer when the graph is not connected, when there are more than
+ * MAX_PLANS base plans and when there are more than MAX_PAIRS pairs.
+ */
+
+#include <bitset>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "query/optimizer/plan/join/hash_join_plan.h"
+#include "query/optimizer/plan/join/index_nested_loop_plan.h"
+#include "query/optimizer/plan/join_order/dp_optimizer.h"
+#include "query/optimizer/plan/join_order/greedy_optimizer.h"
+
+typedef bool TestFunction();
+
+using Subset = uint64_t;
+
+// each assigned variable divides the output size by DISTINCT_VALUES, so the
+// output size of a join doesn't depend on the order of the relations
+const double DISTINCT_VALUES = 1000;
+
+// as in DPOptimizer
+const std::size_t MAX_HASH_JOIN_VARS = 4;
+
+
+// Base plan with a given output size when none of its vars is assigned
+class TestPlan : public Plan {
+public:
+    TestPlan(std::string name, std::vector<VarId> vars, double size) :
+        name (std::move(name)),
+        vars (std::move(vars)),
+        size (size) { }
+
+    std::unique_ptr<Plan> clone() const override {
+        return std::make_unique<TestPlan>(*this);
+    }
+
+    int relation_size() const override { return 1; }
+
+    double estimate_cost() const override {
+        return 1 + estimate_output_size();
+    }
+
+    double estimate_output_size() const override {
+        return size * std::pow(1 / DISTINCT_VALUES, input_vars.size());
+    }
+
+    std::set<VarId> get_vars() const override {
+        std::set<VarId> res;
+        for (auto var : vars) {
+            if (input_vars.find(var) == input_vars.end()) {
+                res.insert(var);
+            }
+        }
+        return res;
+    }
+
+    void set_input_vars(const std::set<VarId>& _input_vars) override {
+        for (auto var : vars) {
+            if (_input_vars.find(var) != _input_vars.end()) {
+                input_vars.insert(var);
+            }
+        }
+    }
+
+    std::unique_ptr<BindingIter> get_binding_iter() const override {
+        return nullptr;
+    }
+
+    bool get_leapfrog_iter(std::vector<std::unique_ptr<LeapfrogIter>>&,
+                           std::vector<VarId>&,
+                           uint_fast32_t&) const override { return false; }
+
+    void print(std::ostream& os, int indent) const override {
+        os << std::string(indent, ' ') << name;
+    }
+
+private:
+    std::string name;
+    std::vector<VarId> vars;
+    double size;
+    std::set<VarId> input_vars;
+};
+
+
+// base plans with the vars of each plan and random sizes
+std::vector<std::unique_ptr<Plan>> make_plans(const std::vector<std::vector<VarId>>& plan_vars, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> exponent(1, 6);
+
+    std::vector<std::unique_ptr<Plan>> plans;
+    for (std::size_t i = 0; i < plan_vars.size(); i++) {
+        auto size = std::round(std::pow(10, exponent(gen)));
+        plans.push_back(std::make_unique<TestPlan>("P" + std::to_string(i), plan_vars[i], size));
+    }
+    return plans;
+}
+
+
+// plan i has the vars i and i + 1, and the last one also has the var 0 if `cycle` is true
+std::vector<std::vector<VarId>> chain_vars(std::size_t plans, bool cycle) {
+    std::vector<std::vector<VarId>> res;
+    for (std::size_t i = 0; i < plans; i++) {
+        res.push_back({ VarId(i), VarId(cycle && i + 1 == plans ? 0 : i + 1) });
+    }
+    return res;
+}
+
+
+// plan 0 has the vars 0 to `plans` - 2, and plan i has the vars i - 1 and `plans` + i
+std::vector<std::vector<VarId>> star_vars(std::size_t plans) {
+    std::vector<std::vector<VarId>> res(1);
+    for (std::size_t i = 1; i < plans; i++) {
+        res[0].push_back(VarId(i - 1));
+        res.push_back({ VarId(i - 1), VarId(plans + i) });
+    }
+    return res;
+}
+
+
+// Computes the cost of the best plan joining the relations of each connected
+// subset, comparing the same joins as DPOptimizer for every partition of the
+// subset into two connected subsets
+class ExhaustiveOptimizer {
+public:
+    ExhaustiveOptimizer(const std::vector<std::unique_ptr<Plan>>& base_plans) :
+        base_plans (base_plans)
+    {
+        neighbors.assign(base_plans.size(), 0);
+        for (std::size_t i = 0; i < base_plans.size(); i++) {
+            for (std::size_t j = 0; j < base_plans.size(); j++) {
+                if (i != j && !base_plans[i]->cartesian_product_needed(*base_plans[j])) {
+                    neighbors[i] |= Subset(1) << j;
+                }
+            }
+        }
+    }
+
+    double get_cost() {
+        const Subset all_plans = (Subset(1) << base_plans.size()) - 1;
+        best_plans.clear();
+        best_plans.resize(all_plans + 1);
+
+        // the subsets of a subset are smaller numbers
+        for (Subset subset = 1; subset <= all_plans; subset++) {
+            if (!is_connected(subset)) {
+                continue;
+            }
+            if (std::bitset<64>(subset).count() == 1) {
+                best_plans[subset] = base_plans[index(subset)]->clone();
+                continue;
+            }
+            for (auto lhs = (subset - 1) & subset; lhs != 0; lhs = (lhs - 1) & subset) {
+                auto rhs = subset & ~lhs;
+                if (is_connected(lhs) && is_connected(rhs)) {
+                    join(lhs, rhs);
+                }
+            }
+        }
+        return best_plans[all_plans]->estimate_cost();
+    }
+
+private:
+    const std::vector<std::unique_ptr<Plan>>& base_plans;
+
+    std::vector<Subset> neighbors;
+
+    std::vector<std::unique_ptr<Plan>> best_plans;
+
+    static std::size_t index(Subset subset) {
+        std::size_t res = 0;
+        while (((subset >> res) & 1) == 0) {
+            res++;
+        }
+        return res;
+    }
+
+    bool is_connected(Subset subset) const {
+        Subset reached = subset & (~subset + 1);
+        while (true) {
+            auto next = reached;
+            for (std::size_t i = 0; i < base_plans.size(); i++) {
+                if ((reached >> i) & 1) {
+                    next |= neighbors[i] & subset;
+                }
+            }
+            if (next == reached) {
+                return reached == subset;
+            }
+            reached = next;
+        }
+    }
+
+    // product of the sizes of the plans, divided for each repetition of a var
+    double get_output_size(Subset subset) const {
+        double res = 1;
+        std::set<VarId> vars;
+        for (std::size_t i = 0; i < base_plans.size(); i++) {
+            if ((subset >> i) & 1) {
+                auto plan = base_plans[i]->clone();
+                plan->set_input_vars(vars);
+                res *= plan->estimate_output_size();
+                for (auto var : base_plans[i]->get_vars()) {
+                    vars.insert(var);
+                }
+            }
+        }
+        return res;
+    }
+
+    void join(Subset lhs, Subset rhs) {
+        auto& lhs_plan = *best_plans[lhs];
+        auto& rhs_plan = *best_plans[rhs];
+        auto& best_plan = best_plans[lhs | rhs];
+
+        std::vector<std::unique_ptr<Plan>> candidates;
+        if (std::bitset<64>(rhs).count() == 1) {
+            candidates.push_back(std::make_unique<IndexNestedLoopPlan>(lhs_plan.clone(), rhs_plan.clone()));
+        }
+
+        auto lhs_vars = lhs_plan.get_vars();
+        std::size_t join_vars = 0;
+        for (auto var : rhs_plan.get_vars()) {
+            if (lhs_vars.find(var) != lhs_vars.end()) {
+                join_vars++;
+            }
+        }
+        if (join_vars > 0 && join_vars <= MAX_HASH_JOIN_VARS) {
+            candidates.push_back(
+                std::make_unique<HashJoinPlan>(lhs_plan.clone(), rhs_plan.clone(), get_output_size(lhs | rhs))
+            );
+        }
+
+        for (auto& candidate : candidates) {
+            if (best_plan == nullptr || candidate->estimate_cost() < best_plan->estimate_cost()) {
+                best_plan = std::move(candidate);
+            }
+        }
+    }
+};
+
+
+std::string to_string(const Plan& plan) {
+    std::stringstream ss;
+    plan.print(ss, 2);
+    return ss.str();
+}
+
+
+bool check_optimal(const std::string& name, const std::vector<std::vector<VarId>>& plan_vars, unsigned seeds) {
+    auto error = false;
+    for (unsigned seed = 0; seed < seeds; seed++) {
+        auto base_plans = make_plans(plan_vars, seed);
+
+        DPOptimizer optimizer(base_plans);
+        auto plan = optimizer.get_plan();
+        auto expected_cost = ExhaustiveOptimizer(base_plans).get_cost();
+
+        if (std::abs(plan->estimate_cost() - expected_cost) > 1e-9 * expected_cost) {
+            error = true;
+            std::cerr << name << " with seed " << seed << ": cost " << plan->estimate_cost()
+                      << ", the best plan costs " << expected_cost << "\n"
+                      << to_string(*plan) << "\n";
+        }
+    }
+    return error;
+}
+
+
+bool check_greedy(const std::string& name, const std::vector<std::vector<VarId>>& plan_vars) {
+    auto base_plans = make_plans(plan_vars, 0);
+
+    DPOptimizer optimizer(base_plans);
+    auto plan = to_string(*optimizer.get_plan());
+    auto greedy_plan = to_string(*GreedyOptimizer::get_plan(base_plans));
+
+    if (plan != greedy_plan) {
+        std::cerr << name << ": the plan is not the one of the GreedyOptimizer\n"
+                  << plan << "\nexpected\n" << greedy_plan << "\n";
+        return true;
+    }
+    return false;
+}
+
+
+bool chain_graphs() {
+    auto error = false;
+    for (std::size_t plans = 2; plans <= 10; plans++) {
+        if (check_optimal("Chain of " + std::to_string(plans), chain_vars(plans, false), 10)) {
+            error = true;
+        }
+    }
+    return error;
+}
+
+
+bool star_graphs() {
+    auto error = false;
+    for (std::size_t plans = 3; plans <= 10; plans++) {
+        if (check_optimal("Star of " + std::to_string(plans), star_vars(plans), 10)) {
+            error = true;
+        }
+    }
+    // the biggest star with less than MAX_PAIRS pairs
+    if (check_optimal("Star of 14", star_vars(14), 1)) {
+        error = true;
+    }
+    return error;
+}
+
+
+bool cycle_graphs() {
+    auto error = false;
+    for (std::size_t plans = 3; plans <= 10; plans++) {
+        if (check_optimal("Cycle of " + std::to_string(plans), chain_vars(plans, true), 10)) {
+            error = true;
+        }
+    }
+    return error;
+}
+
+
+bool disconnected_graph() {
+    // two chains without vars in common
+    auto plan_vars = chain_vars(3, false);
+    for (auto& vars : chain_vars(3, false)) {
+        plan_vars.push_back({ VarId(vars[0].id + 10), VarId(vars[1].id + 10) });
+    }
+    return check_greedy("Disconnected graph", plan_vars);
+}
+
+
+bool too_many_plans() {
+    return check_greedy("Chain of MAX_PLANS + 1", chain_vars(DPOptimizer::MAX_PLANS + 1, false));
+}
+
+
+bool too_many_pairs() {
+    // a star of n plans has (n - 1) * 2^(n - 2) pairs of a connected subset and its complement
+    return check_greedy("Star of 16", star_vars(16));
+}
+
+
+int main() {
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&chain_graphs);
+    tests.push_back(&star_graphs);
+    tests.push_back(&cycle_graphs);
+    tests.push_back(&disconnected_graph);
+    tests.push_back(&too_many_plans);
+    tests.push_back(&too_many_pairs);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    return error;
+}
@@ -0,0 +1,165 @@
+/**
+ * Validate HelperThreads: tasks run in every helper and the threads are reused,
+ * exceptions of the tasks are rethrown by wait(), and helpers can't use the
+ * private pages nor create the temporal strings of the query.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "query/exceptions.h"
+#include "query/executor/helper_threads.h"
+#include "query/query_context.h"
+#include "system/buffer_manager.h"
+#include "system/tmp_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+const std::string DB_FOLDER = "helper_threads_db";
+
+
+bool run_tasks() {
+    auto error = false;
+    HelperThreads helpers;
+
+    for (uint_fast32_t count : { 3, 1, 4 }) {
+        std::vector<int> runs(count, 0);
+        std::atomic<uint_fast32_t> helper_contexts(0);
+        helpers.start(count, [&](uint_fast32_t i) {
+            runs[i]++;
+            if (get_query_ctx().thread_info.is_helper) {
+                helper_contexts++;
+            }
+        });
+        helpers.wait();
+
+        if (runs != std::vector<int>(count, 1) || helper_contexts != count) {
+            error = true;
+            std::cerr << "Task with " << count << " helpers didn't run once in each helper\n";
+        }
+        if (helpers.running() != 0) {
+            error = true;
+            std::cerr << "Helpers still running after wait()\n";
+        }
+    }
+
+    return error;
+}
+
+
+bool task_exceptions() {
+    auto error = false;
+    HelperThreads helpers;
+
+    helpers.start(3, [](uint_fast32_t i) {
+        if (i == 1) {
+            throw std::runtime_error("helper 1");
+        }
+    });
+    try {
+        helpers.wait();
+        error = true;
+        std::cerr << "Exception of a helper was not rethrown\n";
+    } catch (const std::runtime_error& e) {
+        if (std::string(e.what()) != "helper 1") {
+            error = true;
+            std::cerr << "Rethrown exception: " << e.what() << "\n";
+        }
+    }
+
+    // the next task doesn't see the previous exception
+    helpers.start(3, [](uint_fast32_t) { });
+    try {
+        helpers.wait();
+    } catch (const std::exception& e) {
+        error = true;
+        std::cerr << "Exception of a previous task was rethrown: " << e.what() << "\n";
+    }
+
+    return error;
+}
+
+
+// runs `task` in a helper, returns true if it didn't throw a LogicException
+bool expect_logic_exception(const std::string& name, std::function<void()> task) {
+    HelperThreads helpers;
+    helpers.start(1, [&](uint_fast32_t) { task(); });
+    try {
+        helpers.wait();
+    } catch (const LogicException&) {
+        return false;
+    }
+    std::cerr << name << " in a helper didn't throw a LogicException\n";
+    return true;
+}
+
+
+bool helper_resources() {
+    auto error = false;
+
+    error |= expect_logic_exception("Temporal string", []() {
+        tmp_manager.get_str_id("a temporal string");
+    });
+    error |= expect_logic_exception("Temporal list", []() {
+        tmp_manager.get_tmp_list();
+    });
+    error |= expect_logic_exception("Temporal file", []() {
+        buffer_manager.get_tmp_file_id();
+    });
+
+    // the thread of the query can use them
+    auto tmp_file_id = buffer_manager.get_tmp_file_id();
+    buffer_manager.unpin(buffer_manager.get_ppage(tmp_file_id, 0));
+    auto str_id = tmp_manager.get_str_id("a temporal string");
+
+    // and the helpers can read its temporal strings
+    std::string read_str;
+    HelperThreads helpers;
+    helpers.start(1, [&](uint_fast32_t) {
+        read_str = tmp_manager.get_str(str_id);
+    });
+    helpers.wait();
+    if (read_str != "a temporal string") {
+        error = true;
+        std::cerr << "Helper read the temporal string \"" << read_str << "\"\n";
+    }
+
+    error |= expect_logic_exception("Private page", [&]() {
+        buffer_manager.get_ppage(tmp_file_id, 0);
+    });
+
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER, 1024);
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&run_tasks);
+    tests.push_back(&task_exceptions);
+    tests.push_back(&helper_resources);
+
+    auto error = false;
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    return error;
+}
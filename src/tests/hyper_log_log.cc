@@ -0,0 +1,110 @@
+/**
+ * Validate the distinct value estimations of HyperLogLog for sequential and
+ * random values, and that repeated values don't change the sketch.
+ */
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "storage/catalog/hyper_log_log.h"
+
+typedef bool TestFunction();
+
+// standard error of the sketch
+const double STANDARD_ERROR = 1.04 / std::sqrt(static_cast<double>(HyperLogLog::REGISTERS));
+
+const std::vector<uint64_t> CARDINALITIES = { 0, 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+// returns true if the estimation is not within 4 standard errors, or 2 values
+// for small cardinalities
+bool check_estimation(const HyperLogLog& hll, uint64_t expected, const std::string& values) {
+    auto estimation = hll.estimate();
+    auto max_error = std::max(2.0, 4 * STANDARD_ERROR * expected);
+    if (std::abs(estimation - static_cast<double>(expected)) > max_error) {
+        std::cerr << "Estimation of " << expected << " " << values << " values is " << estimation << "\n";
+        return true;
+    }
+    return false;
+}
+
+
+bool sequential_values() {
+    auto error = false;
+
+    for (auto cardinality : CARDINALITIES) {
+        HyperLogLog hll;
+        for (uint64_t i = 0; i < cardinality; i++) {
+            hll.add(i);
+        }
+        if (check_estimation(hll, cardinality, "sequential")) {
+            error = true;
+        }
+    }
+
+    return error;
+}
+
+
+bool random_values() {
+    std::mt19937_64 rng(42);
+    auto error = false;
+
+    for (auto cardinality : CARDINALITIES) {
+        HyperLogLog hll;
+        for (uint64_t i = 0; i < cardinality; i++) {
+            hll.add(rng());
+        }
+        if (check_estimation(hll, cardinality, "random")) {
+            error = true;
+        }
+    }
+
+    return error;
+}
+
+
+bool repeated_values() {
+    auto error = false;
+
+    HyperLogLog once;
+    HyperLogLog repeated;
+    for (uint64_t i = 0; i < 5000; i++) {
+        once.add(i * 3);
+    }
+    for (int repetition = 0; repetition < 10; repetition++) {
+        for (uint64_t i = 0; i < 5000; i++) {
+            repeated.add((5000 - i) * 3 % 15000);
+        }
+    }
+
+    if (once.registers != repeated.registers) {
+        error = true;
+        std::cerr << "Repeated values changed the sketch\n";
+    }
+    if (check_estimation(repeated, 5000, "repeated")) {
+        error = true;
+    }
+
+    return error;
+}
+
+
+int main() {
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&sequential_values);
+    tests.push_back(&random_values);
+    tests.push_back(&repeated_values);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    return error;
+}
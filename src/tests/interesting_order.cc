@@ -0,0 +1,260 @@
+/**
+ * Validate the use of the order of BGP results by GROUP BY: a GROUP BY over a
+ * triple pattern must read it from a permutation sorted by the group vars and
+ * aggregate it with the streaming Aggregation, without the hash table of the
+ * HybridAggregation nor the OrderBy of the non-pipelinable aggregates, also
+ * through a FILTER. An input that is not sorted by the group vars must still
+ * be hashed. In every case the groups must be the ones of the triples.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include "graph_models/common/conversions.h"
+#include "graph_models/rdf_model/rdf_model.h"
+#include "query/optimizer/rdf_model/binding_iter_constructor.h"
+#include "query/parser/sparql_query_parser.h"
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+// values of the group vars of a row, and the value of ?c
+using Groups = std::map<std::vector<uint64_t>, uint64_t>;
+
+const std::string DB_FOLDER = "interesting_order_db";
+
+// (subject, predicate, object) as integers
+std::set<Record<3>> triples;
+
+QueryContext qc;
+
+
+// writes the B+trees and the catalog of a database with 3 permutations, like the import
+void create_database() {
+    std::vector<Record<3>> spo, pos, osp;
+    for (uint64_t i = 0; i < 30000; i++) {
+        triples.insert({ i % 1000, (i / 1000) % 7, (i * 7919) % 5003 });
+    }
+    for (auto& [s, p, o] : triples) {
+        auto s_id = Common::Conversions::pack_int(s).id;
+        auto p_id = Common::Conversions::pack_int(p).id;
+        auto o_id = Common::Conversions::pack_int(o).id;
+        spo.push_back({ s_id, p_id, o_id });
+        pos.push_back({ p_id, o_id, s_id });
+        osp.push_back({ o_id, s_id, p_id });
+    }
+    build_bpt<3>("spo", spo);
+    build_bpt<3>("pos", pos);
+    build_bpt<3>("osp", osp);
+
+    build_bpt<1>("equal_spo", std::vector<Record<1>>());
+    for (auto name : { "equal_sp", "equal_so", "equal_po", "equal_sp_inverted", "equal_so_inverted", "equal_po_inverted" }) {
+        build_bpt<2>(name, std::vector<Record<2>>());
+    }
+
+    // saved by the destructor
+    RdfCatalog catalog("catalog.dat", 3);
+    catalog.set_triples_count(triples.size());
+}
+
+
+// groups of the triples accepted by `filter`, by the columns `group_columns`.
+// Counts the triples, or the distinct objects if `distinct_objects` is true
+Groups expected_groups(
+    const std::vector<uint64_t>& group_columns,
+    bool distinct_objects = false,
+    uint64_t min_object = 0
+) {
+    std::map<std::vector<uint64_t>, std::set<uint64_t>> objects;
+    Groups groups;
+    for (auto& triple : triples) {
+        if (triple[2] < min_object) {
+            continue;
+        }
+        std::vector<uint64_t> key;
+        for (auto column : group_columns) {
+            key.push_back(triple[column]);
+        }
+        groups[key]++;
+        objects[key].insert(triple[2]);
+    }
+    if (distinct_objects) {
+        for (auto& [key, count] : groups) {
+            count = objects[key].size();
+        }
+    }
+    return groups;
+}
+
+
+VarId get_var(const std::string& name) {
+    bool found;
+    auto var = get_query_ctx().get_var(name, &found);
+    if (!found) {
+        throw std::logic_error("Var " + name + " not found");
+    }
+    return var;
+}
+
+
+// builds the iter of `query` and checks that its plan has the operators
+// `expected_ops` and not `unexpected_ops`, and that it returns `expected`
+bool check_query(
+    const std::string&              query,
+    const std::vector<std::string>& group_vars,
+    const std::vector<std::string>& expected_ops,
+    const std::vector<std::string>& unexpected_ops,
+    const Groups&                   expected
+) {
+    auto version_scope = buffer_manager.init_version_readonly();
+    qc.prepare(*version_scope, std::chrono::seconds(60));
+
+    auto logical_plan = SPARQL::QueryParser::get_query_plan(query);
+    SPARQL::BindingIterConstructor visitor;
+    logical_plan->accept_visitor(visitor);
+    auto iter = std::move(visitor.tmp);
+
+    std::stringstream ss;
+    iter->print(ss, 2, false);
+    auto plan = ss.str();
+
+    auto error = false;
+    for (auto& op : expected_ops) {
+        if (plan.find(" " + op + "(") == std::string::npos) {
+            error = true;
+            std::cerr << query << "\n  the plan doesn't have " << op << ":\n" << plan;
+        }
+    }
+    for (auto& op : unexpected_ops) {
+        if (plan.find(" " + op + "(") != std::string::npos) {
+            error = true;
+            std::cerr << query << "\n  the plan has " << op << ":\n" << plan;
+        }
+    }
+
+    std::vector<VarId> vars;
+    for (auto& name : group_vars) {
+        vars.push_back(get_var(name));
+    }
+    auto count_var = get_var("c");
+
+    Binding binding(get_query_ctx().get_var_size());
+    iter->begin(binding);
+
+    Groups groups;
+    uint64_t rows = 0;
+    while (iter->next()) {
+        std::vector<uint64_t> key;
+        for (auto var : vars) {
+            key.push_back(Common::Conversions::unpack_int(binding[var]));
+        }
+        groups[key] = Common::Conversions::unpack_int(binding[count_var]);
+        rows++;
+    }
+    if (groups != expected || rows != expected.size()) {
+        error = true;
+        std::cerr << query << "\n  returned " << rows << " groups, expected " << expected.size() << "\n";
+    }
+    return error;
+}
+
+
+bool group_by_one_var() {
+    auto error = false;
+    std::vector<std::pair<std::string, uint64_t>> vars = { { "s", 0 }, { "p", 1 }, { "o", 2 } };
+    for (auto& [var, column] : vars) {
+        auto query = "SELECT ?" + var + " (COUNT(*) AS ?c) WHERE { ?s ?p ?o } GROUP BY ?" + var;
+        if (check_query(query, { var }, { "Aggregation" }, { "HybridAggregation", "ParallelAggregation" },
+                        expected_groups({ column })))
+        {
+            error = true;
+        }
+    }
+    return error;
+}
+
+
+bool group_by_two_vars() {
+    // ?o ?s is read from osp and ?p ?s from spo, the order of the group vars doesn't matter
+    auto error = false;
+    if (check_query("SELECT ?o ?s (COUNT(*) AS ?c) WHERE { ?s ?p ?o } GROUP BY ?o ?s",
+                    { "o", "s" }, { "Aggregation" }, { "HybridAggregation" }, expected_groups({ 2, 0 })))
+    {
+        error = true;
+    }
+    if (check_query("SELECT ?p ?s (COUNT(*) AS ?c) WHERE { ?s ?p ?o } GROUP BY ?p ?s",
+                    { "p", "s" }, { "Aggregation" }, { "HybridAggregation" }, expected_groups({ 1, 0 })))
+    {
+        error = true;
+    }
+    return error;
+}
+
+
+bool non_pipelinable_aggregate() {
+    // the input is already grouped, so it is not sorted again
+    return check_query("SELECT ?p (COUNT(DISTINCT ?o) AS ?c) WHERE { ?s ?p ?o } GROUP BY ?p",
+                       { "p" }, { "Aggregation" }, { "OrderBy", "HybridAggregation" }, expected_groups({ 1 }, true));
+}
+
+
+bool filter_keeps_order() {
+    return check_query("SELECT ?p (COUNT(*) AS ?c) WHERE { ?s ?p ?o FILTER(?o >= 2500) } GROUP BY ?p",
+                       { "p" }, { "Aggregation", "Filter" }, { "HybridAggregation" }, expected_groups({ 1 }, false, 2500));
+}
+
+
+bool unsorted_input() {
+    // the join of the star is sorted by ?s
+    Groups expected;
+    std::map<uint64_t, uint64_t> subject_triples;
+    for (auto& triple : triples) {
+        subject_triples[triple[0]]++;
+    }
+    for (auto& triple : triples) {
+        expected[{ triple[2] }] += subject_triples[triple[0]];
+    }
+    return check_query("SELECT ?o (COUNT(*) AS ?c) WHERE { ?s ?p ?o . ?s ?p2 ?o2 } GROUP BY ?o",
+                       { "o" }, { "HybridAggregation" }, { }, expected);
+}
+
+
+int main() {
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        create_database();
+    }
+
+    auto model_destroyer = RdfModel::init();
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&group_by_one_var);
+    tests.push_back(&group_by_two_vars);
+    tests.push_back(&non_pipelinable_aggregate);
+    tests.push_back(&filter_keeps_order);
+    tests.push_back(&unsorted_input);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    return error;
+}
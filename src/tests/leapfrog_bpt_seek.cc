@@ -0,0 +1,217 @@
+/**
+ * Validate the seeks of LeapfrogBptIter, that search from the current leaf or
+ * the next one before searching from the root, against searches of the same
+ * records from the root with BPlusTree::get_range.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/leapfrog/leapfrog_bpt_iter.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+const std::string DB_FOLDER = "leapfrog_bpt_seek_db";
+
+std::unique_ptr<BPlusTree<2>> bpt;
+
+// the records expected in bpt
+std::set<Record<2>> records;
+
+bool interruption_requested = false;
+
+
+std::unique_ptr<LeapfrogBptIter<2>> make_iter() {
+    auto iter = std::make_unique<LeapfrogBptIter<2>>(
+        &interruption_requested,
+        *bpt,
+        std::vector<std::unique_ptr<ScanRange>>(),
+        std::vector<VarId> { VarId(0), VarId(1) },
+        std::vector<VarId>()
+    );
+    Binding binding(2);
+    iter->open_terms(binding);
+    return iter;
+}
+
+
+// first record in [min, max] searching from the root, nullptr if there is none
+const Record<2>* search_from_root(const Record<2>& min, const Record<2>& max, BptIter<2>& it) {
+    it = bpt->get_range(&interruption_requested, min, max);
+    return it.next();
+}
+
+
+// checks the result of a seek with the first record in [min, max]
+bool check_seek(bool found, uint64_t key, const Record<2>& min, const Record<2>& max, int level) {
+    auto expected = records.lower_bound(min);
+    auto expected_found = expected != records.end() && *expected <= max;
+
+    BptIter<2> it;
+    auto from_root = search_from_root(min, max, it);
+    if ((from_root != nullptr) != expected_found || (expected_found && *from_root != *expected)) {
+        std::cerr << "Search from the root of " << min << " is not the expected record\n";
+        return true;
+    }
+
+    if (found != expected_found) {
+        std::cerr << "Seek of " << min << " at level " << level << " returned " << found
+                  << ", expected " << expected_found << "\n";
+        return true;
+    }
+    if (found && key != (*expected)[level]) {
+        std::cerr << "Seek of " << min << " at level " << level << " found key " << key
+                  << ", expected " << *expected << "\n";
+        return true;
+    }
+    return false;
+}
+
+
+// seeks the first column with steps that stay in the same leaf, go to the next
+// leaf or go further away, and the second column of some of the keys found
+bool seeks(uint64_t seed) {
+    auto error = false;
+    auto max_key = records.rbegin()->at(0);
+
+    std::mt19937_64 rng(seed);
+    std::vector<uint64_t> steps = { 0, 1, 2, 5, 20, 40, 300, 3000 };
+
+    auto iter = make_iter();
+    iter->down();
+
+    uint64_t key = 0;
+    while (true) {
+        key += steps[rng() % steps.size()];
+
+        auto found = iter->seek(key);
+        if (check_seek(found, iter->get_key(), { key, 0 }, { UINT64_MAX, UINT64_MAX }, 0)) {
+            return true;
+        }
+        if (!found) {
+            if (key <= max_key) {
+                error = true;
+                std::cerr << "Seek of " << key << " didn't find a record\n";
+            }
+            break;
+        }
+        key = iter->get_key();
+
+        if (rng() % 4 == 0) {
+            iter->down();
+            uint64_t second = 0;
+            while (true) {
+                second += rng() % 4;
+                auto found_second = iter->seek(second);
+                if (check_seek(found_second, iter->get_key(), { key, second }, { key, UINT64_MAX }, 1)) {
+                    return true;
+                }
+                if (!found_second) {
+                    break;
+                }
+                second = iter->get_key();
+            }
+            iter->up();
+        }
+    }
+
+    return error;
+}
+
+
+bool seeks_1() {
+    return seeks(1);
+}
+
+
+bool seeks_2() {
+    return seeks(2);
+}
+
+
+// next() is a seek of the key after the current one
+bool next_keys() {
+    auto error = false;
+
+    auto iter = make_iter();
+    iter->down();
+
+    std::vector<uint64_t> keys;
+    for (auto& record : records) {
+        if (keys.empty() || keys.back() != record[0]) {
+            keys.push_back(record[0]);
+        }
+    }
+
+    std::vector<uint64_t> received = { iter->get_key() };
+    while (iter->next()) {
+        received.push_back(iter->get_key());
+    }
+
+    if (received != keys) {
+        error = true;
+        std::cerr << "next() returned " << received.size() << " keys, expected " << keys.size() << "\n";
+    }
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    for (uint64_t i = 0; i < 20000; i++) {
+        records.insert({ i / 10, i % 10 });
+    }
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&seeks_1);
+    tests.push_back(&seeks_2);
+    tests.push_back(&next_keys);
+
+    auto error = false;
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        bpt = build_bpt<2>("test_bpt", records);
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    {
+        auto version_scope = buffer_manager.init_version_editable();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        // leaves with different number of records, and keys with many records
+        for (uint64_t i = 0; i < 20000; i++) {
+            Record<2> record = { (i * 7) % 500, 10 + i % 37 };
+            bpt->insert(record);
+            records.insert(record);
+        }
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    bpt.reset();
+    return error;
+}
@@ -0,0 +1,138 @@
+/**
+ * Validate the merge of sorted sequences with the LoserTree used by OrderBy,
+ * for different numbers of sequences, including empty ones and ties.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "storage/tuple_collection/tuple_collection.h"
+
+typedef bool TestFunction();
+
+// tuples are (value, sequence), sorted by value
+const size_t TUPLE_SIZE = 2;
+
+int64_t compare_ids(ObjectId lhs, ObjectId rhs) {
+    if (lhs.id < rhs.id) {
+        return -1;
+    }
+    return lhs.id > rhs.id ? 1 : 0;
+}
+
+
+// merges the sequences and returns the tuples in the order they are returned
+std::vector<std::pair<uint64_t, uint64_t>> merge(
+    const std::vector<std::vector<ObjectId>>& sequences,
+    const TupleComparator& comparator
+) {
+    LoserTree tree(comparator);
+    std::vector<size_t> positions(sequences.size(), 0);
+    for (auto& sequence : sequences) {
+        tree.heads.push_back(sequence.empty() ? nullptr : sequence.data());
+    }
+    tree.init();
+
+    std::vector<std::pair<uint64_t, uint64_t>> merged;
+    while (tree.heads[tree.winner()] != nullptr) {
+        auto winner = tree.winner();
+        auto head = tree.heads[winner];
+        merged.push_back({ head[0].id, head[1].id });
+
+        positions[winner] += TUPLE_SIZE;
+        tree.heads[winner] = positions[winner] < sequences[winner].size()
+                           ? sequences[winner].data() + positions[winner]
+                           : nullptr;
+        tree.replay();
+    }
+    return merged;
+}
+
+
+bool merge_sequences(bool ascending) {
+    OrderInfo info({ VarId(0) }, { ascending }, { VarId(1) });
+    TupleComparator comparator = { info, &compare_ids };
+
+    std::mt19937 rng(ascending ? 1 : 2);
+    auto error = false;
+
+    for (uint64_t k = 1; k <= 17; k++) {
+        for (int repetition = 0; repetition < 5; repetition++) {
+            std::vector<std::vector<ObjectId>> sequences(k);
+            std::vector<std::pair<uint64_t, uint64_t>> expected;
+
+            for (uint64_t s = 0; s < k; s++) {
+                // some sequences are empty, and the small values repeat
+                auto length = rng() % 4 == 0 ? 0 : rng() % 50;
+                std::vector<uint64_t> values;
+                for (uint64_t i = 0; i < length; i++) {
+                    values.push_back(rng() % 40);
+                }
+                std::sort(values.begin(), values.end());
+                if (!ascending) {
+                    std::reverse(values.begin(), values.end());
+                }
+                for (auto value : values) {
+                    sequences[s].push_back(ObjectId(value));
+                    sequences[s].push_back(ObjectId(s));
+                    expected.push_back({ value, s });
+                }
+            }
+
+            // ties are returned in the order of the sequences
+            std::sort(expected.begin(), expected.end(), [ascending](auto& lhs, auto& rhs) {
+                if (lhs.first != rhs.first) {
+                    return ascending ? lhs.first < rhs.first : lhs.first > rhs.first;
+                }
+                return lhs.second < rhs.second;
+            });
+
+            auto received = merge(sequences, comparator);
+            if (received != expected) {
+                error = true;
+                std::cerr << "Merge of " << k << " sequences" << (ascending ? "" : " in descending order")
+                          << " returned " << received.size() << " tuples";
+                for (size_t i = 0; i < std::min(received.size(), expected.size()); i++) {
+                    if (received[i] != expected[i]) {
+                        std::cerr << ", tuple " << i << " is (" << received[i].first << ", " << received[i].second
+                                  << "), expected (" << expected[i].first << ", " << expected[i].second << ")";
+                        break;
+                    }
+                }
+                std::cerr << ", expected " << expected.size() << " tuples\n";
+            }
+        }
+    }
+
+    return error;
+}
+
+
+bool ascending() {
+    return merge_sequences(true);
+}
+
+
+bool descending() {
+    return merge_sequences(false);
+}
+
+
+int main() {
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&ascending);
+    tests.push_back(&descending);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    return error;
+}
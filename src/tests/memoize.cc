@@ -0,0 +1,223 @@
+/**
+ * Validate Memoize with a child whose results depend on the value of one
+ * variable: the results must be the ones of the child, read again only for
+ * new values, also when the results are not read until the end and when a
+ * value has too many results to be saved.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "query/executor/binding_iter/memoize.h"
+
+typedef bool TestFunction();
+
+const VarId KEY_VAR = VarId(0);
+const VarId VALUE_VAR = VarId(1);
+
+// the big entry is not saved
+const uint64_t BIG_KEY = 7;
+
+uint64_t rows_for(uint64_t key) {
+    if (key == BIG_KEY) {
+        return Memoize::MAX_ENTRY_ROWS + 10;
+    }
+    return key % 4 == 0 ? 0 : key % 5 + 1;
+}
+
+// Returns rows_for(key) results, with the key read from the binding when it
+// begins or is reset
+class KeyRowsIter : public BindingIter {
+public:
+    uint64_t evaluations = 0;
+
+    void _begin(Binding& _parent_binding) override
+    {
+        parent_binding = &_parent_binding;
+        _reset();
+    }
+
+    void _reset() override
+    {
+        evaluations++;
+        key = (*parent_binding)[KEY_VAR].id;
+        row = 0;
+    }
+
+    bool _next() override
+    {
+        if (row == rows_for(key)) {
+            return false;
+        }
+        parent_binding->add(VALUE_VAR, ObjectId(key * 100000 + row));
+        row++;
+        return true;
+    }
+
+    void assign_nulls() override
+    {
+        parent_binding->add(VALUE_VAR, ObjectId::get_null());
+    }
+
+    void print(std::ostream& os, int indent, bool) const override
+    {
+        os << std::string(indent, ' ') << "KeyRowsIter()\n";
+    }
+
+private:
+    Binding* parent_binding;
+    uint64_t key;
+    uint64_t row;
+};
+
+
+struct Lookup {
+    uint64_t key;
+
+    // rows read before stopping, UINT64_MAX reads all of them
+    uint64_t max_rows;
+};
+
+
+// returns true if the rows read don't match the rows of the key
+bool read_rows(Memoize& memoize, Binding& binding, const Lookup& lookup) {
+    auto expected = std::min(rows_for(lookup.key), lookup.max_rows);
+
+    uint64_t row = 0;
+    while (row < lookup.max_rows && memoize.next()) {
+        auto expected_value = lookup.key * 100000 + row;
+        if (binding[VALUE_VAR].id != expected_value) {
+            std::cerr << "Key " << lookup.key << " row " << row << " is " << binding[VALUE_VAR].id
+                      << ", expected " << expected_value << "\n";
+            return true;
+        }
+        row++;
+    }
+    if (row != expected) {
+        std::cerr << "Key " << lookup.key << " returned " << row << " rows, expected " << expected << "\n";
+        return true;
+    }
+    return false;
+}
+
+
+// returns true if the results of the lookups are wrong, and the number of
+// evaluations of the child in `evaluations`
+bool run_lookups(const std::vector<Lookup>& lookups, uint64_t& evaluations) {
+    auto child = std::make_unique<KeyRowsIter>();
+    auto child_ptr = child.get();
+    Memoize memoize(std::move(child), { KEY_VAR }, { VALUE_VAR });
+
+    Binding binding(2);
+    auto error = false;
+    bool begun = false;
+    for (auto& lookup : lookups) {
+        binding.add(KEY_VAR, ObjectId(lookup.key));
+        if (begun) {
+            memoize.reset();
+        } else {
+            memoize.begin(binding);
+            begun = true;
+        }
+        if (read_rows(memoize, binding, lookup)) {
+            error = true;
+        }
+    }
+
+    evaluations = child_ptr->evaluations;
+    return error;
+}
+
+
+bool repeated_keys() {
+    std::vector<Lookup> lookups;
+    for (uint64_t i = 0; i < 200; i++) {
+        lookups.push_back({ (i * 13) % 20, UINT64_MAX });
+    }
+
+    uint64_t evaluations;
+    auto error = run_lookups(lookups, evaluations);
+
+    // each of the 20 keys is evaluated once, except the big one
+    uint64_t big_lookups = 0;
+    for (auto& lookup : lookups) {
+        big_lookups += lookup.key == BIG_KEY;
+    }
+    auto expected = 19 + big_lookups;
+    if (evaluations != expected) {
+        error = true;
+        std::cerr << "Child evaluated " << evaluations << " times, expected " << expected << "\n";
+    }
+
+    return error;
+}
+
+
+bool incomplete_entries() {
+    // as NOT EXISTS, the first reads stop at the first row
+    std::vector<Lookup> lookups = {
+        { 3, 1 },
+        { 3, 1 },
+        { 6, 0 },
+        { 3, UINT64_MAX },
+        { 3, UINT64_MAX },
+        { 6, 2 },
+        { 6, UINT64_MAX },
+        { 9, 2 },
+        { 6, UINT64_MAX },
+        { 9, UINT64_MAX },
+    };
+
+    uint64_t evaluations;
+    auto error = run_lookups(lookups, evaluations);
+
+    // an incomplete entry evaluates the child again to read the remaining rows
+    if (evaluations != 6) {
+        error = true;
+        std::cerr << "Child evaluated " << evaluations << " times, expected 6\n";
+    }
+
+    return error;
+}
+
+
+bool reset_without_next() {
+    auto child = std::make_unique<KeyRowsIter>();
+    auto child_ptr = child.get();
+    Memoize memoize(std::move(child), { KEY_VAR }, { VALUE_VAR });
+
+    Binding binding(2);
+    binding.add(KEY_VAR, ObjectId(1));
+    memoize.begin(binding);
+    for (uint64_t key = 2; key < 10; key++) {
+        binding.add(KEY_VAR, ObjectId(key));
+        memoize.reset();
+    }
+
+    if (child_ptr->evaluations != 0) {
+        std::cerr << "Child evaluated " << child_ptr->evaluations << " times without calling next\n";
+        return true;
+    }
+    return read_rows(memoize, binding, { 9, UINT64_MAX });
+}
+
+
+int main() {
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&repeated_keys);
+    tests.push_back(&incomplete_entries);
+    tests.push_back(&reset_without_next);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    return error;
+}
@@ -0,0 +1,311 @@
+/**
+ * Validate MergeJoin and MergeLeftJoin against a nested loop join of the same
+ * rows: with groups of the same key on both sides, an empty relation on either
+ * side, lhs rows without a match, and keys after the end of rhs, also after a
+ * reset.
+ */
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "query/executor/binding_iter/merge_join.h"
+#include "query/executor/binding_iter/merge_left_join.h"
+
+typedef bool TestFunction();
+
+// (merge var, join var, var of one side)
+using Row = std::tuple<uint64_t, uint64_t, uint64_t>;
+
+// (merge var, join var, lhs var, rhs var)
+using Result = std::tuple<uint64_t, uint64_t, uint64_t, uint64_t>;
+
+const VarId MERGE_VAR = VarId(0);
+const VarId JOIN_VAR  = VarId(1);
+const VarId LHS_VAR   = VarId(2);
+const VarId RHS_VAR   = VarId(3);
+
+const uint64_t NULL_ID = ObjectId::get_null().id;
+
+
+// Returns rows sorted by MERGE_VAR, writing the last value of each row in `var`
+class RowsIter : public BindingIter {
+public:
+    RowsIter(const std::vector<Row>& rows, VarId var) :
+        rows (rows),
+        var  (var) { }
+
+    void _begin(Binding& _parent_binding) override
+    {
+        parent_binding = &_parent_binding;
+        pos = 0;
+    }
+
+    void _reset() override
+    {
+        pos = 0;
+    }
+
+    bool _next() override
+    {
+        if (pos == rows.size()) {
+            return false;
+        }
+        auto& [merge_value, join_value, value] = rows[pos++];
+        parent_binding->add(MERGE_VAR, ObjectId(merge_value));
+        parent_binding->add(JOIN_VAR, ObjectId(join_value));
+        parent_binding->add(var, ObjectId(value));
+        return true;
+    }
+
+    void assign_nulls() override
+    {
+        parent_binding->add(MERGE_VAR, ObjectId::get_null());
+        parent_binding->add(JOIN_VAR, ObjectId::get_null());
+        parent_binding->add(var, ObjectId::get_null());
+    }
+
+    void print(std::ostream& os, int indent, bool) const override
+    {
+        os << std::string(indent, ' ') << "RowsIter()\n";
+    }
+
+private:
+    const std::vector<Row>& rows;
+    const VarId var;
+    Binding* parent_binding;
+    std::size_t pos;
+};
+
+
+// a null join value matches any value
+bool compatible(uint64_t a, uint64_t b) {
+    return a == NULL_ID || b == NULL_ID || a == b;
+}
+
+
+// nested loop join in the order of lhs and then rhs, the lhs rows without a
+// match are returned with a null RHS_VAR if `left` is true
+std::vector<Result> expected_results(const std::vector<Row>& lhs, const std::vector<Row>& rhs, bool left) {
+    std::vector<Result> results;
+    for (auto& [merge_value, join_value, lhs_value] : lhs) {
+        bool matched = false;
+        for (auto& [rhs_merge_value, rhs_join_value, rhs_value] : rhs) {
+            if (rhs_merge_value == merge_value && compatible(join_value, rhs_join_value)) {
+                results.push_back({ merge_value, join_value, lhs_value, rhs_value });
+                matched = true;
+            }
+        }
+        if (left && !matched) {
+            results.push_back({ merge_value, join_value, lhs_value, NULL_ID });
+        }
+    }
+    return results;
+}
+
+
+std::vector<Result> read_results(BindingIter& join, Binding& binding) {
+    std::vector<Result> results;
+    while (join.next()) {
+        results.push_back({
+            binding[MERGE_VAR].id,
+            binding[JOIN_VAR].id,
+            binding[LHS_VAR].id,
+            binding[RHS_VAR].id,
+        });
+    }
+    return results;
+}
+
+
+void print_result(const Result& result) {
+    auto& [merge_value, join_value, lhs_value, rhs_value] = result;
+    std::cerr << "(" << merge_value << ", " << join_value << ", " << lhs_value << ", ";
+    if (rhs_value == NULL_ID) {
+        std::cerr << "null";
+    } else {
+        std::cerr << rhs_value;
+    }
+    std::cerr << ")";
+}
+
+
+// runs MergeJoin and MergeLeftJoin with lhs and rhs, twice with a reset
+bool check_joins(const std::string& name, const std::vector<Row>& lhs, const std::vector<Row>& rhs) {
+    auto error = false;
+
+    for (bool left : { false, true }) {
+        std::unique_ptr<BindingIter> join;
+        if (left) {
+            join = std::make_unique<MergeLeftJoin>(
+                std::make_unique<RowsIter>(lhs, LHS_VAR),
+                std::make_unique<RowsIter>(rhs, RHS_VAR),
+                MERGE_VAR,
+                std::vector<VarId> { JOIN_VAR },
+                std::vector<VarId> { RHS_VAR }
+            );
+        } else {
+            join = std::make_unique<MergeJoin>(
+                std::make_unique<RowsIter>(lhs, LHS_VAR),
+                std::make_unique<RowsIter>(rhs, RHS_VAR),
+                MERGE_VAR,
+                std::vector<VarId> { JOIN_VAR },
+                std::vector<VarId> { RHS_VAR }
+            );
+        }
+        auto expected = expected_results(lhs, rhs, left);
+
+        Binding binding(4);
+        join->begin(binding);
+        for (int execution = 0; execution < 2; execution++) {
+            auto results = read_results(*join, binding);
+            if (results != expected) {
+                error = true;
+                std::cerr << (left ? "MergeLeftJoin" : "MergeJoin") << " with " << name
+                          << (execution > 0 ? " after reset" : "") << ":\n  received";
+                for (auto& result : results) {
+                    std::cerr << ' ';
+                    print_result(result);
+                }
+                std::cerr << "\n  expected";
+                for (auto& result : expected) {
+                    std::cerr << ' ';
+                    print_result(result);
+                }
+                std::cerr << "\n";
+            }
+            join->reset();
+        }
+    }
+
+    return error;
+}
+
+
+bool duplicate_groups() {
+    std::vector<Row> lhs = {
+        { 1, 10, 100 }, { 1, 10, 101 }, { 1, 11, 102 },
+        { 2, 10, 103 },
+        { 4, 10, 104 }, { 4, 12, 105 },
+        { 7, 10, 106 }, { 7, 10, 107 },
+    };
+    std::vector<Row> rhs = {
+        { 1, 10, 200 }, { 1, 11, 201 }, { 1, 10, 202 },
+        { 3, 10, 203 },
+        { 4, 12, 204 }, { 4, 12, 205 }, { 4, 10, 206 },
+        { 7, 10, 207 },
+        { 9, 10, 208 }, { 9, 10, 209 },
+    };
+    return check_joins("duplicate groups", lhs, rhs);
+}
+
+
+bool empty_inputs() {
+    std::vector<Row> rows = { { 1, 10, 100 }, { 1, 10, 101 }, { 5, 10, 102 } };
+    std::vector<Row> empty;
+
+    auto error = false;
+    if (check_joins("an empty lhs", empty, rows)) {
+        error = true;
+    }
+    if (check_joins("an empty rhs", rows, empty)) {
+        error = true;
+    }
+    if (check_joins("both relations empty", empty, empty)) {
+        error = true;
+    }
+    return error;
+}
+
+
+bool rows_without_match() {
+    // keys missing in rhs, before, between and after its groups, join values
+    // without a match, and a null join value that matches any value
+    std::vector<Row> lhs = {
+        { 0, 10, 100 },
+        { 2, 10, 101 }, { 2, 13, 102 },
+        { 3, 10, 103 },
+        { 5, 11, 104 }, { 5, NULL_ID, 105 },
+        { 6, 10, 106 },
+    };
+    std::vector<Row> rhs = {
+        { 2, 10, 200 }, { 2, 10, 201 },
+        { 5, 10, 202 }, { 5, 12, 203 },
+        { 8, 10, 204 },
+    };
+    return check_joins("lhs rows without a match", lhs, rhs);
+}
+
+
+bool end_of_input() {
+    // the last group of rhs ends at the end of rhs and is reused by the
+    // following lhs rows, the keys after it find rhs already finished
+    std::vector<Row> lhs = {
+        { 3, 10, 100 },
+        { 5, 10, 101 }, { 5, 10, 102 },
+        { 6, 10, 103 }, { 6, 10, 104 },
+        { 9, 10, 105 },
+    };
+    std::vector<Row> rhs = {
+        { 1, 10, 200 },
+        { 3, 10, 201 },
+        { 5, 10, 202 }, { 5, 10, 203 },
+    };
+
+    auto error = false;
+    if (check_joins("lhs keys after the end of rhs", lhs, rhs)) {
+        error = true;
+    }
+
+    // rhs rows after the last key of lhs are not needed
+    std::vector<Row> short_lhs = { { 1, 10, 100 }, { 3, 10, 101 } };
+    if (check_joins("rhs keys after the end of lhs", short_lhs, rhs)) {
+        error = true;
+    }
+
+    // a single group in each relation
+    std::vector<Row> single_lhs = { { 5, 10, 100 }, { 5, 10, 101 } };
+    std::vector<Row> single_rhs = { { 5, 10, 200 } };
+    if (check_joins("a single group", single_lhs, single_rhs)) {
+        error = true;
+    }
+    return error;
+}
+
+
+bool many_groups() {
+    std::vector<Row> lhs;
+    std::vector<Row> rhs;
+    for (uint64_t key = 0; key < 300; key++) {
+        for (uint64_t i = 0; i < key % 4; i++) {
+            lhs.push_back({ key, 10 + (key + i) % 3, 1000 + lhs.size() });
+        }
+        for (uint64_t i = 0; i < key % 5; i++) {
+            rhs.push_back({ key, 10 + i % 3, 2000 + rhs.size() });
+        }
+    }
+    return check_joins("many groups", lhs, rhs);
+}
+
+
+int main() {
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&duplicate_groups);
+    tests.push_back(&empty_inputs);
+    tests.push_back(&rows_without_match);
+    tests.push_back(&end_of_input);
+    tests.push_back(&many_groups);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    return error;
+}
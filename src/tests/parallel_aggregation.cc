@@ -0,0 +1,232 @@
+/**
+ * Validate the results of ParallelAggregation, where several workers aggregate
+ * morsels of the same IndexScan and merge their partial aggregates, against
+ * the aggregates computed sequentially.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "graph_models/rdf_model/conversions.h"
+#include "query/executor/binding_iter/aggregation/parallel_aggregation.h"
+#include "query/executor/binding_iter/aggregation/sparql/agg_count_all.h"
+#include "query/executor/binding_iter/aggregation/sparql/agg_sum.h"
+#include "query/executor/binding_iter/aggregation/sparql/uagg_count_all.h"
+#include "query/executor/binding_iter/aggregation/sparql/uagg_sum.h"
+#include "query/executor/binding_iter/binding_expr/binding_expr_var.h"
+#include "query/executor/binding_iter/gather.h"
+#include "query/executor/binding_iter/scan_ranges/unassigned_var.h"
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+const std::string DB_FOLDER = "parallel_aggregation_db";
+
+const VarId GROUP_VAR = VarId(0);
+const VarId VALUE_VAR = VarId(1);
+const VarId COUNT_VAR = VarId(2);
+const VarId SUM_VAR   = VarId(3);
+
+// more than one morsel for each worker
+const uint64_t TOTAL_RECORDS = 4 * Gather<2>::MORSEL_SIZE + 123;
+
+const uint_fast32_t WORKERS = 3;
+
+std::unique_ptr<BPlusTree<2>> bpt;
+
+// count and sum of the values of each group
+std::map<uint64_t, std::pair<int64_t, int64_t>> expected_groups;
+
+
+// records (group, value) with 97 groups
+std::vector<Record<2>> get_records() {
+    std::vector<Record<2>> records;
+    for (uint64_t i = 0; i < TOTAL_RECORDS; i++) {
+        uint64_t group = i % 97;
+        int64_t value = i / 97;
+        records.push_back({ group, SPARQL::Conversions::pack_int(value).id });
+
+        auto& [count, sum] = expected_groups[group];
+        count++;
+        sum += value;
+    }
+    return records;
+}
+
+
+std::unique_ptr<IndexScan<2>> make_scan() {
+    std::array<std::unique_ptr<ScanRange>, 2> ranges;
+    ranges[0] = std::make_unique<UnassignedVar>(GROUP_VAR);
+    ranges[1] = std::make_unique<UnassignedVar>(VALUE_VAR);
+    return std::make_unique<IndexScan<2>>(*bpt, std::move(ranges));
+}
+
+
+// value_expr must outlive the result, the unordered aggregates don't own their expression
+std::unique_ptr<ParallelAggregation<2>> make_parallel_aggregation(
+    const std::set<VarId>& group_vars,
+    BindingExprVar& value_expr
+) {
+    std::map<VarId, std::unique_ptr<Agg>> aggregations;
+    aggregations.insert({ COUNT_VAR, std::make_unique<SPARQL::AggCountAll>(COUNT_VAR, nullptr) });
+    aggregations.insert({ SUM_VAR, std::make_unique<SPARQL::AggSum>(SUM_VAR, std::make_unique<BindingExprVar>(VALUE_VAR)) });
+    auto fallback = std::make_unique<HybridAggregation>(
+        make_scan(),
+        std::move(aggregations),
+        std::set<VarId>(group_vars),
+        std::set<VarId>()
+    );
+
+    std::vector<std::unique_ptr<IndexScan<2>>> scans;
+    std::vector<std::map<VarId, std::unique_ptr<UAgg>>> u_aggregations(WORKERS);
+    for (uint_fast32_t i = 0; i < WORKERS; i++) {
+        scans.push_back(make_scan());
+        u_aggregations[i].insert({ COUNT_VAR, std::make_unique<SPARQL::UAggCountAll>(COUNT_VAR, nullptr) });
+        u_aggregations[i].insert({ SUM_VAR, std::make_unique<SPARQL::UAggSum>(SUM_VAR, &value_expr) });
+    }
+
+    return std::make_unique<ParallelAggregation<2>>(
+        std::move(fallback),
+        std::move(scans),
+        std::move(u_aggregations),
+        group_vars
+    );
+}
+
+
+// reads every result of the aggregation as (group, (count, sum))
+bool read_groups(BindingIter& aggregation, Binding& binding, std::map<uint64_t, std::pair<int64_t, int64_t>>& groups) {
+    auto error = false;
+    while (aggregation.next()) {
+        auto group = binding[GROUP_VAR].id;
+        std::pair<int64_t, int64_t> result = {
+            SPARQL::Conversions::unpack_int(binding[COUNT_VAR]),
+            SPARQL::Conversions::unpack_int(binding[SUM_VAR]),
+        };
+        if (!groups.insert({ group, result }).second) {
+            error = true;
+            std::cerr << "Group " << group << " returned twice\n";
+        }
+    }
+    return error;
+}
+
+
+bool grouped() {
+    BindingExprVar value_expr(VALUE_VAR);
+    auto aggregation = make_parallel_aggregation({ GROUP_VAR }, value_expr);
+
+    Binding binding(4);
+    aggregation->begin(binding);
+
+    auto error = false;
+
+    // reset returns the same groups without aggregating again
+    for (int i = 0; i < 2; i++) {
+        std::map<uint64_t, std::pair<int64_t, int64_t>> received;
+        if (read_groups(*aggregation, binding, received)) {
+            error = true;
+        }
+        if (received != expected_groups) {
+            error = true;
+            std::cerr << "Received " << received.size() << " groups, expected " << expected_groups.size() << "\n";
+            for (auto& [group, count_sum] : expected_groups) {
+                auto it = received.find(group);
+                if (it == received.end()) {
+                    std::cerr << "  group " << group << " missing\n";
+                } else if (it->second != count_sum) {
+                    std::cerr << "  group " << group << ": count " << it->second.first << ", sum "
+                              << it->second.second << ", expected count " << count_sum.first
+                              << ", sum " << count_sum.second << "\n";
+                }
+            }
+        }
+        aggregation->reset();
+    }
+
+    if (aggregation->used_fallback) {
+        error = true;
+        std::cerr << "Grouped aggregation used the fallback\n";
+    }
+    if (aggregation->morsels < WORKERS) {
+        error = true;
+        std::cerr << "Only " << aggregation->morsels << " morsels\n";
+    }
+
+    return error;
+}
+
+
+bool not_grouped() {
+    BindingExprVar value_expr(VALUE_VAR);
+    auto aggregation = make_parallel_aggregation({}, value_expr);
+
+    Binding binding(4);
+    aggregation->begin(binding);
+
+    int64_t expected_count = 0;
+    int64_t expected_sum = 0;
+    for (auto& [group, count_sum] : expected_groups) {
+        expected_count += count_sum.first;
+        expected_sum += count_sum.second;
+    }
+
+    auto error = false;
+
+    if (!aggregation->next()) {
+        std::cerr << "Aggregation without groups returned nothing\n";
+        return true;
+    }
+
+    auto count = SPARQL::Conversions::unpack_int(binding[COUNT_VAR]);
+    auto sum = SPARQL::Conversions::unpack_int(binding[SUM_VAR]);
+    if (count != expected_count || sum != expected_sum) {
+        error = true;
+        std::cerr << "Aggregation without groups: count " << count << ", sum " << sum
+                  << ", expected count " << expected_count << ", sum " << expected_sum << "\n";
+    }
+
+    if (aggregation->next()) {
+        error = true;
+        std::cerr << "Aggregation without groups returned more than one result\n";
+    }
+
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&grouped);
+    tests.push_back(&not_grouped);
+
+    auto error = false;
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        bpt = build_bpt<2>("test_bpt", get_records());
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    bpt.reset();
+    return error;
+}
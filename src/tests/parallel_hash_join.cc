@@ -0,0 +1,324 @@
+/**
+ * Validate HashJoin::BGP::Parallel::Join: the parallel join must return the
+ * same rows as the sequential one (a single thread), and the runtime filters
+ * pushed into the probe relation must be filled with every key of the build
+ * relation before the probe relation is started.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "query/executor/binding_iter/gather.h"
+#include "query/executor/binding_iter/hash_join/bgp/parallel/join.h"
+#include "query/executor/binding_iter/scan_ranges/unassigned_var.h"
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+using Row = std::tuple<uint64_t, uint64_t, uint64_t>;
+
+const std::string DB_FOLDER = "parallel_hash_join_db";
+
+const VarId X = VarId(0);
+const VarId Y = VarId(1);
+const VarId Z = VarId(2);
+
+// more than one morsel for each thread
+const uint64_t BUILD_RECORDS = 3 * Gather<2>::MORSEL_SIZE + 17;
+const uint64_t PROBE_RECORDS = 4 * Gather<2>::MORSEL_SIZE + 5;
+
+const uint_fast32_t THREADS = 3;
+
+std::unique_ptr<BPlusTree<2>> build_bpt_xy;
+std::unique_ptr<BPlusTree<2>> probe_bpt_xz;
+
+// (x, y) with the even values of x, each one twice
+std::vector<Record<2>> build_records;
+
+// (x, z) with the multiples of 3 as x, each one three times
+std::vector<Record<2>> probe_records;
+
+// (x, y, z) of the join, sorted
+std::vector<Row> expected_rows;
+
+
+void create_records() {
+    for (uint64_t i = 0; i < BUILD_RECORDS; i++) {
+        build_records.push_back({ (i % (BUILD_RECORDS / 2)) * 2, i });
+    }
+    for (uint64_t i = 0; i < PROBE_RECORDS; i++) {
+        probe_records.push_back({ (i % (PROBE_RECORDS / 3)) * 3, i });
+    }
+
+    std::multimap<uint64_t, uint64_t> build_ys;
+    for (auto& record : build_records) {
+        build_ys.insert({ record[0], record[1] });
+    }
+    for (auto& record : probe_records) {
+        auto range = build_ys.equal_range(record[0]);
+        for (auto it = range.first; it != range.second; ++it) {
+            expected_rows.push_back({ record[0], it->second, record[1] });
+        }
+    }
+    std::sort(expected_rows.begin(), expected_rows.end());
+}
+
+
+std::unique_ptr<IndexScan<2>> make_scan(BPlusTree<2>& bpt, VarId second_var) {
+    std::array<std::unique_ptr<ScanRange>, 2> ranges;
+    ranges[0] = std::make_unique<UnassignedVar>(X);
+    ranges[1] = std::make_unique<UnassignedVar>(second_var);
+    return std::make_unique<IndexScan<2>>(bpt, std::move(ranges));
+}
+
+
+std::unique_ptr<HashJoin::BGP::Parallel::Join<1>> make_join(
+    std::unique_ptr<BindingIter> probe_rel,
+    uint_fast32_t threads
+) {
+    return std::make_unique<HashJoin::BGP::Parallel::Join<1>>(
+        make_scan(*build_bpt_xy, Y),
+        std::move(probe_rel),
+        std::vector<VarId> { X },
+        std::vector<VarId> { Y },
+        threads
+    );
+}
+
+
+// reads every result of the join, sorted
+std::vector<Row> read_rows(BindingIter& join, Binding& binding) {
+    std::vector<Row> rows;
+    while (join.next()) {
+        rows.push_back({ binding[X].id, binding[Y].id, binding[Z].id });
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+
+bool check_rows(const std::vector<Row>& rows, const std::string& name) {
+    if (rows == expected_rows) {
+        return false;
+    }
+    std::cerr << name << ": received " << rows.size() << " rows, expected " << expected_rows.size() << "\n";
+    auto mismatch = std::mismatch(rows.begin(), rows.end(), expected_rows.begin(), expected_rows.end());
+    if (mismatch.second != expected_rows.end()) {
+        auto& [x, y, z] = *mismatch.second;
+        std::cerr << "  first row missing or different: (" << x << ", " << y << ", " << z << ")\n";
+    }
+    return true;
+}
+
+
+// Probe relation over probe_records that checks the runtime filter of X
+// each time it is started, and skips the rows the filter rejects like an
+// IndexScan does
+class FilterCheckIter : public BindingIter {
+public:
+    const RuntimeFilter* filter = nullptr;
+
+    uint64_t checked_starts = 0;
+
+    uint64_t filtered = 0;
+
+    bool error = false;
+
+    bool push_runtime_filter(const RuntimeFilter& _filter) override {
+        if (_filter.var != X) {
+            return false;
+        }
+        filter = &_filter;
+        return true;
+    }
+
+    void _begin(Binding& _parent_binding) override {
+        parent_binding = &_parent_binding;
+        pos = 0;
+        check_filter();
+    }
+
+    void _reset() override {
+        pos = 0;
+        check_filter();
+    }
+
+    bool _next() override {
+        while (pos < probe_records.size()) {
+            auto& record = probe_records[pos++];
+            if (filter != nullptr && !filter->may_contain(record[0])) {
+                filtered++;
+                continue;
+            }
+            parent_binding->add(X, ObjectId(record[0]));
+            parent_binding->add(Z, ObjectId(record[1]));
+            return true;
+        }
+        return false;
+    }
+
+    void assign_nulls() override {
+        parent_binding->add(X, ObjectId::get_null());
+        parent_binding->add(Z, ObjectId::get_null());
+    }
+
+    void print(std::ostream& os, int indent, bool /*stats*/) const override {
+        os << std::string(indent, ' ') << "FilterCheckIter()\n";
+    }
+
+private:
+    Binding* parent_binding;
+
+    uint64_t pos;
+
+    // the hash table is complete, so every key of the build must be accepted
+    void check_filter() {
+        checked_starts++;
+        if (filter == nullptr) {
+            error = true;
+            std::cerr << "The runtime filter was not pushed\n";
+            return;
+        }
+        uint64_t min = UINT64_MAX;
+        uint64_t max = 0;
+        uint64_t missing = 0;
+        for (auto& record : build_records) {
+            min = std::min(min, record[0]);
+            max = std::max(max, record[0]);
+            if (!filter->may_contain(record[0])) {
+                missing++;
+            }
+        }
+        if (missing > 0) {
+            error = true;
+            std::cerr << "The probe started with " << missing << " build keys missing from the runtime filter\n";
+        }
+        if (filter->min != min || filter->max != max) {
+            error = true;
+            std::cerr << "Runtime filter range [" << filter->min << ", " << filter->max << "], expected ["
+                      << min << ", " << max << "]\n";
+        }
+        if (filter->may_contain(max + 1)) {
+            error = true;
+            std::cerr << "The runtime filter accepts a key above the build keys\n";
+        }
+    }
+};
+
+
+bool same_rows() {
+    auto error = false;
+
+    for (uint_fast32_t threads : { uint_fast32_t(1), THREADS }) {
+        auto probe_scan = make_scan(*probe_bpt_xz, Z);
+        auto probe_scan_ptr = probe_scan.get();
+        auto join = make_join(std::move(probe_scan), threads);
+
+        auto parallel_probe = dynamic_cast<Gather<2>*>(join->probe_rel.get()) != nullptr;
+        if (parallel_probe != (threads > 1)) {
+            error = true;
+            std::cerr << "Join with " << threads << " threads " << (parallel_probe ? "used" : "did not use")
+                      << " a parallel probe\n";
+        }
+
+        Binding binding(3);
+        join->begin(binding);
+
+        auto name = "Join with " + std::to_string(threads) + " threads";
+        if (check_rows(read_rows(*join, binding), name)) {
+            error = true;
+        }
+
+        join->reset();
+        if (check_rows(read_rows(*join, binding), name + " after reset")) {
+            error = true;
+        }
+
+        // the copies of the probe scan inside the Gather have their own statistics
+        if (threads == 1 && probe_scan_ptr->runtime_filtered == 0) {
+            error = true;
+            std::cerr << "The sequential probe scan did not use the runtime filter\n";
+        }
+    }
+
+    return error;
+}
+
+
+bool filters_after_build() {
+    auto error = false;
+
+    for (uint_fast32_t threads : { uint_fast32_t(1), THREADS }) {
+        auto probe_rel = std::make_unique<FilterCheckIter>();
+        auto probe_ptr = probe_rel.get();
+        auto join = make_join(std::move(probe_rel), threads);
+
+        Binding binding(3);
+        join->begin(binding);
+
+        auto name = "Join with " + std::to_string(threads) + " threads and a filtered probe";
+        if (check_rows(read_rows(*join, binding), name)) {
+            error = true;
+        }
+
+        join->reset();
+        if (check_rows(read_rows(*join, binding), name + " after reset")) {
+            error = true;
+        }
+
+        if (probe_ptr->error) {
+            error = true;
+        }
+        if (probe_ptr->checked_starts != 2) {
+            error = true;
+            std::cerr << name << ": the probe was started " << probe_ptr->checked_starts << " times\n";
+        }
+        if (probe_ptr->filtered == 0) {
+            error = true;
+            std::cerr << name << ": the runtime filter did not reject any probe row\n";
+        }
+    }
+
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&same_rows);
+    tests.push_back(&filters_after_build);
+
+    auto error = false;
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        create_records();
+        build_bpt_xy = build_bpt<2>("build_bpt", build_records);
+        probe_bpt_xz = build_bpt<2>("probe_bpt", probe_records);
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    build_bpt_xy.reset();
+    probe_bpt_xz.reset();
+    return error;
+}
@@ -0,0 +1,397 @@
+/**
+ * Validate RuntimeFilter and its use in the probe side of a hash join: the
+ * filter must accept every key added and few others, IndexScan must skip the
+ * records rejected by a filter of an unassigned variable and the whole range
+ * when the variable is assigned, the limit must still count the records of
+ * the range, and Filter and Union must push the filter into their children.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "query/executor/binding_iter/filter.h"
+#include "query/executor/binding_iter/index_scan.h"
+#include "query/executor/binding_iter/scan_ranges/assigned_var.h"
+#include "query/executor/binding_iter/scan_ranges/unassigned_var.h"
+#include "query/executor/binding_iter/union.h"
+#include "query/executor/runtime_filter.h"
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+using Row = std::pair<uint64_t, uint64_t>;
+
+const std::string DB_FOLDER = "runtime_filter_db";
+
+const VarId X = VarId(0);
+const VarId Y = VarId(1);
+const VarId Z = VarId(2);
+
+// several B+tree leaves
+const uint64_t TOTAL_RECORDS = 5000;
+
+// keys of the filters: the multiples of 7 in [MIN_KEY, MAX_KEY]
+const uint64_t MIN_KEY = 70;
+const uint64_t MAX_KEY = 700;
+
+std::unique_ptr<BPlusTree<2>> bpt;
+
+
+// records (i / 5, i * 3)
+std::vector<Record<2>> get_records() {
+    std::vector<Record<2>> records;
+    for (uint64_t i = 0; i < TOTAL_RECORDS; i++) {
+        records.push_back({ i / 5, i * 3 });
+    }
+    return records;
+}
+
+
+bool is_key(uint64_t id) {
+    return id >= MIN_KEY && id <= MAX_KEY && id % 7 == 0;
+}
+
+
+std::unique_ptr<RuntimeFilter> make_filter(VarId var, uint64_t multiplier = 1) {
+    auto filter = std::make_unique<RuntimeFilter>(var);
+    filter->clear((MAX_KEY - MIN_KEY) / 7 + 1);
+    for (uint64_t key = MIN_KEY; key <= MAX_KEY; key += 7) {
+        filter->add(key * multiplier);
+    }
+    return filter;
+}
+
+
+std::unique_ptr<IndexScan<2>> make_scan(VarId first_var, VarId second_var, bool first_assigned = false) {
+    std::array<std::unique_ptr<ScanRange>, 2> ranges;
+    if (first_assigned) {
+        ranges[0] = std::make_unique<AssignedVar>(first_var);
+    } else {
+        ranges[0] = std::make_unique<UnassignedVar>(first_var);
+    }
+    ranges[1] = std::make_unique<UnassignedVar>(second_var);
+    return std::make_unique<IndexScan<2>>(*bpt, std::move(ranges));
+}
+
+
+ObjectId to_boolean(ObjectId oid) {
+    return oid;
+}
+
+
+// true for every row
+class TrueExpr : public BindingExpr {
+public:
+    void accept_visitor(BindingExprVisitor&) override { }
+
+    ObjectId eval(const Binding&) override {
+        return ObjectId(ObjectId::BOOL_TRUE);
+    }
+
+    void print(std::ostream& os, std::vector<BindingIter*>&) const override {
+        os << "true";
+    }
+};
+
+
+std::vector<Row> read_rows(BindingIter& iter, VarId first_var, VarId second_var, uint64_t x = 0) {
+    Binding binding(3);
+    binding.add(X, ObjectId(x));
+    iter.begin(binding);
+
+    std::vector<Row> rows;
+    while (iter.next()) {
+        rows.push_back({ binding[first_var].id, binding[second_var].id });
+    }
+    return rows;
+}
+
+
+// the records of the range from `from` whose value of `column` the filter may contain
+std::vector<Row> expected_rows(const RuntimeFilter& filter, uint_fast32_t column, uint64_t from = 0, uint64_t count = TOTAL_RECORDS) {
+    std::vector<Row> rows;
+    for (uint64_t i = from; i < from + count && i < TOTAL_RECORDS; i++) {
+        Row row = { i / 5, i * 3 };
+        if (filter.may_contain(column == 0 ? row.first : row.second)) {
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+
+bool check_rows(const std::vector<Row>& rows, const std::vector<Row>& expected, const std::string& name) {
+    if (rows != expected) {
+        std::cerr << name << ": received " << rows.size() << " rows, expected " << expected.size() << "\n";
+        return true;
+    }
+    return false;
+}
+
+
+bool bloom_filter() {
+    auto error = false;
+    auto filter = make_filter(X);
+
+    if (filter->min != MIN_KEY || filter->max != MAX_KEY) {
+        error = true;
+        std::cerr << "Filter range [" << filter->min << ", " << filter->max << "], expected ["
+                  << MIN_KEY << ", " << MAX_KEY << "]\n";
+    }
+
+    uint64_t false_positives = 0;
+    uint64_t others = 0;
+    for (uint64_t id = 0; id <= 2 * MAX_KEY; id++) {
+        if (is_key(id)) {
+            if (!filter->may_contain(id)) {
+                error = true;
+                std::cerr << "The filter rejects the key " << id << "\n";
+            }
+        } else if (id < MIN_KEY || id > MAX_KEY) {
+            if (filter->may_contain(id)) {
+                error = true;
+                std::cerr << "The filter accepts " << id << ", outside of its range\n";
+            }
+        } else {
+            others++;
+            if (filter->may_contain(id)) {
+                false_positives++;
+            }
+        }
+    }
+    // about 0.5% with BITS_PER_KEY and HASHES
+    if (false_positives * 50 > others) {
+        error = true;
+        std::cerr << "The filter accepts " << false_positives << " of " << others << " values in its range\n";
+    }
+
+    // clear removes the keys
+    filter->clear(10);
+    if (filter->may_contain(MIN_KEY)) {
+        error = true;
+        std::cerr << "The filter accepts a key after clear\n";
+    }
+
+    // with too many keys only the range is checked
+    filter->clear(RuntimeFilter::MAX_BLOOM_KEYS + 1);
+    filter->add(MIN_KEY);
+    filter->add(MAX_KEY);
+    for (uint64_t id = MIN_KEY; id <= MAX_KEY; id++) {
+        if (!filter->may_contain(id)) {
+            error = true;
+            std::cerr << "The filter without Bloom bits rejects " << id << " in its range\n";
+            break;
+        }
+    }
+    if (filter->may_contain(MAX_KEY + 1)) {
+        error = true;
+        std::cerr << "The filter without Bloom bits accepts " << MAX_KEY + 1 << "\n";
+    }
+    return error;
+}
+
+
+bool index_scan_records() {
+    auto error = false;
+
+    // a filter of the first column and one of the second
+    auto x_filter = make_filter(X);
+    auto y_filter = make_filter(Y, 3);
+    std::vector<std::pair<uint_fast32_t, RuntimeFilter*>> filters = { { 0, x_filter.get() }, { 1, y_filter.get() } };
+
+    for (auto& [column, filter] : filters) {
+        auto name = "IndexScan filtered by column " + std::to_string(column);
+        auto scan = make_scan(X, Y);
+        if (!scan->push_runtime_filter(*filter)) {
+            error = true;
+            std::cerr << name << ": the scan did not use the filter\n";
+        }
+
+        auto expected = expected_rows(*filter, column);
+        auto rows = read_rows(*scan, X, Y);
+        if (check_rows(rows, expected, name)) {
+            error = true;
+        }
+        if (scan->runtime_filtered != TOTAL_RECORDS - expected.size()) {
+            error = true;
+            std::cerr << name << ": runtime_filtered is " << scan->runtime_filtered << ", expected "
+                      << TOTAL_RECORDS - expected.size() << "\n";
+        }
+        // every key is found
+        std::set<uint64_t> keys;
+        for (auto& row : rows) {
+            auto value = column == 0 ? row.first : row.second / 3;
+            if (is_key(value)) {
+                keys.insert(value);
+            }
+        }
+        if (keys.size() != (MAX_KEY - MIN_KEY) / 7 + 1) {
+            error = true;
+            std::cerr << name << ": found " << keys.size() << " keys, expected " << (MAX_KEY - MIN_KEY) / 7 + 1 << "\n";
+        }
+    }
+
+    // the filter changes between executions
+    auto scan = make_scan(X, Y);
+    scan->push_runtime_filter(*x_filter);
+    read_rows(*scan, X, Y);
+    x_filter->clear(1);
+    x_filter->add(3);
+    if (check_rows(read_rows(*scan, X, Y), expected_rows(*x_filter, 0), "IndexScan after the filter changed")) {
+        error = true;
+    }
+
+    return error;
+}
+
+
+bool index_scan_assigned_var() {
+    auto error = false;
+    auto filter = make_filter(X);
+
+    auto scan = make_scan(X, Y, true);
+    if (!scan->push_runtime_filter(*filter)) {
+        error = true;
+        std::cerr << "The scan with X assigned did not use the filter\n";
+    }
+
+    // a rejected value skips the range, without searching the B+tree
+    auto bpt_searches = scan->bpt_searches;
+    auto rows = read_rows(*scan, X, Y, MIN_KEY + 1);
+    if (!rows.empty()) {
+        error = true;
+        std::cerr << "The scan of a rejected X returned " << rows.size() << " rows\n";
+    }
+    if (scan->bpt_searches != bpt_searches || scan->runtime_filtered != 1) {
+        error = true;
+        std::cerr << "The scan of a rejected X searched the B+tree\n";
+    }
+
+    // an accepted value returns its records
+    rows = read_rows(*scan, X, Y, MIN_KEY);
+    if (rows.size() != 5) {
+        error = true;
+        std::cerr << "The scan of an accepted X returned " << rows.size() << " rows, expected 5\n";
+    }
+    return error;
+}
+
+
+bool index_scan_limit() {
+    auto error = false;
+    auto filter = make_filter(X);
+
+    // morsels of the scan, as a Gather reads them
+    for (uint64_t offset : { uint64_t(0), uint64_t(300), uint64_t(2000) }) {
+        auto scan = make_scan(X, Y);
+        scan->push_runtime_filter(*filter);
+        scan->offset = offset;
+        scan->limit = 1000;
+
+        auto name = "IndexScan with offset " + std::to_string(offset) + " and limit 1000";
+        if (check_rows(read_rows(*scan, X, Y), expected_rows(*filter, 0, offset, 1000), name)) {
+            error = true;
+        }
+    }
+    return error;
+}
+
+
+bool push_through_children() {
+    auto error = false;
+    auto filter = make_filter(X);
+
+    // a scan without X doesn't use it
+    auto scan_yz = make_scan(Y, Z);
+    if (scan_yz->push_runtime_filter(*filter)) {
+        error = true;
+        std::cerr << "A scan without X used the filter of X\n";
+    }
+
+    std::vector<std::unique_ptr<BindingExpr>> exprs;
+    exprs.push_back(std::make_unique<TrueExpr>());
+    Filter filter_iter(&to_boolean, make_scan(X, Y), std::move(exprs));
+    if (!filter_iter.push_runtime_filter(*filter)) {
+        error = true;
+        std::cerr << "Filter did not push the filter\n";
+    }
+    if (check_rows(read_rows(filter_iter, X, Y), expected_rows(*filter, 0), "Filter")) {
+        error = true;
+    }
+
+    // only the scans of the union that have X use it
+    std::vector<std::unique_ptr<BindingIter>> iters;
+    iters.push_back(make_scan(X, Y));
+    iters.push_back(make_scan(Y, Z));
+    iters.push_back(make_scan(X, Y));
+    Union union_iter(std::move(iters));
+    if (!union_iter.push_runtime_filter(*filter)) {
+        error = true;
+        std::cerr << "Union did not push the filter\n";
+    }
+    auto expected = expected_rows(*filter, 0);
+    std::vector<Row> all_records;
+    for (uint64_t i = 0; i < TOTAL_RECORDS; i++) {
+        all_records.push_back({ i / 5, i * 3 });
+    }
+    auto union_expected = expected;
+    union_expected.insert(union_expected.end(), all_records.begin(), all_records.end());
+    union_expected.insert(union_expected.end(), expected.begin(), expected.end());
+
+    Binding binding(3);
+    union_iter.begin(binding);
+    std::vector<Row> rows;
+    while (union_iter.next()) {
+        // the second scan assigns (Y, Z)
+        if (binding[X].is_null()) {
+            rows.push_back({ binding[Y].id, binding[Z].id });
+        } else {
+            rows.push_back({ binding[X].id, binding[Y].id });
+        }
+    }
+    if (check_rows(rows, union_expected, "Union")) {
+        error = true;
+    }
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&bloom_filter);
+    tests.push_back(&index_scan_records);
+    tests.push_back(&index_scan_assigned_var);
+    tests.push_back(&index_scan_limit);
+    tests.push_back(&push_through_children);
+
+    auto error = false;
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        bpt = build_bpt<2>("test_bpt", get_records());
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    bpt.reset();
+    return error;
+}
@@ -0,0 +1,145 @@
+/**
+ * Validate the normalized sort keys of SPARQL::Comparisons::normalize against
+ * SPARQL::Comparisons::compare: different keys must be ordered as the values,
+ * and equal exact keys must belong to values that compare as equal.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "graph_models/rdf_model/comparisons.h"
+#include "graph_models/rdf_model/conversions.h"
+#include "query/query_context.h"
+#include "storage/tuple_collection/sort_key.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+using namespace SPARQL;
+
+typedef bool TestFunction();
+
+const std::string DB_FOLDER = "sort_key_db";
+
+struct NormalizedValue {
+    std::string name;
+    ObjectId oid;
+    unsigned char key[SortKey::SIZE];
+    bool exact;
+};
+
+
+std::vector<NormalizedValue> get_values() {
+    std::vector<std::pair<std::string, ObjectId>> values = {
+        { "null", ObjectId::get_null() },
+        { "false", Conversions::pack_bool(false) },
+        { "true", Conversions::pack_bool(true) },
+        { "-5", Conversions::pack_int(-5) },
+        { "0", Conversions::pack_int(0) },
+        { "1", Conversions::pack_int(1) },
+        { "2", Conversions::pack_int(2) },
+        { "2^54", Conversions::pack_int(1LL << 54) },
+        { "2^54 + 1", Conversions::pack_int((1LL << 54) + 1) },
+        { "-2^54 - 1", Conversions::pack_int(-(1LL << 54) - 1) },
+        { "1.5f", Conversions::pack_float(1.5f) },
+        { "-0.0f", Conversions::pack_float(-0.0f) },
+        { "2.0", Conversions::pack_double(2.0) },
+        { "-1e300", Conversions::pack_double(-1e300) },
+        { "1.5 decimal", Conversions::pack_decimal(Decimal(1.5)) },
+        { "2 decimal", Conversions::pack_decimal(Decimal(static_cast<int64_t>(2))) },
+        { "\"\"", Conversions::pack_empty_string() },
+        { "\"a\"", Conversions::pack_string_simple_inline("a") },
+        { "\"ab\"", Conversions::pack_string_simple_inline("ab") },
+        { "\"b\"", Conversions::pack_string_simple_inline("b") },
+        { "\"a\"^^xsd:string", Conversions::pack_string_xsd_inline("a") },
+        { "\"long prefix one\"", Conversions::pack_string_simple("long prefix shared by 1") },
+        { "\"long prefix two\"", Conversions::pack_string_simple("long prefix shared by 2") },
+        { "\"long prefix\"", Conversions::pack_string_simple("long prefix shared") },
+        { "_:b1", Conversions::pack_blank_inline(1) },
+        { "_:b2", Conversions::pack_blank_inline(2) },
+    };
+
+    std::vector<NormalizedValue> normalized_values(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        auto& normalized = normalized_values[i];
+        normalized.name = values[i].first;
+        normalized.oid = values[i].second;
+        std::memset(normalized.key, 0, SortKey::SIZE);
+        normalized.exact = Comparisons::normalize(normalized.oid, normalized.key);
+    }
+    return normalized_values;
+}
+
+
+bool keys_follow_compare() {
+    auto values = get_values();
+    auto error = false;
+
+    for (auto& lhs : values) {
+        for (auto& rhs : values) {
+            auto cmp = Comparisons::compare(lhs.oid, rhs.oid);
+            auto key_cmp = std::memcmp(lhs.key, rhs.key, SortKey::COMPARED_BYTES);
+
+            if ((cmp < 0 && key_cmp > 0) || (cmp > 0 && key_cmp < 0)) {
+                error = true;
+                std::cerr << "Key of " << lhs.name << " and " << rhs.name << " compare " << key_cmp
+                          << ", values compare " << cmp << "\n";
+            }
+            if (key_cmp == 0 && lhs.exact && rhs.exact && cmp != 0) {
+                error = true;
+                std::cerr << "Exact keys of " << lhs.name << " and " << rhs.name
+                          << " are equal, values compare " << cmp << "\n";
+            }
+        }
+    }
+
+    return error;
+}
+
+
+bool inexact_keys() {
+    auto values = get_values();
+    auto error = false;
+
+    // values that can't be fully encoded in the key
+    for (auto& value : values) {
+        auto expected_inexact = value.name == "2^54 + 1" || value.name == "1.5 decimal"
+                             || value.name.rfind("\"long prefix", 0) == 0;
+        if (expected_inexact && value.exact) {
+            error = true;
+            std::cerr << "Key of " << value.name << " should not be exact\n";
+        }
+    }
+
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER, 1024);
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&keys_follow_compare);
+    tests.push_back(&inexact_keys);
+
+    auto error = false;
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    return error;
+}
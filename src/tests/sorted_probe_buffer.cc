@@ -0,0 +1,319 @@
+/**
+ * Validate SortedProbeBuffer: the rows of each batch of the outer relation
+ * must probe the inner IndexScan sorted by its input variable, the results
+ * must be the ones of a nested loop in the order of the outer relation, and
+ * the buffer must not hold more than MAX_BUFFERED_RESULTS results, even when
+ * a single outer row has more.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "query/executor/binding_iter/index_nested_loop_join.h"
+#include "query/executor/binding_iter/index_scan.h"
+#include "query/executor/binding_iter/scan_ranges/assigned_var.h"
+#include "query/executor/binding_iter/scan_ranges/unassigned_var.h"
+#include "query/executor/binding_iter/sorted_probe_buffer.h"
+#include "query/query_context.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "system/buffer_manager.h"
+#include "tests/test_database.h"
+
+typedef bool TestFunction();
+
+using Result = std::pair<uint64_t, uint64_t>;
+
+const std::string DB_FOLDER = "sorted_probe_buffer_db";
+
+const VarId X = VarId(0);
+const VarId Y = VarId(1);
+
+const uint64_t KEYS = 1000;
+
+// key with more results than the buffer can hold
+const uint64_t HEAVY_KEY = 500;
+const uint64_t HEAVY_KEY_RESULTS = SortedProbeBuffer::MAX_BUFFERED_RESULTS + SortedProbeBuffer::MAX_BUFFERED_RESULTS / 2;
+
+// keys multiple of 100 have MEDIUM_KEY_RESULTS, so a few of them fill the buffer
+const uint64_t MEDIUM_KEY_RESULTS = 10'000;
+
+std::unique_ptr<BPlusTree<2>> bpt;
+
+// values of Y of each key, sorted
+std::map<uint64_t, std::vector<uint64_t>> key_values;
+
+
+std::vector<Record<2>> get_records() {
+    std::vector<Record<2>> records;
+    for (uint64_t key = 0; key < KEYS; key++) {
+        uint64_t count = 1 + key % 3;
+        if (key == HEAVY_KEY) {
+            count = HEAVY_KEY_RESULTS;
+        } else if (key % 100 == 0) {
+            count = MEDIUM_KEY_RESULTS;
+        }
+        for (uint64_t i = 0; i < count; i++) {
+            records.push_back({ key, key * 7 + i });
+            key_values[key].push_back(key * 7 + i);
+        }
+    }
+    return records;
+}
+
+
+// Returns the values of X in order
+class OuterIter : public BindingIter {
+public:
+    OuterIter(const std::vector<uint64_t>& keys) :
+        keys (keys) { }
+
+    void _begin(Binding& _parent_binding) override {
+        parent_binding = &_parent_binding;
+        pos = 0;
+    }
+
+    void _reset() override {
+        pos = 0;
+    }
+
+    bool _next() override {
+        if (pos == keys.size()) {
+            return false;
+        }
+        parent_binding->add(X, ObjectId(keys[pos++]));
+        return true;
+    }
+
+    void assign_nulls() override {
+        parent_binding->add(X, ObjectId::get_null());
+    }
+
+    void print(std::ostream& os, int indent, bool /*stats*/) const override {
+        os << std::string(indent, ' ') << "OuterIter()\n";
+    }
+
+private:
+    const std::vector<uint64_t>& keys;
+
+    Binding* parent_binding;
+
+    std::size_t pos;
+};
+
+
+std::unique_ptr<IndexScan<2>> make_inner() {
+    std::array<std::unique_ptr<ScanRange>, 2> ranges;
+    ranges[0] = std::make_unique<AssignedVar>(X);
+    ranges[1] = std::make_unique<UnassignedVar>(Y);
+    return std::make_unique<IndexScan<2>>(*bpt, std::move(ranges));
+}
+
+
+// results of a nested loop join in the order of outer
+std::vector<Result> expected_results(const std::vector<uint64_t>& outer_keys) {
+    std::vector<Result> results;
+    for (auto key : outer_keys) {
+        for (auto value : key_values[key]) {
+            results.push_back({ key, value });
+        }
+    }
+    return results;
+}
+
+
+bool check_results(const std::vector<Result>& results, const std::vector<uint64_t>& outer_keys, const std::string& name) {
+    auto expected = expected_results(outer_keys);
+    if (results == expected) {
+        return false;
+    }
+    std::cerr << name << ": received " << results.size() << " results, expected " << expected.size() << "\n";
+    auto mismatch = std::mismatch(results.begin(), results.end(), expected.begin(), expected.end());
+    auto pos = mismatch.first - results.begin();
+    std::cerr << "  first difference at result " << pos;
+    if (mismatch.second != expected.end()) {
+        std::cerr << ", expected (" << mismatch.second->first << ", " << mismatch.second->second << ")";
+    }
+    std::cerr << "\n";
+    return true;
+}
+
+
+// Joins outer_keys with the B+tree through a SortedProbeBuffer like
+// IndexNestedLoopJoin does. Writes the keys in the order they are probed,
+// and the maximum number of results in the buffer
+std::vector<Result> probe(
+    const std::vector<uint64_t>& outer_keys,
+    std::vector<uint64_t>& probed_keys,
+    uint64_t& max_buffered
+) {
+    OuterIter outer(outer_keys);
+    auto inner = make_inner();
+    SortedProbeBuffer buffer(*inner);
+
+    Binding binding(2);
+    outer.begin(binding);
+    buffer.reset();
+
+    std::vector<Result> results;
+    bool inner_begun = false;
+    max_buffered = 0;
+    while (buffer.next(
+        outer,
+        binding,
+        [&]() {
+            probed_keys.push_back(binding[X].id);
+            if (inner_begun) {
+                inner->reset();
+            } else {
+                inner->begin(binding);
+                inner_begun = true;
+            }
+        },
+        [&]() {
+            max_buffered = std::max<uint64_t>(max_buffered, buffer.buffered_values() / binding.size);
+            return inner->next();
+        }
+    )) {
+        results.push_back({ binding[X].id, binding[Y].id });
+    }
+    return results;
+}
+
+
+bool sorted_probes() {
+    // keys without many results, with repetitions, in no particular order
+    std::vector<uint64_t> outer_keys;
+    for (uint64_t i = 0; i < 5000; i++) {
+        auto key = (i * 7919) % KEYS;
+        if (key % 100 != 0) {
+            outer_keys.push_back(key);
+        }
+    }
+
+    auto error = false;
+
+    SortedProbeBuffer buffer(*make_inner());
+    if (!buffer.enabled()) {
+        std::cerr << "SortedProbeBuffer is not enabled for an IndexScan with an assigned first column\n";
+        return true;
+    }
+
+    std::vector<uint64_t> probed_keys;
+    uint64_t max_buffered;
+    auto results = probe(outer_keys, probed_keys, max_buffered);
+    if (check_results(results, outer_keys, "Sorted probes")) {
+        error = true;
+    }
+
+    // the batches start with MIN_BATCH_SIZE rows and double their size
+    if (probed_keys.size() != outer_keys.size()) {
+        error = true;
+        std::cerr << "Probed " << probed_keys.size() << " rows, expected " << outer_keys.size() << "\n";
+    } else {
+        std::size_t begin = 0;
+        std::size_t batch_size = SortedProbeBuffer::MIN_BATCH_SIZE;
+        while (begin < probed_keys.size()) {
+            auto end = std::min(begin + batch_size, probed_keys.size());
+            auto batch_begin = probed_keys.begin() + begin;
+            auto batch_end = probed_keys.begin() + end;
+            if (!std::is_sorted(batch_begin, batch_end)) {
+                error = true;
+                std::cerr << "The batch of rows [" << begin << ", " << end << ") was not probed in key order\n";
+            }
+            std::vector<uint64_t> batch_keys(outer_keys.begin() + begin, outer_keys.begin() + end);
+            std::sort(batch_keys.begin(), batch_keys.end());
+            if (!std::equal(batch_begin, batch_end, batch_keys.begin())) {
+                error = true;
+                std::cerr << "The batch of rows [" << begin << ", " << end << ") probed other rows\n";
+            }
+            begin = end;
+            batch_size = std::min<std::size_t>(batch_size * 2, BindingBatch::DEFAULT_CAPACITY);
+        }
+    }
+
+    // the join returns the same results
+    IndexNestedLoopJoin join(std::make_unique<OuterIter>(outer_keys), make_inner());
+    Binding binding(2);
+    join.begin(binding);
+    for (int i = 0; i < 2; i++) {
+        std::vector<Result> join_results;
+        while (join.next()) {
+            join_results.push_back({ binding[X].id, binding[Y].id });
+        }
+        if (check_results(join_results, outer_keys, "IndexNestedLoopJoin")) {
+            error = true;
+        }
+        join.reset();
+    }
+
+    return error;
+}
+
+
+bool buffer_cap() {
+    // the keys with many results appear in the middle of the batches, and the
+    // heavy key alone has more results than the buffer
+    std::vector<uint64_t> outer_keys;
+    for (uint64_t i = 0; i < 3000; i++) {
+        outer_keys.push_back((i * 37 + 11) % KEYS);
+        if (i % 700 == 350) {
+            outer_keys.push_back(HEAVY_KEY);
+        }
+    }
+
+    std::vector<uint64_t> probed_keys;
+    uint64_t max_buffered;
+    auto results = probe(outer_keys, probed_keys, max_buffered);
+
+    auto error = false;
+
+    if (check_results(results, outer_keys, "Probes exceeding the buffer")) {
+        error = true;
+    }
+    if (max_buffered > SortedProbeBuffer::MAX_BUFFERED_RESULTS) {
+        error = true;
+        std::cerr << "The buffer held " << max_buffered << " results, the maximum is "
+                  << SortedProbeBuffer::MAX_BUFFERED_RESULTS << "\n";
+    }
+    if (max_buffered < SortedProbeBuffer::MAX_BUFFERED_RESULTS / 2) {
+        error = true;
+        std::cerr << "The buffer held at most " << max_buffered << " results, the test doesn't fill it\n";
+    }
+
+    return error;
+}
+
+
+int main() {
+    QueryContext qc;
+    QueryContext::set_query_ctx(&qc);
+
+    auto system = create_test_system(DB_FOLDER);
+
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&sorted_probes);
+    tests.push_back(&buffer_cap);
+
+    auto error = false;
+
+    {
+        auto version_scope = buffer_manager.init_version_readonly();
+        qc.prepare(*version_scope, std::chrono::seconds(60));
+
+        bpt = build_bpt<2>("test_bpt", get_records());
+
+        for (auto& test_func : tests) {
+            if (test_func()) {
+                error = true;
+            }
+        }
+    }
+
+    bpt.reset();
+    return error;
+}
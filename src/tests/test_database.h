@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * Fixture of the tests that need the storage of a database: an empty database
+ * with small buffers and B+trees built from the records of the test.
+ */
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "import/disk_vector.h"
+#include "macros/aligned_alloc.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
+#include "storage/index/hash/strings_hash/strings_hash_bulk_ondisk_import.h"
+#include "storage/index/hash/tensors_hash/tensors_hash_bulk_ondisk_import.h"
+#include "system/file_manager.h"
+#include "system/string_manager.h"
+#include "system/system.h"
+#include "system/tensor_manager.h"
+
+// Removes db_folder and creates an empty database in it. The QueryContext of
+// the test must be set before.
+inline std::unique_ptr<System> create_test_system(
+    const std::string& db_folder,
+    uint64_t shared_buffer_pages = 4096
+) {
+    std::filesystem::remove_all(db_folder);
+
+    // the System opens the strings and tensors hashes, created empty as the
+    // import does
+    FileManager::init(db_folder);
+    {
+        const uint64_t buffer_size = UPage::SIZE << std::max(StringsHash::MIN_GLOBAL_DEPTH, TensorsHash::MIN_GLOBAL_DEPTH);
+        auto buffer = reinterpret_cast<char*>(MDB_ALIGNED_ALLOC(buffer_size));
+        {
+            StringsHashBulkOnDiskImport strings_hash(file_manager.get_file_path("str_hash"), buffer, buffer_size);
+        }
+        {
+            TensorsHashBulkOnDiskImport tensors_hash(buffer, buffer_size);
+        }
+        MDB_ALIGNED_FREE(buffer);
+    }
+    file_manager.~FileManager();
+
+    return std::make_unique<System>(
+        db_folder,
+        StringManager::BLOCK_SIZE * 16,
+        StringManager::BLOCK_SIZE * 16,
+        VPage::SIZE * shared_buffer_pages,
+        PPage::SIZE * 256,
+        UPage::SIZE * 256,
+        TensorManager::BLOCK_SIZE * 16,
+        TensorManager::BLOCK_SIZE * 16,
+        1
+    );
+}
+
+
+// Bulk imports the B+tree `name` with `records` (a range of Record<N> in any
+// order) like the import of a database. Must be called in a version scope.
+template <std::size_t N, typename Records>
+std::unique_ptr<BPlusTree<N>> build_bpt(const std::string& name, const Records& records) {
+    Import::DiskVector<N> disk_vector(file_manager.get_file_path(name + ".tmp"));
+    for (const Record<N>& record : records) {
+        disk_vector.push_back(Record<N>(record));
+    }
+    disk_vector.finish_appends();
+
+    std::array<uint64_t, N> permutation;
+    for (std::size_t i = 0; i < N; i++) {
+        permutation[i] = i;
+    }
+
+    const uint64_t buffer_size = 64 * VPage::SIZE * N * sizeof(uint64_t);
+    auto buffer = reinterpret_cast<char*>(MDB_ALIGNED_ALLOC(buffer_size));
+    disk_vector.start_indexing(buffer, buffer_size, permutation);
+
+    Import::NoStat<N> no_stat;
+    disk_vector.create_bpt(file_manager.get_file_path(name), std::array<uint64_t, N>(permutation), no_stat);
+    disk_vector.finish_indexing();
+    MDB_ALIGNED_FREE(buffer);
+
+    return std::make_unique<BPlusTree<N>>(name);
+}
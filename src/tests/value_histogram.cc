@@ -0,0 +1,191 @@
+/**
+ * Validate the range estimates of ValueHistogram on uniform and skewed
+ * samples, and the values it reads from the inlined numeric and datetime
+ * ObjectIds.
+ */
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "graph_models/common/conversions.h"
+#include "graph_models/common/datatypes/datetime.h"
+#include "storage/catalog/value_histogram.h"
+
+typedef bool TestFunction();
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+bool check_estimate(const ValueHistogram& histogram, double low, double high, double expected, double tolerance) {
+    auto received = histogram.estimate_range(low, high);
+    if (std::abs(received - expected) > tolerance) {
+        std::cerr << "Estimate of [" << low << ", " << high << "], received " << received
+                  << ", expected " << expected << "\n";
+        return true;
+    }
+    return false;
+}
+
+
+bool uniform_ranges() {
+    auto error = false;
+
+    // 0, 1, ..., 9999
+    std::vector<double> sample;
+    for (int i = 0; i < 10000; i++) {
+        sample.push_back(i);
+    }
+    ValueHistogram histogram(sample, sample.size());
+
+    if (histogram.bounds.size() != ValueHistogram::MAX_BUCKETS + 1) {
+        error = true;
+        std::cerr << "Histogram has " << histogram.bounds.size() << " bounds, expected "
+                  << ValueHistogram::MAX_BUCKETS + 1 << "\n";
+    }
+
+    error |= check_estimate(histogram, -INF, INF, 1, 1e-9);
+    error |= check_estimate(histogram, 0, 9999, 1, 1e-9);
+    error |= check_estimate(histogram, 0, 4999.5, 0.5, 0.01);
+    error |= check_estimate(histogram, 2500, 7500, 0.5, 0.01);
+    error |= check_estimate(histogram, 1000, 1100, 0.01, 0.01);
+    error |= check_estimate(histogram, 9000, INF, 0.1, 0.01);
+
+    // a small sample has a bucket for each value
+    ValueHistogram small({ 1, 2, 3, 4 }, 4);
+    if (small.bounds.size() != 5) {
+        error = true;
+        std::cerr << "Small histogram has " << small.bounds.size() << " bounds, expected 5\n";
+    }
+    error |= check_estimate(small, 1, 4, 1, 1e-9);
+
+    return error;
+}
+
+
+bool skewed_ranges() {
+    auto error = false;
+
+    // 90% of the values are 0, the others are between 1 and 1000
+    std::vector<double> sample(9000, 0);
+    for (int i = 1; i <= 1000; i++) {
+        sample.push_back(i);
+    }
+    ValueHistogram histogram(sample, sample.size());
+
+    // the buckets with equal bounds count as a whole
+    error |= check_estimate(histogram, 0, 0, 0.9, 0.02);
+    error |= check_estimate(histogram, -INF, 0, 0.9, 0.02);
+    error |= check_estimate(histogram, 1, 1000, 0.1, 0.02);
+    error |= check_estimate(histogram, 500, 1000, 0.05, 0.02);
+    error |= check_estimate(histogram, -INF, INF, 1, 1e-9);
+
+    // a single value
+    ValueHistogram constant(std::vector<double>(100, 7), 100);
+    error |= check_estimate(constant, 7, 7, 1, 1e-9);
+    error |= check_estimate(constant, 0, 6.5, 0, 1e-9);
+    error |= check_estimate(constant, 7.5, INF, 0, 1e-9);
+
+    return error;
+}
+
+
+bool empty_ranges() {
+    auto error = false;
+
+    std::vector<double> sample;
+    for (int i = 0; i < 1000; i++) {
+        sample.push_back(i);
+    }
+    ValueHistogram histogram(sample, sample.size());
+
+    // inverted
+    error |= check_estimate(histogram, 600, 400, 0, 1e-9);
+    // out of the bounds
+    error |= check_estimate(histogram, -100, -1, 0, 1e-9);
+    error |= check_estimate(histogram, 1000, INF, 0, 1e-9);
+
+    // a histogram without bounds
+    ValueHistogram empty;
+    error |= check_estimate(empty, -INF, INF, 0, 1e-9);
+
+    return error;
+}
+
+
+bool check_value(const std::string& name, ObjectId oid, ValueHistogram::Kind expected_kind, double expected) {
+    ValueHistogram::Kind kind;
+    double value;
+    if (!ValueHistogram::get_value(oid, &kind, &value)) {
+        std::cerr << "Value of " << name << " was not read\n";
+        return true;
+    }
+    if (kind != expected_kind || value != expected) {
+        std::cerr << "Value of " << name << " is " << value << ", expected " << expected << "\n";
+        return true;
+    }
+    return false;
+}
+
+
+bool object_id_values() {
+    using Common::Conversions::pack_decimal;
+    using Common::Conversions::pack_float;
+    using Common::Conversions::pack_int;
+
+    auto error = false;
+
+    error |= check_value("-5", pack_int(-5), ValueHistogram::Kind::NUMERIC, -5);
+    error |= check_value("42", pack_int(42), ValueHistogram::Kind::NUMERIC, 42);
+    error |= check_value("1.5f", pack_float(1.5f), ValueHistogram::Kind::NUMERIC, 1.5);
+    error |= check_value("2.25 decimal", pack_decimal(Decimal(2.25)), ValueHistogram::Kind::NUMERIC, 2.25);
+
+    // datetimes are compared by their seconds on the timeline
+    ObjectId day1(DateTime::from_dateTime("2020-01-01T00:00:00Z"));
+    ObjectId day2(DateTime::from_dateTime("2020-01-02T00:00:00Z"));
+    ValueHistogram::Kind kind1, kind2;
+    double value1, value2;
+    if (!ValueHistogram::get_value(day1, &kind1, &value1) || !ValueHistogram::get_value(day2, &kind2, &value2)) {
+        error = true;
+        std::cerr << "Value of a datetime was not read\n";
+    } else if (kind1 != ValueHistogram::Kind::DATETIME || kind2 != ValueHistogram::Kind::DATETIME
+               || value2 - value1 != 86400)
+    {
+        error = true;
+        std::cerr << "Datetimes one day apart differ by " << value2 - value1 << " seconds\n";
+    }
+
+    ValueHistogram::Kind kind;
+    double value;
+    if (ValueHistogram::get_value(Common::Conversions::pack_bool(true), &kind, &value)) {
+        error = true;
+        std::cerr << "Value of a boolean should not be read\n";
+    }
+    if (ValueHistogram::get_value(ObjectId::get_null(), &kind, &value)) {
+        error = true;
+        std::cerr << "Value of null should not be read\n";
+    }
+
+    return error;
+}
+
+
+int main() {
+    std::vector<TestFunction*> tests;
+
+    tests.push_back(&uniform_ranges);
+    tests.push_back(&skewed_ranges);
+    tests.push_back(&empty_ranges);
+    tests.push_back(&object_id_values);
+
+    auto error = false;
+
+    for (auto& test_func : tests) {
+        if (test_func()) {
+            error = true;
+        }
+    }
+
+    return error;
+}
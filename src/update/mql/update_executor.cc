@@ -211,6 +211,7 @@ void UpdateExecutor::visit(OpInsert& op)
             quad_model.key_value_object->delete_record(*existing_record);
             quad_model.object_key_value->insert({ node.id, key.id, value.id });
             quad_model.key_value_object->insert({ key.id, value.id, node.id });
+            quad_model.catalog.overwrite_property(key.id, value.id);
 
             ++graph_update_data.overwritten_properties;
 
@@ -240,7 +241,7 @@ void UpdateExecutor::visit(OpInsert& op)
             // The node does not have a property with the same key, create a new one
             quad_model.object_key_value->insert({ node.id, key.id, value.id });
             quad_model.key_value_object->insert({ key.id, value.id, node.id });
-            quad_model.catalog.insert_property(key.id);
+            quad_model.catalog.insert_property(key.id, value.id);
 
             ++graph_update_data.new_properties;
 
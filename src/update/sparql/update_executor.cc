@@ -1,5 +1,7 @@
 #include "update_executor.h"
 
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <sstream>
 
@@ -20,6 +22,77 @@ UpdateExecutor::~UpdateExecutor()
     // TODO: force string file WAL flush?
 }
 
+std::vector<std::pair<uint64_t, uint64_t>> UpdateExecutor::get_subject_predicates(ObjectId subject)
+{
+    std::vector<std::pair<uint64_t, uint64_t>> res;
+
+    bool interruption_requested = false;
+    auto it = rdf_model.spo->get_range(
+        &interruption_requested,
+        { subject.id, 0, 0 },
+        { subject.id, UINT64_MAX, UINT64_MAX }
+    );
+    for (auto record = it.next(); record != nullptr; record = it.next()) {
+        if (res.empty() || res.back().first != (*record)[1]) {
+            res.push_back({ (*record)[1], 1 });
+        } else {
+            res.back().second++;
+        }
+    }
+    return res;
+}
+
+// adds (or removes) a triple of the predicate to a sorted list of (predicate, count)
+static void change_predicate_count(
+    std::vector<std::pair<uint64_t, uint64_t>>& predicates,
+    uint64_t predicate,
+    bool inserted
+)
+{
+    auto it = std::lower_bound(predicates.begin(), predicates.end(), std::make_pair(predicate, uint64_t(0)));
+    if (!inserted) {
+        assert(it != predicates.end() && it->first == predicate);
+        if (--it->second == 0) {
+            predicates.erase(it);
+        }
+    } else if (it != predicates.end() && it->first == predicate) {
+        it->second++;
+    } else {
+        predicates.insert(it, { predicate, 1 });
+    }
+}
+
+void UpdateExecutor::track_characteristic_set(
+    Subject2Predicates& subject2predicates,
+    ObjectId subject,
+    ObjectId predicate,
+    bool inserted
+)
+{
+    auto it = subject2predicates.find(subject.id);
+    if (it != subject2predicates.end()) {
+        change_predicate_count(it->second.after, predicate.id, inserted);
+        return;
+    }
+
+    // the first change of the subject, the SPO index already has it and
+    // the predicates before only differ in the count of predicate
+    SubjectPredicates subject_predicates;
+    subject_predicates.after = get_subject_predicates(subject);
+    subject_predicates.before = subject_predicates.after;
+    change_predicate_count(subject_predicates.before, predicate.id, !inserted);
+    subject2predicates.insert({ subject.id, std::move(subject_predicates) });
+}
+
+void UpdateExecutor::update_characteristic_sets(const Subject2Predicates& subject2predicates)
+{
+    for (auto& [subject, subject_predicates] : subject2predicates) {
+        if (subject_predicates.before != subject_predicates.after) {
+            rdf_model.catalog.update_characteristic_set(subject_predicates.before, subject_predicates.after);
+        }
+    }
+}
+
 constexpr uint64_t CLEAR_TMP_MASK = ~(ObjectId::MOD_MASK | ObjectId::MASK_EXTERNAL_ID);
 constexpr uint64_t CLEAR_TAG_MASK = ~(ObjectId::MASK_LITERAL_TAG);
 
@@ -242,6 +315,8 @@ void UpdateExecutor::visit(OpInsertData& op_insert_data)
     const auto& hnsw_index_predicate2names = rdf_model.catalog.hnsw_index_manager.get_predicate2names();
     Name2InsertsMap hnsw_index_name2inserts;
 
+    Subject2Predicates subject2predicates;
+
     // to receive the data
     for (auto& triple : op_insert_data.triples) {
         assert(triple.subject.is_OID());
@@ -295,6 +370,7 @@ void UpdateExecutor::visit(OpInsertData& op_insert_data)
             }
 
             rdf_model.catalog.insert_triple(S.id, P.id, O.id);
+            track_characteristic_set(subject2predicates, S, P, true);
             graph_update_data.triples_inserted++;
 
             Record<3> record_pos = { P.id, O.id, S.id };
@@ -303,19 +379,19 @@ void UpdateExecutor::visit(OpInsertData& op_insert_data)
             Record<3> record_osp = { O.id, S.id, P.id };
             rdf_model.osp->insert(record_osp);
 
-            if (rdf_model.pso != nullptr) {
+            if (rdf_model.get_pso() != nullptr) {
                 Record<3> record_pso = { P.id, S.id, O.id };
-                rdf_model.pso->insert(record_pso);
+                rdf_model.get_pso()->insert(record_pso);
             }
 
-            if (rdf_model.sop != nullptr) {
+            if (rdf_model.get_sop() != nullptr) {
                 Record<3> record_sop = { S.id, O.id, P.id };
-                rdf_model.sop->insert(record_sop);
+                rdf_model.get_sop()->insert(record_sop);
             }
 
-            if (rdf_model.ops != nullptr) {
+            if (rdf_model.get_ops() != nullptr) {
                 Record<3> record_ops = { O.id, P.id, S.id };
-                rdf_model.ops->insert(record_ops);
+                rdf_model.get_ops()->insert(record_ops);
             }
 
             if (S == P) {
@@ -347,6 +423,8 @@ void UpdateExecutor::visit(OpInsertData& op_insert_data)
         }
     }
 
+    update_characteristic_sets(subject2predicates);
+
     // Execute index inserts
     for (const auto& [name, inserts] : text_index_name2inserts) {
         auto* text_search_index_ptr = rdf_model.catalog.text_index_manager.get_text_index(name);
@@ -395,6 +473,8 @@ void UpdateExecutor::visit(OpDeleteData& op_delete_data)
     const auto& hnsw_index_predicate2names = rdf_model.catalog.hnsw_index_manager.get_predicate2names();
     Name2DeletesMap hnsw_index_name2deletes;
 
+    Subject2Predicates subject2predicates;
+
     for (auto& triple : op_delete_data.triples) {
         assert(triple.subject.is_OID());
         assert(triple.predicate.is_OID());
@@ -451,6 +531,7 @@ void UpdateExecutor::visit(OpDeleteData& op_delete_data)
             }
 
             rdf_model.catalog.delete_triple(S.id, P.id, O.id);
+            track_characteristic_set(subject2predicates, S, P, false);
             graph_update_data.triples_deleted++;
 
             Record<3> record_pos = { P.id, O.id, S.id };
@@ -459,19 +540,19 @@ void UpdateExecutor::visit(OpDeleteData& op_delete_data)
             Record<3> record_osp = { O.id, S.id, P.id };
             rdf_model.osp->delete_record(record_osp);
 
-            if (rdf_model.pso != nullptr) {
+            if (rdf_model.get_pso() != nullptr) {
                 Record<3> record_pso = { P.id, S.id, O.id };
-                rdf_model.pso->delete_record(record_pso);
+                rdf_model.get_pso()->delete_record(record_pso);
             }
 
-            if (rdf_model.sop != nullptr) {
+            if (rdf_model.get_sop() != nullptr) {
                 Record<3> record_sop = { S.id, O.id, P.id };
-                rdf_model.sop->delete_record(record_sop);
+                rdf_model.get_sop()->delete_record(record_sop);
             }
 
-            if (rdf_model.ops != nullptr) {
+            if (rdf_model.get_ops() != nullptr) {
                 Record<3> record_ops = { O.id, P.id, S.id };
-                rdf_model.ops->delete_record(record_ops);
+                rdf_model.get_ops()->delete_record(record_ops);
             }
 
             if (S == P) {
@@ -503,6 +584,8 @@ void UpdateExecutor::visit(OpDeleteData& op_delete_data)
         }
     }
 
+    update_characteristic_sets(subject2predicates);
+
     // Execute index deletes
     for (const auto& [name, deletes] : text_index_name2deletes) {
         auto* text_search_index_ptr = rdf_model.catalog.text_index_manager.get_text_index(name);
@@ -587,6 +670,28 @@ void UpdateExecutor::visit(OpCreateHNSWIndex& op_create_hnsw_index)
     }
 }
 
+void UpdateExecutor::visit(OpCreatePermutationIndex& op_create_permutation_index)
+{
+    try {
+        auto created = rdf_model.create_permutation(op_create_permutation_index.permutation);
+        created_permutations.insert(created_permutations.end(), created.begin(), created.end());
+    } catch (const std::exception& e) {
+        // Rethrow any exception wrapped by a QueryExecutionException
+        throw QueryExecutionException(e.what());
+    }
+}
+
+void UpdateExecutor::visit(OpCompactIndex& op_compact_index)
+{
+    try {
+        auto compaction = rdf_model.compact_permutation(op_compact_index.permutation);
+        compactions.emplace_back(op_compact_index.permutation, compaction);
+    } catch (const std::exception& e) {
+        // Rethrow any exception wrapped by a QueryExecutionException
+        throw QueryExecutionException(e.what());
+    }
+}
+
 void UpdateExecutor::print_stats(std::ostream& os)
 {
     bool has_changes = false;
@@ -613,6 +718,31 @@ void UpdateExecutor::print_stats(std::ostream& os)
         has_changes = true;
     }
 
+    if (!created_permutations.empty()) {
+        os << "Permutations created:\n";
+        for (const auto& permutation : created_permutations) {
+            os << "  " << permutation << '\n';
+        }
+        has_changes = true;
+    }
+
+    if (!compactions.empty()) {
+        os << "Indexes compacted:\n";
+        for (const auto& [permutation, compaction] : compactions) {
+            if (compaction.pages_appended == 0) {
+                os << "  " << permutation << ": " << compaction.records << " records"
+                   << ", leaf pages " << compaction.leaf_pages_before << ", already compact\n";
+                continue;
+            }
+            os << "  " << permutation << ": " << compaction.records << " records"
+               << ", leaf pages " << compaction.leaf_pages_before << " -> " << compaction.leaf_pages_after
+               << ", dir pages " << compaction.dir_pages_before << " -> " << compaction.dir_pages_after
+               << ", " << compaction.pages_appended << " pages appended (old pages are not freed)";
+            os << '\n';
+        }
+        has_changes = true;
+    }
+
     if (!has_changes) {
         os << "No modifications were performed\n";
         return;
@@ -3,13 +3,18 @@
 #include <cstdint>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <boost/unordered/unordered_map.hpp>
 
+#include "query/parser/op/sparql/update/op_compact_index.h"
 #include "query/parser/op/sparql/update/op_create_hnsw_index.h"
+#include "query/parser/op/sparql/update/op_create_permutation_index.h"
 #include "query/parser/op/sparql/update/op_create_text_index.h"
 #include "query/parser/op/sparql/update/op_delete_data.h"
 #include "query/parser/op/sparql/update/op_insert_data.h"
+#include "storage/index/bplus_tree/bplus_tree.h"
 #include "storage/index/hnsw/hnsw_index_update_data.h"
 #include "storage/index/text_search/text_index_update_data.h"
 
@@ -40,6 +45,8 @@ public:
     void visit(OpInsertData&) override;
     void visit(OpCreateTextIndex&) override;
     void visit(OpCreateHNSWIndex&) override;
+    void visit(OpCreatePermutationIndex&) override;
+    void visit(OpCompactIndex&) override;
 
     void visit(OpUpdate&) override { }
 
@@ -82,6 +89,10 @@ private:
     boost::unordered_map<std::string, TextIndexUpdateData> name2text_search_index_update_data;
     boost::unordered_map<std::string, HNSWIndexUpdateData> name2hnsw_index_update_data;
 
+    std::vector<std::string> created_permutations;
+
+    std::vector<std::pair<std::string, BPlusTreeCompaction>> compactions;
+
     // returns true if oid was transformed
     bool transform_if_tmp(ObjectId& oid);
 
@@ -100,5 +111,30 @@ private:
     void insert_text_search_index_update_data(TextIndexUpdateData&& text_search_index_update_data);
 
     void insert_hnsw_index_update_data(HNSWIndexUpdateData&& hnsw_index_update_data);
+
+    // returns the predicates of the subject with how many triples it has with each one
+    static std::vector<std::pair<uint64_t, uint64_t>> get_subject_predicates(ObjectId subject);
+
+    // sorted (predicate, triples of the subject with the predicate) of a subject
+    // before and after the triples of an INSERT DATA or DELETE DATA were applied
+    struct SubjectPredicates {
+        std::vector<std::pair<uint64_t, uint64_t>> before;
+        std::vector<std::pair<uint64_t, uint64_t>> after;
+    };
+
+    using Subject2Predicates = boost::unordered_map<uint64_t, SubjectPredicates>;
+
+    // records a triple inserted (or deleted) with the subject and predicate, after
+    // the change was done in the SPO index. Only the first change of a subject
+    // reads its triples from the index
+    static void track_characteristic_set(
+        Subject2Predicates& subject2predicates,
+        ObjectId subject,
+        ObjectId predicate,
+        bool inserted
+    );
+
+    // moves each subject tracked to the characteristic set of its predicates after the changes
+    static void update_characteristic_sets(const Subject2Predicates& subject2predicates);
 };
 } // namespace SPARQL